@@ -285,6 +285,10 @@ if (LITE_ON_MODEL_OPTIMIZE_TOOL)
   add_definitions("-DLITE_ON_MODEL_OPTIMIZE_TOOL")
 endif(LITE_ON_MODEL_OPTIMIZE_TOOL)
 
+if (LITE_WITH_OPT_CALIBRATION)
+  add_definitions("-DLITE_WITH_OPT_CALIBRATION")
+endif(LITE_WITH_OPT_CALIBRATION)
+
 if (LITE_BUILD_EXTRA)
   add_definitions("-DLITE_BUILD_EXTRA")
 endif(LITE_BUILD_EXTRA)
@@ -65,6 +65,11 @@ bool IsQuantizedMode(const std::shared_ptr<cpp::ProgramDesc> &program_desc) {
           is_quantized_model = true;
         }
       }
+      // Ops quantized offline, e.g. by the calibration of opt
+      if (op_desc->HasAttr("enable_int8") &&
+          op_desc->GetAttr<bool>("enable_int8")) {
+        is_quantized_model = true;
+      }
     }
   }
   return is_quantized_model;
@@ -17,9 +17,11 @@
 #include <memory>
 #include <mutex>  //NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_api.h"
+#include "lite/backends/host/host_allocator.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer/optimizer.h"
 #include "lite/core/program.h"
@@ -182,6 +184,11 @@ class LITE_API Predictor {
     ClearTensorArray(program_desc_);
   }
 
+  // See ConfigBase::set_thread_schedule
+  void SetThreadSchedule(lite_api::ThreadScheduleMode mode) {
+    program_->set_thread_schedule(mode);
+  }
+
 #ifdef LITE_WITH_METAL
   void ConfigMetalContext(const lite_api::CxxConfig& config) {
     program_->ConfigMetalContext(config.metal_lib_path(),
@@ -300,6 +307,8 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   /// \return a boolean variable.
   bool TryShrinkMemory() override;
 
+  lite_api::MemoryStats GetMemoryStats() const override;
+
   std::shared_ptr<lite_api::PaddlePredictor> Clone() override;
 
   std::shared_ptr<lite_api::PaddlePredictor> Clone(
@@ -330,6 +339,12 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   lite_api::CxxConfig config_;
   std::mutex mutex_;
   bool status_is_cloned_;
+  // Host memory allocated while the predictor is created or run
+  HostMemoryStats* memory_stats_{HostMemoryStats::Create()};
+  // The CPUs the threads running the predictor are pinned to, and the
+  // thread calling Run they were pinned for
+  std::vector<int> cpu_affinity_;
+  std::thread::id bound_thread_;
 };
 
 /*
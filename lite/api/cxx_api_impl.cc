@@ -18,9 +18,12 @@
 #include <string>
 #include "lite/api/paddle_api.h"
 #include "lite/core/device_info.h"
+#include "lite/core/optimizer/mir/lookup_table_row_quant_pass.h"
 #include "lite/core/optimizer/mir/pass_manager.h"
 #include "lite/core/optimizer/mir/post_quant_dynamic_pass.h"
+#include "lite/core/optimizer/mir/shared_prefix_pass.h"
 #include "lite/core/optimizer/mir/sparse_conv_detect_pass.h"
+#include "lite/core/optimizer/mir/x86_half_weight_pass.h"
 #include "lite/core/version.h"
 #ifdef LITE_USE_THREAD_POOL
 #include "lite/core/parallel_defines.h"
@@ -36,11 +39,35 @@
 #include <omp.h>
 #endif
 #include "lite/backends/x86/mklml.h"
+#elif (defined LITE_WITH_X86) && (defined LITE_USE_THREAD_POOL) && \
+    !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/parallel.h"
+#endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/parallel.h"
 #endif
 namespace paddle {
 namespace lite {
 
 void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
+  auto &allocator = HostAllocator::Global();
+  allocator.set_max_cached_bytes(config.host_memory_max_cached_bytes());
+  allocator.set_caching(config.host_memory_caching());
+  allocator.set_huge_page_threshold(config.host_memory_huge_page_threshold());
+  allocator.set_numa_node(config.host_memory_numa_node());
+  ScopedHostMemoryStats memory_stats_guard(memory_stats_);
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  if (!config.x86_cpu_affinity().empty() || config.x86_numa_node() >= 0) {
+    // Set before the weights are loaded, so they are placed on the node too
+    int numa_node = x86::ResolveAffinity(
+        config.x86_cpu_affinity(), config.x86_numa_node(), &cpu_affinity_);
+    memory_stats_->set_numa_node(numa_node);
+    LOG(INFO) << "CPU topology: " << x86::GetCpuTopology().ToString()
+              << ", the predictor runs on " << cpu_affinity_.size()
+              << " cpus of NUMA node " << numa_node;
+  }
+#endif
   config_ = config;
   mode_ = config.power_mode();
   threads_ = config.threads();
@@ -97,6 +124,8 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
         raw_predictor_->scope(), config.nnadapter_model_cache_dir());
     Context<TargetType::kNNAdapter>::SetNNAdapterModelCacheBuffers(
         raw_predictor_->scope(), config.nnadapter_model_cache_buffers());
+    Context<TargetType::kNNAdapter>::SetNNAdapterAsyncExecution(
+        raw_predictor_->scope(), config.nnadapter_async_execution());
     Context<TargetType::kNNAdapter>::SetNNAdapterSubgraphPartitionConfigPath(
         raw_predictor_->scope(),
         config.nnadapter_subgraph_partition_config_path());
@@ -132,6 +161,29 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
       pass->SetQuantType(config.quant_type());
     }
 
+    if (config.x86_half_weight_type() != lite_api::HalfWeightType::HALF_NONE) {
+      passes.push_back("x86_half_weight_pass");
+      auto *pass = mir::PassManager::Global().LookUp<mir::X86HalfWeightPass>(
+          "x86_half_weight_pass");
+      CHECK(pass);
+      pass->SetHalfWeightType(config.x86_half_weight_type());
+    }
+
+    // Keep the embedding tables as row-wise int8 for the x86 lookup kernels
+    auto *lookup_quant_pass =
+        mir::PassManager::Global().LookUp<mir::LookupTableRowQuantPass>(
+            "lookup_table_row_quant_pass");
+    CHECK(lookup_quant_pass);
+    lookup_quant_pass->SetEnabled(
+        config.quant_model() &&
+        config.quant_type() == lite_api::QuantType::QUANT_INT8);
+
+    auto *shared_prefix_pass =
+        mir::PassManager::Global().LookUp<mir::SharedPrefixPass>(
+            "shared_prefix_pass");
+    CHECK(shared_prefix_pass);
+    shared_prefix_pass->SetBroadcastInputs(config.broadcast_inputs());
+
     auto *sparse_detect_pass =
         mir::PassManager::Global().LookUp<mir::SparseConvDetectPass>(
             "sparse_conv_detect_pass");
@@ -149,6 +201,7 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
     raw_predictor_->PrepareFeedFetch();
     CHECK(raw_predictor_) << "The Predictor can not be nullptr in Clone mode.";
   }
+  raw_predictor_->SetThreadSchedule(config.thread_schedule());
 
 #ifdef LITE_WITH_METAL
   raw_predictor_->ConfigMetalContext(config);
@@ -176,6 +229,11 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
   VLOG(3) << "x86_math_num_threads() is set successfully and the "
              "number of threads is:"
           << real_num_threads;
+#elif (defined LITE_WITH_X86) && (defined LITE_USE_THREAD_POOL) && \
+    !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // Without MKL the x86 kernels are parallelized on the lite thread pool.
+  x86::SetNumThreads(config.x86_math_num_threads());
+  VLOG(3) << "x86 kernels run on " << ThreadPool::ThreadNum() << " threads";
 #endif
 
 #ifdef LITE_WITH_XPU
@@ -230,6 +288,8 @@ CxxPaddleApiImpl::~CxxPaddleApiImpl() {
 #ifdef LITE_USE_THREAD_POOL
   ThreadPool::ReleaseThreadPool();
 #endif
+  raw_predictor_.reset();
+  memory_stats_->Release();
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInputByName(
@@ -271,6 +331,18 @@ void CxxPaddleApiImpl::Run() {
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // The threads of a predictor follow the thread calling Run
+  if (!cpu_affinity_.empty() && bound_thread_ != std::this_thread::get_id()) {
+    bound_thread_ = std::this_thread::get_id();
+    if (!x86::BindThreads(cpu_affinity_)) {
+      LOG(WARNING) << "Failed to pin the threads of the predictor, the "
+                      "lite thread pool keeps the CPUs of the first "
+                      "predictor pinning it";
+    }
+  }
+#endif
+  ScopedHostMemoryStats memory_stats_guard(memory_stats_);
   raw_predictor_->Run();
 }
 
@@ -312,7 +384,18 @@ void CxxPaddleApiImpl::SaveOptimizedModel(const std::string &model_dir,
 }
 
 bool CxxPaddleApiImpl::TryShrinkMemory() {
-  return raw_predictor_->TryShrinkMemory();
+  bool ret = raw_predictor_->TryShrinkMemory();
+  HostAllocator::Global().ReleaseCache();
+  return ret;
+}
+
+lite_api::MemoryStats CxxPaddleApiImpl::GetMemoryStats() const {
+  lite_api::MemoryStats stats;
+  stats.live_bytes = memory_stats_->live_bytes();
+  stats.peak_bytes = memory_stats_->peak_bytes();
+  stats.allocations = memory_stats_->allocations();
+  stats.cached_bytes = HostAllocator::Global().cached_bytes();
+  return stats;
 }
 
 }  // namespace lite
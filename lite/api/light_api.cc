@@ -15,6 +15,7 @@
 #include "lite/api/light_api.h"
 #include <algorithm>
 #include <map>
+#include "lite/utils/timer.h"
 #ifdef ENABLE_ARM_FP16
 #include "lite/backends/arm/math/fp16/funcs_fp16.h"
 #endif
@@ -24,12 +25,15 @@ namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
                            bool model_from_memory) {
+  auto start_us = Timer::GetCurrentUS();
   if (model_from_memory) {
     LoadModelNaiveFromMemory(
-        lite_model_file, scope_.get(), program_desc_.get());
+        lite_model_file, scope_.get(), program_desc_.get(), &ready_to_run_);
   } else {
-    LoadModelNaiveFromFile(lite_model_file, scope_.get(), program_desc_.get());
+    LoadModelNaiveFromFile(
+        lite_model_file, scope_.get(), program_desc_.get(), &ready_to_run_);
   }
+  auto load_us = Timer::GetCurrentUS();
 
   // For weight quantization of post training, load the int8/16 weights
   // for optimized model, and dequant it to fp32.
@@ -40,6 +44,10 @@ void LightPredictor::Build(const std::string& lite_model_file,
 #endif
   BuildRuntimeProgram(program_desc_);
   PrepareFeedFetch();
+  // Cold start = loading the model + creating the ops and kernels
+  VLOG(1) << "Load model in " << (load_us - start_us) / 1000.f
+          << " ms, build runtime program in "
+          << (Timer::GetCurrentUS() - load_us) / 1000.f << " ms";
 }
 
 void LightPredictor::Build(const std::string& model_dir,
@@ -202,9 +210,26 @@ void LightPredictor::BuildRuntimeProgram(
   CHECK(program_desc);
   auto block_size = program_desc->BlocksSize();
   CHECK(block_size);
+  if (!ready_to_run_.empty()) {
+    // The section only describes single block programs, the vars are
+    // created from its var table. The shapes of the var table are the ones
+    // seen by opt, they are left to the ops to infer at runtime.
+    CHECK_EQ(block_size, 1u);
+    for (auto& var_info : ready_to_run_.vars()) {
+      if (!var_info.persistable) {
+        auto* var = exe_scope->Var(var_info.name);
+        if (var_info.type == lite::VarDescAPI::Type::LOD_TENSOR) {
+          auto* tensor = var->GetMutable<lite::Tensor>();
+          tensor->set_precision(ConvertPrecisionType(var_info.data_type));
+        }
+      } else if (var_info.name != "feed" && var_info.name != "fetch") {
+        scope_->Var(var_info.name);
+      }
+    }
+  }
   for (size_t block_idx = 0; block_idx < block_size; ++block_idx) {
     auto block_desc = program_desc->GetBlock<cpp::BlockDesc>(block_idx);
-    auto var_size = block_desc->VarsSize();
+    auto var_size = ready_to_run_.empty() ? block_desc->VarsSize() : 0;
     for (size_t var_idx = 0; var_idx < var_size; ++var_idx) {
       auto var_desc = block_desc->GetVar<cpp::VarDesc>(var_idx);
       if (!var_desc->Persistable()) {
@@ -228,7 +253,11 @@ void LightPredictor::BuildRuntimeProgram(
   }
   // Only extracting the ops and generate the runtime program from the main
   // block desc
-  program_.reset(new RuntimeProgram(program_desc, exe_scope, kRootBlockIdx));
+  program_.reset(new RuntimeProgram(
+      program_desc,
+      exe_scope,
+      kRootBlockIdx,
+      ready_to_run_.empty() ? nullptr : &ready_to_run_.kernels()));
 }
 
 void LightPredictor::DequantizeWeight() {
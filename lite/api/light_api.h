@@ -22,9 +22,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_api.h"
+#include "lite/backends/host/host_allocator.h"
 #include "lite/core/context.h"
 #include "lite/core/program.h"
 #include "lite/core/tensor.h"
@@ -98,6 +100,11 @@ class LITE_API LightPredictor {
   void PrepareFeedFetch();
   Scope* scope() { return scope_.get(); }
 
+  // See ConfigBase::set_thread_schedule
+  void SetThreadSchedule(lite_api::ThreadScheduleMode mode) {
+    program_->set_thread_schedule(mode);
+  }
+
 #ifdef LITE_WITH_METAL
   void ConfigMetalContext(const lite_api::MobileConfig& config) {
     program_->ConfigMetalContext(config.metal_lib_path(),
@@ -140,6 +147,8 @@ class LITE_API LightPredictor {
   std::shared_ptr<Scope> scope_;
   std::unique_ptr<RuntimeProgram> program_;
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  // The ready-to-run section of a meta_version 3 model
+  model_parser::ReadyToRunProgram ready_to_run_;
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
   std::vector<PrecisionType> input_precisions_;
@@ -176,8 +185,16 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
   /// \return a boolean variable.
   bool TryShrinkMemory() override;
 
+  lite_api::MemoryStats GetMemoryStats() const override;
+
  private:
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  // Host memory allocated while the predictor is created or run
+  HostMemoryStats* memory_stats_{HostMemoryStats::Create()};
+  // The CPUs the threads running the predictor are pinned to, and the
+  // thread calling Run they were pinned for
+  std::vector<int> cpu_affinity_;
+  std::thread::id bound_thread_;
 };
 
 }  // namespace lite
@@ -27,12 +27,36 @@
 #if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
     !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
 #include "lite/backends/x86/mklml.h"
+#elif (defined LITE_WITH_X86) && (defined LITE_USE_THREAD_POOL) && \
+    !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/parallel.h"
+#endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/parallel.h"
 #endif
 
 namespace paddle {
 namespace lite {
 
 void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
+  auto& allocator = HostAllocator::Global();
+  allocator.set_max_cached_bytes(config.host_memory_max_cached_bytes());
+  allocator.set_caching(config.host_memory_caching());
+  allocator.set_huge_page_threshold(config.host_memory_huge_page_threshold());
+  allocator.set_numa_node(config.host_memory_numa_node());
+  ScopedHostMemoryStats memory_stats_guard(memory_stats_);
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  if (!config.x86_cpu_affinity().empty() || config.x86_numa_node() >= 0) {
+    // Set before the weights are loaded, so they are placed on the node too
+    int numa_node = x86::ResolveAffinity(
+        config.x86_cpu_affinity(), config.x86_numa_node(), &cpu_affinity_);
+    memory_stats_->set_numa_node(numa_node);
+    LOG(INFO) << "CPU topology: " << x86::GetCpuTopology().ToString()
+              << ", the predictor runs on " << cpu_affinity_.size()
+              << " cpus of NUMA node " << numa_node;
+  }
+#endif
   // LightPredictor Only support NaiveBuffer backend in publish lib
   if (config.lite_model_file().empty()) {
     raw_predictor_.reset(
@@ -45,6 +69,7 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
     raw_predictor_.reset(new LightPredictor(config.lite_model_file(),
                                             config.is_model_from_memory()));
   }
+  raw_predictor_->SetThreadSchedule(config.thread_schedule());
   mode_ = config.power_mode();
   threads_ = config.threads();
 #ifdef LITE_USE_THREAD_POOL
@@ -78,6 +103,8 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
       raw_predictor_->scope(), config.nnadapter_model_cache_dir());
   Context<TargetType::kNNAdapter>::SetNNAdapterModelCacheBuffers(
       raw_predictor_->scope(), config.nnadapter_model_cache_buffers());
+  Context<TargetType::kNNAdapter>::SetNNAdapterAsyncExecution(
+      raw_predictor_->scope(), config.nnadapter_async_execution());
   Context<TargetType::kNNAdapter>::SetNNAdapterDynamicShapeInfo(
       raw_predictor_->scope(), config.nnadapter_dynamic_shape_info());
 #endif
@@ -94,6 +121,11 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
   VLOG(3) << "x86_math_num_threads() is set successfully and the "
              "number of threads is:"
           << real_num_threads;
+#elif (defined LITE_WITH_X86) && (defined LITE_USE_THREAD_POOL) && \
+    !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // Without MKL the x86 kernels are parallelized on the lite thread pool.
+  x86::SetNumThreads(config.x86_math_num_threads());
+  VLOG(3) << "x86 kernels run on " << ThreadPool::ThreadNum() << " threads";
 #endif
 }
 
@@ -101,6 +133,8 @@ LightPredictorImpl::~LightPredictorImpl() {
 #ifdef LITE_USE_THREAD_POOL
   ThreadPool::ReleaseThreadPool();
 #endif
+  raw_predictor_.reset();
+  memory_stats_->Release();
 }
 
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInputByName(
@@ -130,6 +164,18 @@ void LightPredictorImpl::Run() {
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // The threads of a predictor follow the thread calling Run
+  if (!cpu_affinity_.empty() && bound_thread_ != std::this_thread::get_id()) {
+    bound_thread_ = std::this_thread::get_id();
+    if (!x86::BindThreads(cpu_affinity_)) {
+      LOG(WARNING) << "Failed to pin the threads of the predictor, the "
+                      "lite thread pool keeps the CPUs of the first "
+                      "predictor pinning it";
+    }
+  }
+#endif
+  ScopedHostMemoryStats memory_stats_guard(memory_stats_);
   raw_predictor_->Run();
 }
 
@@ -161,7 +207,18 @@ std::vector<std::string> LightPredictorImpl::GetOutputNames() {
 }
 
 bool LightPredictorImpl::TryShrinkMemory() {
-  return raw_predictor_->TryShrinkMemory();
+  bool ret = raw_predictor_->TryShrinkMemory();
+  HostAllocator::Global().ReleaseCache();
+  return ret;
+}
+
+lite_api::MemoryStats LightPredictorImpl::GetMemoryStats() const {
+  lite_api::MemoryStats stats;
+  stats.live_bytes = memory_stats_->live_bytes();
+  stats.peak_bytes = memory_stats_->peak_bytes();
+  stats.allocations = memory_stats_->allocations();
+  stats.cached_bytes = HostAllocator::Global().cached_bytes();
+  return stats;
 }
 
 }  // namespace lite
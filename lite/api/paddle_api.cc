@@ -14,8 +14,10 @@
 
 #include "lite/api/paddle_api.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "lite/backends/host/host_allocator.h"
 #include "lite/core/context.h"
 #include "lite/core/device_info.h"
 #include "lite/core/target_wrapper.h"
@@ -42,6 +44,14 @@
 #include "lite/backends/metal/target_wrapper.h"
 #endif
 
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/jit/gen_base.h"
+#endif
+
+#ifdef LITE_WITH_NNADAPTER
+#include "lite/backends/nnadapter/program_cache.h"
+#endif
+
 namespace paddle {
 namespace lite_api {
 
@@ -82,6 +92,30 @@ int GetOpenCLDeviceType() {
   return -1;
 }
 
+NNAdapterProgramCacheStats GetNNAdapterProgramCacheStats() {
+  NNAdapterProgramCacheStats stats;
+#ifdef LITE_WITH_NNADAPTER
+  auto cache_stats = paddle::lite::NNAdapterProgramCache::Global().Stats();
+  stats.hits = cache_stats.hits;
+  stats.misses = cache_stats.misses;
+  stats.evictions = cache_stats.evictions;
+  stats.entries = cache_stats.entries;
+#endif
+  return stats;
+}
+
+void SetNNAdapterProgramCacheCapacity(size_t capacity) {
+#ifdef LITE_WITH_NNADAPTER
+  paddle::lite::NNAdapterProgramCache::Global().SetCapacity(capacity);
+#endif
+}
+
+void ClearNNAdapterProgramCache() {
+#ifdef LITE_WITH_NNADAPTER
+  paddle::lite::NNAdapterProgramCache::Global().Clear();
+#endif
+}
+
 Tensor::Tensor(void *raw) : raw_tensor_(raw) {}
 
 // TODO(Superjomn) refine this by using another `const void* const_raw`;
@@ -284,6 +318,92 @@ std::unique_ptr<Tensor> PaddlePredictor::GetMutableTensor(
   return nullptr;
 }
 
+MemoryStats PaddlePredictor::GetMemoryStats() const {
+  MemoryStats stats;
+  stats.cached_bytes = lite::HostAllocator::Global().cached_bytes();
+  return stats;
+}
+
+template <typename T>
+static void FillZeros(Tensor *tensor) {
+  auto shape = tensor->shape();
+  int64_t size = 1;
+  for (auto dim : shape) size *= dim;
+  T *data = tensor->mutable_data<T>();
+  std::fill(data, data + size, static_cast<T>(0));
+}
+
+// Zeros are also valid indices for the lookup and gather inputs
+static void FillSyntheticInput(Tensor *tensor) {
+  switch (tensor->precision()) {
+    case PrecisionType::kInt64:
+      FillZeros<int64_t>(tensor);
+      break;
+    case PrecisionType::kInt32:
+      FillZeros<int>(tensor);
+      break;
+    case PrecisionType::kInt16:
+      FillZeros<int16_t>(tensor);
+      break;
+    case PrecisionType::kInt8:
+      FillZeros<int8_t>(tensor);
+      break;
+    case PrecisionType::kUInt8:
+      FillZeros<uint8_t>(tensor);
+      break;
+    case PrecisionType::kBool:
+      FillZeros<bool>(tensor);
+      break;
+    case PrecisionType::kFP64:
+      FillZeros<double>(tensor);
+      break;
+    default:
+      FillZeros<float>(tensor);
+      break;
+  }
+}
+
+// The number of jit codes generated by the process
+static int64_t NumGeneratedCodes() {
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  return lite::jit::GenBase::NumGenerated();
+#else
+  return 0;
+#endif
+}
+
+bool PaddlePredictor::Warmup(
+    const std::vector<std::map<std::string, shape_t>> &shape_buckets) {
+  auto run_bucket = [&](const std::map<std::string, shape_t> &bucket) {
+    for (auto &input : bucket) {
+      auto tensor = GetInputByName(input.first);
+      tensor->Resize(input.second);
+      tensor->SetLoD({});
+      FillSyntheticInput(tensor.get());
+    }
+    Run();
+  };
+  // The buffers only grow, so every bucket is warm once all of them ran
+  for (auto &bucket : shape_buckets) {
+    run_bucket(bucket);
+  }
+  bool warm = true;
+  for (size_t i = 0; i < shape_buckets.size(); i++) {
+    int64_t allocations = GetMemoryStats().allocations;
+    int64_t codes = NumGeneratedCodes();
+    run_bucket(shape_buckets[i]);
+    allocations = GetMemoryStats().allocations - allocations;
+    codes = NumGeneratedCodes() - codes;
+    if (allocations > 0 || codes > 0) {
+      LOG(WARNING) << "The warm run of shape bucket " << i << " made "
+                   << allocations << " host allocations and generated "
+                   << codes << " jit codes";
+      warm = false;
+    }
+  }
+  return warm;
+}
+
 std::vector<std::string> PaddlePredictor::GetParamNames() {
   std::vector<std::string> null_result = {};
   LOG(FATAL)
@@ -51,6 +51,26 @@ LITE_API bool IsOpenCLBackendValid(bool check_fp16_valid = false);
 // UNKNOWN:0, QUALCOMM_ADRENO:1, ARM_MALI:2, IMAGINATION_POWERVR:3, OTHERS:4,
 LITE_API int GetOpenCLDeviceType();
 
+// The statistics of the process-wide cache of the compiled NNAdapter device
+// programs, which is shared by all of the predictors and their clones. A
+// program is released with the last predictor using it, the cache doesn't
+// keep it alive.
+struct LITE_API NNAdapterProgramCacheStats {
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t evictions{0};
+  uint64_t entries{0};
+};
+
+LITE_API NNAdapterProgramCacheStats GetNNAdapterProgramCacheStats();
+
+// Set the max number of the cached NNAdapter device programs, the least
+// recently used ones are dropped first, and 0 disables the cache. It defaults
+// to the environment variable NNADAPTER_PROGRAM_CACHE_CAPACITY or 32.
+LITE_API void SetNNAdapterProgramCacheCapacity(size_t capacity);
+
+LITE_API void ClearNNAdapterProgramCache();
+
 struct LITE_API Tensor {
   explicit Tensor(void* raw);
   explicit Tensor(const void* raw);
@@ -93,6 +113,20 @@ struct LITE_API Tensor {
   void* raw_tensor_;
 };
 
+/// Host memory statistics of a predictor, in bytes.
+struct LITE_API MemoryStats {
+  /// Allocated on behalf of the predictor and not freed yet.
+  int64_t live_bytes{0};
+  /// The high-water mark of `live_bytes`.
+  int64_t peak_bytes{0};
+  /// Freed blocks kept by the process-wide host allocator for reuse, shared
+  /// by all the predictors.
+  int64_t cached_bytes{0};
+  /// The number of host blocks handed out to the predictor, reused ones
+  /// included. It doesn't grow across runs once the predictor is warm.
+  int64_t allocations{0};
+};
+
 /// The PaddlePredictor defines the basic interfaces for different kinds of
 /// predictors.
 class LITE_API PaddlePredictor {
@@ -122,6 +156,21 @@ class LITE_API PaddlePredictor {
   /// Release all tmp tensor to compress the size of the memory pool.
   virtual bool TryShrinkMemory() = 0;
 
+  /// Host memory allocated while the predictor is created or run.
+  virtual MemoryStats GetMemoryStats() const;
+
+  /// Prepare the predictor for the declared buckets of input shapes before
+  /// serving, each bucket maps the input names to their shapes. The
+  /// predictor runs once per bucket on zero-filled inputs, which generates
+  /// the jit code, packs the weights, grows the buffers and compiles the
+  /// device subgraphs that the first requests would pay for otherwise. The
+  /// contents of the inputs and outputs are unspecified afterwards.
+  ///
+  /// \return Whether a second round over the buckets ran without any host
+  /// allocation or code generation. The offending buckets are logged.
+  virtual bool Warmup(
+      const std::vector<std::map<std::string, shape_t>>& shape_buckets);
+
   // Get Input by name
   virtual std::unique_ptr<Tensor> GetInputByName(const std::string& name) = 0;
 
@@ -175,8 +224,18 @@ class LITE_API ConfigBase {
       nnadapter_dynamic_shape_info_;
   // The buffers for loading the compiled NNAdapter models from memory.
   std::map<std::string, std::vector<char>> nnadapter_model_cache_buffers_{};
+  // Don't block the program while the NNAdapter device is running.
+  bool nnadapter_async_execution_{false};
   int device_id_{0};
   int x86_math_num_threads_ = 1;
+  std::vector<int> x86_cpu_affinity_{};
+  int x86_numa_node_{-1};
+  // The process-wide host allocator
+  bool host_memory_caching_{false};
+  size_t host_memory_max_cached_bytes_{size_t(64) << 20};
+  size_t host_memory_huge_page_threshold_{0};
+  int host_memory_numa_node_{-1};
+  ThreadScheduleMode thread_schedule_{LITE_THREADS_FIXED};
 
   std::string metal_path_;
   bool metal_use_mps_{false};
@@ -191,12 +250,21 @@ class LITE_API ConfigBase {
   // set Model_dir
   void set_model_dir(const std::string& x) { model_dir_ = x; }
   const std::string& model_dir() const { return model_dir_; }
-  // set Thread
+  // set Thread, on x86 see set_x86_math_num_threads
   void set_threads(int threads);
   int threads() const { return threads_; }
   // set Power_mode
   void set_power_mode(PowerMode mode);
   PowerMode power_mode() const { return mode_; }
+  /// \brief Choose the number of threads per op instead of running every op
+  /// on all of the threads, tiny ops then skip the fork/join. The choices are
+  /// made per op and per input size bucket while the predictor runs, so the
+  /// first runs at a new size may be slower.
+  ///
+  /// \param mode  LITE_THREADS_FIXED (default), LITE_THREADS_COST_MODEL or
+  /// LITE_THREADS_MEASURED.
+  void set_thread_schedule(ThreadScheduleMode mode) { thread_schedule_ = mode; }
+  ThreadScheduleMode thread_schedule() const { return thread_schedule_; }
 
   /// \brief Set path and file name of generated OpenCL compiled kernel binary.
   ///
@@ -323,12 +391,65 @@ class LITE_API ConfigBase {
   nnadapter_model_cache_buffers() const {
     return nnadapter_model_cache_buffers_;
   }
+  // Let the NNAdapter subgraphs return as soon as the device starts to run, so
+  // the following ops which don't depend on their outputs run on the host
+  // meanwhile. The predictor waits for the device before Run() returns.
+  void set_nnadapter_async_execution(bool async_execution) {
+    nnadapter_async_execution_ = async_execution;
+  }
+  bool nnadapter_async_execution() const { return nnadapter_async_execution_; }
   // set Device ID
   void set_device_id(int device_id) { device_id_ = device_id; }
   int get_device_id() const { return device_id_; }
-  // set x86_math_num_threads
+  // set x86_math_num_threads, the threads of the x86 thread pool are shared
+  // by all of the predictors of the process, and a predictor running while
+  // the pool serves another one runs its parallel loops on its own thread.
   void set_x86_math_num_threads(int threads);
   int x86_math_num_threads() const;
+  /// \brief Pin the threads running this predictor on x86: the i-th thread
+  /// of the calling thread's OpenMP team or of the lite thread pool runs on
+  /// the i-th CPU of the set. Linux only. The lite thread pool is shared by
+  /// the predictors of the process and keeps the CPUs of the first one, a
+  /// different set of another predictor only pins its calling thread.
+  void set_x86_cpu_affinity(const std::vector<int>& cpu_ids) {
+    x86_cpu_affinity_ = cpu_ids;
+  }
+  const std::vector<int>& x86_cpu_affinity() const {
+    return x86_cpu_affinity_;
+  }
+  /// \param node  Pin the threads to the CPUs of this NUMA node unless a CPU
+  /// set is given, and place the large host blocks of the predictor, weights
+  /// and activations, on it. Defaults to the node of the first CPU of the
+  /// set, -1 without a set. Linux only.
+  void set_x86_numa_node(int node) { x86_numa_node_ = node; }
+  int x86_numa_node() const { return x86_numa_node_; }
+
+  /// \brief Configure the process-wide host allocator, the settings of the
+  /// last created predictor take effect.
+  ///
+  /// \param enable  Keep freed host blocks for reuse (default off), the cache
+  /// is shared by all the predictors of the process.
+  void set_host_memory_caching(bool enable) { host_memory_caching_ = enable; }
+  bool host_memory_caching() const { return host_memory_caching_; }
+  /// \param bytes  The upper bound of the bytes kept for reuse (default 64MB).
+  void set_host_memory_max_cached_bytes(size_t bytes) {
+    host_memory_max_cached_bytes_ = bytes;
+  }
+  size_t host_memory_max_cached_bytes() const {
+    return host_memory_max_cached_bytes_;
+  }
+  /// \param bytes  Back host blocks of at least `bytes` with transparent huge
+  /// pages, 0 (the default) disables it. Linux only.
+  void set_host_memory_huge_page_threshold(size_t bytes) {
+    host_memory_huge_page_threshold_ = bytes;
+  }
+  size_t host_memory_huge_page_threshold() const {
+    return host_memory_huge_page_threshold_;
+  }
+  /// \param node  Prefer placing large host blocks on this NUMA node, -1 (the
+  /// default) leaves it to the system. Linux only.
+  void set_host_memory_numa_node(int node) { host_memory_numa_node_ = node; }
+  int host_memory_numa_node() const { return host_memory_numa_node_; }
 
   void set_metal_lib_path(const std::string& path);
   void set_metal_use_mps(bool flag);
@@ -376,8 +497,12 @@ class LITE_API CxxConfig : public ConfigBase {
   std::vector<std::string> passes_internal_{};
   bool quant_model_{false};  // Enable post_quant_dynamic in opt
   QuantType quant_type_{QuantType::QUANT_INT16};
+  // Enable x86_half_weight_pass in opt
+  HalfWeightType x86_half_weight_type_{HalfWeightType::HALF_NONE};
   bool sparse_model_{false};  // Enable sparse_conv_detect_pass in opt
   float sparse_threshold_{0.6f};
+  // Inputs fed once per request, see set_broadcast_inputs
+  std::vector<std::string> broadcast_inputs_{};
   std::map<int, std::vector<std::shared_ptr<void>>>
       preferred_inputs_for_warmup_;
 #ifdef LITE_WITH_CUDA
@@ -506,6 +631,10 @@ class LITE_API CxxConfig : public ConfigBase {
   bool quant_model() const { return quant_model_; }
   void set_quant_type(QuantType quant_type) { quant_type_ = quant_type; }
   QuantType quant_type() const { return quant_type_; }
+  void set_x86_half_weight_type(HalfWeightType type) {
+    x86_half_weight_type_ = type;
+  }
+  HalfWeightType x86_half_weight_type() const { return x86_half_weight_type_; }
 
   void set_sparse_model(bool sparse_model) { sparse_model_ = sparse_model; }
   bool sparse_model() const { return sparse_model_; }
@@ -514,6 +643,18 @@ class LITE_API CxxConfig : public ConfigBase {
   }
   float sparse_threshold() const { return sparse_threshold_; }
 
+  // Mark the inputs that are the same for every row of a batch, e.g. the user
+  // features of a CTR model scoring many candidate items. They are fed with a
+  // leading dim of 1, the ops depending only on them run once at batch 1 and
+  // their results are broadcast to the batch of the other inputs, see
+  // shared_prefix_pass.
+  void set_broadcast_inputs(const std::vector<std::string>& names) {
+    broadcast_inputs_ = names;
+  }
+  const std::vector<std::string>& broadcast_inputs() const {
+    return broadcast_inputs_;
+  }
+
   // Enable the custom subgraph partition for NNAdapter by providing the
   // configuration file or buffer
   void set_nnadapter_subgraph_partition_config_path(
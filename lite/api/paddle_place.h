@@ -115,6 +115,17 @@ typedef enum {
 
 typedef enum { MLU_220 = 0, MLU_270 = 1 } MLUCoreVersion;
 
+// How many threads every CPU op runs with
+typedef enum {
+  // All of the configured threads
+  LITE_THREADS_FIXED = 0,
+  // Estimated from the FLOPs and bytes of the op at each input size
+  LITE_THREADS_COST_MODEL = 1,
+  // The fastest of 1, 2, 4, ... threads, timed during the first runs at each
+  // input size
+  LITE_THREADS_MEASURED = 2
+} ThreadScheduleMode;
+
 enum class ActivationType : int {
   kIndentity = 0,
   kRelu = 1,
@@ -170,6 +181,14 @@ enum class QuantType : int {
   QUANT_INT16,
 };
 
+// Storage type of the x86 fc/matmul/conv2d weights, the computation is
+// always done in fp32.
+enum class HalfWeightType : int {
+  HALF_NONE,
+  HALF_FP16,
+  HALF_BF16,
+};
+
 template <typename T>
 struct PrecisionTypeTrait {
   constexpr static PrecisionType Type() { return PrecisionType::kUnk; }
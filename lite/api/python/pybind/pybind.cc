@@ -51,6 +51,7 @@ using lite_api::PowerMode;
 using lite_api::PrecisionType;
 using lite_api::TargetType;
 using lite_api::CLTuneMode;
+using lite_api::ThreadScheduleMode;
 using lite_api::CLPrecisionType;
 using lite_api::Tensor;
 using lite_api::CxxModelBuffer;
@@ -71,6 +72,11 @@ void BindLiteOpt(py::module *m) {
       .def("set_model_type", &OptBase::SetModelType)
       .def("set_quant_model", &OptBase::SetQuantModel)
       .def("set_quant_type", &OptBase::SetQuantType)
+      .def("set_x86_half_weight", &OptBase::SetX86HalfWeight)
+      .def("set_calibration_data_dir", &OptBase::SetCalibrationDataDir)
+      .def("set_calibration_algo", &OptBase::SetCalibrationAlgo)
+      .def("set_calibration_max_samples", &OptBase::SetCalibrationMaxSamples)
+      .def("set_calibration_skip", &OptBase::SetCalibrationSkip)
       .def("set_sparse_model", &OptBase::SetSparseModel)
       .def("set_sparse_threshold", &OptBase::SetSparseThreshold)
       .def("record_model_info", &OptBase::RecordModelInfo)
@@ -93,6 +99,7 @@ static void BindLiteLightPredictor(py::module *m);
 static void BindLiteCxxConfig(py::module *m);
 static void BindLiteMobileConfig(py::module *m);
 static void BindLitePowerMode(py::module *m);
+static void BindLiteThreadScheduleMode(py::module *m);
 static void BindLitePlace(py::module *m);
 static void BindLiteCLTuneMode(py::module *m);
 static void BindLiteCLPrecisionType(py::module *m);
@@ -103,6 +110,7 @@ void BindLiteApi(py::module *m) {
   BindLiteCxxConfig(m);
   BindLiteMobileConfig(m);
   BindLitePowerMode(m);
+  BindLiteThreadScheduleMode(m);
   BindLitePlace(m);
   BindLiteCLTuneMode(m);
   BindLiteCLPrecisionType(m);
@@ -153,7 +161,9 @@ void BindLiteCxxConfig(py::module *m) {
   cxx_config.def("set_threads", &CxxConfig::set_threads)
       .def("threads", &CxxConfig::threads)
       .def("set_power_mode", &CxxConfig::set_power_mode)
-      .def("power_mode", &CxxConfig::power_mode);
+      .def("power_mode", &CxxConfig::power_mode)
+      .def("set_thread_schedule", &CxxConfig::set_thread_schedule)
+      .def("thread_schedule", &CxxConfig::thread_schedule);
 
   cxx_config
       .def("set_opencl_binary_path_name",
@@ -212,7 +222,9 @@ void BindLiteMobileConfig(py::module *m) {
   mobile_config.def("set_threads", &MobileConfig::set_threads)
       .def("threads", &MobileConfig::threads)
       .def("set_power_mode", &MobileConfig::set_power_mode)
-      .def("power_mode", &MobileConfig::power_mode);
+      .def("power_mode", &MobileConfig::power_mode)
+      .def("set_thread_schedule", &MobileConfig::set_thread_schedule)
+      .def("thread_schedule", &MobileConfig::thread_schedule);
 #endif
   mobile_config
       .def("set_opencl_binary_path_name",
@@ -249,6 +261,15 @@ void BindLitePowerMode(py::module *m) {
       .value("LITE_POWER_RAND_LOW", PowerMode::LITE_POWER_RAND_LOW);
 }
 
+void BindLiteThreadScheduleMode(py::module *m) {
+  py::enum_<ThreadScheduleMode>(*m, "ThreadScheduleMode")
+      .value("LITE_THREADS_FIXED", ThreadScheduleMode::LITE_THREADS_FIXED)
+      .value("LITE_THREADS_COST_MODEL",
+             ThreadScheduleMode::LITE_THREADS_COST_MODEL)
+      .value("LITE_THREADS_MEASURED",
+             ThreadScheduleMode::LITE_THREADS_MEASURED);
+}
+
 void BindLiteCLTuneMode(py::module *m) {
   py::enum_<CLTuneMode>(*m, "CLTuneMode")
       .value("CL_TUNE_NONE", CLTuneMode::CL_TUNE_NONE)
@@ -401,6 +422,7 @@ void BindLiteCxxPredictor(py::module *m) {
       .def("get_input_by_name", &CxxPaddleApiImpl::GetInputByName)
       .def("get_output_by_name", &CxxPaddleApiImpl::GetOutputByName)
       .def("run", &CxxPaddleApiImpl::Run)
+      .def("warmup", &CxxPaddleApiImpl::Warmup)
       .def("get_version", &CxxPaddleApiImpl::GetVersion)
       .def("save_optimized_pb_model",
            [](CxxPaddleApiImpl &self, const std::string &output_dir) {
@@ -425,6 +447,7 @@ void BindLiteLightPredictor(py::module *m) {
       .def("get_input_by_name", &LightPredictorImpl::GetInputByName)
       .def("get_output_by_name", &LightPredictorImpl::GetOutputByName)
       .def("run", &LightPredictorImpl::Run)
+      .def("warmup", &LightPredictorImpl::Warmup)
       .def("get_version", &LightPredictorImpl::GetVersion);
 }
 
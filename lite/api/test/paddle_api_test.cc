@@ -74,6 +74,35 @@ TEST(CxxApi, run) {
       FLAGS_model_dir + ".opt2.naive", LiteModelType::kNaiveBuffer, true);
 }
 
+TEST(CxxApi, warmup) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto input_name = predictor->GetInputNames()[0];
+  EXPECT_TRUE(predictor->Warmup({{{input_name, {100, 100}}},
+                                 {{input_name, {20, 100}}}}));
+
+  // Requests within the buckets allocate nothing
+  int64_t allocations = predictor->GetMemoryStats().allocations;
+  auto input_tensor = predictor->GetInputByName(input_name);
+  input_tensor->Resize(std::vector<int64_t>({100, 100}));
+  auto* data = input_tensor->mutable_data<float>();
+  for (int i = 0; i < 100 * 100; i++) {
+    data[i] = i;
+  }
+  predictor->Run();
+  EXPECT_EQ(predictor->GetMemoryStats().allocations, allocations);
+
+  auto output = predictor->GetTensor(predictor->GetOutputNames()[0]);
+  auto* out = output->data<float>();
+  EXPECT_NEAR(out[0], 50.2132, 1e-3);
+  EXPECT_NEAR(out[1], -28.8729, 1e-3);
+}
+
 TEST(CxxApi, share_external_data) {
   lite_api::CxxConfig config;
   config.set_model_dir(FLAGS_model_dir);
@@ -29,6 +29,7 @@
 #ifdef __linux__
 #include "lite/api/tools/benchmark/profile/resource_usage_monitor.h"
 #endif
+#include "lite/api/tools/benchmark/stress/stress_test.h"
 #include "lite/core/version.h"
 #include "lite/utils/timer.h"
 
@@ -57,7 +58,11 @@ int Benchmark(int argc, char** argv) {
   auto input_shapes = lite::GetShapes(FLAGS_input_shape);
 
   // Run
-  Run(model_file, input_shapes);
+  if (FLAGS_stress_mode.empty()) {
+    Run(model_file, input_shapes);
+  } else {
+    RunStress(model_file, input_shapes);
+  }
 
   return 0;
 }
@@ -68,6 +73,8 @@ std::shared_ptr<PaddlePredictor> CreatePredictor(
   config.set_model_from_file(model_file);
   config.set_threads(FLAGS_threads);
   config.set_power_mode(static_cast<PowerMode>(FLAGS_power_mode));
+  config.set_thread_schedule(
+      static_cast<ThreadScheduleMode>(FLAGS_thread_schedule));
 
   // Set backend config info
   SetBackendConfig(config);
@@ -331,5 +338,65 @@ void Run(const std::string& model_file,
   StoreBenchmarkResult(ss.str());
 }
 
+void RunStress(const std::string& model_file,
+               const std::vector<std::vector<int64_t>>& input_shapes) {
+  stress::StressOptions options;
+  options.mode = FLAGS_stress_mode;
+  options.predictors = FLAGS_stress_predictors;
+  options.clients = FLAGS_stress_clients;
+  options.qps = FLAGS_stress_qps;
+  options.duration_s = FLAGS_stress_duration;
+  options.warmup_s = FLAGS_stress_warmup;
+  options.sample_interval_ms = FLAGS_stress_sample_interval_ms;
+  if (FLAGS_stress_shape_file.empty()) {
+    stress::ShapeCase shape_case;
+    shape_case.shapes = input_shapes;
+    options.shape_cases.push_back(shape_case);
+  } else {
+    options.shape_cases =
+        stress::LoadShapeDistribution(FLAGS_stress_shape_file);
+  }
+  double weight_sum = 0.0;
+  for (auto& shape_case : options.shape_cases) {
+    weight_sum += shape_case.weight;
+  }
+  if (weight_sum <= 0.0) {
+    std::cerr << "No input shape with a positive weight to stress!"
+              << std::endl;
+    std::abort();
+  }
+
+  lite::Timer timer;
+  timer.Start();
+  auto predictor = CreatePredictor(model_file);
+  float init_time = timer.Stop();
+  auto report = stress::RunStressTest(predictor, options);
+
+  std::stringstream ss;
+  ss.precision(3);
+  ss << "\n======= Model Info =======\n";
+  ss << "optimized_model_file: " << model_file << std::endl;
+  ss << "\n======= Runtime Info =======\n";
+  ss << "benchmark_bin version: " << lite::version() << std::endl;
+  ss << "threads: " << FLAGS_threads << std::endl;
+  ss << "power_mode: " << FLAGS_power_mode << std::endl;
+  ss << "backend: " << FLAGS_backend << std::endl;
+  ss << std::fixed << "init(ms): " << init_time << std::endl;
+  ss << report.ToString();
+  std::cout << ss.str() << std::endl;
+  StoreBenchmarkResult(ss.str());
+
+  if (!FLAGS_stress_report_path.empty()) {
+    std::ofstream fs(FLAGS_stress_report_path);
+    if (!fs.is_open()) {
+      std::cerr << "Fail to open stress report file: "
+                << FLAGS_stress_report_path << std::endl;
+      return;
+    }
+    fs << report.ToJson();
+    fs.close();
+  }
+}
+
 }  // namespace lite_api
 }  // namespace paddle
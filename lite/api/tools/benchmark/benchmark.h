@@ -95,6 +95,8 @@ class PerfData {
 int Benchmark(int argc, char** argv);
 void Run(const std::string& model_file,
          const std::vector<std::vector<int64_t>>& input_shape);
+void RunStress(const std::string& model_file,
+               const std::vector<std::vector<int64_t>>& input_shape);
 
 #ifdef __ANDROID__
 std::string GetDeviceInfo() {
@@ -192,6 +194,32 @@ bool CheckFlagsValid() {
       ret = false;
     }
   }
+  if (!FLAGS_stress_mode.empty()) {
+    if (FLAGS_stress_mode != "closed" && FLAGS_stress_mode != "open") {
+      std::cerr << "Illegal stress mode: " << FLAGS_stress_mode << std::endl;
+      ret = false;
+    }
+    if (FLAGS_stress_mode == "open" && FLAGS_stress_qps <= 0.0) {
+      std::cerr << "Must set a positive --stress_qps for the open mode!"
+                << std::endl;
+      ret = false;
+    }
+    if (FLAGS_stress_predictors < 1 || FLAGS_stress_clients < 1) {
+      std::cerr << "--stress_predictors and --stress_clients should be "
+                   "positive!"
+                << std::endl;
+      ret = false;
+    }
+    if (FLAGS_stress_duration <= 0.0) {
+      std::cerr << "--stress_duration should be positive!" << std::endl;
+      ret = false;
+    }
+    if (!FLAGS_validation_set.empty()) {
+      std::cerr << "--stress_mode can't be used with --validation_set!"
+                << std::endl;
+      ret = false;
+    }
+  }
 
   return ret;
 }
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/benchmark/stress/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace paddle {
+namespace lite_api {
+namespace stress {
+
+namespace {
+// Values below 2^kSubBucketBits are stored exactly, every following
+// power-of-two range is split into kSubBucketHalf linear sub-buckets.
+constexpr int kSubBucketBits = 11;
+constexpr uint64_t kSubBucketCount = 1ULL << kSubBucketBits;
+constexpr uint64_t kSubBucketHalf = kSubBucketCount >> 1;
+// Larger values (~12 days in microseconds) are clamped.
+constexpr int kMaxValueBits = 40;
+constexpr uint64_t kMaxValue = (1ULL << kMaxValueBits) - 1;
+constexpr int kBucketNum =
+    kSubBucketCount + (kMaxValueBits - kSubBucketBits) * kSubBucketHalf;
+
+int FloorLog2(uint64_t value) {
+  int bits = 0;
+  while (value >>= 1) ++bits;
+  return bits;
+}
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() : counts_(kBucketNum, 0) {}
+
+int LatencyHistogram::IndexOf(uint64_t value) {
+  if (value < kSubBucketCount) return static_cast<int>(value);
+  const int shift = FloorLog2(value) - (kSubBucketBits - 1);
+  const uint64_t sub_bucket = value >> shift;
+  return static_cast<int>(kSubBucketCount + (shift - 1) * kSubBucketHalf +
+                          (sub_bucket - kSubBucketHalf));
+}
+
+uint64_t LatencyHistogram::HighestEquivalentValue(int index) {
+  if (index < static_cast<int>(kSubBucketCount)) {
+    return static_cast<uint64_t>(index);
+  }
+  const uint64_t offset = index - kSubBucketCount;
+  const int shift = static_cast<int>(offset / kSubBucketHalf) + 1;
+  const uint64_t sub_bucket = offset % kSubBucketHalf + kSubBucketHalf;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value_us) {
+  value_us = std::min(value_us, kMaxValue);
+  counts_[IndexOf(value_us)]++;
+  min_ = count_ == 0 ? value_us : std::min(min_, value_us);
+  max_ = std::max(max_, value_us);
+  count_++;
+  sum_ += static_cast<double>(value_us);
+  sum_sq_ += static_cast<double>(value_us) * value_us;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.count_ == 0) return;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    counts_[i] += other.counts_[i];
+  }
+  min_ = count_ == 0 ? other.min_ : std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  count_ += other.count_;
+  sum_ += other.sum_;
+  sum_sq_ += other.sum_sq_;
+}
+
+void LatencyHistogram::Reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+  sum_ = 0.0;
+  sum_sq_ = 0.0;
+}
+
+double LatencyHistogram::mean() const {
+  return count_ == 0 ? 0.0 : sum_ / count_;
+}
+
+double LatencyHistogram::stddev() const {
+  if (count_ == 0) return 0.0;
+  const double avg = mean();
+  return std::sqrt(std::max(0.0, sum_sq_ / count_ - avg * avg));
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) return 0;
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t target = static_cast<uint64_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(count_)));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t accumulated = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    accumulated += counts_[i];
+    if (accumulated >= target) {
+      return std::min(HighestEquivalentValue(static_cast<int>(i)), max_);
+    }
+  }
+  return max_;
+}
+
+}  // namespace stress
+}  // namespace lite_api
+}  // namespace paddle
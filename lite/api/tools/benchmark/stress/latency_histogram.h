@@ -0,0 +1,64 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LITE_API_TOOLS_BENCHMARK_STRESS_LATENCY_HISTOGRAM_H_
+#define LITE_API_TOOLS_BENCHMARK_STRESS_LATENCY_HISTOGRAM_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace lite_api {
+namespace stress {
+
+// A log-linear latency histogram in the spirit of HdrHistogram. Values are
+// recorded in microseconds, every power-of-two range is split into 1024
+// linear sub-buckets, so any reported value is within 0.1% of the recorded
+// one while the memory footprint stays constant whatever the run length.
+// Not thread-safe: give every client thread its own histogram and Merge()
+// them once the run is over.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void Record(uint64_t value_us);
+  void Merge(const LatencyHistogram& other);
+  void Reset();
+
+  uint64_t count() const { return count_; }
+  uint64_t min() const { return count_ == 0 ? 0 : min_; }
+  uint64_t max() const { return max_; }
+  double mean() const;
+  double stddev() const;
+  // Returns the smallest recorded value v such that `percentile` percent
+  // of the values are <= v, e.g. ValueAtPercentile(99.9).
+  uint64_t ValueAtPercentile(double percentile) const;
+
+ private:
+  static int IndexOf(uint64_t value);
+  static uint64_t HighestEquivalentValue(int index);
+
+  std::vector<uint64_t> counts_;
+  uint64_t count_{0};
+  uint64_t min_{0};
+  uint64_t max_{0};
+  double sum_{0.0};
+  double sum_sq_{0.0};
+};
+
+}  // namespace stress
+}  // namespace lite_api
+}  // namespace paddle
+
+#endif  // LITE_API_TOOLS_BENCHMARK_STRESS_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,521 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/benchmark/stress/stress_test.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdio>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>  // NOLINT(build/c++11)
+#include <random>
+#include <sstream>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#include "lite/utils/io.h"
+#include "lite/utils/model_util.h"
+#include "lite/utils/string.h"
+
+namespace paddle {
+namespace lite_api {
+namespace stress {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t ElapsedUs(Clock::time_point begin, Clock::time_point end) {
+  if (end <= begin) return 0;
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+      .count();
+}
+
+double ElapsedMs(Clock::time_point begin, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+std::string ShapesToString(const std::vector<std::vector<int64_t>>& shapes) {
+  std::vector<std::string> strs;
+  for (auto& shape : shapes) {
+    strs.push_back(lite::Join(shape, ","));
+  }
+  return lite::Join(strs, ":");
+}
+
+// Process CPU time (user + system) in seconds, -1 if unavailable.
+double ProcessCpuTime() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1.0;
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#else
+  return -1.0;
+#endif
+}
+
+// The current resident set size, unlike rusage::ru_maxrss it goes down as
+// well when memory is released.
+int64_t CurrentRssKB() {
+#ifdef __linux__
+  FILE* fp = fopen("/proc/self/statm", "r");
+  if (fp == nullptr) return -1;
+  long pages = 0;     // NOLINT
+  long resident = 0;  // NOLINT
+  int ret = fscanf(fp, "%ld %ld", &pages, &resident);
+  fclose(fp);
+  if (ret != 2) return -1;
+  return static_cast<int64_t>(resident) * sysconf(_SC_PAGESIZE) / 1024;
+#else
+  return -1;
+#endif
+}
+
+// The predictor and its clones. A predictor serves one request at a time,
+// so clients borrow one for the duration of a request.
+class PredictorPool {
+ public:
+  PredictorPool(std::shared_ptr<PaddlePredictor> predictor, int num) {
+    predictors_.push_back(predictor);
+    for (int i = 1; i < num; i++) {
+      predictors_.push_back(predictor->Clone());
+    }
+    shape_cases_.assign(predictors_.size(), -1);
+    for (int i = num - 1; i >= 0; i--) {
+      free_.push_back(i);
+    }
+  }
+
+  int Acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !free_.empty(); });
+    int idx = free_.back();
+    free_.pop_back();
+    return idx;
+  }
+
+  void Release(int idx) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(idx);
+    }
+    cv_.notify_one();
+  }
+
+  PaddlePredictor* predictor(int idx) { return predictors_[idx].get(); }
+  // The shape case the inputs of a predictor are currently set to, only
+  // accessed by the client holding the predictor.
+  int* shape_case(int idx) { return &shape_cases_[idx]; }
+
+ private:
+  std::vector<std::shared_ptr<PaddlePredictor>> predictors_;
+  std::vector<int> shape_cases_;
+  std::vector<int> free_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+// Arrival times of the requests of the open-loop mode.
+class RequestQueue {
+ public:
+  void Push(Clock::time_point arrival) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      requests_.push_back(arrival);
+    }
+    cv_.notify_one();
+  }
+
+  // Blocks until a request arrives, returns false once the queue is closed.
+  bool Pop(Clock::time_point* arrival) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return closed_ || !requests_.empty(); });
+    if (closed_) return false;
+    *arrival = requests_.front();
+    requests_.pop_front();
+    return true;
+  }
+
+  // Wakes up all the clients, returns the number of requests that were
+  // still waiting and are dropped.
+  uint64_t Close() {
+    uint64_t dropped = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      dropped = requests_.size();
+      requests_.clear();
+    }
+    cv_.notify_all();
+    return dropped;
+  }
+
+ private:
+  std::deque<Clock::time_point> requests_;
+  bool closed_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+class ResourceSampler {
+ public:
+  ResourceSampler(int interval_ms, const std::atomic<uint64_t>* completed)
+      : interval_ms_(std::max(interval_ms, 1)), completed_(completed) {}
+  ~ResourceSampler() { Stop(); }
+
+  void Start() {
+    start_ = Clock::now();
+    base_completed_ = completed_->load();
+    stop_ = false;
+    thread_.reset(new std::thread([this]() {
+      auto last_time = start_;
+      double last_cpu_time = ProcessCpuTime();
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          if (cv_.wait_for(lock,
+                           std::chrono::milliseconds(interval_ms_),
+                           [this] { return stop_; })) {
+            break;
+          }
+        }
+        auto now = Clock::now();
+        double cpu_time = ProcessCpuTime();
+        ResourceSample sample;
+        sample.time_ms = ElapsedMs(start_, now);
+        double wall_s = ElapsedMs(last_time, now) / 1000.0;
+        if (cpu_time >= 0.0 && last_cpu_time >= 0.0 && wall_s > 0.0) {
+          sample.cpu_utilization = (cpu_time - last_cpu_time) / wall_s;
+        }
+        sample.rss_kb = CurrentRssKB();
+        sample.completed = completed_->load() - base_completed_;
+        samples_.push_back(sample);
+        last_time = now;
+        last_cpu_time = cpu_time;
+      }
+    }));
+  }
+
+  void Stop() {
+    if (thread_ == nullptr) return;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_->join();
+    thread_.reset(nullptr);
+  }
+
+  const std::vector<ResourceSample>& samples() const { return samples_; }
+
+ private:
+  int interval_ms_;
+  const std::atomic<uint64_t>* completed_;
+  uint64_t base_completed_{0};
+  Clock::time_point start_;
+  bool stop_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unique_ptr<std::thread> thread_;
+  std::vector<ResourceSample> samples_;
+};
+
+struct ClientStats {
+  LatencyHistogram latency;
+  LatencyHistogram service_time;
+  std::vector<uint64_t> shape_case_requests;
+};
+
+class StressDriver {
+ public:
+  StressDriver(std::shared_ptr<PaddlePredictor> predictor,
+               const StressOptions& options)
+      : options_(options), pool_(predictor, options.predictors) {
+    for (auto& shape_case : options_.shape_cases) {
+      shape_weights_.push_back(shape_case.weight);
+    }
+  }
+
+  // Runs the load for `duration_s`, nothing is recorded if `stats` is null.
+  // Returns the elapsed time in seconds.
+  double RunPhase(double duration_s,
+                  std::vector<ClientStats>* stats,
+                  uint64_t* dropped) {
+    const int clients = options_.clients;
+    const bool open_loop = options_.mode == "open";
+    if (stats != nullptr) {
+      stats->resize(clients);
+      for (auto& client_stats : *stats) {
+        client_stats.shape_case_requests.assign(options_.shape_cases.size(),
+                                                0);
+      }
+    }
+    RequestQueue queue;
+    const auto start = Clock::now();
+    const auto deadline =
+        start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(duration_s));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; i++) {
+      ClientStats* client_stats = stats == nullptr ? nullptr : &(*stats)[i];
+      threads.emplace_back([=, &queue]() {
+        std::mt19937 rng(seed_ + i);
+        std::discrete_distribution<int> shape_dist(shape_weights_.begin(),
+                                                   shape_weights_.end());
+        Clock::time_point arrival;
+        if (open_loop) {
+          while (queue.Pop(&arrival)) {
+            Serve(arrival, shape_dist(rng), client_stats);
+          }
+        } else {
+          while ((arrival = Clock::now()) < deadline) {
+            Serve(arrival, shape_dist(rng), client_stats);
+          }
+        }
+      });
+    }
+    if (open_loop) {
+      // Poisson arrivals: exponentially distributed inter-arrival times.
+      std::mt19937 rng(seed_);
+      std::exponential_distribution<double> interval(options_.qps);
+      auto next = start;
+      while (true) {
+        next += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(interval(rng)));
+        if (next >= deadline) break;
+        std::this_thread::sleep_until(next);
+        queue.Push(next);
+      }
+      std::this_thread::sleep_until(deadline);
+      uint64_t num = queue.Close();
+      if (dropped != nullptr) *dropped += num;
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    seed_ += clients + 1;
+    return ElapsedMs(start, Clock::now()) / 1000.0;
+  }
+
+  const std::atomic<uint64_t>* completed() const { return &completed_; }
+
+ private:
+  void Serve(Clock::time_point arrival, int shape_idx, ClientStats* stats) {
+    int idx = pool_.Acquire();
+    auto predictor = pool_.predictor(idx);
+    // Inputs are only refilled when the shape changes, so the service time
+    // is dominated by the inference itself.
+    if (*pool_.shape_case(idx) != shape_idx) {
+      auto& shapes = options_.shape_cases[shape_idx].shapes;
+      for (size_t i = 0; i < shapes.size(); i++) {
+        auto input_tensor = predictor->GetInput(i);
+        input_tensor->Resize(shapes[i]);
+        auto input_data = input_tensor->mutable_data<float>();
+        auto input_num = lite::ShapeProduction(shapes[i]);
+        std::fill(input_data, input_data + input_num, 1.f);
+      }
+      *pool_.shape_case(idx) = shape_idx;
+    }
+    auto run_start = Clock::now();
+    predictor->Run();
+    auto run_end = Clock::now();
+    pool_.Release(idx);
+    completed_++;
+    if (stats != nullptr) {
+      stats->latency.Record(ElapsedUs(arrival, run_end));
+      stats->service_time.Record(ElapsedUs(run_start, run_end));
+      stats->shape_case_requests[shape_idx]++;
+    }
+  }
+
+  StressOptions options_;
+  PredictorPool pool_;
+  std::vector<double> shape_weights_;
+  std::atomic<uint64_t> completed_{0};
+  uint32_t seed_{2022};
+};
+
+void PercentilesToStream(const LatencyHistogram& histogram,
+                         bool json,
+                         std::ostream* os) {
+  const std::vector<std::pair<std::string, double>> percentiles = {
+      {"p50", 50.0}, {"p90", 90.0}, {"p99", 99.0}, {"p99.9", 99.9}};
+  auto ms = [](double us) { return us / 1000.0; };
+  std::vector<std::pair<std::string, double>> items;
+  items.emplace_back("min", ms(histogram.min()));
+  items.emplace_back("mean", ms(histogram.mean()));
+  items.emplace_back("stddev", ms(histogram.stddev()));
+  for (auto& percentile : percentiles) {
+    items.emplace_back(percentile.first,
+                       ms(histogram.ValueAtPercentile(percentile.second)));
+  }
+  items.emplace_back("max", ms(histogram.max()));
+  for (size_t i = 0; i < items.size(); i++) {
+    if (json) {
+      *os << (i == 0 ? "" : ", ") << "\"" << items[i].first
+          << "\": " << items[i].second;
+    } else {
+      *os << std::setw(6) << items[i].first << " = " << std::setw(12)
+          << items[i].second << std::endl;
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<ShapeCase> LoadShapeDistribution(const std::string& path) {
+  std::vector<ShapeCase> shape_cases;
+  for (auto& line : lite::ReadLines(path)) {
+    std::istringstream ss(line);
+    std::string first;
+    if (!(ss >> first) || first[0] == '#') continue;
+    ss.clear();
+    ss.str(line);
+    ShapeCase shape_case;
+    std::string shapes;
+    if (!(ss >> shape_case.weight >> shapes) || shape_case.weight < 0.0) {
+      std::cerr << "Invalid line in shape distribution file " << path << ": "
+                << line << std::endl;
+      std::abort();
+    }
+    shape_case.shapes = lite::GetShapes(shapes);
+    shape_cases.push_back(shape_case);
+  }
+  return shape_cases;
+}
+
+StressReport RunStressTest(std::shared_ptr<PaddlePredictor> predictor,
+                           const StressOptions& options) {
+  StressReport report;
+  report.options = options;
+  StressDriver driver(predictor, options);
+  if (options.warmup_s > 0.0) {
+    driver.RunPhase(options.warmup_s, nullptr, nullptr);
+  }
+
+  std::vector<ClientStats> stats;
+  ResourceSampler sampler(options.sample_interval_ms, driver.completed());
+  sampler.Start();
+  report.elapsed_s =
+      driver.RunPhase(options.duration_s, &stats, &report.dropped);
+  sampler.Stop();
+
+  report.shape_case_requests.assign(options.shape_cases.size(), 0);
+  for (auto& client_stats : stats) {
+    report.latency.Merge(client_stats.latency);
+    report.service_time.Merge(client_stats.service_time);
+    for (size_t i = 0; i < client_stats.shape_case_requests.size(); i++) {
+      report.shape_case_requests[i] += client_stats.shape_case_requests[i];
+    }
+  }
+  report.samples = sampler.samples();
+  return report;
+}
+
+std::string StressReport::ToString() const {
+  std::stringstream ss;
+  ss << std::fixed << std::left << std::setprecision(3);
+  ss << "\n======= Stress Info =======\n";
+  ss << "mode: " << options.mode << std::endl;
+  ss << "predictors: " << options.predictors << std::endl;
+  ss << "clients: " << options.clients << std::endl;
+  if (options.mode == "open") {
+    ss << "target_qps: " << options.qps << std::endl;
+  }
+  ss << "warmup(sec): " << options.warmup_s << std::endl;
+  ss << "duration(sec): " << elapsed_s << std::endl;
+  for (size_t i = 0; i < options.shape_cases.size(); i++) {
+    ss << "input_shape[" << i << "]: "
+       << ShapesToString(options.shape_cases[i].shapes)
+       << " weight: " << options.shape_cases[i].weight
+       << " requests: " << shape_case_requests[i] << std::endl;
+  }
+  ss << "\n======= Stress Perf Info =======\n";
+  ss << "requests   = " << latency.count() << std::endl;
+  ss << "dropped    = " << dropped << std::endl;
+  ss << "throughput = " << throughput() << " qps" << std::endl;
+  ss << "Latency(unit: ms):\n";
+  PercentilesToStream(latency, false, &ss);
+  ss << "Service time(unit: ms):\n";
+  PercentilesToStream(service_time, false, &ss);
+  double cpu_sum = 0.0;
+  int cpu_num = 0;
+  int64_t peak_rss_kb = -1;
+  for (auto& sample : samples) {
+    if (sample.cpu_utilization >= 0.0) {
+      cpu_sum += sample.cpu_utilization;
+      cpu_num++;
+    }
+    peak_rss_kb = std::max(peak_rss_kb, sample.rss_kb);
+  }
+  if (cpu_num > 0) {
+    ss << "avg cpu utilization(cores) = " << cpu_sum / cpu_num << std::endl;
+  }
+  if (peak_rss_kb >= 0) {
+    ss << "peak rss(MB) = " << peak_rss_kb / 1024.0 << std::endl;
+  }
+  return ss.str();
+}
+
+std::string StressReport::ToJson() const {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "{\n";
+  ss << "  \"mode\": \"" << options.mode << "\",\n";
+  ss << "  \"predictors\": " << options.predictors << ",\n";
+  ss << "  \"clients\": " << options.clients << ",\n";
+  ss << "  \"target_qps\": " << options.qps << ",\n";
+  ss << "  \"warmup_s\": " << options.warmup_s << ",\n";
+  ss << "  \"duration_s\": " << elapsed_s << ",\n";
+  ss << "  \"requests\": " << latency.count() << ",\n";
+  ss << "  \"dropped\": " << dropped << ",\n";
+  ss << "  \"throughput_qps\": " << throughput() << ",\n";
+  ss << "  \"latency_ms\": {";
+  PercentilesToStream(latency, true, &ss);
+  ss << "},\n";
+  ss << "  \"service_time_ms\": {";
+  PercentilesToStream(service_time, true, &ss);
+  ss << "},\n";
+  ss << "  \"input_shapes\": [";
+  for (size_t i = 0; i < options.shape_cases.size(); i++) {
+    ss << (i == 0 ? "\n" : ",\n") << "    {\"shape\": \""
+       << ShapesToString(options.shape_cases[i].shapes)
+       << "\", \"weight\": " << options.shape_cases[i].weight
+       << ", \"requests\": " << shape_case_requests[i] << "}";
+  }
+  ss << "\n  ],\n";
+  ss << "  \"samples\": [";
+  for (size_t i = 0; i < samples.size(); i++) {
+    ss << (i == 0 ? "\n" : ",\n") << "    {\"time_ms\": " << samples[i].time_ms
+       << ", \"cpu_utilization\": " << samples[i].cpu_utilization
+       << ", \"rss_kb\": " << samples[i].rss_kb
+       << ", \"completed\": " << samples[i].completed << "}";
+  }
+  ss << "\n  ]\n";
+  ss << "}\n";
+  return ss.str();
+}
+
+}  // namespace stress
+}  // namespace lite_api
+}  // namespace paddle
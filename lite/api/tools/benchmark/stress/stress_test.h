@@ -0,0 +1,94 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LITE_API_TOOLS_BENCHMARK_STRESS_STRESS_TEST_H_
+#define LITE_API_TOOLS_BENCHMARK_STRESS_STRESS_TEST_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/api/tools/benchmark/stress/latency_histogram.h"
+
+namespace paddle {
+namespace lite_api {
+namespace stress {
+
+// One entry of the input shape distribution: the shapes of all the inputs
+// of a request, picked with probability weight / sum(weights).
+struct ShapeCase {
+  double weight{1.0};
+  std::vector<std::vector<int64_t>> shapes;
+};
+
+// Parses a shape distribution file. Every non-empty line that does not
+// start with '#' is "<weight> <shapes>", where <shapes> uses the syntax of
+// --input_shape, e.g. "0.8 1,3,224,224" and "0.2 4,3,224,224".
+std::vector<ShapeCase> LoadShapeDistribution(const std::string& path);
+
+struct StressOptions {
+  // "closed": every client issues its next request as soon as the previous
+  // one returns, which measures the max throughput.
+  // "open": requests arrive at `qps` following a Poisson process whatever
+  // the progress of the clients, so queueing delays show up in the latency.
+  std::string mode{"closed"};
+  int predictors{1};
+  int clients{1};
+  double qps{0.0};
+  double duration_s{10.0};
+  double warmup_s{0.0};
+  int sample_interval_ms{100};
+  std::vector<ShapeCase> shape_cases;
+};
+
+// CPU utilization and resident memory of the process at one point in time.
+struct ResourceSample {
+  double time_ms{0.0};
+  // In cores, i.e. 2.0 means two cores were busy during the last interval.
+  double cpu_utilization{-1.0};
+  int64_t rss_kb{-1};
+  uint64_t completed{0};
+};
+
+struct StressReport {
+  StressOptions options;
+  double elapsed_s{0.0};
+  uint64_t dropped{0};
+  // From the arrival of a request to its completion, including the time it
+  // waited for a client thread or a free predictor.
+  LatencyHistogram latency;
+  // Time spent in PaddlePredictor::Run() only.
+  LatencyHistogram service_time;
+  std::vector<uint64_t> shape_case_requests;
+  std::vector<ResourceSample> samples;
+
+  double throughput() const {
+    return elapsed_s > 0.0 ? latency.count() / elapsed_s : 0.0;
+  }
+  std::string ToString() const;
+  // A machine-readable report for regression comparison between builds.
+  std::string ToJson() const;
+};
+
+// Drives `options.predictors` clones of `predictor` from `options.clients`
+// threads, first for `warmup_s` without recording, then for `duration_s`.
+StressReport RunStressTest(std::shared_ptr<PaddlePredictor> predictor,
+                           const StressOptions& options);
+
+}  // namespace stress
+}  // namespace lite_api
+}  // namespace paddle
+
+#endif  // LITE_API_TOOLS_BENCHMARK_STRESS_STRESS_TEST_H_
@@ -33,6 +33,7 @@ DEFINE_int32(repeats, 1, repeats_msg);
 DEFINE_double(run_delay, -1.0, run_delay_msg);
 DEFINE_int32(power_mode, 0, power_mode_msg);
 DEFINE_int32(threads, 1, threads_msg);
+DEFINE_int32(thread_schedule, 0, thread_schedule_msg);
 DEFINE_string(result_path, "", result_path_msg);
 
 // Backend options
@@ -60,6 +61,17 @@ DEFINE_int32(memory_check_interval_ms, 5, memory_check_interval_ms_msg);
 // Configuration options
 DEFINE_string(config_path, "", config_path_msg);
 
+// Stress options
+DEFINE_string(stress_mode, "", stress_mode_msg);
+DEFINE_int32(stress_predictors, 1, stress_predictors_msg);
+DEFINE_int32(stress_clients, 1, stress_clients_msg);
+DEFINE_double(stress_qps, 0.0, stress_qps_msg);
+DEFINE_double(stress_duration, 10.0, stress_duration_msg);
+DEFINE_double(stress_warmup, 0.0, stress_warmup_msg);
+DEFINE_string(stress_shape_file, "", stress_shape_file_msg);
+DEFINE_int32(stress_sample_interval_ms, 100, stress_sample_interval_ms_msg);
+DEFINE_string(stress_report_path, "", stress_report_path_msg);
+
 // Others
 
 }  // namespace lite_api
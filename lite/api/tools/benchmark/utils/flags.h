@@ -63,6 +63,11 @@ static const char power_mode_msg[] =
     "2 for all cores, "
     "3 for no bind";
 static const char threads_msg[] = "threads num";
+static const char thread_schedule_msg[] =
+    "threads per op: "
+    "0 for all of the threads, "
+    "1 for a cost model, "
+    "2 for the fastest measured at the first runs";
 static const char result_path_msg[] = "Save benchmark info to the file.";
 
 // Backend options
@@ -110,6 +115,32 @@ static const char memory_check_interval_ms_msg[] =
 // Configuration options
 static const char config_path_msg[] = "Configuration options.";
 
+// Stress options
+static const char stress_mode_msg[] =
+    "Run a latency stress test instead of the fixed repeats. "
+    "Should be one of: closed, open. "
+    "closed: every client sends its next request as soon as the previous "
+    "one returns, which measures the max throughput. "
+    "open: requests arrive at --stress_qps following a Poisson process.";
+static const char stress_predictors_msg[] =
+    "The num of predictor clones serving the requests.";
+static const char stress_clients_msg[] =
+    "The num of client threads sending the requests.";
+static const char stress_qps_msg[] =
+    "The target queries per second of the open-loop mode.";
+static const char stress_duration_msg[] =
+    "The duration in seconds of the measured stress test.";
+static const char stress_warmup_msg[] =
+    "The duration in seconds of the load run before the measurement.";
+static const char stress_shape_file_msg[] =
+    "A file of the input shape distribution, one \"<weight> <input_shape>\" "
+    "per line, such as \"0.8 1,3,224,224\". Use --input_shape if not set.";
+static const char stress_sample_interval_ms_msg[] =
+    "The interval in millisecond between two cpu utilization and memory "
+    "footprint samples of the stress test.";
+static const char stress_report_path_msg[] =
+    "Save the stress test report as json to the file.";
+
 // Others
 
 // Model options
@@ -128,6 +159,7 @@ DECLARE_int32(repeats);
 DECLARE_double(run_delay);
 DECLARE_int32(power_mode);
 DECLARE_int32(threads);
+DECLARE_int32(thread_schedule);
 DECLARE_string(result_path);
 
 // Backend options
@@ -149,6 +181,17 @@ DECLARE_int32(memory_check_interval_ms);
 // Configuration options
 DECLARE_string(config_path);
 
+// Stress options
+DECLARE_string(stress_mode);
+DECLARE_int32(stress_predictors);
+DECLARE_int32(stress_clients);
+DECLARE_double(stress_qps);
+DECLARE_double(stress_duration);
+DECLARE_double(stress_warmup);
+DECLARE_string(stress_shape_file);
+DECLARE_int32(stress_sample_interval_ms);
+DECLARE_string(stress_report_path);
+
 // Others
 
 }  // namespace lite_api
@@ -0,0 +1,215 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/calibration/calibration_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace calibration {
+
+// Quantized levels of |x|, int8 is symmetric around 0
+static constexpr int kLevels = 128;
+static constexpr float kRange = 127.f;
+
+CalibrationAlgo GetCalibrationAlgo(const std::string& name) {
+  if (name == "KL") {
+    return CalibrationAlgo::kKL;
+  } else if (name == "percentile") {
+    return CalibrationAlgo::kPercentile;
+  } else if (name == "min_max") {
+    return CalibrationAlgo::kMinMax;
+  }
+  LOG(FATAL) << "Unsupported calibration algo: " << name
+             << ", expected KL, percentile or min_max.";
+  return CalibrationAlgo::kKL;
+}
+
+void ActivationStats::UpdateRange(const float* data, int64_t size) {
+  CHECK(histogram_.empty()) << "The range is fixed by the histogram pass.";
+  for (int64_t i = 0; i < size; i++) {
+    abs_max_ = std::max(abs_max_, std::fabs(data[i]));
+  }
+}
+
+void ActivationStats::UpdateHistogram(const float* data, int64_t size) {
+  if (histogram_.empty()) {
+    histogram_.resize(kBins, 0.0);
+  }
+  if (empty()) return;
+  const float inv_width = kBins / abs_max_;
+  for (int64_t i = 0; i < size; i++) {
+    // Values beyond the range of pass 1 land in the last bin
+    int bin = static_cast<int>(std::fabs(data[i]) * inv_width);
+    histogram_[std::min(bin, kBins - 1)] += 1.0;
+  }
+}
+
+float ActivationStats::Threshold(CalibrationAlgo algo,
+                                 float percentile) const {
+  if (empty() || histogram_.empty()) return abs_max_;
+  switch (algo) {
+    case CalibrationAlgo::kKL:
+      return KLThreshold();
+    case CalibrationAlgo::kPercentile:
+      return PercentileThreshold(percentile);
+    default:
+      return abs_max_;
+  }
+}
+
+// The threshold that keeps `percentile` of the samples unclipped.
+float ActivationStats::PercentileThreshold(float percentile) const {
+  double total = 0.0;
+  for (auto count : histogram_) total += count;
+  const double target = total * percentile;
+  double sum = 0.0;
+  for (int i = 0; i < kBins; i++) {
+    sum += histogram_[i];
+    if (sum >= target) {
+      return (i + 1) * bin_width();
+    }
+  }
+  return abs_max_;
+}
+
+// For every candidate threshold of i bins, the reference distribution P is
+// the first i bins with the clipped tail folded into bin i - 1, and Q is P
+// merged into kLevels levels and expanded back over the non-empty bins of
+// each level. The threshold of the smallest KL(P || Q) wins.
+float ActivationStats::KLThreshold() const {
+  int best_bins = kBins;
+  double best_kl = std::numeric_limits<double>::max();
+  double tail = 0.0;
+  for (int i = kLevels; i < kBins; i++) tail += histogram_[i];
+  std::vector<double> p(kBins);
+  std::vector<double> q(kBins);
+  for (int bins = kLevels; bins <= kBins; bins++) {
+    std::copy(histogram_.begin(), histogram_.begin() + bins, p.begin());
+    p[bins - 1] += tail;
+    if (bins < kBins) tail -= histogram_[bins];
+    double p_sum = 0.0;
+    for (int j = 0; j < bins; j++) p_sum += p[j];
+    if (p_sum <= 0.0) continue;
+
+    const double merge = static_cast<double>(bins) / kLevels;
+    for (int level = 0; level < kLevels; level++) {
+      const int begin = static_cast<int>(level * merge);
+      const int end = level == kLevels - 1
+                          ? bins
+                          : static_cast<int>((level + 1) * merge);
+      double sum = 0.0;
+      int nonzero = 0;
+      for (int j = begin; j < end; j++) {
+        sum += histogram_[j];
+        nonzero += histogram_[j] > 0.0;
+      }
+      for (int j = begin; j < end; j++) {
+        q[j] = histogram_[j] > 0.0 ? sum / nonzero : 0.0;
+      }
+    }
+    double q_sum = 0.0;
+    for (int j = 0; j < bins; j++) q_sum += q[j];
+    if (q_sum <= 0.0) continue;
+
+    double kl = 0.0;
+    for (int j = 0; j < bins; j++) {
+      if (p[j] <= 0.0) continue;
+      const double pj = p[j] / p_sum;
+      // A bin that only P covers (the folded tail) is charged a small
+      // epsilon instead of an infinite divergence.
+      const double qj = q[j] > 0.0 ? q[j] / q_sum : 1e-10;
+      kl += pj * std::log(pj / qj);
+    }
+    if (kl < best_kl) {
+      best_kl = kl;
+      best_bins = bins;
+    }
+  }
+  return (best_bins + 0.5f) * bin_width();
+}
+
+// The histogram is treated as point masses at the bin centers: the values
+// within the threshold carry the uniform rounding noise step^2 / 12, the
+// clipped ones their distance to the threshold.
+float ActivationStats::SQNR(float threshold) const {
+  if (empty() || histogram_.empty() || threshold <= 0.f) {
+    return std::numeric_limits<float>::infinity();
+  }
+  const double step = threshold / kRange;
+  double signal = 0.0;
+  double noise = 0.0;
+  for (int i = 0; i < kBins; i++) {
+    if (histogram_[i] <= 0.0) continue;
+    const double center = (i + 0.5) * bin_width();
+    signal += histogram_[i] * center * center;
+    if (center <= threshold) {
+      noise += histogram_[i] * step * step / 12.0;
+    } else {
+      noise += histogram_[i] * (center - threshold) * (center - threshold);
+    }
+  }
+  if (noise <= 0.0) return std::numeric_limits<float>::infinity();
+  return static_cast<float>(10.0 * std::log10(signal / noise));
+}
+
+std::vector<float> QuantizeWeight(const float* weight,
+                                  int64_t size,
+                                  int64_t channels,
+                                  bool column_major,
+                                  int8_t* out,
+                                  float* sqnr) {
+  CHECK_GT(channels, 0);
+  CHECK_EQ(size % channels, 0) << "The weight size " << size
+                               << " is not a multiple of the channels "
+                               << channels;
+  const int64_t inner = size / channels;
+  // Channel c of element i
+  auto channel = [&](int64_t i) {
+    return column_major ? i % channels : i / inner;
+  };
+  std::vector<float> scales(channels, 0.f);
+  for (int64_t i = 0; i < size; i++) {
+    float& scale = scales[channel(i)];
+    scale = std::max(scale, std::fabs(weight[i]));
+  }
+  for (auto& scale : scales) {
+    // An all-zero channel quantizes to zeros with any scale
+    scale = scale > 0.f ? scale / kRange : 1.f;
+  }
+  double signal = 0.0;
+  double noise = 0.0;
+  for (int64_t i = 0; i < size; i++) {
+    const float scale = scales[channel(i)];
+    float q = std::round(weight[i] / scale);
+    q = std::min(std::max(q, -kRange), kRange);
+    out[i] = static_cast<int8_t>(q);
+    const double error = weight[i] - q * scale;
+    signal += static_cast<double>(weight[i]) * weight[i];
+    noise += error * error;
+  }
+  if (sqnr != nullptr) {
+    *sqnr = noise > 0.0
+                ? static_cast<float>(10.0 * std::log10(signal / noise))
+                : std::numeric_limits<float>::infinity();
+  }
+  return scales;
+}
+
+}  // namespace calibration
+}  // namespace lite
+}  // namespace paddle
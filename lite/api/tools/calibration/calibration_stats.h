@@ -0,0 +1,82 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace calibration {
+
+// How the clipping threshold of an activation is chosen.
+enum class CalibrationAlgo {
+  // Minimizes the KL divergence between the fp32 and the int8 distribution
+  kKL,
+  // The given percentile of |x|
+  kPercentile,
+  // max(|x|), no clipping
+  kMinMax,
+};
+
+// Returns the CalibrationAlgo of "KL", "percentile" or "min_max".
+CalibrationAlgo GetCalibrationAlgo(const std::string& name);
+
+// Distribution of |x| of one activation tensor over a calibration set.
+// The samples are observed twice: the first pass finds max(|x|), the second
+// one fills a histogram of kBins bins over [0, max(|x|)].
+class ActivationStats {
+ public:
+  static constexpr int kBins = 2048;
+
+  // Pass 1
+  void UpdateRange(const float* data, int64_t size);
+  // Pass 2
+  void UpdateHistogram(const float* data, int64_t size);
+
+  float abs_max() const { return abs_max_; }
+  bool empty() const { return abs_max_ <= 0.f; }
+
+  // The clipping threshold, the int8 scale is threshold / 127.
+  float Threshold(CalibrationAlgo algo, float percentile = 0.9999f) const;
+
+  // Signal to quantization noise ratio (dB) of the activation quantized with
+  // `threshold`, including the clipping error.
+  float SQNR(float threshold) const;
+
+ private:
+  float bin_width() const { return abs_max_ / kBins; }
+  float KLThreshold() const;
+  float PercentileThreshold(float percentile) const;
+
+  float abs_max_{0.f};
+  std::vector<double> histogram_;
+};
+
+// Quantizes `size` weights into `channels` contiguous groups (the leading
+// dim, e.g. Cout of a conv filter) with one abs-max scale per group. With
+// `column_major` the channel is the trailing dim instead (the output columns
+// of a [K, N] mul weight). Returns the scales and the SQNR (dB) in `sqnr`.
+std::vector<float> QuantizeWeight(const float* weight,
+                                  int64_t size,
+                                  int64_t channels,
+                                  bool column_major,
+                                  int8_t* out,
+                                  float* sqnr);
+
+}  // namespace calibration
+}  // namespace lite
+}  // namespace paddle
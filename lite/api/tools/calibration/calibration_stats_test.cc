@@ -0,0 +1,112 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/calibration/calibration_stats.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace calibration {
+
+// Gaussian activations with a few large outliers
+static std::vector<float> GaussianWithOutliers() {
+  std::mt19937 rng(0);
+  std::normal_distribution<float> normal(0.f, 1.f);
+  std::vector<float> data(100000);
+  for (auto& x : data) x = normal(rng);
+  data[0] = 50.f;
+  data[1] = -40.f;
+  return data;
+}
+
+static ActivationStats Collect(const std::vector<float>& data) {
+  ActivationStats stats;
+  stats.UpdateRange(data.data(), data.size());
+  stats.UpdateHistogram(data.data(), data.size());
+  return stats;
+}
+
+TEST(calibration_stats, min_max) {
+  auto data = GaussianWithOutliers();
+  auto stats = Collect(data);
+  EXPECT_FLOAT_EQ(stats.abs_max(), 50.f);
+  EXPECT_FLOAT_EQ(stats.Threshold(CalibrationAlgo::kMinMax), 50.f);
+}
+
+TEST(calibration_stats, clipping) {
+  auto data = GaussianWithOutliers();
+  auto stats = Collect(data);
+  const float kl = stats.Threshold(CalibrationAlgo::kKL);
+  const float percentile = stats.Threshold(CalibrationAlgo::kPercentile);
+  // Both clip the outliers but keep the bulk of N(0, 1)
+  EXPECT_GT(kl, 2.f);
+  EXPECT_LT(kl, 10.f);
+  EXPECT_GT(percentile, 3.f);
+  EXPECT_LT(percentile, 10.f);
+}
+
+TEST(calibration_stats, sqnr) {
+  // A long tailed Laplace distribution, where clipping the tail costs less
+  // than the coarser step of the full range
+  std::mt19937 rng(0);
+  std::exponential_distribution<float> exponential(1.f);
+  std::vector<float> data(100000);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = i % 2 ? exponential(rng) : -exponential(rng);
+  }
+  auto stats = Collect(data);
+  const float min_max = stats.SQNR(stats.Threshold(CalibrationAlgo::kMinMax));
+  EXPECT_GT(stats.SQNR(stats.Threshold(CalibrationAlgo::kKL)), min_max);
+  EXPECT_GT(stats.SQNR(stats.Threshold(CalibrationAlgo::kPercentile)),
+            min_max);
+}
+
+TEST(calibration_stats, empty) {
+  std::vector<float> zeros(16, 0.f);
+  auto stats = Collect(zeros);
+  EXPECT_TRUE(stats.empty());
+  EXPECT_FLOAT_EQ(stats.Threshold(CalibrationAlgo::kKL), 0.f);
+}
+
+TEST(calibration_stats, quantize_weight) {
+  // [K = 3, N = 2]
+  std::vector<float> weight{1.f, -0.1f, 0.5f, 0.2f, -0.25f, 0.05f};
+  std::vector<int8_t> out(weight.size());
+  float sqnr = 0.f;
+  auto scales = QuantizeWeight(
+      weight.data(), weight.size(), 2, true, out.data(), &sqnr);
+  ASSERT_EQ(scales.size(), 2u);
+  EXPECT_FLOAT_EQ(scales[0], 1.f / 127);
+  EXPECT_FLOAT_EQ(scales[1], 0.2f / 127);
+  std::vector<int8_t> expected{127, -64, 64, 127, -32, 32};
+  EXPECT_EQ(out, expected);
+  EXPECT_GT(sqnr, 35.f);
+
+  // [Cout = 2, 3]
+  scales = QuantizeWeight(
+      weight.data(), weight.size(), 2, false, out.data(), nullptr);
+  ASSERT_EQ(scales.size(), 2u);
+  EXPECT_FLOAT_EQ(scales[0], 1.f / 127);
+  EXPECT_FLOAT_EQ(scales[1], 0.25f / 127);
+  for (size_t i = 0; i < weight.size(); i++) {
+    EXPECT_NEAR(out[i] * scales[i / 3], weight[i], scales[i / 3] / 2);
+  }
+}
+
+}  // namespace calibration
+}  // namespace lite
+}  // namespace paddle
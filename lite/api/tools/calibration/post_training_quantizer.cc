@@ -0,0 +1,371 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/calibration/post_training_quantizer.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include "lite/api/cxx_api.h"
+#include "lite/core/op_lite.h"
+#include "lite/core/op_registry.h"
+#include "lite/model_parser/model_parser.h"
+#include "lite/utils/io.h"
+#include "lite/utils/string.h"
+
+namespace paddle {
+namespace lite {
+namespace calibration {
+
+// Layers below this SQNR (dB) are suggested to stay in fp32
+static constexpr float kSensitiveSQNR = 20.f;
+
+// The activation and weight arguments of the ops that can be quantized.
+static bool GetQuantArgs(const std::string& op_type,
+                         std::string* act_arg,
+                         std::string* weight_arg) {
+  if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+    *act_arg = "Input";
+    *weight_arg = "Filter";
+    return true;
+  }
+  if (op_type == "mul" || op_type == "matmul" || op_type == "matmul_v2") {
+    *act_arg = "X";
+    *weight_arg = "Y";
+    return true;
+  }
+  return false;
+}
+
+// Whether the weight of `op` is [N, K] instead of [K, N].
+static bool IsWeightTransposed(const cpp::OpDesc& op) {
+  if (op.Type() == "matmul") {
+    return op.GetAttr<bool>("transpose_Y");
+  }
+  if (op.Type() == "matmul_v2") {
+    return op.GetAttr<bool>("trans_y");
+  }
+  return false;
+}
+
+static bool IsActTransposed(const cpp::OpDesc& op) {
+  if (op.Type() == "matmul") {
+    return op.GetAttr<bool>("transpose_X");
+  }
+  if (op.Type() == "matmul_v2") {
+    return op.GetAttr<bool>("trans_x");
+  }
+  return false;
+}
+
+// Reads one sample into the inputs of `predictor`.
+static void FeedSample(const std::string& path, Predictor* predictor) {
+  auto lines = ReadLines(path);
+  auto input_names = predictor->GetInputNames();
+  CHECK_GE(lines.size(), 2 * input_names.size())
+      << "The sample " << path << " should hold a line of dims and a line of "
+      << "values for each of the " << input_names.size() << " inputs.";
+  for (size_t i = 0; i < input_names.size(); i++) {
+    auto dims = Split<int64_t>(lines[2 * i], ",");
+    auto* input = predictor->GetInput(i);
+    input->Resize(dims);
+    auto* data = input->mutable_data<float>();
+    std::istringstream values(lines[2 * i + 1]);
+    int64_t count = 0;
+    while (count < input->numel() && values >> data[count]) {
+      count++;
+    }
+    CHECK_EQ(count, input->numel()) << "The input " << input_names[i]
+                                    << " of the sample " << path << " has "
+                                    << count << " values, expected "
+                                    << input->numel();
+  }
+}
+
+PostTrainingQuantizer::PostTrainingQuantizer(
+    const CalibrationConfig& config, const std::vector<Place>& valid_places)
+    : config_(config), valid_places_(valid_places) {
+  // Fails early on a bad algo
+  GetCalibrationAlgo(config_.algo);
+}
+
+void PostTrainingQuantizer::Run(const lite_api::CxxConfig& model_config,
+                                Scope* scope,
+                                cpp::ProgramDesc* program) {
+  const bool combined =
+      !model_config.model_file().empty() && !model_config.param_file().empty();
+  LoadModelPb(model_config.model_dir(),
+              model_config.model_file(),
+              model_config.param_file(),
+              scope,
+              program,
+              combined);
+  FindLayers(*program, scope);
+  Calibrate(model_config);
+  Quantize(program, scope);
+}
+
+void PostTrainingQuantizer::FindLayers(const cpp::ProgramDesc& program,
+                                       Scope* scope) {
+  auto* block = program.GetBlock<cpp::BlockDesc>(0);
+  std::set<std::string> persistables;
+  for (size_t i = 0; i < block->VarsSize(); i++) {
+    auto* var = block->GetVar<cpp::VarDesc>(i);
+    if (var->Persistable()) persistables.insert(var->Name());
+  }
+  // The ops reading each var
+  std::map<std::string, std::vector<const cpp::OpDesc*>> consumers;
+  for (size_t i = 0; i < block->OpsSize(); i++) {
+    auto* op = block->GetOp<cpp::OpDesc>(i);
+    for (auto& arg : op->InputArgumentNames()) {
+      for (auto& name : op->Input(arg)) {
+        consumers[name].push_back(op);
+      }
+    }
+  }
+  auto has_int8_kernel = [&](const std::string& op_type) {
+    for (auto& place : valid_places_) {
+      auto kernels = KernelRegistry::Global().Create(
+          op_type, place.target, PRECISION(kInt8), DATALAYOUT(kNCHW));
+      if (!kernels.empty()) return true;
+    }
+    return false;
+  };
+  auto skipped = [&](const std::string& name) {
+    return std::find(config_.skip.begin(), config_.skip.end(), name) !=
+           config_.skip.end();
+  };
+
+  std::set<const cpp::OpDesc*> quantizable;
+  for (size_t i = 0; i < block->OpsSize(); i++) {
+    auto* op = block->GetOp<cpp::OpDesc>(i);
+    std::string act_arg, weight_arg;
+    if (!GetQuantArgs(op->Type(), &act_arg, &weight_arg)) continue;
+    if (op->Input(act_arg).size() != 1 || op->Input(weight_arg).size() != 1) {
+      continue;
+    }
+    auto act_name = op->Input(act_arg).front();
+    auto weight_name = op->Input(weight_arg).front();
+    if (skipped(op->Type()) || skipped(weight_name)) continue;
+    if (persistables.count(act_name) || !persistables.count(weight_name)) {
+      continue;
+    }
+    auto* weight_var = scope->FindVar(weight_name);
+    if (weight_var == nullptr) continue;
+    auto& weight = weight_var->Get<Tensor>();
+    if (weight.precision() != PRECISION(kFloat)) continue;
+    bool supported = false;
+    if (op->Type() == "mul") {
+      // x86 and arm run an int8 mul as fc, so it must match lite_fc_fuse_pass
+      const auto& out_consumers = consumers[op->Output("Out").front()];
+      const bool has_bias =
+          out_consumers.size() == 1 &&
+          out_consumers.front()->Type() == "elementwise_add" &&
+          persistables.count(out_consumers.front()->Input("Y").front());
+      supported = weight.dims().size() == 2 &&
+                  op->GetAttr<int>("y_num_col_dims") == 1 && has_bias &&
+                  has_int8_kernel("fc");
+    } else if (op->Type() == "matmul" || op->Type() == "matmul_v2") {
+      supported = weight.dims().size() == 2 && !IsActTransposed(*op) &&
+                  has_int8_kernel(op->Type());
+    } else {
+      supported = weight.dims().size() == 4 && has_int8_kernel(op->Type());
+    }
+    if (supported) quantizable.insert(op);
+  }
+
+  // A weight converted to int8 can only be read by quantized ops
+  for (size_t i = 0; i < block->OpsSize(); i++) {
+    auto* op = block->GetOp<cpp::OpDesc>(i);
+    if (!quantizable.count(op)) continue;
+    std::string act_arg, weight_arg;
+    GetQuantArgs(op->Type(), &act_arg, &weight_arg);
+    auto weight_name = op->Input(weight_arg).front();
+    bool shared_with_fp32 = false;
+    for (auto* consumer : consumers[weight_name]) {
+      shared_with_fp32 |= !quantizable.count(consumer);
+    }
+    if (shared_with_fp32) {
+      LOG(WARNING) << "The weight " << weight_name
+                   << " is shared with an fp32 op, " << op->Type()
+                   << " stays in fp32.";
+      continue;
+    }
+    Layer layer;
+    layer.op_type = op->Type();
+    layer.act_name = op->Input(act_arg).front();
+    layer.weight_name = weight_name;
+    layers_.push_back(layer);
+    stats_[layer.act_name];
+  }
+  LOG(INFO) << "Calibration found " << layers_.size()
+            << " layers to quantize.";
+}
+
+void PostTrainingQuantizer::Calibrate(
+    const lite_api::CxxConfig& model_config) {
+  auto files = ListFile(config_.data_dir);
+  std::sort(files.begin(), files.end());
+  if (config_.max_samples > 0 &&
+      files.size() > static_cast<size_t>(config_.max_samples)) {
+    files.resize(config_.max_samples);
+  }
+  CHECK(!files.empty()) << "No calibration sample in " << config_.data_dir;
+
+  Predictor predictor;
+  predictor.Build(model_config,
+                  {Place{TARGET(kX86), PRECISION(kFloat)},
+                   Place{TARGET(kHost), PRECISION(kFloat)}});
+  // The activations still visible after the fp32 fusion passes, the others
+  // are not observed and their layers stay in fp32.
+  std::set<std::string> visible;
+  for (auto& inst : predictor.runtime_program().instructions()) {
+    for (auto& name : inst.op()->op_info()->output_names()) {
+      visible.insert(name);
+    }
+  }
+  for (auto it = stats_.begin(); it != stats_.end();) {
+    if (!visible.count(it->first)) {
+      LOG(WARNING) << "The activation " << it->first
+                   << " is fused away in fp32 and not calibrated.";
+      it = stats_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Pass 1 finds the range of each activation, pass 2 its histogram
+  for (int pass = 0; pass < 2; pass++) {
+    for (auto& file : files) {
+      FeedSample(Join<std::string>({config_.data_dir, file}, "/"), &predictor);
+      predictor.Run();
+      for (auto& item : stats_) {
+        auto* tensor = predictor.GetTensor(item.first);
+        if (tensor->precision() != PRECISION(kFloat)) continue;
+        if (pass == 0) {
+          item.second.UpdateRange(tensor->data<float>(), tensor->numel());
+        } else {
+          item.second.UpdateHistogram(tensor->data<float>(), tensor->numel());
+        }
+      }
+    }
+  }
+  LOG(INFO) << "Calibrated " << stats_.size() << " activations on "
+            << files.size() << " samples.";
+}
+
+void PostTrainingQuantizer::Quantize(cpp::ProgramDesc* program,
+                                     Scope* scope) {
+  const auto algo = GetCalibrationAlgo(config_.algo);
+  auto* block = program->GetBlock<cpp::BlockDesc>(0);
+  // A weight stays in fp32 if any of its layers was not calibrated
+  std::set<std::string> fp32_weights;
+  for (auto& layer : layers_) {
+    auto stats = stats_.find(layer.act_name);
+    if (stats == stats_.end() || stats->second.empty()) {
+      fp32_weights.insert(layer.weight_name);
+    }
+  }
+  std::map<std::string, std::pair<std::vector<float>, float>> weight_scales;
+  std::vector<Layer> quantized;
+  for (size_t i = 0; i < block->OpsSize(); i++) {
+    auto* op = block->GetOp<cpp::OpDesc>(i);
+    std::string act_arg, weight_arg;
+    if (!GetQuantArgs(op->Type(), &act_arg, &weight_arg)) continue;
+    auto layer = std::find_if(layers_.begin(), layers_.end(), [&](Layer& l) {
+      return l.op_type == op->Type() &&
+             l.act_name == op->Input(act_arg).front() &&
+             l.weight_name == op->Input(weight_arg).front();
+    });
+    if (layer == layers_.end() || fp32_weights.count(layer->weight_name)) {
+      continue;
+    }
+    auto stats = stats_.find(layer->act_name);
+
+    // A shared weight is converted by its first consumer
+    if (!weight_scales.count(layer->weight_name)) {
+      auto* weight = scope->FindVar(layer->weight_name)->GetMutable<Tensor>();
+      const bool conv = weight->dims().size() == 4;
+      const bool trans = IsWeightTransposed(*op);
+      // Per Cout of a conv filter, per output column of a [K, N] weight
+      const int64_t channels =
+          conv || trans ? weight->dims()[0] : weight->dims()[1];
+      Tensor fp32_weight;
+      fp32_weight.CopyDataFrom(*weight);
+      float sqnr = 0.f;
+      auto scales = QuantizeWeight(fp32_weight.data<float>(),
+                                   fp32_weight.numel(),
+                                   channels,
+                                   !conv && !trans,
+                                   weight->mutable_data<int8_t>(),
+                                   &sqnr);
+      weight->set_precision(PRECISION(kInt8));
+      weight->set_persistable(true);
+      weight_scales[layer->weight_name] = std::make_pair(scales, sqnr);
+    }
+    const auto& weight_scale = weight_scales[layer->weight_name];
+
+    layer->act_threshold = stats->second.Threshold(algo);
+    layer->act_sqnr = stats->second.SQNR(layer->act_threshold);
+    layer->weight_sqnr = weight_scale.second;
+    // The two noises add up
+    layer->sqnr =
+        -10.f * std::log10(std::pow(10.f, -layer->act_sqnr / 10.f) +
+                           std::pow(10.f, -layer->weight_sqnr / 10.f));
+
+    OpInfo op_info(*op);
+    op_info.SetAttr("enable_int8", true);
+    op_info.SetAttr("bit_length", 8);
+    op_info.SetInputScale(layer->act_name, {layer->act_threshold / 127.f});
+    op_info.SetInputScale(layer->weight_name, weight_scale.first);
+    *op = op_info;
+    quantized.push_back(*layer);
+  }
+  layers_ = quantized;
+}
+
+std::string PostTrainingQuantizer::Report() const {
+  std::vector<Layer> layers = layers_;
+  std::sort(layers.begin(), layers.end(), [](const Layer& a, const Layer& b) {
+    return a.sqnr < b.sqnr;
+  });
+  std::ostringstream os;
+  os << "Quantized " << layers.size() << " layers with " << config_.algo
+     << " calibration, most sensitive first (SQNR in dB):\n";
+  os << std::left << std::setw(18) << "op" << std::setw(40) << "weight"
+     << std::right << std::setw(10) << "act_max" << std::setw(10) << "act"
+     << std::setw(10) << "weight" << std::setw(10) << "total"
+     << "\n";
+  std::vector<std::string> sensitive;
+  os << std::fixed << std::setprecision(2);
+  for (auto& layer : layers) {
+    os << std::left << std::setw(18) << layer.op_type << std::setw(40)
+       << layer.weight_name << std::right << std::setw(10)
+       << layer.act_threshold << std::setw(10) << layer.act_sqnr
+       << std::setw(10) << layer.weight_sqnr << std::setw(10) << layer.sqnr
+       << "\n";
+    if (layer.sqnr < kSensitiveSQNR) sensitive.push_back(layer.weight_name);
+  }
+  if (!sensitive.empty()) {
+    os << sensitive.size() << " layers are below " << kSensitiveSQNR
+       << " dB, consider keeping them in fp32 with --calibration_skip="
+       << Join(sensitive, ",") << "\n";
+  }
+  return os.str();
+}
+
+}  // namespace calibration
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,91 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/api/tools/calibration/calibration_stats.h"
+#include "lite/core/scope.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace calibration {
+
+struct CalibrationConfig {
+  // Every regular file in the dir is one sample. It holds two lines per
+  // model input in feed order: the comma separated dims, e.g. "1,3,224,224",
+  // then the whitespace separated fp32 values.
+  std::string data_dir;
+  // KL, percentile or min_max
+  std::string algo{"KL"};
+  // At most this many samples are used, 0 for all of them
+  int max_samples{0};
+  // Op types or weight names left in fp32
+  std::vector<std::string> skip;
+};
+
+// Post-training static int8 quantization: the fp32 model runs on x86 over
+// the calibration set to find the activation scales, then the weights of
+// conv2d, depthwise_conv2d, mul, matmul and matmul_v2 are quantized per
+// channel. The quantized program follows the format of the quant_dequant
+// fuse passes (enable_int8, bit_length, the `<arg><idx>_scale` attrs and an
+// int8 weight), so it goes through the usual int8 kernel pick.
+class PostTrainingQuantizer {
+ public:
+  // Only ops that have an int8 kernel on one of `valid_places` are quantized.
+  PostTrainingQuantizer(const CalibrationConfig& config,
+                        const std::vector<Place>& valid_places);
+
+  // Loads the fp32 model of `model_config` into `scope` and `program`,
+  // calibrates it and quantizes it in place.
+  void Run(const lite_api::CxxConfig& model_config,
+           Scope* scope,
+           cpp::ProgramDesc* program);
+
+  // The quantized layers, most sensitive first, with their SQNR and the
+  // layers suggested to stay in fp32.
+  std::string Report() const;
+
+ private:
+  struct Layer {
+    std::string op_type;
+    std::string act_name;
+    std::string weight_name;
+    float act_threshold{0.f};
+    float act_sqnr{0.f};
+    float weight_sqnr{0.f};
+    // Both noises, in dB
+    float sqnr{0.f};
+  };
+
+  // Finds the ops that can be quantized and their activations.
+  void FindLayers(const cpp::ProgramDesc& program, Scope* scope);
+  // Runs the fp32 model over the calibration set and fills stats_.
+  void Calibrate(const lite_api::CxxConfig& model_config);
+  // Rewrites the ops of layers_ and their weights.
+  void Quantize(cpp::ProgramDesc* program, Scope* scope);
+
+  CalibrationConfig config_;
+  std::vector<Place> valid_places_;
+  std::vector<Layer> layers_;
+  std::map<std::string, ActivationStats> stats_;
+};
+
+}  // namespace calibration
+}  // namespace lite
+}  // namespace paddle
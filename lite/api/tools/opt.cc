@@ -48,6 +48,25 @@ DEFINE_string(quant_type,
               "Set the quant_type for post_quant_dynamic, "
               "and it should be QUANT_INT8 or QUANT_INT16 for now.");
 DEFINE_bool(enable_fp16, false, "Set kernel_type run in FP16.");
+DEFINE_string(x86_half_weight,
+              "",
+              "Store the weights of x86 fc/matmul/conv2d in 16 bits and "
+              "compute in fp32, it should be fp16 or bf16.");
+DEFINE_string(calibration_data_dir,
+              "",
+              "Dir of the calibration samples of post-training static int8 "
+              "quantization, the fp32 model is calibrated on x86.");
+DEFINE_string(calibration_algo,
+              "KL",
+              "How the activation scales are calibrated, it should be KL, "
+              "percentile or min_max.");
+DEFINE_int32(calibration_max_samples,
+             0,
+             "Use at most this many calibration samples, 0 for all.");
+DEFINE_string(calibration_skip,
+              "",
+              "Op types or weight names left in fp32 by the calibration, "
+              "splitted by comma.");
 DEFINE_bool(record_tailoring_info,
             false,
             "Record kernels and operators information of the optimized model "
@@ -125,6 +144,15 @@ int main(int argc, char** argv) {
     opt.SetQuantModel(true);
     opt.SetQuantType(FLAGS_quant_type);
   }
+  if (FLAGS_x86_half_weight != "") {
+    opt.SetX86HalfWeight(FLAGS_x86_half_weight);
+  }
+  if (FLAGS_calibration_data_dir != "") {
+    opt.SetCalibrationDataDir(FLAGS_calibration_data_dir);
+    opt.SetCalibrationAlgo(FLAGS_calibration_algo);
+    opt.SetCalibrationMaxSamples(FLAGS_calibration_max_samples);
+    opt.SetCalibrationSkip(FLAGS_calibration_skip);
+  }
   if (FLAGS_sparse_model) {
     opt.SetSparseModel(true);
     opt.SetSparseThreshold(FLAGS_sparse_threshold);
@@ -58,6 +58,35 @@ void OptBase::SetQuantType(const std::string& quant_type) {
   }
 }
 
+void OptBase::SetX86HalfWeight(const std::string& half_weight_type) {
+  if (half_weight_type == "fp16") {
+    opt_config_.set_x86_half_weight_type(lite_api::HalfWeightType::HALF_FP16);
+  } else if (half_weight_type == "bf16") {
+    opt_config_.set_x86_half_weight_type(lite_api::HalfWeightType::HALF_BF16);
+  } else {
+    OPT_LOG_FATAL << "Unsupported x86 half weight type: " << half_weight_type;
+  }
+}
+
+void OptBase::SetCalibrationDataDir(const std::string& data_dir) {
+  calibration_config_.data_dir = data_dir;
+}
+
+void OptBase::SetCalibrationAlgo(const std::string& algo) {
+  if (algo != "KL" && algo != "percentile" && algo != "min_max") {
+    OPT_LOG_FATAL << "Unsupported calibration algo: " << algo;
+  }
+  calibration_config_.algo = algo;
+}
+
+void OptBase::SetCalibrationMaxSamples(int max_samples) {
+  calibration_config_.max_samples = max_samples;
+}
+
+void OptBase::SetCalibrationSkip(const std::string& skip) {
+  calibration_config_.skip = lite::Split(skip, ",");
+}
+
 void OptBase::SetSparseModel(bool sparse_model) {
   opt_config_.set_sparse_model(sparse_model);
 }
@@ -246,6 +275,8 @@ void OptBase::Run() {
   opt_config_.set_valid_places(valid_places_);
   if (model_set_dir_ != "") {
     RunOptimizeFromModelSet(record_strip_info_);
+  } else if (calibration_config_.data_dir != "") {
+    RunCalibration();
   } else {
     auto opt_predictor = lite_api::CreatePaddlePredictor(opt_config_);
     opt_predictor->SaveOptimizedModel(
@@ -270,12 +301,32 @@ void OptBase::RunOptimize(const std::string& model_dir_path,
   opt_config_.set_valid_places(valid_places_);
   if (model_set_dir_ != "") {
     RunOptimizeFromModelSet(record_strip_info_);
+  } else if (calibration_config_.data_dir != "") {
+    RunCalibration();
   } else {
     auto opt_predictor = lite_api::CreatePaddlePredictor(opt_config_);
     opt_predictor->SaveOptimizedModel(
         lite_out_name_, model_type_, record_strip_info_);
   }
 }
+void OptBase::RunCalibration() {
+#ifdef LITE_WITH_OPT_CALIBRATION
+  lite::calibration::PostTrainingQuantizer quantizer(calibration_config_,
+                                                     valid_places_);
+  auto scope = std::make_shared<lite::Scope>();
+  auto program = std::make_shared<lite::cpp::ProgramDesc>();
+  quantizer.Run(opt_config_, scope.get(), program.get());
+  OPT_LOG << quantizer.Report();
+  lite::Predictor predictor(scope);
+  predictor.Build(
+      program, valid_places_, opt_config_.get_passes_internal(), opt_config_);
+  predictor.SaveModel(lite_out_name_, model_type_, record_strip_info_);
+#else
+  OPT_LOG_FATAL << "Calibration runs the model on x86, please rebuild opt "
+                   "with -DLITE_WITH_OPT_CALIBRATION=ON.";
+#endif
+}
+
 // collect ops info of modelset
 void CollectModelMetaInfo(const std::string& output_dir,
                           const std::vector<std::string>& models,
@@ -416,6 +467,12 @@ void OptBase::PrintExecutableBinHelpInfo() {
       "  Arguments of mode quantization in opt:\n"
       "        `--quant_model=(true|false)`\n"
       "        `--quant_type=(QUANT_INT8|QUANT_INT16)`\n"
+      "        `--x86_half_weight=(fp16|bf16)`\n"
+      "  Arguments of post-training static int8 quantization in opt:\n"
+      "        `--calibration_data_dir=<calibration_samples_dir>`\n"
+      "        `--calibration_algo=(KL|percentile|min_max)`\n"
+      "        `--calibration_max_samples=(int)`\n"
+      "        `--calibration_skip=<op_types_or_weight_names>`\n"
       "  Arguements of sparse convolution in opt: \n"
       "        `--sparse_model=(true|false)`\n"
       "        `--sparse_threshold=(float)`\n"
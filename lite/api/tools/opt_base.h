@@ -27,6 +27,7 @@
 // stores the map that records the source_file path of each kernel.
 #include "kernel_src_map.h"  // NOLINT
 #include "lite/api/cxx_api.h"
+#include "lite/api/tools/calibration/post_training_quantizer.h"
 // version of Paddle-lite
 #include "lite/core/version.h"
 // model parser functions to pre-load model to verify if this model is supported
@@ -54,6 +55,13 @@ class LITE_API OptBase {
   void RecordModelInfo(bool record_strip_info = true);
   void SetQuantModel(bool quant_model);
   void SetQuantType(const std::string &quant_type);
+  void SetX86HalfWeight(const std::string &half_weight_type);
+  // post-training static int8 quantization, calibrated on x86
+  void SetCalibrationDataDir(const std::string &data_dir);
+  void SetCalibrationAlgo(const std::string &algo);
+  void SetCalibrationMaxSamples(int max_samples);
+  // op types or weight names left in fp32, splitted by comma
+  void SetCalibrationSkip(const std::string &skip);
   void SetSparseModel(bool sparse_model);
   void SetSparseThreshold(const float sparse_threshold = 0.6f);
   // set optimized_model type
@@ -122,7 +130,10 @@ class LITE_API OptBase {
   bool record_strip_info_{false};
   std::map<std::string, std::set<std::string>> target_supported_ops_{};
   std::map<std::string, std::set<std::string>> all_supported_ops_{};
+  lite::calibration::CalibrationConfig calibration_config_;
   void RunOptimizeFromModelSet(bool record_strip_info = false);
+  // quantize with calibration_config_, then transform and save
+  void RunCalibration();
   void InitSupportedOpInfo();
 };
 
@@ -0,0 +1,332 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/host_allocator.h"
+#include <stdlib.h>
+#include <algorithm>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "lite/utils/log/cp_logging.h"
+#include "lite/utils/macros.h"
+
+// Toolchains without thread local storage share one cache between threads,
+// skip it there.
+#if ((defined __ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__) && \
+     (__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__ < 90000)) || \
+    defined(LITE_WITH_SW)
+#define LITE_HOST_ALLOCATOR_NO_THREAD_CACHE
+#endif
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+constexpr size_t kAlign = 64;
+// The header of a block lives right before the pointer handed out.
+constexpr size_t kHeaderSize = 64;
+// Kernels may read a little past the end of their buffers.
+constexpr size_t kExtraSize = 64;
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = size_t(2) << 20;
+// Smaller blocks are placed by the first touch.
+constexpr size_t kNumaMinBytes = size_t(64) << 10;
+constexpr int kMinClassShift = 8;
+
+struct BlockHeader {
+  void* raw;
+  HostMemoryStats* stats;
+  size_t bytes;
+  int32_t size_class;
+  // The node the block is bound to, -1 if none
+  int32_t numa_node;
+  // Aligned to 2MB and advised to be backed by huge pages
+  bool huge;
+};
+static_assert(sizeof(BlockHeader) <= kHeaderSize, "block header too large");
+
+inline BlockHeader* Header(void* ptr) {
+  return reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) -
+                                        kHeaderSize);
+}
+
+inline size_t AlignUp(size_t value, size_t align) {
+  return (value + align - 1) & ~(align - 1);
+}
+
+#if defined(__linux__)
+void AdviseHugePages(char* begin, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+  size_t start = AlignUp(reinterpret_cast<size_t>(begin), kPageSize);
+  size_t end = (reinterpret_cast<size_t>(begin) + bytes) & ~(kPageSize - 1);
+  if (end > start) {
+    madvise(reinterpret_cast<void*>(start), end - start, MADV_HUGEPAGE);
+  }
+#endif
+}
+
+// Moves the pages already touched if `move` is set, e.g. for a cached block
+// reused by an owner on another node.
+void BindToNumaNode(char* begin, size_t bytes, int node, bool move = false) {
+#ifdef SYS_mbind
+  constexpr int kMpolPreferred = 1;
+  constexpr unsigned kMpolMfMove = 1 << 1;
+  constexpr int kMaxNodes = 256;
+  if (node < 0 || node >= kMaxNodes) return;
+  size_t start = AlignUp(reinterpret_cast<size_t>(begin), kPageSize);
+  size_t end = (reinterpret_cast<size_t>(begin) + bytes) & ~(kPageSize - 1);
+  if (end <= start) return;
+  const int bits = 8 * sizeof(unsigned long);  // NOLINT
+  unsigned long mask[kMaxNodes / bits] = {0};  // NOLINT
+  mask[node / bits] = 1UL << (node % bits);
+  // The kernel expects the number of bits plus one.
+  if (syscall(SYS_mbind, start, end - start, kMpolPreferred, mask,
+              kMaxNodes + 1, move ? kMpolMfMove : 0) != 0) {
+    VLOG(4) << "mbind to NUMA node " << node << " failed";
+  }
+#endif
+}
+#endif
+
+LITE_THREAD_LOCAL HostMemoryStats* current_stats = nullptr;
+
+}  // namespace
+
+void HostMemoryStats::Allocated(int64_t bytes) {
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  int64_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  live += bytes;
+  int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !peak_bytes_.compare_exchange_weak(peak, live)) {
+  }
+}
+
+ScopedHostMemoryStats::ScopedHostMemoryStats(HostMemoryStats* stats)
+    : prev_(current_stats) {
+  current_stats = stats;
+}
+
+ScopedHostMemoryStats::~ScopedHostMemoryStats() { current_stats = prev_; }
+
+// Recently freed small blocks of one thread, reused without locking. Huge
+// page backed blocks are never kept here.
+struct HostAllocator::ThreadCache {
+  static constexpr size_t kMaxBlockBytes = size_t(256) << 10;
+  static constexpr size_t kMaxBlocks = 4;
+  static constexpr size_t kMaxBytes = size_t(1) << 20;
+
+  ~ThreadCache() { Flush(); }
+
+  void* Pop(int size_class) {
+    auto& blocks = blocks_[size_class];
+    if (blocks.empty()) return nullptr;
+    void* ptr = blocks.back();
+    blocks.pop_back();
+    bytes_ -= ClassBytes(size_class);
+    return ptr;
+  }
+
+  bool Push(void* ptr, int size_class) {
+    size_t bytes = ClassBytes(size_class);
+    auto& blocks = blocks_[size_class];
+    if (Header(ptr)->huge || bytes > kMaxBlockBytes ||
+        blocks.size() >= kMaxBlocks || bytes_ + bytes > kMaxBytes) {
+      return false;
+    }
+    blocks.push_back(ptr);
+    bytes_ += bytes;
+    return true;
+  }
+
+  // Hands all the blocks over to the shared cache.
+  void Flush() {
+    auto& allocator = HostAllocator::Global();
+    for (int c = 0; c < kNumClasses; ++c) {
+      for (void* ptr : blocks_[c]) {
+        allocator.cached_bytes_ -= ClassBytes(c);
+        if (!allocator.CacheBlock(ptr, c)) allocator.ReleaseBlock(ptr);
+      }
+      blocks_[c].clear();
+    }
+    bytes_ = 0;
+  }
+
+ private:
+  std::vector<void*> blocks_[kNumClasses];
+  size_t bytes_{0};
+};
+
+HostAllocator::ThreadCache* HostAllocator::LocalCache() {
+#ifndef LITE_HOST_ALLOCATOR_NO_THREAD_CACHE
+  static LITE_THREAD_LOCAL ThreadCache cache;
+  return &cache;
+#else
+  return nullptr;
+#endif
+}
+
+HostAllocator& HostAllocator::Global() {
+  // Never destroyed, thread caches are flushed into it at thread exit.
+  static HostAllocator* allocator = new HostAllocator();
+  return *allocator;
+}
+
+int HostAllocator::SizeClass(size_t size) {
+  if (size <= (size_t(1) << kMinClassShift)) return 0;
+  if (size > ClassBytes(kNumClasses - 1)) return -1;
+  int shift = 0;
+  while ((size_t(2) << shift) < size) ++shift;
+  // 2^shift < size <= 2^(shift + 1), split into four steps of 2^(shift - 2)
+  size_t base = size_t(1) << shift;
+  size_t step = base >> 2;
+  int index = static_cast<int>((size - base + step - 1) / step);
+  return (shift - kMinClassShift) * 4 + index;
+}
+
+size_t HostAllocator::ClassBytes(int size_class) {
+  if (size_class == 0) return size_t(1) << kMinClassShift;
+  int shift = kMinClassShift + (size_class - 1) / 4;
+  int index = (size_class - 1) % 4 + 1;
+  return (size_t(1) << shift) + index * (size_t(1) << (shift - 2));
+}
+
+void* HostAllocator::AllocateBlock(size_t bytes,
+                                   int size_class,
+                                   bool huge,
+                                   int numa_node) {
+  const size_t align = huge ? kHugePageSize : kAlign;
+  size_t total = kHeaderSize + bytes + kExtraSize + align;
+  CHECK_GT(total, bytes);
+  char* raw = static_cast<char*>(malloc(total));
+  CHECK(raw) << "Error occurred in TargetWrapper::Malloc period: no enough for "
+                "mallocing "
+             << bytes << " bytes.";
+  char* ptr = reinterpret_cast<char*>(
+      AlignUp(reinterpret_cast<size_t>(raw + kHeaderSize), align));
+#if defined(__linux__)
+  if (huge) AdviseHugePages(ptr, bytes);
+  if (numa_node >= 0) BindToNumaNode(ptr, bytes, numa_node);
+#endif
+  BlockHeader* header = Header(ptr);
+  header->raw = raw;
+  header->stats = nullptr;
+  header->bytes = bytes;
+  header->size_class = size_class;
+  header->numa_node = numa_node;
+  header->huge = huge;
+  return ptr;
+}
+
+void HostAllocator::ReleaseBlock(void* ptr) { free(Header(ptr)->raw); }
+
+bool HostAllocator::CacheBlock(void* ptr, int size_class) {
+  const size_t bytes = ClassBytes(size_class);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!caching_ || cached_bytes_ + bytes > max_cached_bytes_) return false;
+  free_blocks_[Header(ptr)->huge][size_class].push_back(ptr);
+  cached_bytes_ += bytes;
+  return true;
+}
+
+void* HostAllocator::Malloc(size_t size) {
+  CHECK(size);
+  const int size_class = caching_ ? SizeClass(size) : -1;
+  const size_t bytes =
+      size_class >= 0 ? ClassBytes(size_class) : AlignUp(size, kAlign);
+  const size_t huge_page_threshold = huge_page_threshold_;
+  const bool huge = huge_page_threshold > 0 && bytes >= huge_page_threshold;
+  void* ptr = nullptr;
+  if (size_class >= 0) {
+    auto* cache = huge ? nullptr : LocalCache();
+    ptr = cache ? cache->Pop(size_class) : nullptr;
+    if (!ptr) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& blocks = free_blocks_[huge][size_class];
+      if (!blocks.empty()) {
+        ptr = blocks.back();
+        blocks.pop_back();
+      }
+    }
+    if (ptr) cached_bytes_ -= bytes;
+  }
+  int numa_node = current_stats ? current_stats->numa_node() : -1;
+  if (numa_node < 0) numa_node = numa_node_;
+  if (bytes < kNumaMinBytes) numa_node = -1;
+  if (!ptr) {
+    ptr = AllocateBlock(bytes, size_class, huge, numa_node);
+  } else if (numa_node >= 0 && Header(ptr)->numa_node != numa_node) {
+#if defined(__linux__)
+    BindToNumaNode(static_cast<char*>(ptr), bytes, numa_node, true);
+#endif
+    Header(ptr)->numa_node = numa_node;
+  }
+
+  live_bytes_ += bytes;
+  BlockHeader* header = Header(ptr);
+  header->stats = current_stats;
+  if (header->stats) {
+    header->stats->AddRef();
+    header->stats->Allocated(bytes);
+  }
+  return ptr;
+}
+
+void HostAllocator::Free(void* ptr) {
+  if (!ptr) return;
+  BlockHeader* header = Header(ptr);
+  live_bytes_ -= header->bytes;
+  if (header->stats) {
+    header->stats->Freed(header->bytes);
+    header->stats->Release();
+    header->stats = nullptr;
+  }
+  const int size_class = header->size_class;
+  if (size_class >= 0 && caching_) {
+    auto* cache = LocalCache();
+    if (cache && cache->Push(ptr, size_class)) {
+      cached_bytes_ += header->bytes;
+      return;
+    }
+    if (CacheBlock(ptr, size_class)) return;
+  }
+  ReleaseBlock(ptr);
+}
+
+void HostAllocator::ReleaseCache() {
+  // Blocks cached by the other threads are released when they exit.
+  auto* cache = LocalCache();
+  if (cache) cache->Flush();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& free_blocks : free_blocks_) {
+    for (int c = 0; c < kNumClasses; ++c) {
+      for (void* ptr : free_blocks[c]) {
+        ReleaseBlock(ptr);
+        cached_bytes_ -= ClassBytes(c);
+      }
+      free_blocks[c].clear();
+    }
+  }
+}
+
+void HostAllocator::set_caching(bool enable) {
+  caching_ = enable;
+  if (!enable) ReleaseCache();
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,152 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+// Host memory attributed to one owner, usually a predictor. It is reference
+// counted because blocks may outlive their owner (e.g. weights shared with a
+// cloned predictor): the owner holds one reference and every live block
+// allocated on its behalf holds another one.
+class HostMemoryStats {
+ public:
+  static HostMemoryStats* Create() { return new HostMemoryStats(); }
+
+  void AddRef() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void Release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+  }
+
+  void Allocated(int64_t bytes);
+  void Freed(int64_t bytes) {
+    live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  int64_t live_bytes() const { return live_bytes_.load(); }
+  int64_t peak_bytes() const { return peak_bytes_.load(); }
+  // The number of blocks handed out, including the reused ones.
+  int64_t allocations() const { return allocations_.load(); }
+
+  // The NUMA node preferred for the large blocks of the owner, overrides the
+  // one of the allocator. -1 (the default) defers to the allocator.
+  void set_numa_node(int node) { numa_node_ = node; }
+  int numa_node() const { return numa_node_.load(); }
+
+ private:
+  HostMemoryStats() = default;
+  ~HostMemoryStats() = default;
+
+  std::atomic<int64_t> refs_{1};
+  std::atomic<int64_t> live_bytes_{0};
+  std::atomic<int64_t> peak_bytes_{0};
+  std::atomic<int64_t> allocations_{0};
+  std::atomic<int> numa_node_{-1};
+};
+
+// Attributes the host allocations made by the current thread to `stats`
+// while it is alive. Guards nest, the innermost one wins.
+class ScopedHostMemoryStats {
+ public:
+  explicit ScopedHostMemoryStats(HostMemoryStats* stats);
+  ~ScopedHostMemoryStats();
+
+ private:
+  HostMemoryStats* prev_{nullptr};
+};
+
+// The process-wide allocator behind TargetWrapper<TARGET(kHost)>::Malloc.
+//
+// With caching on, requests are rounded up to size classes (four per power of
+// two, so at most 25% is wasted) and freed blocks are cached per class
+// instead of being returned to the system, small blocks in a per-thread cache
+// first. This keeps tensors that are resized with dynamic shapes, released by
+// TryShrinkMemory or owned by many predictors from churning and fragmenting
+// the system allocator. It is off by default since the cache is shared by the
+// whole process, and bounded by the max cached bytes when on.
+//
+// Blocks not smaller than the huge page threshold are aligned to 2MB and
+// advised to be backed by transparent huge pages, cached huge blocks are only
+// reused for huge requests and the other way around. If a NUMA node is set,
+// large blocks are preferably placed on it (both only take effect on Linux).
+class HostAllocator {
+ public:
+  static HostAllocator& Global();
+
+  // Returns a 64-byte aligned block of at least `size` bytes.
+  void* Malloc(size_t size);
+  void Free(void* ptr);
+
+  // Returns all the cached blocks to the system.
+  void ReleaseCache();
+
+  // Caching is off by default, turning it off releases the cache.
+  void set_caching(bool enable);
+  bool caching() const { return caching_.load(); }
+  // The upper bound of the bytes kept in the shared cache, 64MB by default.
+  void set_max_cached_bytes(size_t bytes) { max_cached_bytes_ = bytes; }
+  size_t max_cached_bytes() const { return max_cached_bytes_.load(); }
+  // 0 (the default) disables huge page backing.
+  void set_huge_page_threshold(size_t bytes) { huge_page_threshold_ = bytes; }
+  size_t huge_page_threshold() const { return huge_page_threshold_.load(); }
+  // -1 (the default) leaves the placement to the system.
+  void set_numa_node(int node) { numa_node_ = node; }
+  int numa_node() const { return numa_node_.load(); }
+
+  // Bytes in blocks handed out to the callers.
+  int64_t live_bytes() const { return live_bytes_.load(); }
+  // Bytes in blocks kept for reuse.
+  int64_t cached_bytes() const { return cached_bytes_.load(); }
+
+  // Size class helpers, exposed for the tests.
+  static int SizeClass(size_t size);
+  static size_t ClassBytes(int size_class);
+
+  static constexpr int kNumClasses = 81;
+
+ private:
+  struct ThreadCache;
+  friend struct ThreadCache;
+
+  HostAllocator() = default;
+
+  // The cache of the calling thread, nullptr without thread local storage.
+  static ThreadCache* LocalCache();
+
+  void* AllocateBlock(size_t bytes, int size_class, bool huge, int numa_node);
+  void ReleaseBlock(void* ptr);
+  // Puts a free block back to the shared cache, returns false if it is full.
+  bool CacheBlock(void* ptr, int size_class);
+
+  std::atomic<bool> caching_{false};
+  std::atomic<size_t> max_cached_bytes_{size_t(64) << 20};
+  std::atomic<size_t> huge_page_threshold_{0};
+  std::atomic<int> numa_node_{-1};
+  std::atomic<int64_t> live_bytes_{0};
+  std::atomic<int64_t> cached_bytes_{0};
+
+  std::mutex mutex_;
+  // Indexed by whether the blocks are huge page backed, then the size class
+  std::vector<void*> free_blocks_[2][kNumClasses];
+};
+
+}  // namespace lite
+}  // namespace paddle
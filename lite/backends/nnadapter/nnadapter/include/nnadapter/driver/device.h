@@ -46,6 +46,17 @@ typedef struct Device {
                          core::Argument* input_arguments,
                          uint32_t output_count,
                          core::Argument* output_arguments);
+  // Optional and available since version 2, start to execute the program and
+  // return an event which is passed to wait_event to wait for the results and
+  // release it. The runtime calls execute_program on a worker thread if they
+  // are not provided or the driver is of version 1.
+  int (*execute_program_async)(void* program,
+                               uint32_t input_count,
+                               core::Argument* input_arguments,
+                               uint32_t output_count,
+                               core::Argument* output_arguments,
+                               void** event);
+  int (*wait_event)(void* event);
 } Device;
 
 }  // namespace driver
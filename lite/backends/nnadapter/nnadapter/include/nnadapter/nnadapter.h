@@ -22,7 +22,7 @@
 #include <stdint.h>
 #include <sys/cdefs.h>
 
-enum { NNADAPTER_VERSION = 1 };
+enum { NNADAPTER_VERSION = 2 };
 enum { NNADAPTER_UNKNOWN = -65535 };
 
 /**
@@ -2321,6 +2321,13 @@ typedef struct NNAdapterCompilation NNAdapterCompilation;
  * Available since version 1.
  */
 typedef struct NNAdapterExecution NNAdapterExecution;
+/**
+ * An opaque type for Event, which is signaled when an asynchronous
+ * computation is finished.
+ *
+ * Available since version 2.
+ */
+typedef struct NNAdapterEvent NNAdapterEvent;
 
 #ifdef __cplusplus
 extern "C" {
@@ -2597,6 +2604,30 @@ int NNAdapterExecution_setOutput(NNAdapterExecution* execution,
  * Available since version 1.
  */
 int NNAdapterExecution_compute(NNAdapterExecution* execution);
+/**
+ * Start to run the execution asynchronously and return an event which is
+ * signaled when the computation is finished, so the caller can prepare the
+ * next request on the host while the device is running. The input and output
+ * memory must be kept until the event is signaled, and only one computation
+ * of an execution can be in flight.
+ *
+ * Available since version 2.
+ */
+int NNAdapterExecution_computeAsync(NNAdapterExecution* execution,
+                                    NNAdapterEvent** event);
+/**
+ * Wait until the computation is finished and return its result, the outputs
+ * are valid after it returns.
+ *
+ * Available since version 2.
+ */
+int NNAdapterEvent_wait(NNAdapterEvent* event);
+/**
+ * Destroy an event, it waits for the computation if it is not finished yet.
+ *
+ * Available since version 2.
+ */
+void NNAdapterEvent_destroy(NNAdapterEvent* event);
 
 #ifdef __cplusplus
 }
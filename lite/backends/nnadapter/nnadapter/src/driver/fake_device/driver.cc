@@ -122,6 +122,27 @@ int ExecuteProgram(void* program,
       input_count, input_arguments, output_count, output_arguments);
 }
 
+int ExecuteProgramAsync(void* program,
+                        uint32_t input_count,
+                        core::Argument* input_arguments,
+                        uint32_t output_count,
+                        core::Argument* output_arguments,
+                        void** event) {
+  if (!program || !output_arguments || !output_count || !event) {
+    return NNADAPTER_INVALID_PARAMETER;
+  }
+  auto p = reinterpret_cast<Program*>(program);
+  return p->ExecuteAsync(
+      input_count, input_arguments, output_count, output_arguments, event);
+}
+
+int WaitEvent(void* event) {
+  if (!event) {
+    return NNADAPTER_INVALID_PARAMETER;
+  }
+  return Program::WaitEvent(event);
+}
+
 }  // namespace fake_device
 }  // namespace nnadapter
 
@@ -129,7 +150,7 @@ NNADAPTER_EXPORT nnadapter::driver::Device NNADAPTER_AS_SYM2(DEVICE_NAME) = {
     .name = NNADAPTER_AS_STR2(DEVICE_NAME),
     .vendor = "Paddle",
     .type = NNADAPTER_ACCELERATOR,
-    .version = 1,
+    .version = 2,
     .open_device = nnadapter::fake_device::OpenDevice,
     .close_device = nnadapter::fake_device::CloseDevice,
     .create_context = nnadapter::fake_device::CreateContext,
@@ -138,4 +159,6 @@ NNADAPTER_EXPORT nnadapter::driver::Device NNADAPTER_AS_SYM2(DEVICE_NAME) = {
     .create_program = nnadapter::fake_device::CreateProgram,
     .destroy_program = nnadapter::fake_device::DestroyProgram,
     .execute_program = nnadapter::fake_device::ExecuteProgram,
+    .execute_program_async = nnadapter::fake_device::ExecuteProgramAsync,
+    .wait_event = nnadapter::fake_device::WaitEvent,
 };
@@ -31,6 +31,13 @@ namespace fake_device {
 
 Context::Context(void* device, const char* properties) : device_(device) {
   // TODO(hong19860320) create the raw context from fake_ddk
+  // Extract the runtime parameters from the context properties
+  auto key_values = GetKeyValues(properties);
+  if (key_values.count(FAKE_DEVICE_EXECUTION_DELAY_MS)) {
+    execution_delay_ms_ =
+        string_parse<int32_t>(key_values[FAKE_DEVICE_EXECUTION_DELAY_MS]);
+  }
+  NNADAPTER_VLOG(3) << "execution delay: " << execution_delay_ms_ << " ms";
 }
 
 Context::~Context() {}
@@ -201,6 +208,9 @@ int Program::Execute(uint32_t input_count,
   NNADAPTER_CHECK_EQ(execution_->SetInputs(input_tensors),
                      fake_ddk::StatusType::SUCCESS);
   NNADAPTER_CHECK_EQ(execution_->Run(), fake_ddk::StatusType::SUCCESS);
+  if (context_->execution_delay_ms() > 0) {
+    usleep(context_->execution_delay_ms() * 1000);
+  }
   std::vector<fake_ddk::Argument> output_tensors;
   NNADAPTER_CHECK_EQ(execution_->GetOutputs(&output_tensors),
                      fake_ddk::StatusType::SUCCESS);
@@ -246,5 +256,24 @@ int Program::Execute(uint32_t input_count,
   return NNADAPTER_NO_ERROR;
 }
 
+int Program::ExecuteAsync(uint32_t input_count,
+                          core::Argument* input_arguments,
+                          uint32_t output_count,
+                          core::Argument* output_arguments,
+                          void** event) {
+  *event = new std::future<int>(std::async(std::launch::async, [=]() {
+    return Execute(
+        input_count, input_arguments, output_count, output_arguments);
+  }));
+  return NNADAPTER_NO_ERROR;
+}
+
+int Program::WaitEvent(void* event) {
+  auto future = reinterpret_cast<std::future<int>*>(event);
+  int result = future->get();
+  delete future;
+  return result;
+}
+
 }  // namespace fake_device
 }  // namespace nnadapter
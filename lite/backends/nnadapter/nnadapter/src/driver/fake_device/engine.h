@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <future>  // NOLINT
 #include <map>
 #include <memory>
 #include <string>
@@ -33,10 +34,12 @@ class Context {
  public:
   explicit Context(void* device, const char* properties);
   ~Context();
+  int execution_delay_ms() { return execution_delay_ms_; }
 
  private:
   void* device_{nullptr};
   void* context_{nullptr};
+  int execution_delay_ms_{0};
 };
 
 class Program {
@@ -50,6 +53,14 @@ class Program {
               core::Argument* input_arguments,
               uint32_t output_count,
               core::Argument* output_arguments);
+  // Run Execute on a worker thread, the returned event is waited and
+  // released by WaitEvent
+  int ExecuteAsync(uint32_t input_count,
+                   core::Argument* input_arguments,
+                   uint32_t output_count,
+                   core::Argument* output_arguments,
+                   void** event);
+  static int WaitEvent(void* event);
 
  private:
   void Clear();
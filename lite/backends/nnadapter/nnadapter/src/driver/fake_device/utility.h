@@ -23,6 +23,11 @@
 namespace nnadapter {
 namespace fake_device {
 
+// Simulate the latency of a real device by sleeping the specified
+// milliseconds in every execution, such as
+// FAKE_DEVICE_EXECUTION_DELAY_MS=20
+#define FAKE_DEVICE_EXECUTION_DELAY_MS "FAKE_DEVICE_EXECUTION_DELAY_MS"
+
 // Convert the NNAdapter types to the fake device types
 fake_ddk::PrecisionType ConvertToFakeDevicePrecisionType(
     NNAdapterOperandPrecisionCode input_precision);
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "runtime/compilation.h"
+#include <future>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -139,60 +140,57 @@ Compilation::Compilation(Model* model,
   }
 }
 
-int Compilation::Execute(std::vector<core::Argument>* input_arguments,
-                         std::vector<core::Argument>* output_arguments) {
-  auto create_program_arguments = [&](
-      std::vector<core::Argument>* args,
-      const std::vector<int>& indexes,
-      std::vector<core::Argument>* arguments,
-      std::vector<std::shared_ptr<Buffer>>* buffers,
-      void* (*access)(
-          void* memory, NNAdapterOperandType* type, void* device_buffer)) {
-    for (size_t i = 0; i < indexes.size(); i++) {
-      core::Argument arg;
-      arg.index = i;
-      auto pos = indexes[i];
-      if (pos < 0) {
-        pos = -pos - 1;
-        bool found = false;
-        for (size_t j = 0; j < arguments->size(); j++) {
-          if (pos == arguments->at(j).index) {
-            arg.memory = arguments->at(j).memory;
-            arg.access = arguments->at(j).access;
-            found = true;
-            break;
-          }
-        }
-        NNADAPTER_CHECK(found) << "No matched argument found!";
-      } else {
-        for (int j = buffers->size(); j <= pos; j++) {
-          auto buffer = std::make_shared<Compilation::Buffer>();
-          NNADAPTER_CHECK(buffer)
-              << "Failed to allocate memory for a operand, out of memory!";
-          buffers->push_back(buffer);
+void Compilation::CreateProgramArguments(
+    const std::vector<int>& indexes,
+    std::vector<core::Argument>* arguments,
+    void* (*access)(
+        void* memory, NNAdapterOperandType* type, void* device_buffer),
+    std::vector<core::Argument>* args) {
+  for (size_t i = 0; i < indexes.size(); i++) {
+    core::Argument arg;
+    arg.index = i;
+    auto pos = indexes[i];
+    if (pos < 0) {
+      pos = -pos - 1;
+      bool found = false;
+      for (size_t j = 0; j < arguments->size(); j++) {
+        if (pos == arguments->at(j).index) {
+          arg.memory = arguments->at(j).memory;
+          arg.access = arguments->at(j).access;
+          found = true;
+          break;
         }
-        arg.memory = buffers->at(pos).get();
-        arg.access = access;
       }
-      args->push_back(arg);
+      NNADAPTER_CHECK(found) << "No matched argument found!";
+    } else {
+      for (int j = buffers_.size(); j <= pos; j++) {
+        auto buffer = std::make_shared<Compilation::Buffer>();
+        NNADAPTER_CHECK(buffer)
+            << "Failed to allocate memory for a operand, out of memory!";
+        buffers_.push_back(buffer);
+      }
+      arg.memory = buffers_.at(pos).get();
+      arg.access = access;
     }
-  };
-  // Executes the compiled programs on the multi-devices asynchronously or
-  // synchronously
-  // TODO(hong19860320) Supports asynchronously execution in future.
+    args->push_back(arg);
+  }
+}
+
+int Compilation::Execute(std::vector<core::Argument>* input_arguments,
+                         std::vector<core::Argument>* output_arguments) {
+  // Executes the compiled programs on the multi-devices synchronously, see
+  // ExecuteAsync for the asynchronous execution
   for (size_t i = 0; i < programs_.size(); i++) {
     auto device_context = programs_[i].device_context;
     std::vector<core::Argument> input_args, output_args;
-    create_program_arguments(&input_args,
-                             programs_[i].input_indexes,
-                             input_arguments,
-                             &buffers_,
-                             AccessSubmodelInput);
-    create_program_arguments(&output_args,
-                             programs_[i].output_indexes,
-                             output_arguments,
-                             &buffers_,
-                             AccessSubmodelOutput);
+    CreateProgramArguments(programs_[i].input_indexes,
+                           input_arguments,
+                           AccessSubmodelInput,
+                           &input_args);
+    CreateProgramArguments(programs_[i].output_indexes,
+                           output_arguments,
+                           AccessSubmodelOutput,
+                           &output_args);
     auto result = device_context->device->ExecuteProgram(programs_[i].program,
                                                          input_args.size(),
                                                          input_args.data(),
@@ -237,6 +235,49 @@ int Compilation::Execute(std::vector<core::Argument>* input_arguments,
   return NNADAPTER_NO_ERROR;
 }
 
+int Compilation::ExecuteAsync(std::vector<core::Argument>* input_arguments,
+                              std::vector<core::Argument>* output_arguments,
+                              Event** event) {
+  // A single program is handed to the driver if it supports the asynchronous
+  // execution, once the cache models have been serialized at the first
+  // iteration
+  auto device = programs_.size() == 1 ? programs_[0].device_context->device
+                                      : nullptr;
+  if (device && device->SupportsAsyncExecution() &&
+      !(model_ && CheckCache())) {
+    // The arguments must live until the driver finishes
+    auto args = std::make_shared<
+        std::pair<std::vector<core::Argument>, std::vector<core::Argument>>>();
+    CreateProgramArguments(programs_[0].input_indexes,
+                           input_arguments,
+                           AccessSubmodelInput,
+                           &args->first);
+    CreateProgramArguments(programs_[0].output_indexes,
+                           output_arguments,
+                           AccessSubmodelOutput,
+                           &args->second);
+    void* device_event = nullptr;
+    auto result = device->ExecuteProgramAsync(programs_[0].program,
+                                              args->first.size(),
+                                              args->first.data(),
+                                              args->second.size(),
+                                              args->second.data(),
+                                              &device_event);
+    if (result != NNADAPTER_NO_ERROR) return result;
+    *event = new Event([device, device_event, args]() {
+      return device->WaitEvent(device_event);
+    });
+    return NNADAPTER_NO_ERROR;
+  }
+  // Otherwise execute the programs on a worker thread
+  auto future = std::make_shared<std::future<int>>(
+      std::async(std::launch::async, [=]() {
+        return Execute(input_arguments, output_arguments);
+      }));
+  *event = new Event([future]() { return future->get(); });
+  return NNADAPTER_NO_ERROR;
+}
+
 int Compilation::Finish() {
   // Start to build program from model or cache
   completed_ = true;
@@ -20,6 +20,7 @@
 #include <utility>
 #include <vector>
 #include "runtime/context.h"
+#include "runtime/event.h"
 #include "runtime/model.h"
 
 namespace nnadapter {
@@ -76,8 +77,21 @@ class Compilation {
                             NNAdapterOperandType** output_types);
   int Execute(std::vector<core::Argument>* input_arguments,
               std::vector<core::Argument>* output_arguments);
+  // Start to execute the programs and return an event to wait for them, the
+  // arguments must be kept until the event is signaled.
+  int ExecuteAsync(std::vector<core::Argument>* input_arguments,
+                   std::vector<core::Argument>* output_arguments,
+                   Event** event);
 
  private:
+  // Map the arguments of the model to the ones of a program, the operands
+  // shared between the submodels are stored in `buffers_`
+  void CreateProgramArguments(
+      const std::vector<int>& indexes,
+      std::vector<core::Argument>* arguments,
+      void* (*access)(
+          void* memory, NNAdapterOperandType* type, void* device_buffer),
+      std::vector<core::Argument>* args);
   bool CheckCache();
   void ClearCache();
   int PartitionModel(
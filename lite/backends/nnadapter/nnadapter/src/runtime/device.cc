@@ -459,6 +459,31 @@ int Device::ExecuteProgram(void* program,
   return NNADAPTER_INVALID_PARAMETER;
 }
 
+int Device::ExecuteProgramAsync(void* program,
+                                uint32_t input_count,
+                                core::Argument* input_arguments,
+                                uint32_t output_count,
+                                core::Argument* output_arguments,
+                                void** event) {
+  if (SupportsAsyncExecution() && program && output_arguments &&
+      output_count && event) {
+    return device_->second->execute_program_async(program,
+                                                  input_count,
+                                                  input_arguments,
+                                                  output_count,
+                                                  output_arguments,
+                                                  event);
+  }
+  return NNADAPTER_INVALID_PARAMETER;
+}
+
+int Device::WaitEvent(void* event) {
+  if (SupportsAsyncExecution() && event) {
+    return device_->second->wait_event(event);
+  }
+  return NNADAPTER_INVALID_PARAMETER;
+}
+
 DeviceManager& DeviceManager::get() {
   static DeviceManager instance;
   return instance;
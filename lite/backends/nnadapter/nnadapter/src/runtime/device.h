@@ -60,6 +60,20 @@ class Device {
                      core::Argument* input_arguments,
                      uint32_t output_count,
                      core::Argument* output_arguments);
+  // The drivers of version 1 are built against the structure without the
+  // async hooks, so they must not be read from them.
+  bool SupportsAsyncExecution() const {
+    return IsValid() && device_->second->version >= 2 &&
+           device_->second->execute_program_async &&
+           device_->second->wait_event;
+  }
+  int ExecuteProgramAsync(void* program,
+                          uint32_t input_count,
+                          core::Argument* input_arguments,
+                          uint32_t output_count,
+                          core::Argument* output_arguments,
+                          void** event);
+  int WaitEvent(void* event);
 
  private:
   std::pair<void*, driver::Device*>* device_{nullptr};
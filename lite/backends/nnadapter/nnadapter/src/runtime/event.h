@@ -0,0 +1,47 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <utility>
+#include "core/types.h"
+
+namespace nnadapter {
+namespace runtime {
+
+// The completion of an asynchronous computation, `wait` blocks until the
+// computation is finished and returns its result.
+class Event {
+ public:
+  explicit Event(std::function<int()> wait) : wait_(std::move(wait)) {}
+  ~Event() { Wait(); }
+  int Wait() {
+    if (!signaled_) {
+      result_ = wait_();
+      signaled_ = true;
+    }
+    return result_;
+  }
+
+ private:
+  std::function<int()> wait_;
+  bool signaled_{false};
+  int result_{NNADAPTER_NO_ERROR};
+  Event(const Event&) = delete;
+  Event& operator=(const Event&) = delete;
+};
+
+}  // namespace runtime
+}  // namespace nnadapter
@@ -63,9 +63,13 @@ int Execution::SetOutput(int32_t index,
 }
 
 int Execution::Compute() {
-  // TODO(hong19860320) support asynchronously execution
   return compilation_->Execute(&input_arguments_, &output_arguments_);
 }
 
+int Execution::ComputeAsync(Event** event) {
+  return compilation_->ExecuteAsync(
+      &input_arguments_, &output_arguments_, event);
+}
+
 }  // namespace runtime
 }  // namespace nnadapter
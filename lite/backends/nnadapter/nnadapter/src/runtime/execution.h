@@ -34,6 +34,7 @@ class Execution {
                                 NNAdapterOperandType* type,
                                 void* device_buffer));
   int Compute();
+  int ComputeAsync(Event** event);
 
  private:
   Compilation* compilation_{nullptr};
@@ -110,6 +110,10 @@ class NNAdapterWrapper final {
                       NNAdapterOperandType* type,
                       void* device_buffer));
   typedef int (*NNAdapterExecution_compute_fn)(NNAdapterExecution* execution);
+  typedef int (*NNAdapterExecution_computeAsync_fn)(
+      NNAdapterExecution* execution, NNAdapterEvent** event);
+  typedef int (*NNAdapterEvent_wait_fn)(NNAdapterEvent* event);
+  typedef void (*NNAdapterEvent_destroy_fn)(NNAdapterEvent* event);
 
 #define NNADAPTER_DECLARE_FUNCTION(name) name##_fn name;
 
@@ -141,6 +145,9 @@ class NNAdapterWrapper final {
   NNADAPTER_DECLARE_FUNCTION(NNAdapterExecution_setInput)
   NNADAPTER_DECLARE_FUNCTION(NNAdapterExecution_setOutput)
   NNADAPTER_DECLARE_FUNCTION(NNAdapterExecution_compute)
+  NNADAPTER_DECLARE_FUNCTION(NNAdapterExecution_computeAsync)
+  NNADAPTER_DECLARE_FUNCTION(NNAdapterEvent_wait)
+  NNADAPTER_DECLARE_FUNCTION(NNAdapterEvent_destroy)
 #undef NNADAPTER_DECLARE_FUNCTION
 
  private:
@@ -346,5 +353,19 @@ inline int NNAdapterExecution_compute_invoke(NNAdapterExecution* execution) {
   return NNAdapterWrapper::Global().NNAdapterExecution_compute(execution);
 }
 
+inline int NNAdapterExecution_computeAsync_invoke(NNAdapterExecution* execution,
+                                                  NNAdapterEvent** event) {
+  return NNAdapterWrapper::Global().NNAdapterExecution_computeAsync(execution,
+                                                                    event);
+}
+
+inline int NNAdapterEvent_wait_invoke(NNAdapterEvent* event) {
+  return NNAdapterWrapper::Global().NNAdapterEvent_wait(event);
+}
+
+inline void NNAdapterEvent_destroy_invoke(NNAdapterEvent* event) {
+  NNAdapterWrapper::Global().NNAdapterEvent_destroy(event);
+}
+
 }  // namespace lite
 }  // namespace paddle
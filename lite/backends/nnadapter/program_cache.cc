@@ -0,0 +1,144 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/nnadapter/program_cache.h"
+#include <utility>
+#include "lite/utils/env.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+// The max number of the compiled programs kept by the cache
+static const char* NNADAPTER_PROGRAM_CACHE_CAPACITY =
+    "NNADAPTER_PROGRAM_CACHE_CAPACITY";
+static const int kDefaultCapacity = 32;
+
+NNAdapterProgramCache& NNAdapterProgramCache::Global() {
+  // Never destroyed, because the cached programs must be released before the
+  // NNAdapter runtime library is unloaded at exit.
+  static NNAdapterProgramCache* cache = new NNAdapterProgramCache();
+  return *cache;
+}
+
+NNAdapterProgramCache::NNAdapterProgramCache() {
+  int capacity =
+      GetIntFromEnv(NNADAPTER_PROGRAM_CACHE_CAPACITY, kDefaultCapacity);
+  capacity_ = capacity > 0 ? static_cast<size_t>(capacity) : 0;
+}
+
+std::shared_ptr<NNAdapterCompiledProgram> NNAdapterProgramCache::Get(
+    const std::string& key, const BuildFunction& build) {
+  std::shared_future<std::shared_ptr<NNAdapterCompiledProgram>> future;
+  std::promise<std::shared_ptr<NNAdapterCompiledProgram>> promise;
+  uint64_t id = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+      stats_.misses++;
+    } else {
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        auto& entry = it->second;
+        lru_.splice(lru_.begin(), lru_, entry.lru);
+        auto program = entry.program.lock();
+        if (entry.building.valid()) {
+          stats_.hits++;
+          future = entry.building;
+        } else if (program) {
+          stats_.hits++;
+          VLOG(3) << "Found the compiled program " << key << " in the cache.";
+          return program;
+        } else {
+          // All the engines using it were destroyed, compile it again
+          stats_.misses++;
+          entry.building = promise.get_future().share();
+          entry.id = id = ++next_id_;
+        }
+      } else {
+        stats_.misses++;
+        lru_.push_front(key);
+        Entry entry;
+        entry.building = promise.get_future().share();
+        entry.lru = lru_.begin();
+        entry.id = id = ++next_id_;
+        entries_.emplace(key, entry);
+        Evict();
+      }
+    }
+  }
+  if (future.valid()) {
+    VLOG(3) << "Wait for the compiled program " << key << ".";
+    return future.get();
+  }
+  auto program = build();
+  if (id == 0) return program;
+  promise.set_value(program);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end() && it->second.id == id) {
+    if (program) {
+      it->second.program = program;
+      it->second.building = {};
+    } else {
+      // Don't cache the failure, the following lookups try to compile it
+      // again
+      lru_.erase(it->second.lru);
+      entries_.erase(it);
+    }
+  }
+  return program;
+}
+
+void NNAdapterProgramCache::Evict() {
+  while (entries_.size() > capacity_ && !lru_.empty()) {
+    VLOG(3) << "Evict the compiled program " << lru_.back()
+            << " from the cache.";
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+    stats_.evictions++;
+  }
+}
+
+void NNAdapterProgramCache::SetCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  Evict();
+}
+
+size_t NNAdapterProgramCache::Capacity() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+void NNAdapterProgramCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+NNAdapterProgramCacheStats NNAdapterProgramCache::Stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stats = stats_;
+  stats.entries = 0;
+  for (auto& entry : entries_) {
+    if (entry.second.building.valid() || !entry.second.program.expired()) {
+      stats.entries++;
+    }
+  }
+  return stats;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,92 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <future>  // NOLINT
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+namespace paddle {
+namespace lite {
+
+// The base of the compiled programs kept by NNAdapterProgramCache, see
+// kernels/nnadapter/engine.h for the one of the subgraph kernel.
+class NNAdapterCompiledProgram {
+ public:
+  virtual ~NNAdapterCompiledProgram() = default;
+};
+
+struct NNAdapterProgramCacheStats {
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t evictions{0};
+  uint64_t entries{0};
+};
+
+// A process-wide cache of the compiled programs, so that the predictors
+// cloned from or loaded with the same model share the device programs
+// instead of compiling them again. The cache doesn't own the programs, a
+// program is released once the last engine using it is destroyed and the
+// following lookup compiles it again. The least recently used keys are
+// dropped once there are more than `capacity` of them. The capacity is read
+// from NNADAPTER_PROGRAM_CACHE_CAPACITY and 0 disables the cache.
+class NNAdapterProgramCache {
+ public:
+  typedef std::function<std::shared_ptr<NNAdapterCompiledProgram>()>
+      BuildFunction;
+
+  static NNAdapterProgramCache& Global();
+
+  // Returns the program cached with `key`, otherwise calls `build` to compile
+  // it. If several threads miss the same key at the same time, only one of
+  // them compiles the program and the others wait for it. Returns nullptr if
+  // `build` fails.
+  std::shared_ptr<NNAdapterCompiledProgram> Get(const std::string& key,
+                                                const BuildFunction& build);
+  void SetCapacity(size_t capacity);
+  size_t Capacity();
+  void Clear();
+  NNAdapterProgramCacheStats Stats();
+
+ private:
+  NNAdapterProgramCache();
+  NNAdapterProgramCache(const NNAdapterProgramCache&) = delete;
+  NNAdapterProgramCache& operator=(const NNAdapterProgramCache&) = delete;
+  // Drop the least recently used programs, `mutex_` must be held
+  void Evict();
+
+  struct Entry {
+    // Valid while the program is being compiled
+    std::shared_future<std::shared_ptr<NNAdapterCompiledProgram>> building;
+    std::weak_ptr<NNAdapterCompiledProgram> program;
+    std::list<std::string>::iterator lru;
+    uint64_t id{0};
+  };
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // The keys ordered from the most recently used to the least
+  std::list<std::string> lru_;
+  size_t capacity_{0};
+  uint64_t next_id_{0};
+  NNAdapterProgramCacheStats stats_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,133 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/nnadapter/program_cache.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+class FakeProgram : public NNAdapterCompiledProgram {
+ public:
+  explicit FakeProgram(int id) : id_(id) {}
+  int id_{0};
+};
+
+TEST(NNAdapterProgramCache, dedup_concurrent_builds) {
+  auto& cache = NNAdapterProgramCache::Global();
+  cache.SetCapacity(4);
+  cache.Clear();
+  auto base = cache.Stats();
+  std::atomic<int> build_count(0);
+  auto build = [&]() -> std::shared_ptr<NNAdapterCompiledProgram> {
+    build_count++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return std::make_shared<FakeProgram>(1);
+  };
+  std::vector<std::shared_ptr<NNAdapterCompiledProgram>> programs(8);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < programs.size(); i++) {
+    threads.emplace_back(
+        [&, i]() { programs[i] = cache.Get("dedup", build); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(build_count.load(), 1);
+  for (auto& program : programs) {
+    EXPECT_EQ(program.get(), programs[0].get());
+  }
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats.misses - base.misses, 1u);
+  EXPECT_EQ(stats.hits - base.hits, programs.size() - 1);
+  EXPECT_EQ(stats.entries, 1u);
+}
+
+TEST(NNAdapterProgramCache, lru_eviction) {
+  auto& cache = NNAdapterProgramCache::Global();
+  cache.SetCapacity(2);
+  cache.Clear();
+  auto base = cache.Stats();
+  auto build_with = [](int id) {
+    return [id]() -> std::shared_ptr<NNAdapterCompiledProgram> {
+      return std::make_shared<FakeProgram>(id);
+    };
+  };
+  auto a = cache.Get("a", build_with(1));
+  auto old_b = cache.Get("b", build_with(2));
+  // Touch "a", so "b" becomes the least recently used one
+  EXPECT_EQ(cache.Get("a", build_with(3)).get(), a.get());
+  auto c = cache.Get("c", build_with(4));
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats.entries, 2u);
+  EXPECT_EQ(stats.evictions - base.evictions, 1u);
+  EXPECT_EQ(cache.Get("a", build_with(5)).get(), a.get());
+  auto b = cache.Get("b", build_with(6));
+  EXPECT_EQ(static_cast<FakeProgram*>(b.get())->id_, 6);
+}
+
+TEST(NNAdapterProgramCache, released_with_last_owner) {
+  auto& cache = NNAdapterProgramCache::Global();
+  cache.SetCapacity(2);
+  cache.Clear();
+  auto base = cache.Stats();
+  int build_count = 0;
+  std::weak_ptr<NNAdapterCompiledProgram> released;
+  auto build = [&]() -> std::shared_ptr<NNAdapterCompiledProgram> {
+    build_count++;
+    return std::make_shared<FakeProgram>(build_count);
+  };
+  {
+    auto first = cache.Get("owned", build);
+    auto second = cache.Get("owned", build);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(cache.Stats().entries, 1u);
+    released = first;
+  }
+  // The cache doesn't keep the program alive once its owners are destroyed
+  EXPECT_TRUE(released.expired());
+  EXPECT_EQ(cache.Stats().entries, 0u);
+  auto program = cache.Get("owned", build);
+  EXPECT_EQ(static_cast<FakeProgram*>(program.get())->id_, 2);
+  EXPECT_EQ(build_count, 2);
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats.misses - base.misses, 2u);
+  EXPECT_EQ(stats.hits - base.hits, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+}
+
+TEST(NNAdapterProgramCache, failure_not_cached) {
+  auto& cache = NNAdapterProgramCache::Global();
+  cache.SetCapacity(2);
+  cache.Clear();
+  auto failed = cache.Get("failed", []() {
+    return std::shared_ptr<NNAdapterCompiledProgram>();
+  });
+  EXPECT_EQ(failed, nullptr);
+  EXPECT_EQ(cache.Stats().entries, 0u);
+  auto program = cache.Get("failed", []() {
+    return std::shared_ptr<NNAdapterCompiledProgram>(new FakeProgram(1));
+  });
+  EXPECT_NE(program, nullptr);
+  cache.SetCapacity(0);
+  EXPECT_EQ(cache.Stats().entries, 0u);
+}
+
+}  // namespace lite
+}  // namespace paddle
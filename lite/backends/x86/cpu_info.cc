@@ -25,7 +25,16 @@
 #include <unistd.h>
 #endif  // _WIN32
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <ctype.h>
+#include <stdlib.h>
 #include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
 #include "lite/utils/log/cp_logging.h"
 
 #include "lite/utils/env.h"
@@ -167,6 +176,179 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
 }
 #endif
 
+bool ParseCpuList(const std::string& text, std::vector<int>* cpus) {
+  cpus->clear();
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    item.erase(std::remove_if(item.begin(), item.end(), ::isspace),
+               item.end());
+    if (item.empty()) continue;
+    int first = -1;
+    int last = -1;
+    char dash = 0;
+    std::stringstream range(item);
+    range >> first;
+    if (range.fail() || first < 0) return false;
+    last = first;
+    if (range >> dash) {
+      if (dash != '-' || !(range >> last) || last < first) return false;
+    }
+    for (int cpu = first; cpu <= last; cpu++) cpus->push_back(cpu);
+  }
+  return !cpus->empty();
+}
+
+// Formats the cpus as a sysfs cpu list, e.g. "0-3,8"
+static std::string CpuListString(const std::vector<int>& cpus) {
+  std::stringstream ss;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+    if (i > 0) ss << ",";
+    ss << cpus[i];
+    if (j > i) ss << "-" << cpus[j];
+    i = j + 1;
+  }
+  return ss.str();
+}
+
+#if defined(__linux__)
+static bool ReadFirstLine(const std::string& path, std::string* line) {
+  std::ifstream file(path);
+  return file.is_open() && std::getline(file, *line);
+}
+#endif
+
+static CpuTopology DetectCpuTopology() {
+  CpuTopology topology;
+#if defined(__linux__)
+  const std::string sysfs = "/sys/devices/system/";
+  std::string line;
+  if (ReadFirstLine(sysfs + "cpu/online", &line)) {
+    ParseCpuList(line, &topology.cpus);
+  }
+#endif
+  if (topology.cpus.empty()) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int num_cpus = static_cast<int>(info.dwNumberOfProcessors);
+#else
+    int num_cpus = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    for (int cpu = 0; cpu < (std::max)(num_cpus, 1); cpu++) {
+      topology.cpus.push_back(cpu);
+    }
+  }
+  int max_cpu = *std::max_element(topology.cpus.begin(), topology.cpus.end());
+  topology.socket_of_cpu.assign(max_cpu + 1, -1);
+  topology.numa_node_of_cpu.assign(max_cpu + 1, -1);
+  std::set<int> sockets;
+  std::set<std::pair<int, int>> cores;
+  for (int cpu : topology.cpus) {
+    int socket = 0;
+    int core = cpu;
+#if defined(__linux__)
+    auto cpu_dir = sysfs + "cpu/cpu" + std::to_string(cpu) + "/topology/";
+    if (ReadFirstLine(cpu_dir + "physical_package_id", &line)) {
+      socket = std::max(atoi(line.c_str()), 0);
+    }
+    if (ReadFirstLine(cpu_dir + "core_id", &line)) {
+      core = atoi(line.c_str());
+    }
+#endif
+    topology.socket_of_cpu[cpu] = socket;
+    sockets.insert(socket);
+    cores.insert(std::make_pair(socket, core));
+  }
+  topology.num_sockets = static_cast<int>(sockets.size());
+  topology.num_physical_cores = static_cast<int>(cores.size());
+
+#if defined(__linux__)
+  std::vector<int> nodes;
+  if (ReadFirstLine(sysfs + "node/online", &line) &&
+      ParseCpuList(line, &nodes)) {
+    topology.numa_node_cpus.resize(nodes.back() + 1);
+    for (int node : nodes) {
+      std::vector<int> node_cpus;
+      auto path = sysfs + "node/node" + std::to_string(node) + "/cpulist";
+      if (!ReadFirstLine(path, &line) || !ParseCpuList(line, &node_cpus)) {
+        continue;
+      }
+      for (int cpu : node_cpus) {
+        if (cpu > max_cpu || topology.socket_of_cpu[cpu] < 0) continue;
+        topology.numa_node_of_cpu[cpu] = node;
+        topology.numa_node_cpus[node].push_back(cpu);
+      }
+    }
+  }
+#endif
+  if (topology.numa_node_cpus.empty()) {
+    topology.numa_node_cpus.push_back(topology.cpus);
+    for (int cpu : topology.cpus) topology.numa_node_of_cpu[cpu] = 0;
+  }
+  return topology;
+}
+
+const CpuTopology& GetCpuTopology() {
+  static const CpuTopology topology = DetectCpuTopology();
+  return topology;
+}
+
+std::string CpuTopology::ToString() const {
+  std::stringstream ss;
+  ss << num_sockets << " sockets, " << num_physical_cores << " cores, "
+     << cpus.size() << " cpus";
+  for (size_t node = 0; node < numa_node_cpus.size(); node++) {
+    if (numa_node_cpus[node].empty()) continue;
+    ss << ", node" << node << ": " << CpuListString(numa_node_cpus[node]);
+  }
+  return ss.str();
+}
+
+int ResolveAffinity(const std::vector<int>& cpu_ids,
+                    int numa_node,
+                    std::vector<int>* cpus) {
+  const auto& topology = GetCpuTopology();
+  cpus->clear();
+  for (int cpu : cpu_ids) {
+    if (cpu < 0 || cpu >= static_cast<int>(topology.socket_of_cpu.size()) ||
+        topology.socket_of_cpu[cpu] < 0) {
+      LOG(WARNING) << "Cpu " << cpu << " is not online, ignored";
+      continue;
+    }
+    cpus->push_back(cpu);
+  }
+  if (numa_node >= static_cast<int>(topology.numa_node_cpus.size()) ||
+      (numa_node >= 0 && topology.numa_node_cpus[numa_node].empty())) {
+    LOG(WARNING) << "NUMA node " << numa_node << " has no cpu, ignored";
+    numa_node = -1;
+  }
+  if (cpus->empty() && numa_node >= 0) {
+    *cpus = topology.numa_node_cpus[numa_node];
+  }
+  if (numa_node < 0 && !cpus->empty()) {
+    numa_node = topology.numa_node_of_cpu[cpus->front()];
+  }
+  return numa_node;
+}
+
+bool BindCurrentThread(const std::vector<int>& cpu_ids) {
+#if defined(__linux__) && defined(CPU_SET)
+  if (cpu_ids.empty()) return false;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpu_ids) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    CPU_SET(cpu, &mask);
+  }
+  return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
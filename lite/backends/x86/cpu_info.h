@@ -15,6 +15,8 @@
 #pragma once
 
 #include <stddef.h>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #if defined(__AVX2__)
@@ -75,6 +77,40 @@ typedef enum {
 // May I use some instruction
 bool MayIUse(const cpu_isa_t cpu_isa);
 
+// The CPUs of the machine, read from sysfs on Linux. Elsewhere all of the
+// CPUs are reported as one socket and one NUMA node.
+struct CpuTopology {
+  // The online logical CPUs
+  std::vector<int> cpus;
+  // Indexed by the logical CPU id, -1 for the offline ones
+  std::vector<int> socket_of_cpu;
+  std::vector<int> numa_node_of_cpu;
+  // The CPUs of every NUMA node, indexed by the node id
+  std::vector<std::vector<int>> numa_node_cpus;
+  int num_sockets{1};
+  int num_physical_cores{0};
+
+  // e.g. "2 sockets, 32 cores, 64 cpus, node0: 0-15,32-47, node1: ..."
+  std::string ToString() const;
+};
+
+// Detected once and cached.
+const CpuTopology& GetCpuTopology();
+
+// Parses a sysfs cpu list such as "0-3,8,10-11", returns false if malformed.
+bool ParseCpuList(const std::string& text, std::vector<int>* cpus);
+
+// Resolves the CPUs and the NUMA node of a predictor, see
+// ConfigBase::set_x86_cpu_affinity and set_x86_numa_node. The CPUs that are
+// not online are dropped. Returns the node, -1 if there is none.
+int ResolveAffinity(const std::vector<int>& cpu_ids,
+                    int numa_node,
+                    std::vector<int>* cpus);
+
+// Pins the calling thread to `cpu_ids`, returns false if it fails or is not
+// supported on this system.
+bool BindCurrentThread(const std::vector<int>& cpu_ids);
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
@@ -13,6 +13,7 @@
  * limitations under the License. */
 
 #include "lite/backends/x86/jit/gen_base.h"
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -56,7 +57,12 @@ void GenBase::dumpCode(const unsigned char* code) const {
   }
 }
 
+static std::atomic<int64_t> num_generated{0};
+
+int64_t GenBase::NumGenerated() { return num_generated.load(); }
+
 void* GenBase::operator new(size_t size) {
+  num_generated++;
   void* ptr;
   constexpr size_t alignment = 32ul;
 #ifdef _WIN32
@@ -47,6 +47,8 @@ class GenBase : public Kernel {
 
   void* operator new(size_t size);
   void operator delete(void* ptr);
+  // The number of jit codes generated by the process so far.
+  static int64_t NumGenerated();
   void* operator new[](size_t size) { return operator new(size); }
   void operator delete[](void* ptr) { operator delete(ptr); }
 
@@ -17,6 +17,7 @@ limitations under the License. */
 #include "lite/backends/x86/math/avx/conv_depthwise_pack8.h"
 #include "lite/backends/x86/math/avx/conv_utils.h"
 #include "lite/backends/x86/math/conv_depthwise_impl.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/memory.h"
 #ifdef __AVX__
 #include <immintrin.h>
@@ -56,8 +57,6 @@ void conv_depthwise_3x3s2_p01_direct(
   float *zero_ptr = static_cast<float *>(
       TargetMalloc(TARGET(kX86), Max(w_in * sizeof(float), 8 * sizeof(float))));
   memset(zero_ptr, 0, Max(w_in * sizeof(float), 8 * sizeof(float)));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
 
   //! prepare for processing right result
   int rmask_o[4] = {0};
@@ -93,11 +92,16 @@ void conv_depthwise_3x3s2_p01_direct(
   __m128 zero = _mm_set1_ps(0.f);
   __m256 zero_256 = _mm256_set1_ps(0.f);
 
-  for (int n = 0; n < num; ++n) {
-    const float *din_batch = din + n * ch_in * size_in_channel;
-    float *dout_batch = dout + n * ch_in * size_out_channel;
-
-    for (int c = 0; c < ch_in; c++) {
+  // split the channels of all images across threads, every thread dumps
+  // the rows past the output into its own buffer
+  RunParallelFor(0, num * ch_in, [&](int64_t begin, int64_t end) {
+    float *write_ptr =
+        static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+    for (int64_t idx = begin; idx < end; idx++) {
+      int n = idx / ch_in;
+      int c = idx % ch_in;
+      const float *din_batch = din + n * ch_in * size_in_channel;
+      float *dout_batch = dout + n * ch_in * size_out_channel;
       float *dout_ptr = dout_batch + c * size_out_channel;
       const float *din_ch_ptr = din_batch + c * size_in_channel;
 
@@ -332,9 +336,9 @@ void conv_depthwise_3x3s2_p01_direct(
         }
       }
     }
-  }
+    TargetFree(TARGET(kX86), write_ptr);
+  });
   TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #else
   bool right = false;  // for right result
 
@@ -344,8 +348,6 @@ void conv_depthwise_3x3s2_p01_direct(
   float *zero_ptr = static_cast<float *>(TargetMalloc(
       TARGET(kX86), Max(w_in * sizeof(float), 12 * sizeof(float))));
   memset(zero_ptr, 0, Max(w_in * sizeof(float), 12 * sizeof(float)));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
 
   //! prepare for processing right result
   float rmasko[4] = {1.f, 1.f, 1.f, 1.f};
@@ -379,11 +381,16 @@ void conv_depthwise_3x3s2_p01_direct(
 
   __m128 zero = _mm_set1_ps(0.f);
 
-  for (int n = 0; n < num; ++n) {
-    const float *din_batch = din + n * ch_in * size_in_channel;
-    float *dout_batch = dout + n * ch_in * size_out_channel;
-
-    for (int c = 0; c < ch_in; c++) {
+  // split the channels of all images across threads, every thread dumps
+  // the rows past the output into its own buffer
+  RunParallelFor(0, num * ch_in, [&](int64_t begin, int64_t end) {
+    float *write_ptr =
+        static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+    for (int64_t idx = begin; idx < end; idx++) {
+      int n = idx / ch_in;
+      int c = idx % ch_in;
+      const float *din_batch = din + n * ch_in * size_in_channel;
+      float *dout_batch = dout + n * ch_in * size_out_channel;
       float *dout_ptr = dout_batch + c * size_out_channel;
       const float *din_ch_ptr = din_batch + c * size_in_channel;
 
@@ -604,9 +611,9 @@ void conv_depthwise_3x3s2_p01_direct(
         }
       }
     }
-  }
+    TargetFree(TARGET(kX86), write_ptr);
+  });
   TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #endif
 }
 void conv_depthwise_3x3s1_p01_direct(
@@ -633,8 +640,6 @@ void conv_depthwise_3x3s1_p01_direct(
   float *zero_ptr = static_cast<float *>(
       TargetMalloc(TARGET(kX86), Max(w_in * sizeof(float), 8)));
   memset(zero_ptr, 0, Max(w_in * sizeof(float), 8));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
 
   //! prepare for processing right result
   int rmask_o[8] = {0, 0, 0, 0, 0, 0, 0, 0};
@@ -668,11 +673,16 @@ void conv_depthwise_3x3s1_p01_direct(
 
   __m256 zero = _mm256_set1_ps(0.f);
 
-  for (int n = 0; n < num; ++n) {
-    const float *din_batch = din + n * ch_in * size_in_channel;
-    float *dout_batch = dout + n * ch_in * size_out_channel;
-
-    for (int c = 0; c < ch_in; c++) {
+  // split the channels of all images across threads, every thread dumps
+  // the rows past the output into its own buffer
+  RunParallelFor(0, num * ch_in, [&](int64_t begin, int64_t end) {
+    float *write_ptr =
+        static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+    for (int64_t idx = begin; idx < end; idx++) {
+      int n = idx / ch_in;
+      int c = idx % ch_in;
+      const float *din_batch = din + n * ch_in * size_in_channel;
+      float *dout_batch = dout + n * ch_in * size_out_channel;
       float *dout_ptr = dout_batch + c * size_out_channel;
       const float *din_ch_ptr = din_batch + c * size_in_channel;
 
@@ -1001,10 +1011,9 @@ void conv_depthwise_3x3s1_p01_direct(
         }
       }
     }
-  }
-
+    TargetFree(TARGET(kX86), write_ptr);
+  });
   TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #else
   bool right = false;  // for right result
 
@@ -1014,8 +1023,6 @@ void conv_depthwise_3x3s1_p01_direct(
   float *zero_ptr = static_cast<float *>(
       TargetMalloc(TARGET(kX86), Max(w_in * sizeof(float), 8)));
   memset(zero_ptr, 0, Max(w_in * sizeof(float), 8));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
 
   //! prepare for processing right result
   float rmasko[4] = {1.f, 1.f, 1.f, 1.f};
@@ -1049,11 +1056,16 @@ void conv_depthwise_3x3s1_p01_direct(
 
   __m128 zero = _mm_set1_ps(0.f);
 
-  for (int n = 0; n < num; ++n) {
-    const float *din_batch = din + n * ch_in * size_in_channel;
-    float *dout_batch = dout + n * ch_in * size_out_channel;
-
-    for (int c = 0; c < ch_in; c++) {
+  // split the channels of all images across threads, every thread dumps
+  // the rows past the output into its own buffer
+  RunParallelFor(0, num * ch_in, [&](int64_t begin, int64_t end) {
+    float *write_ptr =
+        static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+    for (int64_t idx = begin; idx < end; idx++) {
+      int n = idx / ch_in;
+      int c = idx % ch_in;
+      const float *din_batch = din + n * ch_in * size_in_channel;
+      float *dout_batch = dout + n * ch_in * size_out_channel;
       float *dout_ptr = dout_batch + c * size_out_channel;
       const float *din_ch_ptr = din_batch + c * size_in_channel;
 
@@ -1318,9 +1330,9 @@ void conv_depthwise_3x3s1_p01_direct(
         }
       }
     }
-  }
+    TargetFree(TARGET(kX86), write_ptr);
+  });
   TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #endif
 }
 
@@ -19,6 +19,7 @@ limitations under the License. */
 #include "lite/backends/x86/math/avx/conv_utils.h"
 #include "lite/backends/x86/math/conv_depthwise_impl.h"
 #include "lite/backends/x86/math/sse/conv_utils.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/memory.h"
 
 namespace paddle {
@@ -51,11 +52,6 @@ void conv_depthwise_5x5s1(const float* din,
   int channel_num = ROUNDUP(ch_in, block_channel);
   float* pack_weight = static_cast<float*>(
       TargetMalloc(TARGET(kX86), channel_num * 5 * 5 * sizeof(float)));
-  float* pack_input = static_cast<float*>(TargetMalloc(
-      TARGET(kX86),
-      (h_in + 2 * pad) * (w_in + 2 * pad) * block_channel * sizeof(float)));
-  float* pack_out = static_cast<float*>(TargetMalloc(
-      TARGET(kX86), h_out * w_out * block_channel * sizeof(float)));
 
 #ifdef __AVX__
   packC8_common(weights, pack_weight, {0, 0, 0, 0}, 5, 5, ch_in);
@@ -63,11 +59,20 @@ void conv_depthwise_5x5s1(const float* din,
   packC4_common(weights, pack_weight, {0, 0, 0, 0}, 5, 5, ch_in);
 #endif
 
-  for (int n = 0; n < num; n++) {
-    const float* din_batch = din + n * ch_in * size_in_channel;
-    float* dout_batch = dout + n * ch_out * size_out_channel;
-
-    for (int c = 0; c < ch_out; c += block_channel) {
+  // split the channel blocks of all images across threads, every thread
+  // packs into its own buffers
+  const int c_blocks = channel_num / block_channel;
+  RunParallelFor(0, num * c_blocks, [&](int64_t begin, int64_t end) {
+    float* pack_input = static_cast<float*>(TargetMalloc(
+        TARGET(kX86),
+        (h_in + 2 * pad) * (w_in + 2 * pad) * block_channel * sizeof(float)));
+    float* pack_out = static_cast<float*>(TargetMalloc(
+        TARGET(kX86), h_out * w_out * block_channel * sizeof(float)));
+    for (int64_t idx = begin; idx < end; idx++) {
+      int n = idx / c_blocks;
+      int c = idx % c_blocks * block_channel;
+      const float* din_batch = din + n * ch_in * size_in_channel;
+      float* dout_batch = dout + n * ch_out * size_out_channel;
       int real_block_channel = Min(block_channel, ch_out - c);
       auto* dout_ptr = dout_batch + c * size_out_channel;
       auto* din_ptr = din_batch + c * size_in_channel;
@@ -401,11 +406,11 @@ void conv_depthwise_5x5s1(const float* din,
       unpackC4_common(pack_out, dout_ptr, size_out_channel, real_block_channel);
 #endif
     }
-  }
+    TargetFree(TARGET(kX86), pack_input);
+    TargetFree(TARGET(kX86), pack_out);
+  });
 
   TargetFree(TARGET(kX86), pack_weight);
-  TargetFree(TARGET(kX86), pack_input);
-  TargetFree(TARGET(kX86), pack_out);
 }
 void conv_depthwise_5x5s2(const float* din,
                           float* dout,
@@ -431,11 +436,6 @@ void conv_depthwise_5x5s2(const float* din,
   int channel_num = ROUNDUP(ch_in, block_channel);
   float* pack_weight = static_cast<float*>(
       TargetMalloc(TARGET(kX86), channel_num * 5 * 5 * sizeof(float)));
-  float* pack_input = static_cast<float*>(TargetMalloc(
-      TARGET(kX86),
-      (h_in + 2 * pad) * (w_in + 2 * pad) * block_channel * sizeof(float)));
-  float* pack_out = static_cast<float*>(TargetMalloc(
-      TARGET(kX86), h_out * w_out * block_channel * sizeof(float)));
 
 #ifdef __AVX__
   packC8_common(weights, pack_weight, {0, 0, 0, 0}, 5, 5, ch_in);
@@ -443,11 +443,20 @@ void conv_depthwise_5x5s2(const float* din,
   packC4_common(weights, pack_weight, {0, 0, 0, 0}, 5, 5, ch_in);
 #endif
 
-  for (int n = 0; n < num; n++) {
-    const float* din_batch = din + n * ch_in * size_in_channel;
-    float* dout_batch = dout + n * ch_out * size_out_channel;
-
-    for (int c = 0; c < ch_out; c += block_channel) {
+  // split the channel blocks of all images across threads, every thread
+  // packs into its own buffers
+  const int c_blocks = channel_num / block_channel;
+  RunParallelFor(0, num * c_blocks, [&](int64_t begin, int64_t end) {
+    float* pack_input = static_cast<float*>(TargetMalloc(
+        TARGET(kX86),
+        (h_in + 2 * pad) * (w_in + 2 * pad) * block_channel * sizeof(float)));
+    float* pack_out = static_cast<float*>(TargetMalloc(
+        TARGET(kX86), h_out * w_out * block_channel * sizeof(float)));
+    for (int64_t idx = begin; idx < end; idx++) {
+      int n = idx / c_blocks;
+      int c = idx % c_blocks * block_channel;
+      const float* din_batch = din + n * ch_in * size_in_channel;
+      float* dout_batch = dout + n * ch_out * size_out_channel;
       int real_block_channel = Min(block_channel, ch_out - c);
       auto* dout_ptr = dout_batch + c * size_out_channel;
       auto* din_ptr = din_batch + c * size_in_channel;
@@ -796,11 +805,11 @@ void conv_depthwise_5x5s2(const float* din,
       unpackC4_common(pack_out, dout_ptr, size_out_channel, real_block_channel);
 #endif
     }
-  }
+    TargetFree(TARGET(kX86), pack_input);
+    TargetFree(TARGET(kX86), pack_out);
+  });
 
   TargetFree(TARGET(kX86), pack_weight);
-  TargetFree(TARGET(kX86), pack_input);
-  TargetFree(TARGET(kX86), pack_out);
 }
 
 }  // namespace math
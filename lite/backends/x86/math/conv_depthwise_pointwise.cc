@@ -0,0 +1,201 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_depthwise_pointwise.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Half of a typical L2, the rest is left to the filter and the output rows
+static const int64_t kTileBytes = 128 * 1024;
+
+int depthwise_pointwise_tile_rows(
+    int batch, int channels, int out_h, int out_w, int threads) {
+  int64_t row_bytes = static_cast<int64_t>(channels) * out_w * sizeof(float);
+  int rows = static_cast<int>(
+      (std::min)(static_cast<int64_t>(out_h),
+                 kTileBytes / (std::max)(row_bytes, int64_t(1))));
+  // Enough tiles for all the threads
+  int tiles_per_image = (threads + batch - 1) / batch;
+  rows = (std::min)(rows, (out_h + tiles_per_image - 1) / tiles_per_image);
+  return (std::max)(rows, 1);
+}
+
+void conv_depthwise_rows(const float* src,
+                         int in_h,
+                         int in_w,
+                         const float* weights,
+                         int kernel_h,
+                         int kernel_w,
+                         int stride_h,
+                         int stride_w,
+                         int pad_top,
+                         int pad_left,
+                         int out_w,
+                         int row_begin,
+                         int row_end,
+                         float* dst) {
+  std::memset(dst, 0, sizeof(float) * (row_end - row_begin) * out_w);
+  // The columns whose taps at kx fall inside the input
+  auto col_begin = [&](int kx) {
+    int first = pad_left - kx;
+    return first <= 0 ? 0 : (first + stride_w - 1) / stride_w;
+  };
+  auto col_end = [&](int kx) {
+    int last = in_w - 1 + pad_left - kx;
+    return last < 0 ? 0 : (std::min)(out_w, last / stride_w + 1);
+  };
+  for (int oh = row_begin; oh < row_end; oh++) {
+    float* dst_row = dst + (oh - row_begin) * out_w;
+    for (int ky = 0; ky < kernel_h; ky++) {
+      int ih = oh * stride_h - pad_top + ky;
+      if (ih < 0 || ih >= in_h) continue;
+      const float* src_row = src + ih * in_w;
+      for (int kx = 0; kx < kernel_w; kx++) {
+        const float w = weights[ky * kernel_w + kx];
+        const int begin = col_begin(kx);
+        const int end = col_end(kx);
+        if (begin >= end) continue;
+        const float* src_tap = src_row + begin * stride_w - pad_left + kx;
+        float* dst_tap = dst_row + begin;
+        if (stride_w == 1) {
+          for (int i = 0; i < end - begin; i++) {
+            dst_tap[i] += w * src_tap[i];
+          }
+        } else {
+          for (int i = 0; i < end - begin; i++) {
+            dst_tap[i] += w * src_tap[i * stride_w];
+          }
+        }
+      }
+    }
+  }
+}
+
+void conv_depthwise_pointwise(
+    const operators::DepthwisePointwiseConvParam& param,
+    const X86Context& ctx,
+    int tile_rows,
+    float* buffer,
+    int num_buffers) {
+  const auto& x_dims = param.x->dims();
+  const auto& dw_dims = param.dw_filter->dims();
+  const auto& out_dims = param.output->dims();
+  const int batch = x_dims[0];
+  const int channels = x_dims[1];
+  const int in_h = x_dims[2];
+  const int in_w = x_dims[3];
+  const int kernel_h = dw_dims[2];
+  const int kernel_w = dw_dims[3];
+  const int out_channels = out_dims[1];
+  const int out_h = out_dims[2];
+  const int out_w = out_dims[3];
+  const int64_t in_size = static_cast<int64_t>(in_h) * in_w;
+  const int64_t out_size = static_cast<int64_t>(out_h) * out_w;
+  const int64_t tile_size = static_cast<int64_t>(channels) * tile_rows * out_w;
+  const int tiles = (out_h + tile_rows - 1) / tile_rows;
+  const int64_t tasks = static_cast<int64_t>(batch) * tiles;
+  const int64_t tasks_per_buffer = (tasks + num_buffers - 1) / num_buffers;
+
+  const float* x = param.x->data<float>();
+  const float* dw_filter = param.dw_filter->data<float>();
+  const float* dw_bias = param.dw_bias ? param.dw_bias->data<float>() : nullptr;
+  const float* pw_filter = param.pw_filter->data<float>();
+  const float* pw_bias = param.pw_bias ? param.pw_bias->data<float>() : nullptr;
+  const float* residual =
+      param.residual ? param.residual->data<float>() : nullptr;
+  float* out = param.output->mutable_data<float>();
+
+  Blas<lite::TargetType::kX86> matmul(ctx);
+  RunParallelFor(0, num_buffers, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      float* tile = buffer + b * tile_size;
+      const int64_t task_end = (std::min)(tasks, (b + 1) * tasks_per_buffer);
+      for (int64_t task = b * tasks_per_buffer; task < task_end; task++) {
+        const int n = task / tiles;
+        const int row_begin = (task % tiles) * tile_rows;
+        const int row_end = (std::min)(out_h, row_begin + tile_rows);
+        const int cols = (row_end - row_begin) * out_w;
+        const float* x_n = x + n * channels * in_size;
+        for (int c = 0; c < channels; c++) {
+          conv_depthwise_rows(x_n + c * in_size,
+                              in_h,
+                              in_w,
+                              dw_filter + c * kernel_h * kernel_w,
+                              kernel_h,
+                              kernel_w,
+                              param.strides[0],
+                              param.strides[1],
+                              param.paddings[0],
+                              param.paddings[2],
+                              out_w,
+                              row_begin,
+                              row_end,
+                              tile + c * cols);
+        }
+        fill_bias_act(tile,
+                      dw_bias,
+                      channels,
+                      cols,
+                      dw_bias != nullptr,
+                      &param.dw_activation_param);
+
+        // The rows of every output channel are strided by the whole plane
+        const int64_t offset =
+            n * out_channels * out_size + row_begin * out_w;
+        float* out_tile = out + offset;
+        matmul.GEMM<float>(false,
+                           false,
+                           out_channels,
+                           cols,
+                           channels,
+                           1.f,
+                           pw_filter,
+                           channels,
+                           tile,
+                           cols,
+                           0.f,
+                           out_tile,
+                           out_size);
+        for (int oc = 0; oc < out_channels; oc++) {
+          float* out_row = out_tile + oc * out_size;
+          fill_bias_act(out_row,
+                        pw_bias ? pw_bias + oc : nullptr,
+                        1,
+                        cols,
+                        pw_bias != nullptr,
+                        &param.pw_activation_param);
+          if (residual) {
+            const float* residual_row = residual + offset + oc * out_size;
+            for (int i = 0; i < cols; i++) {
+              out_row[i] += residual_row[i];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/core/context.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Rows of the output a tile covers. The depthwise output of a tile, all of
+// the channels of these rows, stays in L2 between the depthwise conv and the
+// 1x1 GEMM. Tiles get smaller when there are fewer of them than threads.
+int depthwise_pointwise_tile_rows(
+    int batch, int channels, int out_h, int out_w, int threads);
+
+// Computes the output rows [row_begin, row_end) of a depthwise conv of one
+// channel without bias, dst holds (row_end - row_begin) * out_w floats.
+void conv_depthwise_rows(const float* src,
+                         int in_h,
+                         int in_w,
+                         const float* weights,
+                         int kernel_h,
+                         int kernel_w,
+                         int stride_h,
+                         int stride_w,
+                         int pad_top,
+                         int pad_left,
+                         int out_w,
+                         int row_begin,
+                         int row_end,
+                         float* dst);
+
+// Runs the fused depthwise and 1x1 convs of `param` over tiles of
+// `tile_rows` output rows. The depthwise output of a tile is consumed by the
+// GEMM right after it is computed instead of going through memory. `buffer`
+// holds `num_buffers` depthwise tiles, one per thread.
+void conv_depthwise_pointwise(
+    const operators::DepthwisePointwiseConvParam& param,
+    const X86Context& ctx,
+    int tile_rows,
+    float* buffer,
+    int num_buffers);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
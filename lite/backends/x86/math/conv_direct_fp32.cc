@@ -23,6 +23,7 @@ limitations under the License. */
 #include <emmintrin.h>
 #endif
 #include "lite/backends/x86/math/conv_direct_fp32.h"
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
@@ -334,72 +335,72 @@ void conv_direct::run(const float* i_data,
 
   // strideh *
   if (iw >= 224) {
-    // fetch bs_i th input feature map
-    for (int bs_i = 0; bs_i < bs; bs_i++) {
-      // calculate the result of each line of output
-      auto cal_out_line = [=](const float* in_row_addr,
-                              const float* trans_weight,
-                              float* out_row_addr,
-                              int wh) {
-        for (int ic_i = 0; ic_i < ic; ic_i += ic_block) {
-          for (int oc_gi = 0; oc_gi < oc; oc_gi += oc_block) {
-            jit_param param;
-            param.in_row_addr = in_row_addr + ic_i * ihw;
-            param.kernel_addr =
-                trans_weight + oc_gi / BLOCK * whwB * wc + ic_i * whwB;
-            param.out_row_addr = out_row_addr + oc_gi * oh * ow;
-            param.oc = oc_gi + oc_block - 1 < oc ? oc_block : oc - oc_gi;
-            param.ic = ic_i + ic_block - 1 < ic ? ic_block : ic - ic_i;
-            param.wh = wh;
+    // calculate the result of each line of output
+    auto cal_out_line = [=](const float* in_row_addr,
+                            const float* trans_weight,
+                            float* out_row_addr,
+                            int wh) {
+      for (int ic_i = 0; ic_i < ic; ic_i += ic_block) {
+        for (int oc_gi = 0; oc_gi < oc; oc_gi += oc_block) {
+          jit_param param;
+          param.in_row_addr = in_row_addr + ic_i * ihw;
+          param.kernel_addr =
+              trans_weight + oc_gi / BLOCK * whwB * wc + ic_i * whwB;
+          param.out_row_addr = out_row_addr + oc_gi * oh * ow;
+          param.oc = oc_gi + oc_block - 1 < oc ? oc_block : oc - oc_gi;
+          param.ic = ic_i + ic_block - 1 < ic ? ic_block : ic - ic_i;
+          param.wh = wh;
 
-            void (*f)(jit_param*) =
-                CodeGenerator::getCode<void (*)(jit_param*)>();
-            f(&param);
-          }
+          void (*f)(jit_param*) =
+              CodeGenerator::getCode<void (*)(jit_param*)>();
+          f(&param);
         }
-      };
-
-      const float* in_row_addr = i_data + bs_i * ichw;
-      float* out_row_addr = trans_out + bs_i * ochw;
-
-      int oh_i = 0;
-      if (ph > 0) {  // upper boundry
-        int temp_wh =
-            wh - ph;  // we olny need deal with temp_wh rows not wh rows!
-
-        // check if the kernel will occupy lower boundry
-        // if so, we need decrease temp_wh again
-        if (ih + ph < wh) temp_wh -= (wh - ih - ph);
-        cal_out_line(
-            in_row_addr, trans_weight + ph * ww * BLOCK, out_row_addr, temp_wh);
-        oh_i++;
-        in_row_addr += (strideh - ph) * iw;
-        out_row_addr += ow * BLOCK;
-      }
-      // middle
-      for (; oh_i < oh - 1; oh_i++) {
-        cal_out_line(in_row_addr, trans_weight, out_row_addr, wh);
-        out_row_addr += ow * BLOCK;
-        in_row_addr += strideh * iw;
       }
+    };
 
-      if (oh_i >= oh) continue;
-
-      // lower boundary,
-      // compute how many boundry rows is used to the lowerest output row
-      int lower = strideh * (oh - 1) + wh - ph - ih;
+    // every output line of every image is independent, split them across
+    // threads
+    RunParallelFor(0, bs * oh, [&](int64_t begin, int64_t end) {
+      for (int64_t idx = begin; idx < end; idx++) {
+        int bs_i = idx / oh;
+        int oh_i = idx % oh;
+        const float* in_row_addr = i_data + bs_i * ichw;
+        float* out_row_addr = trans_out + bs_i * ochw + oh_i * ow * BLOCK;
+
+        if (oh_i == 0 && ph > 0) {  // upper boundry
+          int temp_wh =
+              wh - ph;  // we olny need deal with temp_wh rows not wh rows!
+
+          // check if the kernel will occupy lower boundry
+          // if so, we need decrease temp_wh again
+          if (ih + ph < wh) temp_wh -= (wh - ih - ph);
+          cal_out_line(in_row_addr,
+                       trans_weight + ph * ww * BLOCK,
+                       out_row_addr,
+                       temp_wh);
+          continue;
+        }
 
-      if (lower > 0) {
-        cal_out_line(in_row_addr, trans_weight, out_row_addr, wh - lower);
-      } else {
-        cal_out_line(in_row_addr, trans_weight, out_row_addr, wh);
+        in_row_addr += (oh_i * strideh - ph) * iw;
+        int rows = wh;
+        if (oh_i == oh - 1) {
+          // lower boundary,
+          // compute how many boundry rows is used to the lowerest output row
+          int lower = strideh * (oh - 1) + wh - ph - ih;
+          if (lower > 0) rows -= lower;
+        }
+        cal_out_line(in_row_addr, trans_weight, out_row_addr, rows);
       }
-    }
+    });
   } else {
-    // fetch bs_i th input feature map
-    for (int bs_i = 0; bs_i < bs; bs_i++) {
-      for (int ic_i = 0; ic_i < ic; ic_i += ic_block) {
-        for (int oc_gi = 0; oc_gi < oc; oc_gi += oc_block) {
+    // the output channel blocks of every image are independent, the input
+    // channels are accumulated in order inside one block
+    const int oc_blocks = (oc + oc_block - 1) / oc_block;
+    RunParallelFor(0, bs * oc_blocks, [&](int64_t begin, int64_t end) {
+      for (int64_t idx = begin; idx < end; idx++) {
+        int bs_i = idx / oc_blocks;
+        int oc_gi = idx % oc_blocks * oc_block;
+        for (int ic_i = 0; ic_i < ic; ic_i += ic_block) {
           const float* in_row_addr = i_data + bs_i * ichw + ic_i * ihw;
           float* out_row_addr = trans_out + bs_i * ochw + oc_gi * oh * ow;
           const float* weight =
@@ -461,7 +462,7 @@ void conv_direct::run(const float* i_data,
           }
         }
       }
-    }
+    });
   }
 }
 
@@ -485,9 +486,11 @@ void conv_direct_transpose_out(int bs,
   int ohw = oh * ow;
   int ochw = oc * oh * ow;
 
-  // fetch bs_i th input feature map
-  for (int bs_i = 0; bs_i < bs; bs_i++) {
-    for (int oc_gi = 0; oc_gi < oc; oc_gi += BLOCK) {
+  const int oc_blocks = (oc + BLOCK - 1) / BLOCK;
+  RunParallelFor(0, bs * oc_blocks, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      int bs_i = idx / oc_blocks;
+      int oc_gi = idx % oc_blocks * BLOCK;
       // trans_out's start_index, we need fetch 8x8 element;
       float* from_address = trans_out + bs_i * oc * ohw + oc_gi * ohw;
       float* dst_address = o_data + bs_i * ochw + oc_gi * ohw;
@@ -806,7 +809,7 @@ void conv_direct_transpose_out(int bs,
         }
       }
     }
-  }
+  });
 }
 }  // namespace math
 }  // namespace x86
@@ -0,0 +1,473 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/elementwise_chain.h"
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// 4KB per tile, the running value stays in L1 while all steps run on it.
+static constexpr int64_t kTileSize = 1024;
+// Tensors smaller than this run on the calling thread
+static constexpr int64_t kParallelThreshold = 1 << 16;
+
+bool GetChainOpType(const std::string& op_type, ChainOpType* type) {
+  static const std::map<std::string, ChainOpType> kChainOps{
+      {"elementwise_add", ChainOpType::kAdd},
+      {"elementwise_sub", ChainOpType::kSub},
+      {"elementwise_mul", ChainOpType::kMul},
+      {"elementwise_div", ChainOpType::kDiv},
+      {"elementwise_max", ChainOpType::kMax},
+      {"elementwise_min", ChainOpType::kMin},
+      {"relu", ChainOpType::kRelu},
+      {"relu6", ChainOpType::kRelu6},
+      {"leaky_relu", ChainOpType::kLeakyRelu},
+      {"sigmoid", ChainOpType::kSigmoid},
+      {"tanh", ChainOpType::kTanh},
+      {"swish", ChainOpType::kSwish},
+      {"hard_swish", ChainOpType::kHardSwish},
+      {"hard_sigmoid", ChainOpType::kHardSigmoid},
+      {"gelu", ChainOpType::kGelu},
+      {"exp", ChainOpType::kExp},
+      {"abs", ChainOpType::kAbs},
+      {"square", ChainOpType::kSquare},
+      {"sqrt", ChainOpType::kSqrt},
+      {"scale", ChainOpType::kScale}};
+  auto it = kChainOps.find(op_type);
+  if (it == kChainOps.end()) return false;
+  *type = it->second;
+  return true;
+}
+
+bool IsBinaryChainOp(ChainOpType type) {
+  return static_cast<int>(type) <= static_cast<int>(ChainOpType::kMin);
+}
+
+#ifdef __AVX__
+static inline __m256 sigmoid_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 e = exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(), x));
+  return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+static inline __m256 tanh_ps(__m256 x) {
+  // tanh(x) = 2 * sigmoid(2x) - 1
+  const __m256 two = _mm256_set1_ps(2.f);
+  return _mm256_sub_ps(_mm256_mul_ps(two, sigmoid_ps(_mm256_mul_ps(two, x))),
+                       _mm256_set1_ps(1.f));
+}
+#endif
+
+static inline float sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+// Unary steps, `Vec` is the AVX version of `Scalar`.
+struct ReluOp {
+  float Scalar(float x) const { return x > 0.f ? x : 0.f; }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const { return _mm256_max_ps(x, _mm256_setzero_ps()); }
+#endif
+};
+
+struct Relu6Op {
+  float threshold;
+  float Scalar(float x) const { return std::min(std::max(x, 0.f), threshold); }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    return _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()),
+                         _mm256_set1_ps(threshold));
+  }
+#endif
+};
+
+struct LeakyReluOp {
+  float alpha;
+  float Scalar(float x) const { return x > 0.f ? x : alpha * x; }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    __m256 mask = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ);
+    return _mm256_blendv_ps(_mm256_mul_ps(x, _mm256_set1_ps(alpha)), x, mask);
+  }
+#endif
+};
+
+struct SigmoidOp {
+  float Scalar(float x) const { return sigmoid(x); }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const { return sigmoid_ps(x); }
+#endif
+};
+
+struct TanhOp {
+  float Scalar(float x) const { return std::tanh(x); }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const { return tanh_ps(x); }
+#endif
+};
+
+struct SwishOp {
+  float beta;
+  float Scalar(float x) const { return x * sigmoid(beta * x); }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    return _mm256_mul_ps(x, sigmoid_ps(_mm256_mul_ps(x, _mm256_set1_ps(beta))));
+  }
+#endif
+};
+
+struct HardSwishOp {
+  float threshold;
+  float scale;
+  float offset;
+  float Scalar(float x) const {
+    return x * std::min(std::max(x + offset, 0.f), threshold) / scale;
+  }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    __m256 t = _mm256_add_ps(x, _mm256_set1_ps(offset));
+    t = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()),
+                      _mm256_set1_ps(threshold));
+    return _mm256_div_ps(_mm256_mul_ps(x, t), _mm256_set1_ps(scale));
+  }
+#endif
+};
+
+struct HardSigmoidOp {
+  float slope;
+  float offset;
+  float Scalar(float x) const {
+    return std::min(std::max(slope * x + offset, 0.f), 1.f);
+  }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    __m256 t = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(slope)),
+                             _mm256_set1_ps(offset));
+    return _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()),
+                         _mm256_set1_ps(1.f));
+  }
+#endif
+};
+
+struct GeluOp {
+  bool approximate;
+  float Scalar(float x) const {
+    if (approximate) {
+      const float kAlpha = 0.7978845608028654f;  // sqrt(2 / pi)
+      return 0.5f * x * (1.f + std::tanh(kAlpha * (x + 0.044715f * x * x * x)));
+    }
+    return 0.5f * x * (1.f + std::erf(x * 0.7071067811865476f));
+  }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    if (!approximate) {
+      // There is no vector erf, evaluate it lane by lane.
+      alignas(32) float lanes[8];
+      _mm256_store_ps(lanes, x);
+      for (int k = 0; k < 8; ++k) {
+        lanes[k] = Scalar(lanes[k]);
+      }
+      return _mm256_load_ps(lanes);
+    }
+    __m256 x3 = _mm256_mul_ps(_mm256_mul_ps(x, x), x);
+    __m256 inner = _mm256_mul_ps(
+        _mm256_set1_ps(0.7978845608028654f),
+        _mm256_add_ps(x, _mm256_mul_ps(_mm256_set1_ps(0.044715f), x3)));
+    __m256 half_x = _mm256_mul_ps(_mm256_set1_ps(0.5f), x);
+    return _mm256_mul_ps(half_x,
+                         _mm256_add_ps(_mm256_set1_ps(1.f), tanh_ps(inner)));
+  }
+#endif
+};
+
+struct ExpOp {
+  float Scalar(float x) const { return std::exp(x); }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const { return exp256_ps(x); }
+#endif
+};
+
+struct AbsOp {
+  float Scalar(float x) const { return std::fabs(x); }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.f), x);
+  }
+#endif
+};
+
+struct SquareOp {
+  float Scalar(float x) const { return x * x; }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const { return _mm256_mul_ps(x, x); }
+#endif
+};
+
+struct SqrtOp {
+  float Scalar(float x) const { return std::sqrt(x); }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const { return _mm256_sqrt_ps(x); }
+#endif
+};
+
+struct ScaleOp {
+  float scale;
+  float bias;
+  bool bias_after_scale;
+  float Scalar(float x) const {
+    return bias_after_scale ? x * scale + bias : (x + bias) * scale;
+  }
+#ifdef __AVX__
+  __m256 Vec(__m256 x) const {
+    __m256 vscale = _mm256_set1_ps(scale);
+    __m256 vbias = _mm256_set1_ps(bias);
+    return bias_after_scale ? _mm256_add_ps(_mm256_mul_ps(x, vscale), vbias)
+                            : _mm256_mul_ps(_mm256_add_ps(x, vbias), vscale);
+  }
+#endif
+};
+
+// Binary steps
+struct AddOp {
+  float Scalar(float a, float b) const { return a + b; }
+#ifdef __AVX__
+  __m256 Vec(__m256 a, __m256 b) const { return _mm256_add_ps(a, b); }
+#endif
+};
+
+struct SubOp {
+  float Scalar(float a, float b) const { return a - b; }
+#ifdef __AVX__
+  __m256 Vec(__m256 a, __m256 b) const { return _mm256_sub_ps(a, b); }
+#endif
+};
+
+struct MulOp {
+  float Scalar(float a, float b) const { return a * b; }
+#ifdef __AVX__
+  __m256 Vec(__m256 a, __m256 b) const { return _mm256_mul_ps(a, b); }
+#endif
+};
+
+struct DivOp {
+  float Scalar(float a, float b) const { return a / b; }
+#ifdef __AVX__
+  __m256 Vec(__m256 a, __m256 b) const { return _mm256_div_ps(a, b); }
+#endif
+};
+
+struct MaxOp {
+  float Scalar(float a, float b) const { return a > b ? a : b; }
+#ifdef __AVX__
+  __m256 Vec(__m256 a, __m256 b) const { return _mm256_max_ps(a, b); }
+#endif
+};
+
+struct MinOp {
+  float Scalar(float a, float b) const { return a < b ? a : b; }
+#ifdef __AVX__
+  __m256 Vec(__m256 a, __m256 b) const { return _mm256_min_ps(a, b); }
+#endif
+};
+
+template <class Op>
+static void apply_unary(const Op& op, float* v, int64_t len) {
+  int64_t i = 0;
+#ifdef __AVX__
+  for (; i + 7 < len; i += 8) {
+    _mm256_storeu_ps(v + i, op.Vec(_mm256_loadu_ps(v + i)));
+  }
+#endif
+  for (; i < len; ++i) {
+    v[i] = op.Scalar(v[i]);
+  }
+}
+
+// v[i] = v[i] op y[i]
+template <class Op, bool kReversed>
+static void apply_vv(const Op& op, const float* y, float* v, int64_t len) {
+  int64_t i = 0;
+#ifdef __AVX__
+  for (; i + 7 < len; i += 8) {
+    __m256 a = _mm256_loadu_ps(v + i);
+    __m256 b = _mm256_loadu_ps(y + i);
+    _mm256_storeu_ps(v + i, kReversed ? op.Vec(b, a) : op.Vec(a, b));
+  }
+#endif
+  for (; i < len; ++i) {
+    v[i] = kReversed ? op.Scalar(y[i], v[i]) : op.Scalar(v[i], y[i]);
+  }
+}
+
+// v[i] = v[i] op y
+template <class Op, bool kReversed>
+static void apply_vs(const Op& op, float y, float* v, int64_t len) {
+  int64_t i = 0;
+#ifdef __AVX__
+  __m256 b = _mm256_set1_ps(y);
+  for (; i + 7 < len; i += 8) {
+    __m256 a = _mm256_loadu_ps(v + i);
+    _mm256_storeu_ps(v + i, kReversed ? op.Vec(b, a) : op.Vec(a, b));
+  }
+#endif
+  for (; i < len; ++i) {
+    v[i] = kReversed ? op.Scalar(y, v[i]) : op.Scalar(v[i], y);
+  }
+}
+
+// Applies a binary step on value[start, start + len), split into runs that
+// see either a contiguous slice of the operand or a single operand element.
+template <class Op, bool kReversed>
+static void apply_binary(const Op& op,
+                         const ChainStep& step,
+                         int64_t start,
+                         int64_t len,
+                         float* v) {
+  int64_t i = 0;
+  while (i < len) {
+    const int64_t index = start + i;
+    const int64_t y_index = (index / step.post) % step.n;
+    int64_t run = 0;
+    if (step.post == 1) {
+      run = std::min(len - i, step.n - y_index);
+      apply_vv<Op, kReversed>(op, step.operand + y_index, v + i, run);
+    } else {
+      run = std::min(len - i, step.post - index % step.post);
+      apply_vs<Op, kReversed>(op, step.operand[y_index], v + i, run);
+    }
+    i += run;
+  }
+}
+
+template <class Op>
+static void apply_binary(const Op& op,
+                         const ChainStep& step,
+                         int64_t start,
+                         int64_t len,
+                         float* v) {
+  if (step.reversed) {
+    apply_binary<Op, true>(op, step, start, len, v);
+  } else {
+    apply_binary<Op, false>(op, step, start, len, v);
+  }
+}
+
+static void apply_step(const ChainStep& step,
+                       int64_t start,
+                       int64_t len,
+                       float* v) {
+  const float* p = step.params;
+  switch (step.type) {
+    case ChainOpType::kAdd:
+      apply_binary(AddOp(), step, start, len, v);
+      break;
+    case ChainOpType::kSub:
+      apply_binary(SubOp(), step, start, len, v);
+      break;
+    case ChainOpType::kMul:
+      apply_binary(MulOp(), step, start, len, v);
+      break;
+    case ChainOpType::kDiv:
+      apply_binary(DivOp(), step, start, len, v);
+      break;
+    case ChainOpType::kMax:
+      apply_binary(MaxOp(), step, start, len, v);
+      break;
+    case ChainOpType::kMin:
+      apply_binary(MinOp(), step, start, len, v);
+      break;
+    case ChainOpType::kRelu:
+      apply_unary(ReluOp(), v, len);
+      break;
+    case ChainOpType::kRelu6:
+      apply_unary(Relu6Op{p[0]}, v, len);
+      break;
+    case ChainOpType::kLeakyRelu:
+      apply_unary(LeakyReluOp{p[0]}, v, len);
+      break;
+    case ChainOpType::kSigmoid:
+      apply_unary(SigmoidOp(), v, len);
+      break;
+    case ChainOpType::kTanh:
+      apply_unary(TanhOp(), v, len);
+      break;
+    case ChainOpType::kSwish:
+      apply_unary(SwishOp{p[0]}, v, len);
+      break;
+    case ChainOpType::kHardSwish:
+      apply_unary(HardSwishOp{p[0], p[1], p[2]}, v, len);
+      break;
+    case ChainOpType::kHardSigmoid:
+      apply_unary(HardSigmoidOp{p[0], p[1]}, v, len);
+      break;
+    case ChainOpType::kGelu:
+      apply_unary(GeluOp{p[0] != 0.f}, v, len);
+      break;
+    case ChainOpType::kExp:
+      apply_unary(ExpOp(), v, len);
+      break;
+    case ChainOpType::kAbs:
+      apply_unary(AbsOp(), v, len);
+      break;
+    case ChainOpType::kSquare:
+      apply_unary(SquareOp(), v, len);
+      break;
+    case ChainOpType::kSqrt:
+      apply_unary(SqrtOp(), v, len);
+      break;
+    case ChainOpType::kScale:
+      apply_unary(ScaleOp{p[0], p[1], p[2] != 0.f}, v, len);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported elementwise chain step "
+                 << static_cast<int>(step.type);
+  }
+}
+
+void elementwise_chain(const float* x,
+                       int64_t num,
+                       const std::vector<ChainStep>& steps,
+                       float* out) {
+  auto run = [&](int64_t begin, int64_t end) {
+    for (int64_t tile = begin; tile < end; ++tile) {
+      const int64_t start = tile * kTileSize;
+      const int64_t len = std::min(kTileSize, num - start);
+      float* v = out + start;
+      if (v != x + start) {
+        memcpy(v, x + start, len * sizeof(float));
+      }
+      for (const auto& step : steps) {
+        apply_step(step, start, len, v);
+      }
+    }
+  };
+  const int64_t tiles = (num + kTileSize - 1) / kTileSize;
+  if (num < kParallelThreshold) {
+    run(0, tiles);
+  } else {
+    RunParallelFor(0, tiles, run);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+enum class ChainOpType : int {
+  kAdd = 0,
+  kSub,
+  kMul,
+  kDiv,
+  kMax,
+  kMin,
+  kRelu,
+  kRelu6,
+  kLeakyRelu,
+  kSigmoid,
+  kTanh,
+  kSwish,
+  kHardSwish,
+  kHardSigmoid,
+  kGelu,
+  kExp,
+  kAbs,
+  kSquare,
+  kSqrt,
+  kScale,
+};
+
+// Maps an op type (e.g. "elementwise_add", "relu", "scale") to its chain
+// step, returns false if the op can not be part of a chain.
+bool GetChainOpType(const std::string& op_type, ChainOpType* type);
+
+bool IsBinaryChainOp(ChainOpType type);
+
+// One step of an elementwise chain, applied in place on the running value.
+//   - relu6: params[0] = threshold
+//   - leaky_relu: params[0] = alpha
+//   - swish: params[0] = beta
+//   - hard_swish: params = {threshold, scale, offset}
+//   - hard_sigmoid: params = {slope, offset}
+//   - gelu: params[0] = approximate (0 or 1)
+//   - scale: params = {scale, bias, bias_after_scale (0 or 1)}
+// A binary step combines the value with `operand`, where value[i] meets
+// operand[(i / post) % n]. `reversed` computes `operand op value`.
+struct ChainStep {
+  ChainOpType type{ChainOpType::kRelu};
+  float params[3]{0.f, 0.f, 0.f};
+  const float* operand{nullptr};
+  int64_t n{1};
+  int64_t post{1};
+  bool reversed{false};
+};
+
+// out = steps[k](...steps[0](x)). The chain is evaluated on L1-sized tiles
+// of `out`, so every tensor is read or written once instead of once per step.
+// `out` may alias `x`.
+void elementwise_chain(const float* x,
+                       int64_t num,
+                       const std::vector<ChainStep>& steps,
+                       float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,72 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_half_weight.h"
+#include "lite/utils/log/cp_logging.h"
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+#include <immintrin.h>
+#define LITE_HALF_WEIGHT_AVX2
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+HalfType GetHalfType(const std::string& half_weight_type) {
+  if (half_weight_type == "fp16") {
+    return HalfType::kFP16;
+  } else if (half_weight_type == "bf16") {
+    return HalfType::kBF16;
+  }
+  LOG(FATAL) << "Unsupported half weight type: " << half_weight_type;
+  return HalfType::kFP16;
+}
+
+#ifdef LITE_HALF_WEIGHT_AVX2
+template <HalfType T>
+static inline __m256 load_half8(const uint16_t* src) {
+  __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  if (T == HalfType::kFP16) {
+    return _mm256_cvtph_ps(h);
+  }
+  return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+}
+#endif
+
+template <HalfType T>
+static void half_to_float_impl(const uint16_t* src, float* dst, int64_t n) {
+  int64_t i = 0;
+#ifdef LITE_HALF_WEIGHT_AVX2
+  for (; i + 7 < n; i += 8) {
+    _mm256_storeu_ps(dst + i, load_half8<T>(src + i));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = half_to_float<T>(src[i]);
+  }
+}
+
+void half_to_float(HalfType type, const uint16_t* src, float* dst, int64_t n) {
+  if (type == HalfType::kFP16) {
+    half_to_float_impl<HalfType::kFP16>(src, dst, n);
+  } else {
+    half_to_float_impl<HalfType::kBF16>(src, dst, n);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
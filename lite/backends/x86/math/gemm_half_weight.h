@@ -0,0 +1,57 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include "lite/backends/x86/fluid/float16.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// 16-bit storage types of fp32 weights
+enum class HalfType { kFP16, kBF16 };
+
+// Returns the HalfType of "fp16" or "bf16".
+HalfType GetHalfType(const std::string& half_weight_type);
+
+// Expands one fp16/bf16 value to fp32.
+template <HalfType T>
+inline float half_to_float(uint16_t h) {
+  if (T == HalfType::kFP16) {
+    fluid::float16 value;
+    value.x = h;
+    return static_cast<float>(value);
+  }
+  uint32_t bits = static_cast<uint32_t>(h) << 16;
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Expands n fp16/bf16 values to fp32.
+void half_to_float(HalfType type, const uint16_t* src, float* dst, int64_t n);
+
+// Up to this M, fc/matmul on a 16-bit weight run gemm_skinny_half, above it
+// expanding the weight once and calling the fp32 gemm is faster.
+static constexpr int kHalfGemmMaxM = 16;
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,355 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_skinny.h"
+#include <string.h>
+#include <algorithm>
+#include "lite/backends/x86/parallel.h"
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define LITE_SKINNY_GEMM_AVX512
+#elif defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+#include <immintrin.h>
+#define LITE_SKINNY_GEMM_AVX2
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Rows of A handled by one microkernel call
+static constexpr int kBlockM = 4;
+// Problems smaller than this (in multiply-adds) run on the calling thread
+static constexpr int64_t kParallelThreshold = 1 << 18;
+
+int64_t skinny_packed_size(int K, int N) {
+  const int64_t panels = (N + kSkinnyPanelN - 1) / kSkinnyPanelN;
+  return panels * K * kSkinnyPanelN;
+}
+
+template <typename T>
+static void pack_skinny_panels(
+    bool trans, int K, int N, const T* B, int ldb, T* packed) {
+  for (int n0 = 0; n0 < N; n0 += kSkinnyPanelN) {
+    const int cols = std::min(kSkinnyPanelN, N - n0);
+    T* panel = packed + static_cast<int64_t>(n0) * K;
+    for (int k = 0; k < K; ++k) {
+      T* dst = panel + k * kSkinnyPanelN;
+      if (trans) {
+        for (int j = 0; j < cols; ++j) {
+          dst[j] = B[static_cast<int64_t>(n0 + j) * ldb + k];
+        }
+      } else {
+        memcpy(dst, B + static_cast<int64_t>(k) * ldb + n0, cols * sizeof(T));
+      }
+      for (int j = cols; j < kSkinnyPanelN; ++j) {
+        dst[j] = 0;
+      }
+    }
+  }
+}
+
+void pack_skinny_weight(
+    bool trans, int K, int N, const float* B, int ldb, float* packed) {
+  pack_skinny_panels(trans, K, N, B, ldb, packed);
+}
+
+void pack_skinny_weight(
+    bool trans, int K, int N, const uint16_t* B, int ldb, uint16_t* packed) {
+  pack_skinny_panels(trans, K, N, B, ldb, packed);
+}
+
+// The loads of a panel row of 16 weights as fp32, from a packed fp32 weight
+struct FloatPanel {
+  typedef float T;
+  static inline float load(const float* b) { return *b; }
+#if defined(LITE_SKINNY_GEMM_AVX512)
+  static inline __m512 load16(const float* b) { return _mm512_loadu_ps(b); }
+#elif defined(LITE_SKINNY_GEMM_AVX2)
+  static inline __m256 load8(const float* b) { return _mm256_loadu_ps(b); }
+#endif
+};
+
+// and from a fp16/bf16 weight, converted in registers
+template <HalfType H>
+struct HalfPanel {
+  typedef uint16_t T;
+  static inline float load(const uint16_t* b) { return half_to_float<H>(*b); }
+#if defined(LITE_SKINNY_GEMM_AVX512)
+  static inline __m512 load16(const uint16_t* b) {
+    __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    if (H == HalfType::kFP16) {
+      return _mm512_cvtph_ps(h);
+    }
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16));
+  }
+#elif defined(LITE_SKINNY_GEMM_AVX2)
+  static inline __m256 load8(const uint16_t* b) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    if (H == HalfType::kFP16) {
+      return _mm256_cvtph_ps(h);
+    }
+    return _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+  }
+#endif
+};
+
+// C[MR, 16] = alpha * A[MR, K] * panel[K, 16] (+ bias) (relu), the panel rows
+// are loaded once and A is broadcast one element at a time.
+template <int MR, typename Panel>
+static inline void kernel_mrx16(int K,
+                                float alpha,
+                                const float* A,
+                                int lda,
+                                const typename Panel::T* B,
+                                const float* bias,
+                                bool relu,
+                                float* C,
+                                int ldc) {
+#if defined(LITE_SKINNY_GEMM_AVX512)
+  // Even and odd k accumulate separately to hide the FMA latency, one
+  // chain per row is not enough to keep up with the memory for small MR.
+  __m512 acc0[MR];
+  __m512 acc1[MR];
+  for (int r = 0; r < MR; ++r) {
+    acc0[r] = _mm512_setzero_ps();
+    acc1[r] = _mm512_setzero_ps();
+  }
+  int k = 0;
+  for (; k + 1 < K; k += 2) {
+    __m512 b0 = Panel::load16(B + k * kSkinnyPanelN);
+    __m512 b1 = Panel::load16(B + (k + 1) * kSkinnyPanelN);
+    for (int r = 0; r < MR; ++r) {
+      acc0[r] = _mm512_fmadd_ps(_mm512_set1_ps(A[r * lda + k]), b0, acc0[r]);
+      acc1[r] =
+          _mm512_fmadd_ps(_mm512_set1_ps(A[r * lda + k + 1]), b1, acc1[r]);
+    }
+  }
+  if (k < K) {
+    __m512 b0 = Panel::load16(B + k * kSkinnyPanelN);
+    for (int r = 0; r < MR; ++r) {
+      acc0[r] = _mm512_fmadd_ps(_mm512_set1_ps(A[r * lda + k]), b0, acc0[r]);
+    }
+  }
+  __m512 valpha = _mm512_set1_ps(alpha);
+  __m512 vbias = bias ? _mm512_loadu_ps(bias) : _mm512_setzero_ps();
+  __m512 vzero = _mm512_setzero_ps();
+  for (int r = 0; r < MR; ++r) {
+    __m512 c = _mm512_fmadd_ps(_mm512_add_ps(acc0[r], acc1[r]), valpha, vbias);
+    if (relu) {
+      c = _mm512_max_ps(c, vzero);
+    }
+    _mm512_storeu_ps(C + r * ldc, c);
+  }
+#elif defined(LITE_SKINNY_GEMM_AVX2)
+  __m256 acc0[MR];
+  __m256 acc1[MR];
+  for (int r = 0; r < MR; ++r) {
+    acc0[r] = _mm256_setzero_ps();
+    acc1[r] = _mm256_setzero_ps();
+  }
+  for (int k = 0; k < K; ++k) {
+    const typename Panel::T* b = B + k * kSkinnyPanelN;
+    __m256 b0 = Panel::load8(b);
+    __m256 b1 = Panel::load8(b + 8);
+    for (int r = 0; r < MR; ++r) {
+      __m256 a = _mm256_broadcast_ss(A + r * lda + k);
+      acc0[r] = _mm256_fmadd_ps(a, b0, acc0[r]);
+      acc1[r] = _mm256_fmadd_ps(a, b1, acc1[r]);
+    }
+  }
+  __m256 valpha = _mm256_set1_ps(alpha);
+  __m256 vbias0 = bias ? _mm256_loadu_ps(bias) : _mm256_setzero_ps();
+  __m256 vbias1 = bias ? _mm256_loadu_ps(bias + 8) : _mm256_setzero_ps();
+  __m256 vzero = _mm256_setzero_ps();
+  for (int r = 0; r < MR; ++r) {
+    __m256 c0 = _mm256_fmadd_ps(acc0[r], valpha, vbias0);
+    __m256 c1 = _mm256_fmadd_ps(acc1[r], valpha, vbias1);
+    if (relu) {
+      c0 = _mm256_max_ps(c0, vzero);
+      c1 = _mm256_max_ps(c1, vzero);
+    }
+    _mm256_storeu_ps(C + r * ldc, c0);
+    _mm256_storeu_ps(C + r * ldc + 8, c1);
+  }
+#else
+  float acc[MR][kSkinnyPanelN] = {};
+  for (int k = 0; k < K; ++k) {
+    const typename Panel::T* b = B + k * kSkinnyPanelN;
+    for (int r = 0; r < MR; ++r) {
+      const float a = A[r * lda + k];
+      for (int j = 0; j < kSkinnyPanelN; ++j) {
+        acc[r][j] += a * Panel::load(b + j);
+      }
+    }
+  }
+  for (int r = 0; r < MR; ++r) {
+    for (int j = 0; j < kSkinnyPanelN; ++j) {
+      float c = acc[r][j] * alpha + (bias ? bias[j] : 0.f);
+      C[r * ldc + j] = relu ? std::max(c, 0.f) : c;
+    }
+  }
+#endif
+}
+
+template <int MR, typename Panel>
+static inline void panel_rows(int K,
+                              int cols,
+                              float alpha,
+                              const float* A,
+                              int lda,
+                              const typename Panel::T* panel,
+                              const float* bias,
+                              bool relu,
+                              float* C,
+                              int ldc) {
+  if (cols == kSkinnyPanelN) {
+    kernel_mrx16<MR, Panel>(K, alpha, A, lda, panel, bias, relu, C, ldc);
+    return;
+  }
+  // The zero-padded last panel goes through a scratch tile, the bias and C
+  // only have `cols` valid columns.
+  float tile[MR * kSkinnyPanelN];
+  kernel_mrx16<MR, Panel>(
+      K, alpha, A, lda, panel, nullptr, false, tile, kSkinnyPanelN);
+  for (int r = 0; r < MR; ++r) {
+    for (int j = 0; j < cols; ++j) {
+      float c = tile[r * kSkinnyPanelN + j] + (bias ? bias[j] : 0.f);
+      C[r * ldc + j] = relu ? std::max(c, 0.f) : c;
+    }
+  }
+}
+
+// Computes the panels [p_begin, p_end) for all rows of A.
+template <typename Panel>
+static void gemm_skinny_panels(int64_t p_begin,
+                               int64_t p_end,
+                               int M,
+                               int N,
+                               int K,
+                               float alpha,
+                               const float* A,
+                               int lda,
+                               const typename Panel::T* packed_B,
+                               const float* bias,
+                               bool relu,
+                               float* C,
+                               int ldc) {
+  for (int64_t p = p_begin; p < p_end; ++p) {
+    const int n = static_cast<int>(p) * kSkinnyPanelN;
+    const int cols = std::min(kSkinnyPanelN, N - n);
+    const typename Panel::T* panel = packed_B + static_cast<int64_t>(n) * K;
+    const float* bias_n = bias ? bias + n : nullptr;
+    int m = 0;
+    for (; m + kBlockM <= M; m += kBlockM) {
+      panel_rows<kBlockM, Panel>(K,
+                                 cols,
+                                 alpha,
+                                 A + m * lda,
+                                 lda,
+                                 panel,
+                                 bias_n,
+                                 relu,
+                                 C + m * ldc + n,
+                                 ldc);
+    }
+    const float* a = A + m * lda;
+    float* c = C + m * ldc + n;
+    switch (M - m) {
+      case 3:
+        panel_rows<3, Panel>(
+            K, cols, alpha, a, lda, panel, bias_n, relu, c, ldc);
+        break;
+      case 2:
+        panel_rows<2, Panel>(
+            K, cols, alpha, a, lda, panel, bias_n, relu, c, ldc);
+        break;
+      case 1:
+        panel_rows<1, Panel>(
+            K, cols, alpha, a, lda, panel, bias_n, relu, c, ldc);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+template <typename Panel>
+static void gemm_skinny_impl(int M,
+                             int N,
+                             int K,
+                             float alpha,
+                             const float* A,
+                             int lda,
+                             const typename Panel::T* packed_B,
+                             const float* bias,
+                             bool relu,
+                             float* C,
+                             int ldc) {
+  auto compute = [&](int64_t begin, int64_t end) {
+    gemm_skinny_panels<Panel>(
+        begin, end, M, N, K, alpha, A, lda, packed_B, bias, relu, C, ldc);
+  };
+  const int64_t panels = (N + kSkinnyPanelN - 1) / kSkinnyPanelN;
+  if (static_cast<int64_t>(M) * N * K < kParallelThreshold) {
+    compute(0, panels);
+  } else {
+    RunParallelFor(0, panels, compute);
+  }
+}
+
+void gemm_skinny(int M,
+                 int N,
+                 int K,
+                 float alpha,
+                 const float* A,
+                 int lda,
+                 const float* packed_B,
+                 const float* bias,
+                 bool relu,
+                 float* C,
+                 int ldc) {
+  if (M <= 0 || N <= 0) return;
+  gemm_skinny_impl<FloatPanel>(
+      M, N, K, alpha, A, lda, packed_B, bias, relu, C, ldc);
+}
+
+void gemm_skinny_half(HalfType type,
+                      int M,
+                      int N,
+                      int K,
+                      float alpha,
+                      const float* A,
+                      int lda,
+                      const uint16_t* packed_B,
+                      const float* bias,
+                      bool relu,
+                      float* C,
+                      int ldc) {
+  if (M <= 0 || N <= 0) return;
+  if (type == HalfType::kFP16) {
+    gemm_skinny_impl<HalfPanel<HalfType::kFP16>>(
+        M, N, K, alpha, A, lda, packed_B, bias, relu, C, ldc);
+  } else {
+    gemm_skinny_impl<HalfPanel<HalfType::kBF16>>(
+        M, N, K, alpha, A, lda, packed_B, bias, relu, C, ldc);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
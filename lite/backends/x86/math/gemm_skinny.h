@@ -0,0 +1,77 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/backends/x86/math/gemm_half_weight.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Up to this M, fc/matmul on a constant weight use gemm_skinny instead of
+// the general GEMM, which runs far below memory bandwidth for such shapes.
+static constexpr int kSkinnyGemmMaxM = 4;
+
+// Columns of one panel of a packed weight
+static constexpr int kSkinnyPanelN = 16;
+
+// Number of elements of a packed [K, N] weight.
+int64_t skinny_packed_size(int K, int N);
+
+// Packs the weight B[K, N] (B[N, K] if `trans`) into panel-major order: N is
+// split into panels of kSkinnyPanelN columns, each stored as a contiguous
+// [K, kSkinnyPanelN] block, the last panel is zero-padded.
+void pack_skinny_weight(
+    bool trans, int K, int N, const float* B, int ldb, float* packed);
+void pack_skinny_weight(
+    bool trans, int K, int N, const uint16_t* B, int ldb, uint16_t* packed);
+
+// C[M, N] = alpha * A[M, K] * B[K, N] (+ bias[N]) (relu), where B is packed
+// by pack_skinny_weight. Every panel is streamed from memory once for all
+// rows of A, and panels are split across threads.
+void gemm_skinny(int M,
+                 int N,
+                 int K,
+                 float alpha,
+                 const float* A,
+                 int lda,
+                 const float* packed_B,
+                 const float* bias,
+                 bool relu,
+                 float* C,
+                 int ldc);
+
+// gemm_skinny on a weight stored in fp16/bf16 by x86_half_weight_pass and
+// packed by pack_skinny_weight, every panel row is converted to fp32 in
+// registers so the weight is streamed in 16 bits.
+void gemm_skinny_half(HalfType type,
+                      int M,
+                      int N,
+                      int K,
+                      float alpha,
+                      const float* A,
+                      int lda,
+                      const uint16_t* packed_B,
+                      const float* bias,
+                      bool relu,
+                      float* C,
+                      int ldc);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,239 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/lookup_table.h"
+#include <string.h>
+#include <xmmintrin.h>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/fluid/float16.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// How many ids ahead the rows are prefetched
+static constexpr int64_t kPrefetchDistance = 4;
+// Batches smaller than this (in output elements) run on the calling thread
+static constexpr int64_t kParallelThreshold = 1 << 16;
+
+static inline void prefetch_row(const char* row, int64_t bytes) {
+  for (int64_t offset = 0; offset < bytes; offset += 64) {
+    _mm_prefetch(row + offset, _MM_HINT_T0);
+  }
+}
+
+// Decodes one table row into fp32, `kAccumulate` adds it onto `dout`.
+template <bool kAccumulate>
+static inline void decode_row_fp32(const float* din, float* dout, int64_t n) {
+  if (!kAccumulate) {
+    memcpy(dout, din, n * sizeof(float));
+    return;
+  }
+  int64_t i = 0;
+#ifdef __AVX__
+  for (; i + 7 < n; i += 8) {
+    _mm256_storeu_ps(
+        dout + i,
+        _mm256_add_ps(_mm256_loadu_ps(dout + i), _mm256_loadu_ps(din + i)));
+  }
+#endif
+  for (; i < n; ++i) {
+    dout[i] += din[i];
+  }
+}
+
+template <bool kAccumulate>
+static inline void decode_row_fp16(const uint16_t* din,
+                                   float* dout,
+                                   int64_t n) {
+  int64_t i = 0;
+#ifdef __F16C__
+  for (; i + 7 < n; i += 8) {
+    __m256 vin = _mm256_cvtph_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(din + i)));
+    if (kAccumulate) {
+      vin = _mm256_add_ps(_mm256_loadu_ps(dout + i), vin);
+    }
+    _mm256_storeu_ps(dout + i, vin);
+  }
+#endif
+  for (; i < n; ++i) {
+    fluid::float16 h;
+    h.x = din[i];
+    float value = static_cast<float>(h);
+    dout[i] = kAccumulate ? dout[i] + value : value;
+  }
+}
+
+template <bool kAccumulate>
+static inline void decode_row_int8(const int8_t* din,
+                                   float scale,
+                                   float* dout,
+                                   int64_t n) {
+  int64_t i = 0;
+#ifdef __AVX2__
+  __m256 vscale = _mm256_set1_ps(scale);
+  for (; i + 7 < n; i += 8) {
+    __m256i vi32 = _mm256_cvtepi8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(din + i)));
+    __m256 vin = _mm256_mul_ps(_mm256_cvtepi32_ps(vi32), vscale);
+    if (kAccumulate) {
+      vin = _mm256_add_ps(_mm256_loadu_ps(dout + i), vin);
+    }
+    _mm256_storeu_ps(dout + i, vin);
+  }
+#endif
+  for (; i < n; ++i) {
+    float value = static_cast<float>(din[i]) * scale;
+    dout[i] = kAccumulate ? dout[i] + value : value;
+  }
+}
+
+static inline int64_t element_size(lite_api::PrecisionType precision) {
+  switch (precision) {
+    case lite_api::PrecisionType::kFloat:
+      return sizeof(float);
+    case lite_api::PrecisionType::kFP16:
+      return sizeof(uint16_t);
+    case lite_api::PrecisionType::kInt8:
+      return sizeof(int8_t);
+    default:
+      LOG(FATAL) << "Unsupported embedding table precision: "
+                 << lite_api::PrecisionToStr(precision);
+  }
+  return 0;
+}
+
+template <bool kAccumulate>
+static inline void decode_row(const EmbeddingTable& table,
+                              int64_t row,
+                              float* dout) {
+  const int64_t width = table.row_width;
+  switch (table.precision) {
+    case lite_api::PrecisionType::kFloat:
+      decode_row_fp32<kAccumulate>(
+          static_cast<const float*>(table.data) + row * width, dout, width);
+      break;
+    case lite_api::PrecisionType::kFP16:
+      decode_row_fp16<kAccumulate>(
+          static_cast<const uint16_t*>(table.data) + row * width, dout, width);
+      break;
+    case lite_api::PrecisionType::kInt8:
+      decode_row_int8<kAccumulate>(
+          static_cast<const int8_t*>(table.data) + row * width,
+          table.row_scales[row],
+          dout,
+          width);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported embedding table precision: "
+                 << lite_api::PrecisionToStr(table.precision);
+  }
+}
+
+static inline void check_id(int64_t id, int64_t row_number) {
+  CHECK_LT(id, row_number) << "lookup_table ids[i] < row_number check failed";
+  CHECK_GE(id, 0) << "lookup_table ids[i] >= 0 check failed";
+}
+
+static void check_table(const EmbeddingTable& table) {
+  CHECK(table.data);
+  if (table.precision == lite_api::PrecisionType::kInt8) {
+    CHECK(table.row_scales) << "int8 embedding table requires row scales";
+  }
+}
+
+void lookup_table(const EmbeddingTable& table,
+                  const int64_t* ids,
+                  int64_t ids_num,
+                  int64_t padding_idx,
+                  float* out) {
+  check_table(table);
+  const int64_t width = table.row_width;
+  const int64_t row_bytes = width * element_size(table.precision);
+  const char* base = static_cast<const char*>(table.data);
+  auto gather = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (i + kPrefetchDistance < end) {
+        int64_t next = ids[i + kPrefetchDistance];
+        if (next >= 0 && next < table.row_number) {
+          prefetch_row(base + next * row_bytes, row_bytes);
+        }
+      }
+      if (padding_idx != -1 && ids[i] == padding_idx) {
+        memset(out + i * width, 0, width * sizeof(float));
+      } else {
+        check_id(ids[i], table.row_number);
+        decode_row<false>(table, ids[i], out + i * width);
+      }
+    }
+  };
+  if (ids_num * width < kParallelThreshold) {
+    gather(0, ids_num);
+  } else {
+    RunParallelFor(0, ids_num, gather);
+  }
+}
+
+void lookup_table_seq_pool(const EmbeddingTable& table,
+                           const int64_t* ids,
+                           const uint64_t* lod,
+                           int64_t seq_num,
+                           int64_t padding_idx,
+                           bool average,
+                           float* out) {
+  check_table(table);
+  const int64_t width = table.row_width;
+  const int64_t row_bytes = width * element_size(table.precision);
+  const char* base = static_cast<const char*>(table.data);
+  auto pool = [&](int64_t begin, int64_t end) {
+    for (int64_t s = begin; s < end; ++s) {
+      float* dout = out + s * width;
+      memset(dout, 0, width * sizeof(float));
+      const int64_t seq_begin = static_cast<int64_t>(lod[s]);
+      const int64_t seq_end = static_cast<int64_t>(lod[s + 1]);
+      for (int64_t i = seq_begin; i < seq_end; ++i) {
+        if (i + kPrefetchDistance < seq_end) {
+          int64_t next = ids[i + kPrefetchDistance];
+          if (next >= 0 && next < table.row_number) {
+            prefetch_row(base + next * row_bytes, row_bytes);
+          }
+        }
+        if (padding_idx != -1 && ids[i] == padding_idx) continue;
+        check_id(ids[i], table.row_number);
+        decode_row<true>(table, ids[i], dout);
+      }
+      if (average && seq_end > seq_begin) {
+        const float inv = 1.f / static_cast<float>(seq_end - seq_begin);
+        for (int64_t k = 0; k < width; ++k) {
+          dout[k] *= inv;
+        }
+      }
+    }
+  };
+  const int64_t ids_num = static_cast<int64_t>(lod[seq_num] - lod[0]);
+  if (ids_num * width < kParallelThreshold) {
+    pool(0, seq_num);
+  } else {
+    RunParallelFor(0, seq_num, pool);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
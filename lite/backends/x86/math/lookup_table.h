@@ -0,0 +1,58 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/api/paddle_place.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// A row-major embedding table. Rows are stored as fp32, fp16 or int8, int8
+// rows are dequantized with one scale per row (`row_scales[row_number]`).
+struct EmbeddingTable {
+  const void* data{nullptr};
+  lite_api::PrecisionType precision{lite_api::PrecisionType::kFloat};
+  const float* row_scales{nullptr};
+  int64_t row_number{0};
+  int64_t row_width{0};
+};
+
+// out[i, :] = table[ids[i], :], rows equal to padding_idx are zero-filled.
+// Rows are software-prefetched a few ids ahead and large batches are split
+// across threads.
+void lookup_table(const EmbeddingTable& table,
+                  const int64_t* ids,
+                  int64_t ids_num,
+                  int64_t padding_idx,
+                  float* out);
+
+// Lookup fused with a SUM/AVERAGE sequence pooling: for every sequence
+// [lod[i], lod[i + 1]) the gathered rows are accumulated into out[i, :]
+// directly, so the [ids_num, row_width] intermediate is never materialized.
+void lookup_table_seq_pool(const EmbeddingTable& table,
+                           const int64_t* ids,
+                           const uint64_t* lod,
+                           int64_t seq_num,
+                           int64_t padding_idx,
+                           bool average,
+                           float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
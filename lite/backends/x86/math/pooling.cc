@@ -15,6 +15,7 @@ limitations under the License. */
 #include "lite/backends/x86/math/pooling.h"
 #include <algorithm>
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
@@ -54,14 +55,16 @@ class Pool2dFunctor<lite::TargetType::kX86, PoolProcess, T> {
     const int input_stride = input_height * input_width;
     const int output_stride = output_height * output_width;
 
-    const T* input_data = input->template data<T>();
-    T* output_data = output->template mutable_data<T>(lite::TargetType::kX86);
+    const T* input_base = input->template data<T>();
+    T* output_base = output->template mutable_data<T>(lite::TargetType::kX86);
 
-    int hstart, hend;
-    int wstart, wend;
-
-    for (int i = 0; i < batch_size; i++) {
-      for (int c = 0; c < output_channels; ++c) {
+    // every (batch, channel) plane is pooled independently
+    auto pool_planes = [&](int64_t begin, int64_t end) {
+      int hstart, hend;
+      int wstart, wend;
+      for (int64_t idx = begin; idx < end; ++idx) {
+        const T* input_data = input_base + idx * input_stride;
+        T* output_data = output_base + idx * output_stride;
         for (int ph = 0; ph < output_height; ++ph) {
           if (adaptive) {
             hstart = AdaptStartIndex(ph, input_height, output_height);
@@ -101,10 +104,9 @@ class Pool2dFunctor<lite::TargetType::kX86, PoolProcess, T> {
             output_data[ph * output_width + pw] = ele;
           }
         }
-        input_data += input_stride;
-        output_data += output_stride;
       }
-    }
+    };
+    RunParallelFor(0, batch_size * output_channels, pool_planes);
   }
 };
 
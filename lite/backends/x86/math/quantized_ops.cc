@@ -0,0 +1,652 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/quantized_ops.h"
+#include <immintrin.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Tensors smaller than this (in elements) run on the calling thread
+static constexpr int64_t kParallelThreshold = 1 << 16;
+
+static inline void store_one(float* out, float v, float inv_scale) {
+  *out = v;
+}
+
+static inline void store_one(int8_t* out, float v, float inv_scale) {
+  float q = std::nearbyint(v * inv_scale);
+  q = std::min(std::max(q, -127.f), 127.f);
+  *out = static_cast<int8_t>(q);
+}
+
+// 1 / out_scale for an int8 output, fp32 outputs are stored as is.
+template <typename Tout>
+static inline float output_inv_scale(float out_scale) {
+  return 1.f;
+}
+
+template <>
+inline float output_inv_scale<int8_t>(float out_scale) {
+  CHECK_GT(out_scale, 0.f) << "The output scale of an int8 op must be > 0";
+  return 1.f / out_scale;
+}
+
+#ifdef __AVX2__
+static inline __m256 load_eight(const int8_t* x, __m256 vscale) {
+  __m256i v = _mm256_cvtepi8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(x)));
+  return _mm256_mul_ps(_mm256_cvtepi32_ps(v), vscale);
+}
+
+static inline void store_eight(float* out, __m256 v, __m256 vinv_scale) {
+  _mm256_storeu_ps(out, v);
+}
+
+static inline void store_eight(int8_t* out, __m256 v, __m256 vinv_scale) {
+  v = _mm256_mul_ps(v, vinv_scale);
+  v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-127.f)),
+                    _mm256_set1_ps(127.f));
+  // Rounds to nearest even, as std::nearbyint does in the tails
+  __m256i q = _mm256_cvtps_epi32(v);
+  __m128i q16 = _mm_packs_epi32(_mm256_castsi256_si128(q),
+                                _mm256_extracti128_si256(q, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out),
+                   _mm_packs_epi16(q16, q16));
+}
+#endif
+
+// Runs `f(begin, end)` over [0, num), split across threads for large tensors.
+template <typename Fn>
+static inline void run_chunks(int64_t num, int64_t cost, Fn f) {
+  if (num * cost < kParallelThreshold) {
+    f(0, num);
+  } else {
+    RunParallelFor(0, num, f);
+  }
+}
+
+struct AddOp {
+  static inline float apply(float a, float b) { return a + b; }
+#ifdef __AVX2__
+  static inline __m256 apply(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+#endif
+};
+
+struct MulOp {
+  static inline float apply(float a, float b) { return a * b; }
+#ifdef __AVX2__
+  static inline __m256 apply(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+#endif
+};
+
+struct IdentityAct {
+  inline float apply(float v) const { return v; }
+#ifdef __AVX2__
+  inline __m256 apply(__m256 v) const { return v; }
+#endif
+};
+
+struct ReluAct {
+  inline float apply(float v) const { return std::max(v, 0.f); }
+#ifdef __AVX2__
+  inline __m256 apply(__m256 v) const {
+    return _mm256_max_ps(v, _mm256_setzero_ps());
+  }
+#endif
+};
+
+struct Relu6Act {
+  float threshold;
+  inline float apply(float v) const {
+    return std::min(std::max(v, 0.f), threshold);
+  }
+#ifdef __AVX2__
+  inline __m256 apply(__m256 v) const {
+    return _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()),
+                         _mm256_set1_ps(threshold));
+  }
+#endif
+};
+
+// hard_swish(x) = x * min(max(0, x + offset), threshold) / scale
+struct HardSwishAct {
+  float threshold;
+  float inv_scale;
+  float offset;
+  inline float apply(float v) const {
+    return v * std::min(std::max(v + offset, 0.f), threshold) * inv_scale;
+  }
+#ifdef __AVX2__
+  inline __m256 apply(__m256 v) const {
+    __m256 t = _mm256_add_ps(v, _mm256_set1_ps(offset));
+    t = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()),
+                      _mm256_set1_ps(threshold));
+    return _mm256_mul_ps(_mm256_mul_ps(v, t), _mm256_set1_ps(inv_scale));
+  }
+#endif
+};
+
+// The body of unary_impl on the calling thread
+template <typename Tout, typename Act>
+static inline void unary_range(const int8_t* x,
+                               Tout* out,
+                               int64_t num,
+                               float in_scale,
+                               float inv_scale,
+                               Act act) {
+  int64_t i = 0;
+#ifdef __AVX2__
+  __m256 vscale = _mm256_set1_ps(in_scale);
+  __m256 vinv_scale = _mm256_set1_ps(inv_scale);
+  for (; i + 7 < num; i += 8) {
+    store_eight(out + i, act.apply(load_eight(x + i, vscale)), vinv_scale);
+  }
+#endif
+  for (; i < num; ++i) {
+    store_one(out + i, act.apply(x[i] * in_scale), inv_scale);
+  }
+}
+
+template <typename Tout, typename Act>
+static void unary_impl(const int8_t* x,
+                       Tout* out,
+                       int64_t num,
+                       float in_scale,
+                       float out_scale,
+                       Act act) {
+  const float inv_scale = output_inv_scale<Tout>(out_scale);
+  run_chunks(num, 1, [&](int64_t begin, int64_t end) {
+    unary_range(x + begin, out + begin, end - begin, in_scale, inv_scale, act);
+  });
+}
+
+static inline void requantize_impl(
+    const int8_t* x, float* out, int64_t num, float in_scale, float out_scale) {
+  unary_impl(x, out, num, in_scale, out_scale, IdentityAct());
+}
+
+static inline void requantize_impl(const int8_t* x,
+                                   int8_t* out,
+                                   int64_t num,
+                                   float in_scale,
+                                   float out_scale) {
+  if (in_scale == out_scale) {
+    if (x != out) memcpy(out, x, num * sizeof(int8_t));
+    return;
+  }
+  unary_impl(x, out, num, in_scale, out_scale, IdentityAct());
+}
+
+template <typename Tout>
+void int8_requantize(
+    const int8_t* x, Tout* out, int64_t num, float in_scale, float out_scale) {
+  requantize_impl(x, out, num, in_scale, out_scale);
+}
+
+static void int8_relu_same_scale(const int8_t* x, int8_t* out, int64_t num) {
+  run_chunks(num, 1, [&](int64_t begin, int64_t end) {
+    int64_t i = begin;
+#ifdef __AVX2__
+    __m256i vzero = _mm256_setzero_si256();
+    for (; i + 31 < end; i += 32) {
+      __m256i v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                          _mm256_max_epi8(v, vzero));
+    }
+#endif
+    for (; i < end; ++i) {
+      out[i] = x[i] > 0 ? x[i] : 0;
+    }
+  });
+}
+
+template <typename Tout>
+static void activation_impl(const int8_t* x,
+                            Tout* out,
+                            int64_t num,
+                            float in_scale,
+                            float out_scale,
+                            const Int8ActivationParam& act) {
+  switch (act.type) {
+    case Int8ActivationType::kRelu:
+      unary_impl(x, out, num, in_scale, out_scale, ReluAct());
+      break;
+    case Int8ActivationType::kRelu6:
+      unary_impl(x, out, num, in_scale, out_scale, Relu6Act{act.threshold});
+      break;
+    case Int8ActivationType::kHardSwish:
+      unary_impl(x,
+                 out,
+                 num,
+                 in_scale,
+                 out_scale,
+                 HardSwishAct{act.hard_swish_threshold,
+                              1.f / act.hard_swish_scale,
+                              act.hard_swish_offset});
+      break;
+    default:
+      LOG(FATAL) << "Unsupported int8 activation type "
+                 << static_cast<int>(act.type);
+  }
+}
+
+// relu keeps the scale, so with matching scales int8 relu is exact.
+static inline bool relu_same_scale(const int8_t* x,
+                                   float* out,
+                                   int64_t num,
+                                   float in_scale,
+                                   float out_scale,
+                                   const Int8ActivationParam& act) {
+  return false;
+}
+
+static inline bool relu_same_scale(const int8_t* x,
+                                   int8_t* out,
+                                   int64_t num,
+                                   float in_scale,
+                                   float out_scale,
+                                   const Int8ActivationParam& act) {
+  if (act.type != Int8ActivationType::kRelu || in_scale != out_scale) {
+    return false;
+  }
+  int8_relu_same_scale(x, out, num);
+  return true;
+}
+
+template <typename Tout>
+void int8_activation(const int8_t* x,
+                     Tout* out,
+                     int64_t num,
+                     float in_scale,
+                     float out_scale,
+                     const Int8ActivationParam& act) {
+  if (relu_same_scale(x, out, num, in_scale, out_scale, act)) return;
+  activation_impl(x, out, num, in_scale, out_scale, act);
+}
+
+// out[i] = max(a[i], b[i]), `out` may be `a`
+static inline void max_row(const int8_t* a,
+                           const int8_t* b,
+                           int8_t* out,
+                           int num) {
+  int i = 0;
+#ifdef __AVX2__
+  for (; i + 31 < num; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_max_epi8(va, vb));
+  }
+  for (; i + 15 < num; i += 16) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_max_epi8(va, vb));
+  }
+#endif
+  for (; i < num; ++i) {
+    out[i] = std::max(a[i], b[i]);
+  }
+}
+
+// row_max[w] is the max of the rows [hstart, hend) of `x` at column w
+static void max_rows(
+    const int8_t* x, int hstart, int hend, int width, int8_t* row_max) {
+  if (hstart >= hend) {
+    memset(row_max, -128, width);
+    return;
+  }
+  memcpy(row_max, x + hstart * width, width);
+  for (int h = hstart + 1; h < hend; ++h) {
+    max_row(row_max, x + h * width, row_max, width);
+  }
+}
+
+// row_sum[w] is the sum of the rows [hstart, hend) of `x` at column w
+static void sum_rows(
+    const int8_t* x, int hstart, int hend, int width, int32_t* row_sum) {
+  std::fill(row_sum, row_sum + width, 0);
+  for (int h = hstart; h < hend; ++h) {
+    const int8_t* row = x + h * width;
+    int w = 0;
+#ifdef __AVX2__
+    for (; w + 7 < width; w += 8) {
+      __m256i a =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_sum + w));
+      __m256i b = _mm256_cvtepi8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + w)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(row_sum + w),
+                          _mm256_add_epi32(a, b));
+    }
+#endif
+    for (; w < width; ++w) {
+      row_sum[w] += row[w];
+    }
+  }
+}
+
+// Stores a row of pooled int8 values, a plain copy if the scales match.
+static inline void store_pooled_row(const int8_t* pooled,
+                                    float* out,
+                                    int num,
+                                    float in_scale,
+                                    float out_scale,
+                                    float inv_scale) {
+  unary_range(pooled, out, num, in_scale, inv_scale, IdentityAct());
+}
+
+static inline void store_pooled_row(const int8_t* pooled,
+                                    int8_t* out,
+                                    int num,
+                                    float in_scale,
+                                    float out_scale,
+                                    float inv_scale) {
+  if (in_scale == out_scale) {
+    memcpy(out, pooled, num * sizeof(int8_t));
+    return;
+  }
+  unary_range(pooled, out, num, in_scale, inv_scale, IdentityAct());
+}
+
+template <typename Tout>
+void int8_pool2d(const int8_t* x,
+                 Tout* out,
+                 int planes,
+                 int in_h,
+                 int in_w,
+                 int out_h,
+                 int out_w,
+                 const std::vector<int>& ksize,
+                 const std::vector<int>& strides,
+                 const std::vector<int>& paddings,
+                 bool is_max,
+                 bool exclusive,
+                 float in_scale,
+                 float out_scale) {
+  CHECK_EQ(ksize.size(), 2UL);
+  CHECK_EQ(strides.size(), 2UL);
+  CHECK_EQ(paddings.size(), 4UL);
+  const int ksize_h = ksize[0];
+  const int ksize_w = ksize[1];
+  const int stride_h = strides[0];
+  const int stride_w = strides[1];
+  const int pad_h = paddings[0];
+  const int pad_w = paddings[2];
+  const float inv_scale = output_inv_scale<Tout>(out_scale);
+  const int64_t in_stride = static_cast<int64_t>(in_h) * in_w;
+  const int64_t out_stride = static_cast<int64_t>(out_h) * out_w;
+  // The number of windows that lie inside a row
+  const int inner_w = in_w - ksize_w + 1;
+  auto pool_planes = [&](int64_t begin, int64_t end) {
+    // The rows of a window reduced over its height, so the columns of the
+    // window are only read once per output row
+    std::vector<int8_t> row_max(is_max ? in_w : 0);
+    std::vector<int8_t> win_max(is_max ? std::max(inner_w, 0) : 0);
+    std::vector<int8_t> pooled(is_max ? out_w : 0);
+    std::vector<int32_t> row_sum(is_max ? 0 : in_w);
+    for (int64_t idx = begin; idx < end; ++idx) {
+      const int8_t* x_plane = x + idx * in_stride;
+      Tout* out_plane = out + idx * out_stride;
+      for (int ph = 0; ph < out_h; ++ph) {
+        int hstart = ph * stride_h - pad_h;
+        int hend = std::min(hstart + ksize_h, in_h + pad_h);
+        const int pool_h = hend - hstart;
+        hstart = std::max(hstart, 0);
+        hend = std::min(hend, in_h);
+        Tout* out_row = out_plane + ph * out_w;
+        if (is_max) {
+          max_rows(x_plane, hstart, hend, in_w, row_max.data());
+          // The max of every window inside the row, the windows of the
+          // output are picked from it at the stride
+          if (inner_w > 0) {
+            memcpy(win_max.data(), row_max.data(), inner_w);
+            for (int k = 1; k < ksize_w; ++k) {
+              max_row(win_max.data(),
+                      row_max.data() + k,
+                      win_max.data(),
+                      inner_w);
+            }
+          }
+          for (int pw = 0; pw < out_w; ++pw) {
+            int wstart = pw * stride_w - pad_w;
+            if (wstart >= 0 && wstart < inner_w) {
+              pooled[pw] = win_max[wstart];
+              continue;
+            }
+            int wend = std::min(wstart + ksize_w, in_w);
+            int8_t max_q = -128;
+            for (int w = std::max(wstart, 0); w < wend; ++w) {
+              max_q = std::max(max_q, row_max[w]);
+            }
+            pooled[pw] = max_q;
+          }
+          store_pooled_row(
+              pooled.data(), out_row, out_w, in_scale, out_scale, inv_scale);
+        } else {
+          sum_rows(x_plane, hstart, hend, in_w, row_sum.data());
+          for (int pw = 0; pw < out_w; ++pw) {
+            int wstart = pw * stride_w - pad_w;
+            int wend = std::min(wstart + ksize_w, in_w + pad_w);
+            int pool_size = pool_h * (wend - wstart);
+            wstart = std::max(wstart, 0);
+            wend = std::min(wend, in_w);
+            int32_t sum = 0;
+            for (int w = wstart; w < wend; ++w) {
+              sum += row_sum[w];
+            }
+            if (exclusive) {
+              pool_size = (hend - hstart) * (wend - wstart);
+            }
+            float value = pool_size > 0 ? sum * in_scale / pool_size : 0.f;
+            store_one(out_row + pw, value, inv_scale);
+          }
+        }
+      }
+    }
+  };
+  run_chunks(planes, out_stride * ksize_h * ksize_w, pool_planes);
+}
+
+template <typename Tout, typename Op>
+static void elementwise_impl(const int8_t* x,
+                             const int8_t* y,
+                             Tout* out,
+                             int64_t pre,
+                             int64_t n,
+                             int64_t post,
+                             float x_scale,
+                             float y_scale,
+                             float out_scale) {
+  const float inv_scale = output_inv_scale<Tout>(out_scale);
+  if (pre == 1 && post == 1) {
+    // Same shapes, one fused dequantize-op-requantize pass
+    run_chunks(n, 1, [&](int64_t begin, int64_t end) {
+      int64_t i = begin;
+#ifdef __AVX2__
+      __m256 vx_scale = _mm256_set1_ps(x_scale);
+      __m256 vy_scale = _mm256_set1_ps(y_scale);
+      __m256 vinv_scale = _mm256_set1_ps(inv_scale);
+      for (; i + 7 < end; i += 8) {
+        __m256 v = Op::apply(load_eight(x + i, vx_scale),
+                             load_eight(y + i, vy_scale));
+        store_eight(out + i, v, vinv_scale);
+      }
+#endif
+      for (; i < end; ++i) {
+        store_one(
+            out + i, Op::apply(x[i] * x_scale, y[i] * y_scale), inv_scale);
+      }
+    });
+    return;
+  }
+  run_chunks(pre * n, post, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const float y_value = y[row % n] * y_scale;
+      const int8_t* x_row = x + row * post;
+      Tout* out_row = out + row * post;
+      int64_t k = 0;
+#ifdef __AVX2__
+      __m256 vx_scale = _mm256_set1_ps(x_scale);
+      __m256 vy = _mm256_set1_ps(y_value);
+      __m256 vinv_scale = _mm256_set1_ps(inv_scale);
+      for (; k + 7 < post; k += 8) {
+        store_eight(out_row + k,
+                    Op::apply(load_eight(x_row + k, vx_scale), vy),
+                    vinv_scale);
+      }
+#endif
+      for (; k < post; ++k) {
+        store_one(
+            out_row + k, Op::apply(x_row[k] * x_scale, y_value), inv_scale);
+      }
+    }
+  });
+}
+
+template <typename Tout>
+void int8_elementwise(const int8_t* x,
+                      const int8_t* y,
+                      Tout* out,
+                      int64_t pre,
+                      int64_t n,
+                      int64_t post,
+                      float x_scale,
+                      float y_scale,
+                      float out_scale,
+                      bool is_mul) {
+  if (is_mul) {
+    elementwise_impl<Tout, MulOp>(
+        x, y, out, pre, n, post, x_scale, y_scale, out_scale);
+  } else {
+    elementwise_impl<Tout, AddOp>(
+        x, y, out, pre, n, post, x_scale, y_scale, out_scale);
+  }
+}
+
+template <typename Tout, typename Op>
+static void elementwise_broadcast_impl(const int8_t* x,
+                                       const int8_t* y,
+                                       Tout* out,
+                                       const std::vector<int64_t>& out_dims,
+                                       const std::vector<int64_t>& x_strides,
+                                       const std::vector<int64_t>& y_strides,
+                                       float x_scale,
+                                       float y_scale,
+                                       float out_scale) {
+  const float inv_scale = output_inv_scale<Tout>(out_scale);
+  const int rank = static_cast<int>(out_dims.size());
+  CHECK_EQ(x_strides.size(), out_dims.size());
+  CHECK_EQ(y_strides.size(), out_dims.size());
+  int64_t num = 1;
+  for (auto dim : out_dims) num *= dim;
+  std::vector<int64_t> index(rank, 0);
+  int64_t x_offset = 0;
+  int64_t y_offset = 0;
+  for (int64_t i = 0; i < num; ++i) {
+    store_one(out + i,
+              Op::apply(x[x_offset] * x_scale, y[y_offset] * y_scale),
+              inv_scale);
+    // Advance the multi-dimensional index like an odometer
+    for (int d = rank - 1; d >= 0; --d) {
+      x_offset += x_strides[d];
+      y_offset += y_strides[d];
+      if (++index[d] < out_dims[d]) break;
+      x_offset -= x_strides[d] * out_dims[d];
+      y_offset -= y_strides[d] * out_dims[d];
+      index[d] = 0;
+    }
+  }
+}
+
+template <typename Tout>
+void int8_elementwise_broadcast(const int8_t* x,
+                                const int8_t* y,
+                                Tout* out,
+                                const std::vector<int64_t>& out_dims,
+                                const std::vector<int64_t>& x_strides,
+                                const std::vector<int64_t>& y_strides,
+                                float x_scale,
+                                float y_scale,
+                                float out_scale,
+                                bool is_mul) {
+  if (is_mul) {
+    elementwise_broadcast_impl<Tout, MulOp>(
+        x, y, out, out_dims, x_strides, y_strides, x_scale, y_scale, out_scale);
+  } else {
+    elementwise_broadcast_impl<Tout, AddOp>(
+        x, y, out, out_dims, x_strides, y_strides, x_scale, y_scale, out_scale);
+  }
+}
+
+#define INSTANTIATE_INT8_OPS(Tout)                                      \
+  template void int8_requantize<Tout>(                                  \
+      const int8_t*, Tout*, int64_t, float, float);                     \
+  template void int8_activation<Tout>(const int8_t*,                    \
+                                      Tout*,                            \
+                                      int64_t,                          \
+                                      float,                            \
+                                      float,                            \
+                                      const Int8ActivationParam&);      \
+  template void int8_pool2d<Tout>(const int8_t*,                        \
+                                  Tout*,                                \
+                                  int,                                  \
+                                  int,                                  \
+                                  int,                                  \
+                                  int,                                  \
+                                  int,                                  \
+                                  const std::vector<int>&,              \
+                                  const std::vector<int>&,              \
+                                  const std::vector<int>&,              \
+                                  bool,                                 \
+                                  bool,                                 \
+                                  float,                                \
+                                  float);                               \
+  template void int8_elementwise<Tout>(const int8_t*,                   \
+                                       const int8_t*,                   \
+                                       Tout*,                           \
+                                       int64_t,                         \
+                                       int64_t,                         \
+                                       int64_t,                         \
+                                       float,                           \
+                                       float,                           \
+                                       float,                           \
+                                       bool);                           \
+  template void int8_elementwise_broadcast<Tout>(                       \
+      const int8_t*,                                                    \
+      const int8_t*,                                                    \
+      Tout*,                                                            \
+      const std::vector<int64_t>&,                                      \
+      const std::vector<int64_t>&,                                      \
+      const std::vector<int64_t>&,                                      \
+      float,                                                            \
+      float,                                                            \
+      float,                                                            \
+      bool);
+
+INSTANTIATE_INT8_OPS(float)
+INSTANTIATE_INT8_OPS(int8_t)
+#undef INSTANTIATE_INT8_OPS
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,106 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Int8 routines for the ops between two quantized convolutions. A quantized
+// value q stands for q * scale. Every routine is instantiated for an int8
+// output, requantized with `out_scale` and saturated to [-127, 127] like
+// `fp32_to_int8`, and for an fp32 output, where `out_scale` is ignored, so a
+// tensor leaving the int8 region does not need a separate calib op.
+
+enum class Int8ActivationType { kRelu, kRelu6, kHardSwish };
+
+struct Int8ActivationParam {
+  Int8ActivationType type{Int8ActivationType::kRelu};
+  // relu6
+  float threshold{6.f};
+  // hard_swish
+  float hard_swish_threshold{6.f};
+  float hard_swish_scale{6.f};
+  float hard_swish_offset{3.f};
+};
+
+// out = requantize(x), a plain copy if the scales match.
+template <typename Tout>
+void int8_requantize(
+    const int8_t* x, Tout* out, int64_t num, float in_scale, float out_scale);
+
+template <typename Tout>
+void int8_activation(const int8_t* x,
+                     Tout* out,
+                     int64_t num,
+                     float in_scale,
+                     float out_scale,
+                     const Int8ActivationParam& act);
+
+// Max pooling compares the int8 values directly, average pooling accumulates
+// them in int32, both only rescale once per output element. `paddings` is
+// {top, bottom, left, right} and the windows follow `Pool2dFunctor`.
+template <typename Tout>
+void int8_pool2d(const int8_t* x,
+                 Tout* out,
+                 int planes,
+                 int in_h,
+                 int in_w,
+                 int out_h,
+                 int out_w,
+                 const std::vector<int>& ksize,
+                 const std::vector<int>& strides,
+                 const std::vector<int>& paddings,
+                 bool is_max,
+                 bool exclusive,
+                 float in_scale,
+                 float out_scale);
+
+// out[i, j, k] = x[i, j, k] op y[j] for x of shape [pre, n, post], `pre` = 1
+// and `post` = 1 cover inputs of the same shape.
+template <typename Tout>
+void int8_elementwise(const int8_t* x,
+                      const int8_t* y,
+                      Tout* out,
+                      int64_t pre,
+                      int64_t n,
+                      int64_t post,
+                      float x_scale,
+                      float y_scale,
+                      float out_scale,
+                      bool is_mul);
+
+// Any other broadcast, `x_strides` and `y_strides` are the strides of the
+// inputs over `out_dims`, 0 on the broadcast dimensions.
+template <typename Tout>
+void int8_elementwise_broadcast(const int8_t* x,
+                                const int8_t* y,
+                                Tout* out,
+                                const std::vector<int64_t>& out_dims,
+                                const std::vector<int64_t>& x_strides,
+                                const std::vector<int64_t>& y_strides,
+                                float x_scale,
+                                float y_scale,
+                                float out_scale,
+                                bool is_mul);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -20,6 +20,7 @@ limitations under the License. */
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/cpu_vec.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/tensor.h"
 
 namespace paddle {
@@ -151,39 +152,57 @@ class SoftmaxFunctor<Target, float, true, enable_if_CPU<Target>> {
         lite::jit::KernelFuncs<lite::jit::SoftmaxTuple<float>,
                                fluid::CPUPlace>::Cache()
             .At(in_dims[kClassDim]);
-    compute_softmax(in_data,
-                    out_data,
-                    in_dims[kClassDim],
-                    in_dims[kBatchDim],
-                    in_dims[kClassDim] / axis_dim);
+    const int length = in_dims[kClassDim];
+    // rows are independent, split them across threads
+    RunParallelFor(0, in_dims[kBatchDim], [&](int64_t begin, int64_t end) {
+      compute_softmax(in_data + begin * length,
+                      out_data + begin * length,
+                      length,
+                      static_cast<int>(end - begin),
+                      length / axis_dim);
+    });
 #else
-    const int batch_size = in_dims[kBatchDim];
     const int length = in_dims[kClassDim];
     const int stride = in_dims[kClassDim] / axis_dim;
-    for (int bs = 0; bs < batch_size; ++bs) {
-      // get max value of input data
-      float in_max = -FLT_MAX;
-      for (int i = 0; i < length; ++i) {
-        in_max = (std::max)(in_max, in_data[i]);
+    auto softmax_rows = [&](int64_t begin, int64_t end) {
+      const float* in_data_row = in_data + begin * length;
+      float* out_data_row = out_data + begin * length;
+      for (int64_t bs = begin; bs < end; ++bs) {
+        softmax_row(in_data_row, out_data_row, length, stride, axis_dim);
+        in_data_row += length;
+        out_data_row += length;
       }
-      // y = exp(x - in_max)
-      for (int i = 0; i < length; ++i) {
-        out_data[i] = static_cast<float>(std::exp(in_data[i] - in_max));
+    };
+    // rows are independent, split them across threads
+    RunParallelFor(0, in_dims[kBatchDim], softmax_rows);
+#endif
+  }
+
+ private:
+  static void softmax_row(const float* in_data,
+                          float* out_data,
+                          int length,
+                          int stride,
+                          int axis_dim) {
+    // get max value of input data
+    float in_max = -FLT_MAX;
+    for (int i = 0; i < length; ++i) {
+      in_max = (std::max)(in_max, in_data[i]);
+    }
+    // y = exp(x - in_max)
+    for (int i = 0; i < length; ++i) {
+      out_data[i] = static_cast<float>(std::exp(in_data[i] - in_max));
+    }
+    // y = y / sum(y[i], y[i + stride], y[i + stride + stride] ...)
+    for (int i = 0; i < stride; ++i) {
+      float sum = 0.f;
+      for (int j = 0; j < axis_dim; ++j) {
+        sum += out_data[i + j * stride];
       }
-      // y = y / sum(y[i], y[i + stride], y[i + stride + stride] ...)
-      for (int i = 0; i < stride; ++i) {
-        float sum = 0.f;
-        for (int j = 0; j < axis_dim; ++j) {
-          sum += out_data[i + j * stride];
-        }
-        for (int j = 0; j < axis_dim; ++j) {
-          out_data[i + j * stride] /= sum;
-        }
+      for (int j = 0; j < axis_dim; ++j) {
+        out_data[i + j * stride] /= sum;
       }
-      in_data += length;
-      out_data += length;
     }
-#endif
   }
 };
 
@@ -0,0 +1,274 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/transpose.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The side of the blocks of a 2-D transpose, a 64x64 float block of the
+// input and of the output fit in L1 together.
+static const int64_t kBlock = 64;
+// Smaller transposes run on the calling thread
+static const int64_t kParallelElements = 1 << 16;
+
+#ifdef __AVX__
+static const int64_t kTile = 8;
+
+static inline void transpose_tile(const float* src,
+                                  int64_t ld_src,
+                                  float* dst,
+                                  int64_t ld_dst) {
+  __m256 r0 = _mm256_loadu_ps(src);
+  __m256 r1 = _mm256_loadu_ps(src + ld_src);
+  __m256 r2 = _mm256_loadu_ps(src + 2 * ld_src);
+  __m256 r3 = _mm256_loadu_ps(src + 3 * ld_src);
+  __m256 r4 = _mm256_loadu_ps(src + 4 * ld_src);
+  __m256 r5 = _mm256_loadu_ps(src + 5 * ld_src);
+  __m256 r6 = _mm256_loadu_ps(src + 6 * ld_src);
+  __m256 r7 = _mm256_loadu_ps(src + 7 * ld_src);
+  // Interleave pairs of rows, then pairs of pairs, then swap the 128-bit
+  // lanes
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s0, s4, 0x20));
+  _mm256_storeu_ps(dst + ld_dst, _mm256_permute2f128_ps(s1, s5, 0x20));
+  _mm256_storeu_ps(dst + 2 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x20));
+  _mm256_storeu_ps(dst + 3 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x20));
+  _mm256_storeu_ps(dst + 4 * ld_dst, _mm256_permute2f128_ps(s0, s4, 0x31));
+  _mm256_storeu_ps(dst + 5 * ld_dst, _mm256_permute2f128_ps(s1, s5, 0x31));
+  _mm256_storeu_ps(dst + 6 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x31));
+  _mm256_storeu_ps(dst + 7 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+#else
+static const int64_t kTile = 4;
+
+static inline void transpose_tile(const float* src,
+                                  int64_t ld_src,
+                                  float* dst,
+                                  int64_t ld_dst) {
+  __m128 r0 = _mm_loadu_ps(src);
+  __m128 r1 = _mm_loadu_ps(src + ld_src);
+  __m128 r2 = _mm_loadu_ps(src + 2 * ld_src);
+  __m128 r3 = _mm_loadu_ps(src + 3 * ld_src);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(dst, r0);
+  _mm_storeu_ps(dst + ld_dst, r1);
+  _mm_storeu_ps(dst + 2 * ld_dst, r2);
+  _mm_storeu_ps(dst + 3 * ld_dst, r3);
+}
+#endif
+
+// dst[c * ld_dst + r] = src[r * ld_src + c] for the rows x cols block
+static void transpose_block(const float* src,
+                            int64_t ld_src,
+                            float* dst,
+                            int64_t ld_dst,
+                            int64_t rows,
+                            int64_t cols) {
+  int64_t r = 0;
+  for (; r + kTile <= rows; r += kTile) {
+    int64_t c = 0;
+    for (; c + kTile <= cols; c += kTile) {
+      transpose_tile(
+          src + r * ld_src + c, ld_src, dst + c * ld_dst + r, ld_dst);
+    }
+    for (; c < cols; c++) {
+      for (int64_t i = r; i < r + kTile; i++) {
+        dst[c * ld_dst + i] = src[i * ld_src + c];
+      }
+    }
+  }
+  for (; r < rows; r++) {
+    for (int64_t c = 0; c < cols; c++) {
+      dst[c * ld_dst + r] = src[r * ld_src + c];
+    }
+  }
+}
+
+template <typename Func>
+static void parallel_tasks(int64_t tasks, int64_t task_elements, Func func) {
+  if (tasks * task_elements < kParallelElements) {
+    func(0, tasks);
+  } else {
+    RunParallelFor(0, tasks, func);
+  }
+}
+
+// The permutations keeping the last axis
+static void transpose_rows(const float* din,
+                           float* dout,
+                           const std::vector<int64_t>& dims,
+                           const std::vector<int>& perm) {
+  const int outer_rank = static_cast<int>(dims.size()) - 1;
+  const int64_t inner = dims[outer_rank];
+  std::vector<int64_t> in_strides(outer_rank + 1, 1);
+  for (int i = outer_rank - 1; i >= 0; i--) {
+    in_strides[i] = in_strides[i + 1] * dims[i + 1];
+  }
+  // The output dims but the last, and the input strides along them
+  std::vector<int64_t> out_dims(outer_rank);
+  std::vector<int64_t> strides(outer_rank);
+  int64_t outer = 1;
+  for (int i = 0; i < outer_rank; i++) {
+    out_dims[i] = dims[perm[i]];
+    strides[i] = in_strides[perm[i]];
+    outer *= out_dims[i];
+  }
+  parallel_tasks(outer, inner, [&](int64_t begin, int64_t end) {
+    std::vector<int64_t> index(outer_rank);
+    int64_t offset = 0;
+    int64_t rest = begin;
+    for (int i = outer_rank - 1; i >= 0; i--) {
+      index[i] = rest % out_dims[i];
+      rest /= out_dims[i];
+      offset += index[i] * strides[i];
+    }
+    for (int64_t row = begin; row < end; row++) {
+      std::memcpy(dout + row * inner, din + offset, inner * sizeof(float));
+      for (int i = outer_rank - 1; i >= 0; i--) {
+        offset += strides[i];
+        if (++index[i] < out_dims[i]) break;
+        offset -= index[i] * strides[i];
+        index[i] = 0;
+      }
+    }
+  });
+}
+
+// The permutations swapping the last two axes
+static void transpose_batched_2d(const float* din,
+                                 float* dout,
+                                 int64_t batch,
+                                 int64_t rows,
+                                 int64_t cols) {
+  const int64_t row_blocks = (rows + kBlock - 1) / kBlock;
+  const int64_t col_blocks = (cols + kBlock - 1) / kBlock;
+  const int64_t blocks = row_blocks * col_blocks;
+  parallel_tasks(
+      batch * blocks, kBlock * kBlock, [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; task++) {
+          const int64_t b = task / blocks;
+          const int64_t r = task % blocks / col_blocks * kBlock;
+          const int64_t c = task % col_blocks * kBlock;
+          const float* src = din + b * rows * cols + r * cols + c;
+          float* dst = dout + b * rows * cols + c * rows + r;
+          transpose_block(src,
+                          cols,
+                          dst,
+                          rows,
+                          (std::min)(kBlock, rows - r),
+                          (std::min)(kBlock, cols - c));
+        }
+      });
+}
+
+void collapse_transpose_axes(const std::vector<int64_t>& in_dims,
+                             const std::vector<int>& axis,
+                             std::vector<int64_t>* dims,
+                             std::vector<int>* perm) {
+  const int rank = static_cast<int>(axis.size());
+  std::vector<int> kept_index(rank, -1);
+  std::vector<int64_t> kept_dims;
+  for (int i = 0; i < rank; i++) {
+    if (in_dims[i] != 1) {
+      kept_index[i] = static_cast<int>(kept_dims.size());
+      kept_dims.push_back(in_dims[i]);
+    }
+  }
+  // The input axes of every group of adjacent axes, in output order
+  std::vector<int> group_begin;
+  std::vector<int> group_end;
+  for (int i = 0; i < rank; i++) {
+    int index = kept_index[axis[i]];
+    if (index < 0) continue;
+    if (!group_end.empty() && index == group_end.back() + 1) {
+      group_end.back() = index;
+    } else {
+      group_begin.push_back(index);
+      group_end.push_back(index);
+    }
+  }
+  std::vector<int> order(group_begin.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return group_begin[a] < group_begin[b];
+  });
+  dims->clear();
+  perm->assign(order.size(), 0);
+  for (size_t i = 0; i < order.size(); i++) {
+    const int group = order[i];
+    int64_t dim = 1;
+    for (int j = group_begin[group]; j <= group_end[group]; j++) {
+      dim *= kept_dims[j];
+    }
+    dims->push_back(dim);
+    (*perm)[group] = static_cast<int>(i);
+  }
+}
+
+bool transpose_blocked(const float* din,
+                       float* dout,
+                       const std::vector<int64_t>& in_dims,
+                       const std::vector<int>& axis) {
+  std::vector<int64_t> dims;
+  std::vector<int> perm;
+  collapse_transpose_axes(in_dims, axis, &dims, &perm);
+  const int rank = static_cast<int>(dims.size());
+  if (rank <= 1) {
+    int64_t size = rank == 0 ? 1 : dims[0];
+    std::memcpy(dout, din, size * sizeof(float));
+    return true;
+  }
+  if (perm[rank - 1] == rank - 1) {
+    transpose_rows(din, dout, dims, perm);
+    return true;
+  }
+  if (perm[rank - 1] != rank - 2 || perm[rank - 2] != rank - 1) {
+    return false;
+  }
+  int64_t batch = 1;
+  for (int i = 0; i < rank - 2; i++) {
+    if (perm[i] != i) return false;
+    batch *= dims[i];
+  }
+  transpose_batched_2d(din, dout, batch, dims[rank - 2], dims[rank - 1]);
+  return true;
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
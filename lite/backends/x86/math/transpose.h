@@ -0,0 +1,48 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Merges the axes that stay adjacent and in order through `axis` and drops
+// the axes of size 1, e.g. [N, C, H, W] by {0, 2, 3, 1} becomes [N, C, H*W]
+// by {0, 2, 1}.
+void collapse_transpose_axes(const std::vector<int64_t>& in_dims,
+                             const std::vector<int>& axis,
+                             std::vector<int64_t>* dims,
+                             std::vector<int>* perm);
+
+// Transposes a float tensor with cache blocked kernels, and returns false
+// without writing `dout` if the permutation is not supported. After
+// collapse_transpose_axes the supported permutations are
+// - those keeping the last axis, e.g. 0213: rows are copied as a whole.
+// - those swapping the last two axes, e.g. 0231 and 0312: batches of 2-D
+//   transposes done by 8x8 (AVX) or 4x4 (SSE) register tiles within blocks
+//   fitting in L1.
+bool transpose_blocked(const float* din,
+                       float* dout,
+                       const std::vector<int64_t>& in_dims,
+                       const std::vector<int>& axis);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
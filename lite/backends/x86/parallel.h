@@ -15,9 +15,16 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
+#include <vector>
+#include "lite/backends/x86/cpu_info.h"
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 #include "lite/backends/x86/mklml.h"
+#elif defined(LITE_USE_THREAD_POOL)
+#include <mutex>  // NOLINT
+#include "lite/core/thread_pool.h"
+#include "lite/utils/log/cp_logging.h"
 #endif
 
 namespace paddle {
@@ -33,18 +40,92 @@ static void SetNumThreads(int num_threads) {
   x86::MKL_Set_Num_Threads(real_num_threads);
 #endif
   omp_set_num_threads(real_num_threads);
+#elif defined(LITE_USE_THREAD_POOL)
+  // The pool is shared with the ARM kernels and is created once, by the
+  // first predictor asking for more than one thread. It runs one
+  // parallel-for at a time, a predictor finding it busy with another one
+  // runs its parallel-fors on its own thread instead, see RunParallelFor.
+  ThreadPool::Init(num_threads);
 #endif
 }
 
+#if !defined(PADDLE_WITH_MKLML) && defined(LITE_USE_THREAD_POOL)
+// Set on every thread that runs a chunk of a pooled RunParallelFor, nested
+// parallel-fors run serially on the calling thread because the pool is not
+// reentrant.
+inline bool& InParallelRegion() {
+  static thread_local bool in_parallel = false;
+  return in_parallel;
+}
+
+// Held for the duration of a pooled parallel-for, so two predictors running
+// on different threads never share the pool at the same time.
+inline std::mutex& ParallelRegionMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// The CPUs the threads of the pool are pinned to, guarded by
+// ParallelRegionMutex.
+inline std::vector<int>& PoolCpuIds() {
+  static std::vector<int> cpu_ids;
+  return cpu_ids;
+}
+#endif
+
 static inline int64_t GetMaxThreads() {
   int64_t num_threads = 1;
 #ifdef PADDLE_WITH_MKLML
   // Do not support nested omp parallem.
   num_threads = omp_in_parallel() ? 1 : omp_get_max_threads();
+#elif defined(LITE_USE_THREAD_POOL)
+  num_threads = InParallelRegion() ? 1 : ThreadPool::ActiveThreadNum();
 #endif
   return (std::max<int>)(num_threads, 1L);
 }
 
+// Pins the calling thread and the threads that run the x86 kernels for it,
+// the i-th thread of the team or the pool to cpu_ids[i % cpu_ids.size()].
+// The pool is shared by all of the predictors of the process, it keeps the
+// first binding and refuses another set of CPUs, and it is not rebound while
+// a parallel-for runs on it. Returns false if any thread is not pinned.
+static bool BindThreads(const std::vector<int>& cpu_ids) {
+  if (cpu_ids.empty()) return false;
+  const int num_cpus = static_cast<int>(cpu_ids.size());
+  // Without a team the calling thread may float over the whole set
+  bool ok = BindCurrentThread(cpu_ids);
+#ifdef PADDLE_WITH_MKLML
+  int num_threads = static_cast<int>(GetMaxThreads());
+  if (num_threads > 1) {
+    std::vector<char> results(num_threads, 0);
+#pragma omp parallel num_threads(num_threads)
+    {
+      int tid = omp_get_thread_num();
+      results[tid] = BindCurrentThread({cpu_ids[tid % num_cpus]});
+    }
+    for (char result : results) ok = ok && result;
+  }
+#elif defined(LITE_USE_THREAD_POOL)
+  int num_threads = ThreadPool::ThreadNum();
+  if (num_threads > 1) {
+    if (InParallelRegion()) return false;
+    std::unique_lock<std::mutex> lock(ParallelRegionMutex(), std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    auto& pool_cpu_ids = PoolCpuIds();
+    if (!pool_cpu_ids.empty()) return ok && pool_cpu_ids == cpu_ids;
+    std::vector<char> results(num_threads, 0);
+    ThreadPool::Enqueue({[&](int index, int tid) {
+                           results[index] =
+                               BindCurrentThread({cpu_ids[index % num_cpus]});
+                         },
+                         num_threads});
+    for (char result : results) ok = ok && result;
+    if (ok) pool_cpu_ids = cpu_ids;
+  }
+#endif
+  return ok;
+}
+
 using ThreadHandler =
     std::function<void(const int64_t begin, const int64_t end)>;
 
@@ -67,6 +148,30 @@ static inline void RunParallelFor(const int64_t begin,
     }
     return;
   }
+#elif defined(LITE_USE_THREAD_POOL)
+  int64_t num_threads = (std::min)(GetMaxThreads(), end - begin);
+  if (num_threads > 1) {
+    std::unique_lock<std::mutex> lock(ParallelRegionMutex(), std::try_to_lock);
+    if (lock.owns_lock()) {
+      int64_t chunk_size = (end - begin + num_threads - 1) / num_threads;
+      ThreadPool::Enqueue({[&](int tid, int) {
+                             int64_t begin_tid = begin + tid * chunk_size;
+                             int64_t end_tid =
+                                 (std::min)(end, chunk_size + begin_tid);
+                             if (begin_tid >= end_tid) return;
+                             InParallelRegion() = true;
+                             f(begin_tid, end_tid);
+                             InParallelRegion() = false;
+                           },
+                           static_cast<int>(num_threads)});
+      return;
+    }
+    static std::once_flag busy_logged;
+    std::call_once(busy_logged, [] {
+      VLOG(1) << "The thread pool is busy with another predictor, running "
+                 "the parallel-for on the calling thread";
+    });
+  }
 #endif
 
   f(begin, end);
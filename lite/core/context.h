@@ -150,6 +150,20 @@ class Context<TargetType::kNNAdapter> {
     return var->Get<std::string>();
   }
 
+  static void SetNNAdapterAsyncExecution(Scope* scope, bool async_execution) {
+    auto var = scope->Var("NNADAPTER_ASYNC_EXECUTION");
+    CHECK(var);
+    auto data = var->GetMutable<bool>();
+    CHECK(data);
+    *data = async_execution;
+  }
+
+  static bool NNAdapterAsyncExecution(Scope* scope) {
+    auto var = scope->FindVar("NNADAPTER_ASYNC_EXECUTION");
+    if (!var) return false;
+    return var->Get<bool>();
+  }
+
   static void SetNNAdapterDynamicShapeInfo(
       Scope* scope,
       const std::map<std::string, std::vector<std::vector<int64_t>>>&
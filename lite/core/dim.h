@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <functional>  // for multiplies
+#include <initializer_list>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -27,6 +28,171 @@ namespace paddle {
 namespace lite {
 // class DDimLite;
 
+// A vector of dims which keeps up to `kInlineSize` elements inline, so
+// copying, resizing and comparing the shapes of common tensors never touches
+// the heap. It mimics the parts of std::vector the code base uses on shapes
+// and converts to std::vector implicitly. The conversion takes no part in
+// template argument deduction, so pass Vectorize() to templates taking a
+// std::vector<T>.
+class DimVector {
+ public:
+  using value_type = int64_t;
+  using size_type = size_t;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = value_type *;
+  using const_iterator = const value_type *;
+
+  static constexpr size_t kInlineSize = 8;
+
+  DimVector() = default;
+  DimVector(size_t size, value_type value) { assign(size, value); }
+  DimVector(const value_type *first, const value_type *last) {
+    assign(first, last);
+  }
+  DimVector(std::initializer_list<value_type> init) {
+    assign(init.begin(), init.end());
+  }
+  explicit DimVector(const std::vector<value_type> &x) {
+    assign(x.data(), x.data() + x.size());
+  }
+  DimVector(const DimVector &other) { assign(other.begin(), other.end()); }
+  DimVector(DimVector &&other) noexcept { *this = std::move(other); }
+  ~DimVector() { delete[] heap_; }
+
+  DimVector &operator=(const DimVector &other) {
+    if (this != &other) assign(other.begin(), other.end());
+    return *this;
+  }
+  DimVector &operator=(DimVector &&other) noexcept {
+    if (this == &other) return *this;
+    if (other.heap_ == nullptr) {
+      std::copy(other.inline_, other.inline_ + other.size_, data());
+    } else {
+      delete[] heap_;
+      heap_ = other.heap_;
+      capacity_ = other.capacity_;
+      other.heap_ = nullptr;
+      other.capacity_ = kInlineSize;
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+    return *this;
+  }
+
+  operator std::vector<value_type>() const {  // NOLINT
+    return std::vector<value_type>(begin(), end());
+  }
+
+  void assign(size_t size, value_type value) {
+    resize(0);
+    resize(size, value);
+  }
+  void assign(const value_type *first, const value_type *last) {
+    size_t size = static_cast<size_t>(last - first);
+    reserve(size);
+    std::copy(first, last, data());
+    size_ = size;
+  }
+
+  value_type *data() { return heap_ ? heap_ : inline_; }
+  const value_type *data() const { return heap_ ? heap_ : inline_; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  value_type &operator[](size_t i) { return data()[i]; }
+  const value_type &operator[](size_t i) const { return data()[i]; }
+  value_type &at(size_t i) { return data()[i]; }
+  const value_type &at(size_t i) const { return data()[i]; }
+  value_type &front() { return data()[0]; }
+  const value_type &front() const { return data()[0]; }
+  value_type &back() { return data()[size_ - 1]; }
+  const value_type &back() const { return data()[size_ - 1]; }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + size_; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + size_; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  void reserve(size_t capacity) {
+    if (capacity <= capacity_) return;
+    value_type *heap = new value_type[capacity];
+    std::copy(begin(), end(), heap);
+    delete[] heap_;
+    heap_ = heap;
+    capacity_ = capacity;
+  }
+  void resize(size_t size, value_type value = 0) {
+    reserve(size);
+    if (size > size_) std::fill(data() + size_, data() + size, value);
+    size_ = size;
+  }
+  void clear() { size_ = 0; }
+  void push_back(value_type value) {
+    if (size_ == capacity_) reserve(capacity_ * 2);
+    data()[size_++] = value;
+  }
+  void emplace_back(value_type value) { push_back(value); }
+  void pop_back() { --size_; }
+
+  iterator insert(const_iterator pos, value_type value) {
+    return insert(pos, &value, &value + 1);
+  }
+  iterator insert(const_iterator pos,
+                  const value_type *first,
+                  const value_type *last) {
+    size_t offset = static_cast<size_t>(pos - begin());
+    size_t count = static_cast<size_t>(last - first);
+    // `first` may point into this vector
+    DimVector values(first, last);
+    reserve(size_ + count);
+    std::copy_backward(data() + offset, end(), end() + count);
+    std::copy(values.begin(), values.end(), data() + offset);
+    size_ += count;
+    return data() + offset;
+  }
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+  iterator erase(const_iterator first, const_iterator last) {
+    size_t offset = static_cast<size_t>(first - begin());
+    size_t count = static_cast<size_t>(last - first);
+    std::copy(data() + offset + count, end(), data() + offset);
+    size_ -= count;
+    return data() + offset;
+  }
+
+  friend bool operator==(const DimVector &a, const DimVector &b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+  friend bool operator!=(const DimVector &a, const DimVector &b) {
+    return !(a == b);
+  }
+  friend bool operator==(const DimVector &a,
+                         const std::vector<value_type> &b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+  friend bool operator==(const std::vector<value_type> &a,
+                         const DimVector &b) {
+    return b == a;
+  }
+  friend bool operator!=(const DimVector &a,
+                         const std::vector<value_type> &b) {
+    return !(a == b);
+  }
+  friend bool operator!=(const std::vector<value_type> &a,
+                         const DimVector &b) {
+    return !(b == a);
+  }
+
+ private:
+  value_type inline_[kInlineSize];
+  value_type *heap_{nullptr};
+  size_t size_{0};
+  size_t capacity_{kInlineSize};
+};
+
 class DDimLite {
  public:
   using value_type = int64_t;
@@ -37,7 +203,9 @@ class DDimLite {
   // DDimLite(std::initializer_list<value_type> init_list) :
   // DDimLite(std::vector<value_type>(init_list)) {}
 
-  void ConstructFrom(const std::vector<value_type> &x) { data_ = x; }
+  void ConstructFrom(const std::vector<value_type> &x) {
+    data_.assign(x.data(), x.data() + x.size());
+  }
 
   value_type operator[](int offset) const { return data_[offset]; }
   value_type &operator[](int offset) { return data_[offset]; }
@@ -48,14 +216,16 @@ class DDimLite {
 
   value_type production() const;
 
-  const std::vector<value_type> &data() const { return data_; }
+  const DimVector &data() const { return data_; }
   value_type count(int start, int end) const;
 
   DDimLite Slice(int start, int end) const;
 
   DDimLite Flatten2D(int col) const {
-    return DDimLite(std::vector<value_type>(
-        {Slice(0, col).production(), Slice(col, size()).production()}));
+    DDimLite flattened;
+    flattened.data_.assign(2, count(0, col));
+    flattened.data_[1] = count(col, size());
+    return flattened;
   }
 
   std::string repr() const;
@@ -66,23 +236,15 @@ class DDimLite {
   }
 
   friend bool operator==(const DDimLite &a, const DDimLite &b) {
-    if (a.size() != b.size()) return false;
-    for (size_t i = 0; i < a.size(); i++) {
-      if (a[i] != b[i]) return false;
-    }
-    return true;
+    return a.data_ == b.data_;
   }
 
   friend bool operator!=(const DDimLite &a, const DDimLite &b) {
-    if (a.size() != b.size()) return true;
-    for (size_t i = 0; i < a.size(); i++) {
-      if (a[i] != b[i]) return true;
-    }
-    return false;
+    return a.data_ != b.data_;
   }
 
  private:
-  std::vector<value_type> data_;
+  DimVector data_;
 };
 
 using DDim = paddle::lite::DDimLite;
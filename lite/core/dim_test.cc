@@ -0,0 +1,75 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "lite/core/dim.h"
+
+// Counts the heap allocations of this test binary.
+static std::atomic<int64_t> g_alloc_count{0};
+
+void* operator new(size_t size) {
+  g_alloc_count++;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace paddle {
+namespace lite {
+
+TEST(dim_vector, basic) {
+  DimVector dims({1, 3, 224, 224});
+  EXPECT_EQ(dims.size(), 4UL);
+  EXPECT_EQ(dims[2], 224);
+  dims.insert(dims.begin(), 8);
+  dims.erase(dims.begin() + 1);
+  EXPECT_EQ(dims, std::vector<int64_t>({8, 3, 224, 224}));
+  // Grow past the inline storage and back
+  for (int i = 0; i < 12; i++) dims.push_back(i);
+  EXPECT_EQ(dims.size(), 16UL);
+  EXPECT_EQ(dims.back(), 11);
+  DimVector small({2, 2});
+  dims = std::move(small);
+  EXPECT_EQ(dims, DimVector({2, 2}));
+  std::vector<int64_t> converted = dims;
+  EXPECT_EQ(converted, std::vector<int64_t>({2, 2}));
+}
+
+TEST(ddim, no_allocation_in_steady_state) {
+  DDim shape({1, 3, 224, 224});
+  DDim other;
+  int64_t hits = 0;
+  int64_t before = g_alloc_count.load();
+  for (int i = 0; i < 1000; i++) {
+    // What a Run() does to shapes: resize, copy, compare and reshape
+    other = shape;
+    other[0] = i % 4 + 1;
+    hits += other == shape;
+    DDim flattened = other.Flatten2D(1);
+    DDim sliced = other.Slice(1, 3);
+    hits += flattened.production() == other.production();
+    hits += sliced.size() == 2;
+  }
+  EXPECT_EQ(g_alloc_count.load() - before, 0);
+  EXPECT_EQ(hits, 250 + 2000);
+}
+
+}  // namespace lite
+}  // namespace paddle
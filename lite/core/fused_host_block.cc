@@ -0,0 +1,111 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/fused_host_block.h"
+#include <set>
+#include <string>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+FusedHostBlock::FusedHostBlock(const std::vector<Instruction*>& insts)
+    : insts_(insts) {}
+
+static Tensor* FindTensor(Scope* scope, const std::string& name) {
+  auto* var = scope->FindVar(name);
+  if (var == nullptr || !var->IsType<Tensor>()) return nullptr;
+  return var->GetMutable<Tensor>();
+}
+
+bool FusedHostBlock::Init() {
+  std::set<std::string> produced;
+  std::set<std::string> consumed;
+  inputs_.clear();
+  outputs_.clear();
+  for (auto* inst : insts_) {
+    auto* op = inst->mutable_op();
+    if (op->run_once() || op->scope() == nullptr) return false;
+    auto* op_info = op->op_info();
+    for (auto& name : op_info->input_vars()) {
+      if (produced.count(name) || consumed.count(name)) continue;
+      auto* tensor = FindTensor(op->scope(), name);
+      if (tensor == nullptr) return false;
+      consumed.insert(name);
+      inputs_.push_back(tensor);
+    }
+    std::vector<Tensor*> outputs;
+    for (auto& name : op_info->output_vars()) {
+      // Writing an input of the block would change the shapes it is keyed on
+      if (consumed.count(name)) return false;
+      auto* tensor = FindTensor(op->scope(), name);
+      if (tensor == nullptr) return false;
+      produced.insert(name);
+      outputs.push_back(tensor);
+    }
+    outputs_.push_back(outputs);
+  }
+  input_dims_.resize(inputs_.size());
+  input_lods_.resize(inputs_.size());
+  output_dims_.resize(outputs_.size());
+  output_lods_.resize(outputs_.size());
+  for (size_t i = 0; i < outputs_.size(); i++) {
+    output_dims_[i].resize(outputs_[i].size());
+    output_lods_[i].resize(outputs_[i].size());
+  }
+  has_shapes_ = false;
+  return true;
+}
+
+bool FusedHostBlock::InputsUnchanged() const {
+  for (size_t i = 0; i < inputs_.size(); i++) {
+    if (inputs_[i]->dims() != input_dims_[i] ||
+        inputs_[i]->lod() != input_lods_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FusedHostBlock::Run() {
+  if (has_shapes_ && InputsUnchanged()) {
+    for (size_t i = 0; i < insts_.size(); i++) {
+      auto& outputs = outputs_[i];
+      for (size_t j = 0; j < outputs.size(); j++) {
+        outputs[j]->Resize(output_dims_[i][j]);
+        outputs[j]->set_lod(output_lods_[i][j]);
+      }
+      insts_[i]->mutable_kernel()->Launch();
+    }
+    return;
+  }
+  // The shapes changed, run every op as usual and record the new shapes
+  for (size_t i = 0; i < inputs_.size(); i++) {
+    input_dims_[i] = inputs_[i]->dims();
+    input_lods_[i] = inputs_[i]->lod();
+  }
+  for (auto* inst : insts_) {
+    inst->Run();
+  }
+  for (size_t i = 0; i < outputs_.size(); i++) {
+    for (size_t j = 0; j < outputs_[i].size(); j++) {
+      output_dims_[i][j] = outputs_[i][j]->dims();
+      output_lods_[i][j] = outputs_[i][j]->lod();
+    }
+  }
+  has_shapes_ = true;
+}
+
+}  // namespace lite
+}  // namespace paddle
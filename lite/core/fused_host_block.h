@@ -0,0 +1,62 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "lite/core/dim.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+// The ops marked with the same id by host_block_fuse_pass run as one
+// FusedHostBlock if their instructions are consecutive.
+static const char kFusedHostBlockAttr[] = "__fused_host_block_id__";
+
+// A run of small host/x86 instructions executed as a single unit. The
+// tensors of the block are bound once, and as long as the shapes and lods
+// of its external inputs don't change, none of its ops runs InferShape: the
+// outputs are resized to the shapes recorded by the last full run and the
+// kernels are launched back to back.
+class FusedHostBlock {
+ public:
+  explicit FusedHostBlock(const std::vector<Instruction*>& insts);
+
+  // Binds the input and output tensors, returns false if any variable of the
+  // block is not a tensor, the block can't be fused then.
+  bool Init();
+  void Run();
+
+  const std::vector<Instruction*>& instructions() const { return insts_; }
+
+ private:
+  bool InputsUnchanged() const;
+
+  std::vector<Instruction*> insts_;
+  // The tensors read by the block but written outside of it
+  std::vector<const Tensor*> inputs_;
+  std::vector<DDim> input_dims_;
+  std::vector<LoD> input_lods_;
+  // The output tensors of every instruction and their last shapes
+  std::vector<std::vector<Tensor*>> outputs_;
+  std::vector<std::vector<DDim>> output_dims_;
+  std::vector<std::vector<LoD>> output_lods_;
+  bool has_shapes_{false};
+};
+
+}  // namespace lite
+}  // namespace paddle
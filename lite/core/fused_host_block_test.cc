@@ -0,0 +1,169 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/fused_host_block.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+cpp::OpDesc ScaleDesc(const std::string& x, const std::string& out) {
+  cpp::OpDesc desc;
+  desc.SetType("scale");
+  desc.SetInput("X", {x});
+  desc.SetOutput("Out", {out});
+  desc.SetAttr<float>("scale", 2.f);
+  desc.SetAttr<float>("bias", 1.f);
+  desc.SetAttr<bool>("bias_after_scale", true);
+  return desc;
+}
+
+cpp::OpDesc AddDesc(const std::string& x,
+                    const std::string& y,
+                    const std::string& out) {
+  cpp::OpDesc desc;
+  desc.SetType("elementwise_add");
+  desc.SetInput("X", {x});
+  desc.SetInput("Y", {y});
+  desc.SetOutput("Out", {out});
+  desc.SetAttr<int>("axis", -1);
+  return desc;
+}
+
+cpp::OpDesc ShapeDesc(const std::string& input, const std::string& out) {
+  cpp::OpDesc desc;
+  desc.SetType("shape");
+  desc.SetInput("Input", {input});
+  desc.SetOutput("Out", {out});
+  return desc;
+}
+
+// Every op runs its "def" kernel, marked as one fused host block if `fused`.
+std::unique_ptr<RuntimeProgram> BuildProgram(std::vector<cpp::OpDesc> descs,
+                                             bool fused,
+                                             Scope* scope) {
+  std::vector<std::vector<Instruction>> insts(1);
+  for (auto& desc : descs) {
+    if (fused) desc.SetAttr<int>(kFusedHostBlockAttr, 0);
+    for (auto& output : desc.outputs()) {
+      for (auto& name : output.second) {
+        scope->Var(name)->GetMutable<Tensor>();
+      }
+    }
+    auto op = LiteOpRegistry::Global().Create(desc.Type());
+    CHECK(op);
+    op->Attach(desc, scope);
+    Place place{TARGET(kX86), PRECISION(kFloat)};
+    if (desc.Type() == "shape") place = Place{TARGET(kHost), PRECISION(kAny)};
+    std::unique_ptr<KernelBase> picked;
+    for (auto& kernel : op->CreateKernels({place})) {
+      if (kernel->alias() == "def") picked = std::move(kernel);
+    }
+    CHECK(picked) << "No kernel for " << desc.Type();
+    insts[0].emplace_back(std::move(op), std::move(picked));
+  }
+  return std::unique_ptr<RuntimeProgram>(new RuntimeProgram(std::move(insts)));
+}
+
+std::vector<Instruction*> Instructions(RuntimeProgram* program) {
+  std::vector<Instruction*> insts;
+  for (auto& inst : *program->mutable_instructions()) {
+    insts.push_back(&inst);
+  }
+  return insts;
+}
+
+void FillInput(Scope* scope, const DDim& dims, int step) {
+  auto* x = scope->FindVar("x")->GetMutable<Tensor>();
+  x->Resize(dims);
+  auto* x_data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    x_data[i] = static_cast<float>((i + step) % 5) - 2.f;
+  }
+}
+
+template <typename T>
+void ExpectSameTensor(Scope* a, Scope* b, const std::string& name) {
+  auto* ta = a->FindVar(name)->GetMutable<Tensor>();
+  auto* tb = b->FindVar(name)->GetMutable<Tensor>();
+  ASSERT_EQ(ta->dims(), tb->dims()) << name;
+  for (int64_t i = 0; i < ta->numel(); i++) {
+    EXPECT_EQ(ta->data<T>()[i], tb->data<T>()[i]) << name << " at " << i;
+  }
+}
+
+// x -> scale -> y, (y, x) -> elementwise_add -> z -> shape -> s, run while
+// the values and then the shape of x change.
+TEST(FusedHostBlock, same_outputs_as_unfused) {
+  Scope fused_scope, unfused_scope;
+  auto descs = std::vector<cpp::OpDesc>{
+      ScaleDesc("x", "y"), AddDesc("y", "x", "z"), ShapeDesc("z", "s")};
+  for (auto* scope : {&fused_scope, &unfused_scope}) {
+    scope->Var("x")->GetMutable<Tensor>()->Resize({2, 3});
+  }
+  auto fused = BuildProgram(descs, true, &fused_scope);
+  auto unfused = BuildProgram(descs, false, &unfused_scope);
+  FusedHostBlock block(Instructions(fused.get()));
+  EXPECT_TRUE(block.Init());
+
+  std::vector<DDim> dims{
+      DDim({2, 3}), DDim({2, 3}), DDim({4, 3}), DDim({4, 3})};
+  for (size_t step = 0; step < dims.size(); step++) {
+    FillInput(&fused_scope, dims[step], step);
+    FillInput(&unfused_scope, dims[step], step);
+    fused->Run();
+    unfused->Run();
+    ExpectSameTensor<float>(&fused_scope, &unfused_scope, "z");
+    ExpectSameTensor<int32_t>(&fused_scope, &unfused_scope, "s");
+  }
+}
+
+// The elementwise_add writes x, an input of the block, so the block is not
+// fused and its ops run one by one.
+TEST(FusedHostBlock, block_writing_its_input_is_not_fused) {
+  Scope fused_scope, unfused_scope;
+  auto descs =
+      std::vector<cpp::OpDesc>{ScaleDesc("x", "y"), AddDesc("y", "x", "x")};
+  for (auto* scope : {&fused_scope, &unfused_scope}) {
+    scope->Var("x")->GetMutable<Tensor>()->Resize({2, 3});
+  }
+  auto fused = BuildProgram(descs, true, &fused_scope);
+  auto unfused = BuildProgram(descs, false, &unfused_scope);
+  FusedHostBlock block(Instructions(fused.get()));
+  EXPECT_FALSE(block.Init());
+
+  FillInput(&fused_scope, DDim({2, 3}), 0);
+  FillInput(&unfused_scope, DDim({2, 3}), 0);
+  for (int step = 0; step < 3; step++) {
+    fused->Run();
+    unfused->Run();
+    ExpectSameTensor<float>(&fused_scope, &unfused_scope, "x");
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(scale);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(shape);
+USE_LITE_KERNEL(scale, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(shape, kHost, kAny, kAny, def);
@@ -58,6 +58,12 @@ class KernelBase {
   /// Run the kernel. Before Run, both the param_ and context_ should be valid.
   virtual void Run() = 0;
 
+  /// Whether `Run` returned before the outputs are ready, e.g. the NNAdapter
+  /// subgraph kernel in the asynchronous mode. `Wait` blocks until they are,
+  /// the program calls it before any later kernel touches the same variables.
+  virtual bool IsPending() const { return false; }
+  virtual void Wait() {}
+
 #ifdef LITE_WITH_METAL
   virtual void SaveOutput() {}
 #endif
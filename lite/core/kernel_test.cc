@@ -15,6 +15,7 @@
 #include "lite/core/kernel.h"
 #include <gtest/gtest.h>
 #include "lite/core/op_lite.h"
+#include "lite/core/op_registry.h"
 
 namespace paddle {
 namespace lite {
@@ -58,6 +59,39 @@ TEST(Kernel, kernel_type) {
   ASSERT_EQ(place, place1);
 }
 
+TEST(Kernel, create_by_alias) {
+  int created = 0;
+  for (std::string alias : {"def", "fast"}) {
+    KernelRegistry::Global().RegisterCreator(
+        "kernel_alias_test",
+        TARGET(kHost),
+        PRECISION(kFloat),
+        DATALAYOUT(kNCHW),
+        alias,
+        [&created, alias]() {
+          created++;
+          std::unique_ptr<KernelBase> kernel(new SomeKernel);
+          kernel->set_op_type("kernel_alias_test");
+          kernel->set_alias(alias);
+          return kernel;
+        });
+  }
+  auto kernel = KernelRegistry::Global().Create("kernel_alias_test",
+                                                TARGET(kHost),
+                                                PRECISION(kFloat),
+                                                DATALAYOUT(kNCHW),
+                                                "fast");
+  ASSERT_TRUE(kernel);
+  ASSERT_EQ(kernel->alias(), "fast");
+  ASSERT_EQ(created, 1);
+  ASSERT_FALSE(KernelRegistry::Global().Create("kernel_alias_test",
+                                               TARGET(kHost),
+                                               PRECISION(kFloat),
+                                               DATALAYOUT(kNCHW),
+                                               "none"));
+  ASSERT_EQ(created, 1);
+}
+
 }  // namespace core
 }  // namespace lite
 }  // namespace paddle
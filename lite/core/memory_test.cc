@@ -14,6 +14,8 @@
 
 #include "lite/core/memory.h"
 #include <gtest/gtest.h>
+#include <thread>  // NOLINT
+#include "lite/backends/host/host_allocator.h"
 
 namespace paddle {
 namespace lite {
@@ -36,5 +38,132 @@ TEST(memory, test) {
 #endif
 }
 
+TEST(host_allocator, size_class) {
+  size_t prev = 0;
+  for (int c = 0; c < HostAllocator::kNumClasses; ++c) {
+    size_t bytes = HostAllocator::ClassBytes(c);
+    ASSERT_GT(bytes, prev);
+    ASSERT_EQ(HostAllocator::SizeClass(bytes), c);
+    ASSERT_EQ(HostAllocator::SizeClass(prev + 1), c);
+    // at most 25% is wasted by rounding up
+    ASSERT_LE(bytes, (prev + 1) + (prev + 1) / 4 + 256);
+    prev = bytes;
+  }
+  ASSERT_EQ(HostAllocator::SizeClass(prev + 1), -1);
+}
+
+TEST(host_allocator, reuse) {
+  auto& allocator = HostAllocator::Global();
+  // Off by default
+  ASSERT_FALSE(allocator.caching());
+  allocator.set_caching(true);
+  void* buf = TargetMalloc(TARGET(kHost), 1000);
+  ASSERT_EQ(reinterpret_cast<size_t>(buf) % 64, 0u);
+  memset(buf, 1, 1000);
+  TargetFree(TARGET(kHost), buf);
+  ASSERT_GT(allocator.cached_bytes(), 0);
+  // The same size class is served from the cache
+  void* reused = TargetMalloc(TARGET(kHost), 900);
+  ASSERT_EQ(reused, buf);
+  TargetFree(TARGET(kHost), reused);
+
+  // Blocks freed by other threads are returned to the shared cache
+  std::thread([] {
+    TargetFree(TARGET(kHost), TargetMalloc(TARGET(kHost), 5000));
+  }).join();
+  allocator.ReleaseCache();
+  ASSERT_EQ(allocator.cached_bytes(), 0);
+
+  allocator.set_caching(false);
+  buf = TargetMalloc(TARGET(kHost), 1000);
+  TargetFree(TARGET(kHost), buf);
+  ASSERT_EQ(allocator.cached_bytes(), 0);
+}
+
+TEST(host_allocator, max_cached_bytes) {
+  auto& allocator = HostAllocator::Global();
+  allocator.set_caching(true);
+  allocator.set_max_cached_bytes(1 << 20);
+  void* small = TargetMalloc(TARGET(kHost), 512 << 10);
+  void* large = TargetMalloc(TARGET(kHost), 2 << 20);
+  TargetFree(TARGET(kHost), small);
+  TargetFree(TARGET(kHost), large);
+  ASSERT_LE(allocator.cached_bytes(), 1 << 20);
+  allocator.set_max_cached_bytes(64 << 20);
+  allocator.set_caching(false);
+}
+
+TEST(host_allocator, stats) {
+  auto* stats = HostMemoryStats::Create();
+  void* outer = nullptr;
+  {
+    ScopedHostMemoryStats guard(stats);
+    outer = TargetMalloc(TARGET(kHost), 1 << 20);
+    void* tmp = TargetMalloc(TARGET(kHost), 1 << 20);
+    TargetFree(TARGET(kHost), tmp);
+  }
+  // Not attributed once the guard is gone
+  void* other = TargetMalloc(TARGET(kHost), 1 << 20);
+  ASSERT_EQ(stats->live_bytes(), 1 << 20);
+  ASSERT_EQ(stats->peak_bytes(), 2 << 20);
+  ASSERT_EQ(stats->allocations(), 2);
+  // The stats stay valid until the last attributed block is freed
+  stats->Release();
+  TargetFree(TARGET(kHost), outer);
+  TargetFree(TARGET(kHost), other);
+}
+
+TEST(host_allocator, numa_node) {
+  auto& allocator = HostAllocator::Global();
+  allocator.set_caching(true);
+  auto* stats = HostMemoryStats::Create();
+  {
+    ScopedHostMemoryStats guard(stats);
+    // Placed by the system first, then moved when reused from the cache
+    for (int node : {-1, 0}) {
+      stats->set_numa_node(node);
+      void* buf = TargetMalloc(TARGET(kHost), 1 << 20);
+      memset(buf, 0, 1 << 20);
+      TargetFree(TARGET(kHost), buf);
+    }
+  }
+  ASSERT_EQ(stats->live_bytes(), 0);
+  stats->Release();
+  allocator.set_caching(false);
+}
+
+TEST(host_allocator, huge_page) {
+  auto& allocator = HostAllocator::Global();
+  allocator.set_huge_page_threshold(2 << 20);
+  void* buf = TargetMalloc(TARGET(kHost), 4 << 20);
+  ASSERT_EQ(reinterpret_cast<size_t>(buf) % (2 << 20), 0u);
+  memset(buf, 0, 4 << 20);
+  TargetFree(TARGET(kHost), buf);
+  allocator.set_huge_page_threshold(0);
+  allocator.ReleaseCache();
+}
+
+TEST(host_allocator, huge_page_reuse) {
+  auto& allocator = HostAllocator::Global();
+  allocator.set_caching(true);
+  // A cached block is not reused for a request of the other kind
+  void* normal = TargetMalloc(TARGET(kHost), 3 << 20);
+  TargetFree(TARGET(kHost), normal);
+  allocator.set_huge_page_threshold(2 << 20);
+  void* huge = TargetMalloc(TARGET(kHost), 3 << 20);
+  ASSERT_EQ(reinterpret_cast<size_t>(huge) % (2 << 20), 0u);
+  TargetFree(TARGET(kHost), huge);
+  allocator.set_huge_page_threshold(0);
+  void* reused = TargetMalloc(TARGET(kHost), 3 << 20);
+  ASSERT_EQ(reused, normal);
+  TargetFree(TARGET(kHost), reused);
+  allocator.set_huge_page_threshold(2 << 20);
+  reused = TargetMalloc(TARGET(kHost), 3 << 20);
+  ASSERT_EQ(reused, huge);
+  TargetFree(TARGET(kHost), reused);
+  allocator.set_huge_page_threshold(0);
+  allocator.set_caching(false);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #include "lite/core/model/base/io.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
 
 namespace paddle {
 namespace lite {
@@ -41,7 +47,8 @@ std::string ByteReader::ReadToString(size_t size) const {
   return tmp;
 }
 
-BinaryFileReader::BinaryFileReader(const std::string& path, size_t offset) {
+BinaryFileReader::BinaryFileReader(const std::string& path, size_t offset)
+    : offset_(offset) {
   file_ = fopen(path.c_str(), "rb");
   CHECK(file_) << "Unable to open file: " << path;
   fseek(file_, 0L, SEEK_END);
@@ -49,13 +56,52 @@ BinaryFileReader::BinaryFileReader(const std::string& path, size_t offset) {
   fseek(file_, offset, SEEK_SET);
 }
 
+BinaryFileReader::~BinaryFileReader() {
+  if (file_) {
+    fclose(file_);
+  }
+#if !defined(_WIN32)
+  if (mapped_data_) {
+    munmap(const_cast<char*>(mapped_data_), offset_ + length_);
+  }
+#endif
+}
+
 void BinaryFileReader::Read(void* dst, size_t size) const {
   CHECK(dst);
-  CHECK_EQ(fread(dst, 1, size, file_), size) << "Failed to read " << size
-                                             << " bytes.";
+  if (mapped_data_) {
+    CHECK_LE(cur_ + size, length_) << "Failed to read " << size << " bytes.";
+    lite::TargetCopy(
+        TargetType::kHost, dst, mapped_data_ + offset_ + cur_, size);
+  } else {
+    CHECK_EQ(fread(dst, 1, size, file_), size) << "Failed to read " << size
+                                               << " bytes.";
+  }
   cur_ += size;
 }
 
+const void* BinaryFileReader::Map(size_t size) const {
+#if !defined(_WIN32)
+  if (!mapped_data_ && !map_failed_ && offset_ + length_ > 0) {
+    void* addr = mmap(
+        nullptr, offset_ + length_, PROT_READ, MAP_PRIVATE, fileno(file_), 0);
+    if (addr == MAP_FAILED) {
+      map_failed_ = true;
+    } else {
+      mapped_data_ = static_cast<const char*>(addr);
+      // The mapping holds its own reference to the file.
+      fclose(file_);
+      file_ = nullptr;
+    }
+  }
+#endif
+  if (!mapped_data_) return nullptr;
+  CHECK_LE(cur_ + size, length_) << "Failed to map " << size << " bytes.";
+  const char* data = mapped_data_ + offset_ + cur_;
+  cur_ += size;
+  return data;
+}
+
 void BinaryFileWriter::Write(const void* src, size_t size) const {
   CHECK(src);
   CHECK_EQ(fwrite(src, 1, size, file_), size) << "Failed to read " << size
@@ -69,6 +115,57 @@ void StringBufferReader::Read(void* dst, size_t size) const {
   cur_ += size;
 }
 
+const void* StringBufferReader::Map(size_t size) const {
+  CHECK_LE(cur_ + size, length_) << "Failed to map " << size << " bytes.";
+  const char* data = buf_ + cur_;
+  cur_ += size;
+  return data;
+}
+
+void ParallelCopier::Add(void* dst, const void* src, size_t size) {
+  if (size == 0) return;
+  CHECK(dst);
+  CHECK(src);
+  tasks_.push_back({dst, src, size});
+  bytes_ += size;
+}
+
+void ParallelCopier::Run() {
+  // Large copies are split so that the threads stay balanced, and every
+  // thread gets at least kBytesPerThread so small models are copied inline.
+  const size_t kChunkBytes = 1 << 20;
+  const size_t kBytesPerThread = 4 << 20;
+  const size_t kMaxThreads = 8;
+  std::vector<Task> chunks;
+  for (auto& task : tasks_) {
+    for (size_t offset = 0; offset < task.size; offset += kChunkBytes) {
+      chunks.push_back({static_cast<char*>(task.dst) + offset,
+                        static_cast<const char*>(task.src) + offset,
+                        std::min(kChunkBytes, task.size - offset)});
+    }
+  }
+  size_t thread_num = std::min<size_t>(
+      std::min<size_t>(std::thread::hardware_concurrency(), kMaxThreads),
+      bytes_ / kBytesPerThread);
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < chunks.size(); i = next++) {
+      lite::TargetCopy(
+          TargetType::kHost, chunks[i].dst, chunks[i].src, chunks[i].size);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_num; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  tasks_.clear();
+  bytes_ = 0;
+}
+
 }  // namespace model_parser
 }  // namespace lite
 }  // namespace paddle
@@ -17,6 +17,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include "lite/core/memory.h"
 
 // Use the no_sanitize attribute on a function or a global variable declaration
@@ -83,6 +84,10 @@ class ByteReader {
   virtual size_t length() const = 0;
   virtual size_t current() const = 0;
   virtual bool ReachEnd() const = 0;
+  // Returns the address of the next `size` bytes and moves past them without
+  // copying, if the reader is backed by memory. Otherwise returns nullptr and
+  // nothing is consumed, Read() has to be used instead.
+  virtual const void* Map(size_t size) const { return nullptr; }
 
   template <typename T,
             typename = typename std::enable_if<
@@ -118,6 +123,8 @@ class ByteWriter {
   }
 
   virtual size_t Align(size_t bytes_size) const = 0;
+  // The number of bytes written so far.
+  virtual size_t current() const = 0;
 
   virtual ~ByteWriter() = default;
 
@@ -126,23 +133,25 @@ class ByteWriter {
   ByteWriter& operator=(const ByteWriter&) = delete;
 };
 
+// Map() memory-maps the file where the platform supports it, from then on
+// the file is closed and Read() copies from the mapping as well.
 class BinaryFileReader : public ByteReader {
  public:
   explicit BinaryFileReader(const std::string& path, size_t offset = 0);
-  ~BinaryFileReader() {
-    if (file_) {
-      fclose(file_);
-    }
-  }
+  ~BinaryFileReader();
   void Read(void* dst, size_t size) const override;
+  const void* Map(size_t size) const override;
   bool ReachEnd() const override { return cur_ >= length_; }
   size_t length() const override { return length_; }
   size_t current() const override { return cur_; }
 
  private:
-  FILE* file_{};
+  mutable FILE* file_{};
+  size_t offset_{0};
   size_t length_{0};
   mutable size_t cur_{0};
+  mutable const char* mapped_data_{nullptr};
+  mutable bool map_failed_{false};
 };
 
 class BinaryFileWriter : public ByteWriter {
@@ -157,6 +166,7 @@ class BinaryFileWriter : public ByteWriter {
     }
   }
   void Write(const void* src, size_t size) const override;
+  size_t current() const override { return cur_; }
 
   // Fill a number of zero characters to align the number
   // of written bytes to a certain position.
@@ -187,6 +197,7 @@ class StringBufferReader : public ByteReader {
   }
   ~StringBufferReader() = default;
   void Read(void* dst, size_t size) const override;
+  const void* Map(size_t size) const override;
   bool ReachEnd() const override { return cur_ >= length_; }
   size_t length() const override { return length_; }
   size_t current() const override { return cur_; }
@@ -198,6 +209,27 @@ class StringBufferReader : public ByteReader {
   mutable size_t cur_{0};
 };
 
+// Collects the copies of the param data found while a model is parsed and
+// performs them on several threads at once in Run(), so loading a large
+// model is not bound by a single memcpy stream. The destinations are
+// allocated by the caller on its own thread beforehand, and the sources,
+// e.g. a mapped reader, must stay valid until Run() returns.
+class ParallelCopier {
+ public:
+  void Add(void* dst, const void* src, size_t size);
+  void Run();
+  size_t bytes() const { return bytes_; }
+
+ private:
+  struct Task {
+    void* dst;
+    const void* src;
+    size_t size;
+  };
+  std::vector<Task> tasks_;
+  size_t bytes_{0};
+};
+
 }  // namespace model_parser
 }  // namespace lite
 }  // namespace paddle
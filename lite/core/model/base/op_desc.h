@@ -22,6 +22,10 @@
 namespace paddle {
 namespace lite {
 
+// The attr holding the kernel picked for the op in an optimized program, see
+// KernelBase::SerializeKernelType.
+static const char kKernelTypeAttr[] = "__@kernel_type_attr@__";
+
 class OpDescReadAPI {
  public:
   virtual std::string Type() const = 0;
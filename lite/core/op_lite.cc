@@ -47,17 +47,18 @@ bool OpLite::InferShape() {
   } else {
     this->InferShapeImpl();
     if (InferShapeWithCache()) {
-      last_output_shapes_.clear();
-      last_output_lods_.clear();
+      // Assign in place, so the lods reuse their buffers
+      last_output_shapes_.resize(output_tensor_ptrs_cache_.size());
+      last_output_lods_.resize(output_tensor_ptrs_cache_.size());
       for (size_t i = 0; i < output_tensor_ptrs_cache_.size(); i++) {
-        last_output_shapes_.push_back(output_tensor_ptrs_cache_[i]->dims());
-        last_output_lods_.push_back(output_tensor_ptrs_cache_[i]->lod());
+        last_output_shapes_[i] = output_tensor_ptrs_cache_[i]->dims();
+        last_output_lods_[i] = output_tensor_ptrs_cache_[i]->lod();
       }
-      last_input_shapes_.clear();
-      last_input_lods_.clear();
+      last_input_shapes_.resize(input_tensor_ptrs_cache_.size());
+      last_input_lods_.resize(input_tensor_ptrs_cache_.size());
       for (size_t i = 0; i < input_tensor_ptrs_cache_.size(); i++) {
-        last_input_shapes_.push_back(input_tensor_ptrs_cache_[i]->dims());
-        last_input_lods_.push_back(input_tensor_ptrs_cache_[i]->lod());
+        last_input_shapes_[i] = input_tensor_ptrs_cache_[i]->dims();
+        last_input_lods_[i] = input_tensor_ptrs_cache_[i]->lod();
       }
     }
   }
@@ -110,6 +111,17 @@ std::vector<std::unique_ptr<KernelBase>> OpLite::CreateKernels(
   return kernels;
 }
 
+std::unique_ptr<KernelBase> OpLite::CreateKernel(const Place &place,
+                                                 const std::string &alias) {
+  CHECK(!op_type_.empty()) << "op_type_ should be set first";
+  auto kernel = KernelRegistry::Global().Create(
+      op_type_, place.target, place.precision, place.layout, alias);
+  if (kernel) {
+    AttachKernel(kernel.get());
+  }
+  return kernel;
+}
+
 bool OpLite::Run() {
   CHECK(kernel_);
   SyncInputEvents();
@@ -101,6 +101,11 @@ class OpLite : public Registry {
   std::vector<std::unique_ptr<KernelBase>> CreateKernels(
       const std::vector<Place> &places, const std::string &kernel_type = "");
 
+  // Create only the kernel `alias` of `place`, returns nullptr if it is not
+  // registered.
+  std::unique_ptr<KernelBase> CreateKernel(const Place &place,
+                                           const std::string &alias);
+
   Scope *scope() { return scope_; }
 
   // Assign op param to kernel.
@@ -130,8 +130,19 @@ class KernelFactory {
                        PrecisionType precision,
                        DataLayoutType layout,
                        std::function<std::unique_ptr<KernelBase>()> fun) {
-    op_registry_[op_type][std::make_tuple(target, precision, layout)].push_back(
-        fun);
+    RegisterCreator(op_type, target, precision, layout, "", fun);
+  }
+
+  // Register a function to create the kernel named `alias`, so it can be
+  // created without constructing the other kernels of the same place.
+  void RegisterCreator(const std::string& op_type,
+                       TargetType target,
+                       PrecisionType precision,
+                       DataLayoutType layout,
+                       const std::string& alias,
+                       std::function<std::unique_ptr<KernelBase>()> fun) {
+    op_registry_[op_type][std::make_tuple(target, precision, layout)]
+        .emplace_back(alias, fun);
   }
 
   static KernelFactory& Global() {
@@ -147,8 +158,8 @@ class KernelFactory {
     if (op_registry_.find(op_type) == op_registry_.end()) return res;
     auto& kernel_registry = op_registry_[op_type];
     for (auto it = kernel_registry.begin(); it != kernel_registry.end(); ++it) {
-      for (auto& fun : it->second) {
-        res.emplace_back(fun());
+      for (auto& creator : it->second) {
+        res.emplace_back(creator.second());
       }
     }
     return res;
@@ -166,12 +177,37 @@ class KernelFactory {
     auto& kernel_registry = op_registry_[op_type];
     auto it = kernel_registry.find(std::make_tuple(target, precision, layout));
     if (it == kernel_registry.end()) return res;
-    for (auto& fun : it->second) {
-      res.emplace_back(fun());
+    for (auto& creator : it->second) {
+      res.emplace_back(creator.second());
     }
     return res;
   }
 
+  /**
+   * Create only the kernel registered with `alias`, return nullptr if there
+   * is no such kernel. Used when the kernel was picked offline, e.g. by opt.
+   */
+  std::unique_ptr<KernelBase> Create(const std::string& op_type,
+                                     TargetType target,
+                                     PrecisionType precision,
+                                     DataLayoutType layout,
+                                     const std::string& alias) {
+    auto op_it = op_registry_.find(op_type);
+    if (op_it == op_registry_.end()) return nullptr;
+    auto it = op_it->second.find(std::make_tuple(target, precision, layout));
+    if (it == op_it->second.end()) return nullptr;
+    for (auto& creator : it->second) {
+      if (creator.first == alias) return creator.second();
+    }
+    // Kernels registered without an alias have to be created to be checked.
+    for (auto& creator : it->second) {
+      if (!creator.first.empty()) continue;
+      auto kernel = creator.second();
+      if (kernel->alias() == alias) return kernel;
+    }
+    return nullptr;
+  }
+
   std::string DebugString() const {
     STL::stringstream ss;
     for (const auto& item : op_registry_) {
@@ -182,12 +218,14 @@ class KernelFactory {
 
  protected:
   // Outer map: op -> a map of kernel.
-  // Inner map: kernel -> creator function.
+  // Inner map: kernel -> (alias, creator function) of every registered kernel.
   // Each kernel was represented by a combination of <TargetType, PrecisionType,
   // DataLayoutType>
   std::map<std::string,
            std::map<std::tuple<TargetType, PrecisionType, DataLayoutType>,
-                    std::list<std::function<std::unique_ptr<KernelBase>()>>>>
+                    std::list<std::pair<
+                        std::string,
+                        std::function<std::unique_ptr<KernelBase>()>>>>>
       op_registry_;
 };
 
@@ -204,6 +242,15 @@ class KernelRegistrar {
     KernelFactory::Global().RegisterCreator(
         op_type, target, precision, layout, fun);
   }
+  KernelRegistrar(const std::string& op_type,
+                  TargetType target,
+                  PrecisionType precision,
+                  DataLayoutType layout,
+                  const std::string& alias,
+                  std::function<std::unique_ptr<KernelBase>()> fun) {
+    KernelFactory::Global().RegisterCreator(
+        op_type, target, precision, layout, alias, fun);
+  }
   // Touch function is used to guarantee registrar was initialized.
   void touch() {}
 };
@@ -273,6 +320,7 @@ class ParamTypeDummyRegistry {
           TARGET(target__),                                                   \
           PRECISION(precision__),                                             \
           DATALAYOUT(layout__),                                               \
+          #alias__,                                                           \
           []() {                                                              \
             std::unique_ptr<KernelClass> x(new KernelClass);                  \
             x->set_op_type(#op_type__);                                       \
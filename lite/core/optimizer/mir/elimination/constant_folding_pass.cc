@@ -0,0 +1,216 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/constant_folding_pass.h"
+#include <utility>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+#include "lite/core/type_system.h"
+#include "lite/utils/env.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Control flow, io and random ops are never folded.
+static const std::set<std::string> kUnfoldableOps{"feed",
+                                                  "fetch",
+                                                  "while",
+                                                  "conditional_block",
+                                                  "subgraph",
+                                                  "io_copy",
+                                                  "io_copy_once",
+                                                  "calib",
+                                                  "calib_once",
+                                                  "layout",
+                                                  "layout_once",
+                                                  "print",
+                                                  "dropout",
+                                                  "uniform_random",
+                                                  "gaussian_random",
+                                                  "randint",
+                                                  "sampling_id",
+                                                  "read_from_array",
+                                                  "write_to_array",
+                                                  "tensor_array_to_tensor",
+                                                  "lod_array_length"};
+
+static constexpr int kDefaultMaxBytes = 4 * 1024 * 1024;
+
+static Tensor* FindTensor(Scope* scope, const std::string& name) {
+  auto* var = scope->FindVar(name);
+  if (var == nullptr || !var->IsType<Tensor>()) return nullptr;
+  return var->GetMutable<Tensor>();
+}
+
+void ConstantFoldingPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The bytes all the folded ops together may still add to the model
+  int64_t budget = GetIntFromEnv(CONSTANT_FOLDING_MAX_BYTES, kDefaultMaxBytes);
+  std::map<std::string, int> producer_count;
+  for (auto& node : graph->StmtTopologicalOrder()) {
+    for (auto* out : node->outlinks) {
+      producer_count[out->AsArg().name]++;
+    }
+  }
+
+  int folded = 0;
+  for (auto& node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt() || !IsFoldable(node, producer_count)) continue;
+    if (!Fold(node, &budget)) continue;
+    // Drop the op, and the weights only it consumed
+    std::set<const Node*> nodes2rm{node};
+    for (auto* in : node->inlinks) {
+      if (in->outlinks.size() == 1 && in->inlinks.empty()) {
+        nodes2rm.insert(in);
+      }
+    }
+    for (auto* out : node->outlinks) {
+      out->AsArg().is_weight = true;
+      out->AsArg().is_persist = true;
+    }
+    GraphSafeRemoveNodes(graph.get(), nodes2rm);
+    folded++;
+  }
+  VLOG(3) << "Folded " << folded << " constant ops.";
+}
+
+bool ConstantFoldingPass::IsFoldable(
+    Node* node, const std::map<std::string, int>& producer_count) const {
+  auto& inst = node->AsStmt();
+  auto op_type = inst.op_type();
+  // Keep the quantization ops, the scales are consumed by the later passes
+  if (kUnfoldableOps.count(op_type) ||
+      op_type.find("quantize") != std::string::npos) {
+    return false;
+  }
+  auto* scope = inst.op()->scope();
+  std::set<std::string> input_names;
+  for (auto* in : node->inlinks) {
+    auto& arg = in->AsArg();
+    auto* tensor = FindTensor(scope, arg.name);
+    if (!(arg.is_weight || arg.is_persist) || tensor == nullptr ||
+        !tensor->persistable()) {
+      return false;
+    }
+    input_names.insert(arg.name);
+  }
+  for (auto* out : node->outlinks) {
+    auto& arg = out->AsArg();
+    // In-place ops and vars written by several ops must be kept
+    if (input_names.count(arg.name) || producer_count.at(arg.name) > 1 ||
+        FindTensor(scope, arg.name) == nullptr) {
+      return false;
+    }
+  }
+  return !node->outlinks.empty();
+}
+
+std::unique_ptr<KernelBase> ConstantFoldingPass::PickKernel(Node* node) const {
+  auto& inst = node->AsStmt();
+  auto* op_info = inst.op_info();
+  auto* scope = inst.op()->scope();
+  std::vector<Place> places{Place{TARGET(kHost), PRECISION(kFloat)},
+                            Place{TARGET(kHost), PRECISION(kInt32)},
+                            Place{TARGET(kHost), PRECISION(kInt64)}};
+#ifdef LITE_WITH_X86
+  places.emplace_back(TARGET(kX86), PRECISION(kFloat));
+  places.emplace_back(TARGET(kX86), PRECISION(kInt64));
+#endif
+  auto kernels = inst.op()->CreateKernels(places);
+  // Prefer the kernel whose declared input precisions match the most
+  int best = -1;
+  int best_score = -1;
+  for (size_t i = 0; i < kernels.size(); i++) {
+    auto& kernel = kernels[i];
+    int score = 0;
+    for (auto& input : op_info->inputs()) {
+      const auto* decl = ParamTypeRegistry::Global().RetrieveInArgument(
+          kernel->place(), kernel->GenParamTypeKey(), input.first);
+      if (decl == nullptr || decl->type->precision() == PRECISION(kAny)) {
+        continue;
+      }
+      for (auto& name : input.second) {
+        auto* tensor = FindTensor(scope, name);
+        if (tensor == nullptr) continue;
+        if (decl->type->precision() != tensor->precision()) {
+          score = -1;
+          break;
+        }
+        score++;
+      }
+      if (score < 0) break;
+    }
+    if (score > best_score) {
+      best = i;
+      best_score = score;
+    }
+  }
+  if (best < 0) return nullptr;
+  return std::move(kernels[best]);
+}
+
+bool ConstantFoldingPass::Fold(Node* node, int64_t* budget) const {
+  auto& inst = node->AsStmt();
+  auto op = inst.op();
+  auto* scope = op->scope();
+  auto kernel = PickKernel(node);
+  if (!kernel) {
+    VLOG(4) << "No host kernel to fold " << inst.op_type();
+    return false;
+  }
+  if (!op->CheckShape() || !op->InferShape()) return false;
+  kernel->SetContext(ContextScheduler::Global().NewContext(kernel->target()));
+#ifdef LITE_WITH_PROFILE
+  // Not part of the runtime program, nothing to profile
+  kernel->SetIsKernelTest(true);
+#endif
+  kernel->Launch();
+
+  // The weights only consumed by this op are dropped from the model
+  int64_t freed_bytes = 0;
+  for (auto* in : node->inlinks) {
+    if (in->outlinks.size() == 1) {
+      freed_bytes += FindTensor(scope, in->AsArg().name)->memory_size();
+    }
+  }
+  int64_t output_bytes = 0;
+  for (auto* out : node->outlinks) {
+    output_bytes += FindTensor(scope, out->AsArg().name)->memory_size();
+  }
+  int64_t grown_bytes = output_bytes - freed_bytes;
+  if (grown_bytes > *budget) {
+    VLOG(4) << "Skip folding " << inst.op_type() << ", it grows the model by "
+            << grown_bytes << " bytes and only " << *budget << " are left";
+    for (auto* out : node->outlinks) {
+      FindTensor(scope, out->AsArg().name)->clear();
+    }
+    return false;
+  }
+  // Folds that shrink the model make room for the following ones
+  *budget -= grown_bytes;
+  for (auto* out : node->outlinks) {
+    FindTensor(scope, out->AsArg().name)->set_persistable(true);
+  }
+  VLOG(4) << "Folded " << inst.op_type() << " with "
+          << kernel->SerializedKernelType();
+  return true;
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(constant_folding_pass, paddle::lite::mir::ConstantFoldingPass)
+    .BindTargets({TARGET(kAny)});
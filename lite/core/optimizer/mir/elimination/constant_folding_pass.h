@@ -0,0 +1,51 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include "lite/core/kernel.h"
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Folds every op whose inputs are all persistable: the op is executed once
+// with the host (or x86) kernels at optimization time and its outputs become
+// persistable tensors. Ops are visited in topological order and the folded
+// outputs feed the following ops, so whole constant subgraphs (e.g.
+// shape->slice->concat->reshape chains on weights) collapse into weights.
+// Set the environment variable 'CONSTANT_FOLDING_MAX_BYTES' to limit how much
+// all the folded ops together are allowed to grow the model.
+class ConstantFoldingPass : public mir::StmtPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool IsFoldable(Node* node,
+                  const std::map<std::string, int>& producer_count) const;
+  std::unique_ptr<KernelBase> PickKernel(Node* node) const;
+  // Runs the op and returns false if it failed or its outputs don't fit in
+  // the bytes left in `budget`, which is reduced by what the fold adds.
+  bool Fold(Node* node, int64_t* budget) const;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,160 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/constant_folding_pass.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+#include "lite/utils/env.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                bool persistable) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(VarDescAPI::VarDataType::FP32);
+  var_desc->SetPersistable(persistable);
+}
+
+void AddElementwiseAddDesc(cpp::BlockDesc* block_desc,
+                           const std::string& x,
+                           const std::string& y,
+                           const std::string& out) {
+  AddVarDesc(block_desc, out, false);
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("elementwise_add");
+  op_desc->SetInput("X", {x});
+  op_desc->SetInput("Y", {y});
+  op_desc->SetOutput("Out", {out});
+  op_desc->SetAttr<int>("axis", -1);
+}
+
+std::vector<std::string> StmtTypes(SSAGraph* graph) {
+  std::vector<std::string> types;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (node->IsStmt()) types.push_back(node->AsStmt().op_type());
+  }
+  return types;
+}
+
+std::unique_ptr<SSAGraph> BuildGraph(
+    const std::shared_ptr<cpp::ProgramDesc>& program_desc,
+    const std::shared_ptr<Scope>& scope) {
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  return graph;
+}
+
+// w -> scale -> w_scaled -> elementwise_add(x) -> out
+TEST(ConstantFoldingPass, fold_scale_of_weight) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x", false);
+  AddVarDesc(block_desc, "w", true);
+  AddVarDesc(block_desc, "w_scaled", false);
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({2, 3});
+  auto* w_data = w->mutable_data<float>();
+  for (int i = 0; i < w->numel(); i++) w_data[i] = static_cast<float>(i);
+  w->set_persistable(true);
+
+  auto* scale_desc = block_desc->AddOp<cpp::OpDesc>();
+  scale_desc->SetType("scale");
+  scale_desc->SetInput("X", {"w"});
+  scale_desc->SetOutput("Out", {"w_scaled"});
+  scale_desc->SetAttr<float>("scale", 2.f);
+  scale_desc->SetAttr<float>("bias", 1.f);
+  scale_desc->SetAttr<bool>("bias_after_scale", true);
+  AddElementwiseAddDesc(block_desc, "x", "w_scaled", "out");
+
+  auto graph = BuildGraph(program_desc, scope);
+  ConstantFoldingPass pass;
+  pass.Apply(graph);
+
+  ASSERT_EQ(StmtTypes(graph.get()),
+            std::vector<std::string>({"elementwise_add"}));
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsArg()) continue;
+    EXPECT_NE(node.AsArg().name, "w");
+    if (node.AsArg().name == "w_scaled") {
+      EXPECT_TRUE(node.AsArg().is_weight);
+    }
+  }
+  // w_scaled is not persistable in the desc, it lives in the exec scope
+  auto* exec_scope =
+      graph->StmtTopologicalOrder().front()->AsStmt().op()->scope();
+  auto* w_scaled = exec_scope->FindVar("w_scaled")->GetMutable<Tensor>();
+  EXPECT_TRUE(w_scaled->persistable());
+  ASSERT_EQ(w_scaled->dims(), DDim({2, 3}));
+  for (int i = 0; i < w_scaled->numel(); i++) {
+    EXPECT_FLOAT_EQ(w_scaled->data<float>()[i], 2.f * i + 1.f);
+  }
+}
+
+// Two fill_constant ops of 256 bytes each while the pass may only add 300
+// bytes to the model, so only one of them is folded.
+TEST(ConstantFoldingPass, max_bytes_is_a_total_budget) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x", false);
+  for (int i = 0; i < 2; i++) {
+    auto name = "c" + std::to_string(i);
+    AddVarDesc(block_desc, name, false);
+    auto* fill_desc = block_desc->AddOp<cpp::OpDesc>();
+    fill_desc->SetType("fill_constant");
+    fill_desc->SetOutput("Out", {name});
+    fill_desc->SetAttr<int>("dtype",
+                            static_cast<int>(VarDescAPI::VarDataType::FP32));
+    fill_desc->SetAttr<std::vector<int64_t>>("shape", {64});
+    fill_desc->SetAttr<float>("value", 1.f + i);
+    fill_desc->SetAttr<bool>("force_cpu", false);
+    AddElementwiseAddDesc(block_desc, "x", name, "out" + std::to_string(i));
+  }
+
+  auto graph = BuildGraph(program_desc, scope);
+  setenv(CONSTANT_FOLDING_MAX_BYTES, "300", 1);
+  ConstantFoldingPass pass;
+  pass.Apply(graph);
+  unsetenv(CONSTANT_FOLDING_MAX_BYTES);
+
+  int fill_constant_count = 0;
+  for (auto& type : StmtTypes(graph.get())) {
+    if (type == "fill_constant") fill_constant_count++;
+  }
+  EXPECT_EQ(fill_constant_count, 1);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(scale, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(fill_constant, kHost, kAny, kNCHW, def);
@@ -0,0 +1,291 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/graph_dedup_pass.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+#include "lite/core/optimizer/mir/type_precision_cast_pass.h"
+#include "lite/utils/hash.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Ops with side effects or whose outputs differ from run to run.
+static const std::set<std::string> kUndedupableOps{"feed",
+                                                   "fetch",
+                                                   "while",
+                                                   "conditional_block",
+                                                   "subgraph",
+                                                   "io_copy",
+                                                   "io_copy_once",
+                                                   "calib_once",
+                                                   "layout_once",
+                                                   "print",
+                                                   "dropout",
+                                                   "uniform_random",
+                                                   "gaussian_random",
+                                                   "randint",
+                                                   "sampling_id",
+                                                   "increment",
+                                                   "read_from_array",
+                                                   "write_to_array",
+                                                   "tensor_array_to_tensor",
+                                                   "lod_array_length"};
+
+static Tensor* FindTensor(Scope* scope, const std::string& name) {
+  auto* var = scope->FindVar(name);
+  if (var == nullptr || !var->IsType<Tensor>()) return nullptr;
+  return var->GetMutable<Tensor>();
+}
+
+static size_t HashTensor(const Tensor& tensor) {
+  size_t hash = 0;
+  CombineHash(static_cast<int>(tensor.precision()), &hash);
+  for (auto dim : tensor.dims().Vectorize()) {
+    CombineHash(dim, &hash);
+  }
+  const auto* data = static_cast<const uint8_t*>(tensor.raw_data());
+  size_t size = tensor.memory_size();
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    CombineHash(word, &hash);
+  }
+  for (; i < size; i++) {
+    CombineHash(data[i], &hash);
+  }
+  return hash;
+}
+
+static bool SameTensor(const Tensor& a, const Tensor& b) {
+  return a.precision() == b.precision() && a.dims() == b.dims() &&
+         a.lod() == b.lod() && a.memory_size() == b.memory_size() &&
+         std::memcmp(a.raw_data(), b.raw_data(), a.memory_size()) == 0;
+}
+
+static bool SameAttrs(const OpInfo& a, const OpInfo& b) {
+  if (a.attr_types() != b.attr_types()) return false;
+  for (auto& pair : a.attr_types()) {
+    const std::string& name = pair.first;
+    switch (pair.second) {
+#define ATTR_COMPARE(attr_type, cpp_type)                         \
+  case cpp::OpDesc::AttrType::attr_type:                          \
+    if (a.GetAttr<cpp_type>(name) != b.GetAttr<cpp_type>(name)) { \
+      return false;                                               \
+    }                                                             \
+    break
+
+      ATTR_COMPARE(INT, int32_t);
+      ATTR_COMPARE(FLOAT, float);
+      ATTR_COMPARE(STRING, std::string);
+      ATTR_COMPARE(INTS, std::vector<int32_t>);
+      ATTR_COMPARE(FLOATS, std::vector<float>);
+      ATTR_COMPARE(STRINGS, std::vector<std::string>);
+      ATTR_COMPARE(BOOLEAN, bool);
+      ATTR_COMPARE(LONG, int64_t);
+      ATTR_COMPARE(LONGS, std::vector<int64_t>);
+#undef ATTR_COMPARE
+      // Blocks and the other attributes are never considered identical
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+// Redirect the readers of `from` to `to`
+static void ReplaceReads(SSAGraph* graph, Node* from, Node* to) {
+  const auto& from_name = from->AsArg().name;
+  const auto& to_name = to->AsArg().name;
+  std::vector<Node*> readers(from->outlinks.begin(), from->outlinks.end());
+  for (auto* reader : readers) {
+    UpdateInputs(reader->AsStmt().op().get(), from_name, to_name);
+    auto updated_op_info = *reader->AsStmt().op_info();
+    reader->AsStmt().ResetOp(updated_op_info, graph->valid_places());
+    RemoveDirectedLink(from, reader);
+    DirectedLink(to, reader);
+  }
+}
+
+int64_t GraphDedupPass::DedupWeights(SSAGraph* graph, int* removed) {
+  // The weights seen so far by their content hash
+  std::map<size_t, std::vector<std::pair<Node*, Tensor*>>> weights;
+  std::set<const Node*> nodes2rm;
+  std::vector<Tensor*> tensors2free;
+  int64_t removed_bytes = 0;
+  *removed = 0;
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsArg() || node.outlinks.empty() || !node.inlinks.empty()) {
+      continue;
+    }
+    auto& arg = node.AsArg();
+    if (!(arg.is_weight || arg.is_persist)) continue;
+    auto* scope = node.outlinks.front()->AsStmt().op()->scope();
+    auto* tensor = FindTensor(scope, arg.name);
+    if (tensor == nullptr || tensor->memory_size() == 0 ||
+        !(tensor->target() == TARGET(kHost) ||
+          tensor->target() == TARGET(kX86) ||
+          tensor->target() == TARGET(kARM))) {
+      continue;
+    }
+    // Weights updated in place are kept apart
+    bool written = false;
+    for (auto* reader : node.outlinks) {
+      auto outputs = reader->AsStmt().op_info()->output_vars();
+      if (std::find(outputs.begin(), outputs.end(), arg.name) !=
+          outputs.end()) {
+        written = true;
+      }
+    }
+    if (written) continue;
+
+    auto& same_hash = weights[HashTensor(*tensor)];
+    Node* keep = nullptr;
+    for (auto& weight : same_hash) {
+      if (SameTensor(*weight.second, *tensor)) {
+        keep = weight.first;
+        break;
+      }
+    }
+    if (keep == nullptr) {
+      same_hash.emplace_back(&node, tensor);
+      continue;
+    }
+    VLOG(4) << "Weight " << arg.name << " duplicates " << keep->AsArg().name;
+    ReplaceReads(graph, &node, keep);
+    nodes2rm.insert(&node);
+    tensors2free.push_back(tensor);
+    removed_bytes += tensor->memory_size();
+    (*removed)++;
+  }
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  for (auto* tensor : tensors2free) {
+    tensor->clear();
+  }
+  return removed_bytes;
+}
+
+static bool IsDedupable(Node* node) {
+  auto& inst = node->AsStmt();
+  auto* op_info = inst.op_info();
+  if (kUndedupableOps.count(op_info->Type()) || node->outlinks.empty()) {
+    return false;
+  }
+  auto inputs = op_info->input_vars();
+  for (auto* out : node->outlinks) {
+    auto& arg = out->AsArg();
+    if (arg.is_weight || arg.is_persist || out->inlinks.size() > 1 ||
+        std::find(inputs.begin(), inputs.end(), arg.name) != inputs.end()) {
+      return false;
+    }
+    // The fetched vars keep their names
+    for (auto* reader : out->outlinks) {
+      if (reader->AsStmt().op_type() == "fetch") return false;
+    }
+  }
+  return true;
+}
+
+// The type and the inputs of an op
+static std::string OpKey(const OpInfo& op_info) {
+  std::string key = op_info.Type();
+  for (auto& input : op_info.inputs()) {
+    key += "|" + input.first + ":";
+    for (auto& name : input.second) {
+      key += name + ",";
+    }
+  }
+  return key;
+}
+
+static bool SameOutputs(const OpInfo& a, const OpInfo& b) {
+  if (a.outputs().size() != b.outputs().size()) return false;
+  for (auto& output : a.outputs()) {
+    if (!b.HasOutput(output.first) ||
+        b.Output(output.first).size() != output.second.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int GraphDedupPass::DedupOps(SSAGraph* graph) {
+  std::map<std::string, std::vector<Node*>> ops;
+  int removed = 0;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!IsDedupable(node)) continue;
+    auto* op_info = node->AsStmt().op_info();
+    auto& same_key = ops[OpKey(*op_info)];
+    Node* keep = nullptr;
+    for (auto* op : same_key) {
+      auto* keep_info = op->AsStmt().op_info();
+      if (SameOutputs(*keep_info, *op_info) &&
+          SameAttrs(*keep_info, *op_info)) {
+        keep = op;
+        break;
+      }
+    }
+    if (keep == nullptr) {
+      same_key.push_back(node);
+      continue;
+    }
+
+    VLOG(4) << "Op " << op_info->Type() << " duplicates an earlier one";
+    std::map<std::string, Node*> keep_outputs;
+    for (auto* out : keep->outlinks) {
+      keep_outputs[out->AsArg().name] = out;
+    }
+    auto* keep_info = keep->AsStmt().op_info();
+    std::set<const Node*> nodes2rm{node};
+    std::map<std::string, Node*> outputs;
+    for (auto* out : node->outlinks) {
+      outputs[out->AsArg().name] = out;
+    }
+    for (auto& output : op_info->outputs()) {
+      auto keep_names = keep_info->Output(output.first);
+      for (size_t i = 0; i < output.second.size(); i++) {
+        auto* from = outputs.at(output.second[i]);
+        ReplaceReads(graph, from, keep_outputs.at(keep_names[i]));
+        nodes2rm.insert(from);
+      }
+    }
+    GraphSafeRemoveNodes(graph, nodes2rm);
+    removed++;
+  }
+  return removed;
+}
+
+void GraphDedupPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // Weights first, so that the ops reading copies of a weight match
+  int removed_weights = 0;
+  int64_t removed_bytes = DedupWeights(graph.get(), &removed_weights);
+  int removed_ops = DedupOps(graph.get());
+  LOG(INFO) << "Graph dedup: removed " << removed_weights
+            << " duplicate weights(" << removed_bytes << " bytes) and "
+            << removed_ops << " duplicate ops.";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(graph_dedup_pass, paddle::lite::mir::GraphDedupPass)
+    .BindTargets({TARGET(kAny)});
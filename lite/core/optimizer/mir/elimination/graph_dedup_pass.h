@@ -0,0 +1,49 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Removes the duplicates of a model in two steps:
+// 1. Weights with the same precision, dims, lod and bytes (e.g. shared
+//    embeddings, repeated masks or position encodings exported twice) are
+//    found by a content hash, and their readers are redirected to the first
+//    one. The duplicates are freed and no longer saved.
+// 2. Common subexpression elimination: an op with the same type, inputs and
+//    attributes as an earlier op is removed, and the readers of its outputs
+//    read the outputs of the earlier op. Ops are visited in topological
+//    order, so identical branches collapse as a whole.
+// Random, io and control flow ops, and the ops writing fetched or
+// persistable vars are kept.
+class GraphDedupPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // Returns the bytes of the weights removed
+  int64_t DedupWeights(SSAGraph* graph, int* removed);
+  int DedupOps(SSAGraph* graph);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
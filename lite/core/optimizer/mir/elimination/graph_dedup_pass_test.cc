@@ -0,0 +1,242 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/graph_dedup_pass.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(VarDescAPI::VarDataType::FP32);
+  var_desc->SetPersistable(persistable);
+}
+
+// A persistable weight of 2x3 filled with `value`
+void AddWeight(cpp::BlockDesc* block_desc,
+               Scope* scope,
+               const std::string& name,
+               float value) {
+  AddVarDesc(block_desc, name, true);
+  auto* tensor = scope->Var(name)->GetMutable<Tensor>();
+  tensor->Resize({2, 3});
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) data[i] = value;
+  tensor->set_persistable(true);
+}
+
+void AddBinaryDesc(cpp::BlockDesc* block_desc,
+                   const std::string& type,
+                   const std::string& x,
+                   const std::string& y,
+                   const std::string& out) {
+  AddVarDesc(block_desc, out);
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  op_desc->SetInput("X", {x});
+  op_desc->SetInput("Y", {y});
+  op_desc->SetOutput("Out", {out});
+  op_desc->SetAttr<int>("axis", -1);
+}
+
+void AddUnaryDesc(cpp::BlockDesc* block_desc,
+                  const std::string& type,
+                  const std::string& x,
+                  const std::string& out,
+                  float scale = 2.f) {
+  AddVarDesc(block_desc, out);
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  op_desc->SetInput("X", {x});
+  op_desc->SetOutput("Out", {out});
+  if (type == "scale") {
+    op_desc->SetAttr<float>("scale", scale);
+    op_desc->SetAttr<float>("bias", 0.f);
+    op_desc->SetAttr<bool>("bias_after_scale", true);
+  } else if (type == "dropout") {
+    AddVarDesc(block_desc, out + "_mask");
+    op_desc->SetOutput("Mask", {out + "_mask"});
+    op_desc->SetAttr<float>("dropout_prob", 0.5f);
+    op_desc->SetAttr<bool>("is_test", false);
+    op_desc->SetAttr<bool>("fix_seed", false);
+    op_desc->SetAttr<int>("seed", 0);
+    op_desc->SetAttr<std::string>("dropout_implementation",
+                                  "upscale_in_train");
+  }
+}
+
+void AddFetchDesc(cpp::BlockDesc* block_desc, const std::string& x, int col) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("fetch");
+  op_desc->SetInput("X", {x});
+  op_desc->SetOutput("Out", {"fetch"});
+  op_desc->SetAttr<int>("col", col);
+}
+
+std::unique_ptr<SSAGraph> BuildGraph(
+    const std::shared_ptr<cpp::ProgramDesc>& program_desc,
+    const std::shared_ptr<Scope>& scope) {
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kAny)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  return graph;
+}
+
+std::map<std::string, int> CountOps(SSAGraph* graph) {
+  std::map<std::string, int> counts;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    counts[node->AsStmt().op_type()]++;
+  }
+  return counts;
+}
+
+// The inputs of the op writing `out`
+std::vector<std::string> InputsOf(SSAGraph* graph, const std::string& out) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto* op_info = node->AsStmt().op_info();
+    auto outputs = op_info->output_vars();
+    if (std::find(outputs.begin(), outputs.end(), out) != outputs.end()) {
+      return op_info->input_vars();
+    }
+  }
+  return {};
+}
+
+bool HasArg(SSAGraph* graph, const std::string& name) {
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg() && node.AsArg().name == name) return true;
+  }
+  return false;
+}
+
+// x + w1 -> a, x * w2 -> b, x - w3 -> c where w2 is a copy of w1
+TEST(GraphDedupPass, dedup_weights) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x");
+  AddWeight(block_desc, scope.get(), "w1", 1.f);
+  AddWeight(block_desc, scope.get(), "w2", 1.f);
+  AddWeight(block_desc, scope.get(), "w3", 3.f);
+  AddBinaryDesc(block_desc, "elementwise_add", "x", "w1", "a");
+  AddBinaryDesc(block_desc, "elementwise_mul", "x", "w2", "b");
+  AddBinaryDesc(block_desc, "elementwise_sub", "x", "w3", "c");
+
+  auto graph = BuildGraph(program_desc, scope);
+  GraphDedupPass pass;
+  pass.Apply(graph);
+
+  EXPECT_EQ(InputsOf(graph.get(), "a"),
+            std::vector<std::string>({"x", "w1"}));
+  EXPECT_EQ(InputsOf(graph.get(), "b"),
+            std::vector<std::string>({"x", "w1"}));
+  EXPECT_EQ(InputsOf(graph.get(), "c"),
+            std::vector<std::string>({"x", "w3"}));
+  // No op reads w2, so it is not saved with the model, and it is freed
+  EXPECT_FALSE(HasArg(graph.get(), "w2"));
+  EXPECT_TRUE(HasArg(graph.get(), "w3"));
+  EXPECT_FALSE(scope->FindVar("w2")->Get<Tensor>().IsInitialized());
+  EXPECT_EQ(scope->FindVar("w1")->Get<Tensor>().numel(), 6);
+}
+
+// x -> relu -> r1 -> scale -> s1, x -> relu -> r2 -> scale -> s2,
+// x -> relu -> r3 -> scale(3) -> s3, (s1, s2) -> elementwise_add -> o1,
+// (s1, s3) -> elementwise_add -> o2
+TEST(GraphDedupPass, merge_identical_branches) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x");
+  AddUnaryDesc(block_desc, "relu", "x", "r1");
+  AddUnaryDesc(block_desc, "scale", "r1", "s1");
+  AddUnaryDesc(block_desc, "relu", "x", "r2");
+  AddUnaryDesc(block_desc, "scale", "r2", "s2");
+  AddUnaryDesc(block_desc, "relu", "x", "r3");
+  AddUnaryDesc(block_desc, "scale", "r3", "s3", 3.f);
+  AddBinaryDesc(block_desc, "elementwise_add", "s1", "s2", "o1");
+  AddBinaryDesc(block_desc, "elementwise_add", "s1", "s3", "o2");
+
+  auto graph = BuildGraph(program_desc, scope);
+  GraphDedupPass pass;
+  pass.Apply(graph);
+
+  // The three relus and the two identical scales collapse
+  auto counts = CountOps(graph.get());
+  EXPECT_EQ(counts["relu"], 1);
+  EXPECT_EQ(counts["scale"], 2);
+  EXPECT_EQ(counts["elementwise_add"], 2);
+  EXPECT_EQ(InputsOf(graph.get(), "o1"),
+            std::vector<std::string>({"s1", "s1"}));
+  EXPECT_EQ(InputsOf(graph.get(), "s3"), std::vector<std::string>({"r1"}));
+  for (auto name : {"r2", "r3", "s2"}) {
+    EXPECT_FALSE(HasArg(graph.get(), name)) << name;
+  }
+}
+
+// Identical random, fetched and in-place ops are all kept
+TEST(GraphDedupPass, keep_undedupable_ops) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  scope->Var("fetch")->GetMutable<std::vector<Tensor>>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x");
+  AddVarDesc(block_desc, "fetch", true);
+  // Two dropouts draw different masks
+  AddUnaryDesc(block_desc, "dropout", "x", "d1");
+  AddUnaryDesc(block_desc, "dropout", "x", "d2");
+  AddBinaryDesc(block_desc, "elementwise_add", "d1", "d2", "d");
+  // The fetched vars keep their names
+  AddUnaryDesc(block_desc, "sigmoid", "x", "f1");
+  AddUnaryDesc(block_desc, "sigmoid", "x", "f2");
+  AddFetchDesc(block_desc, "f1", 0);
+  AddFetchDesc(block_desc, "f2", 1);
+  // Both scales read and write y, merging them would drop one of them
+  AddUnaryDesc(block_desc, "relu", "x", "y");
+  AddUnaryDesc(block_desc, "scale", "y", "y");
+  AddUnaryDesc(block_desc, "scale", "y", "y");
+  AddBinaryDesc(block_desc, "elementwise_add", "y", "x", "z");
+
+  auto graph = BuildGraph(program_desc, scope);
+  GraphDedupPass pass;
+  pass.Apply(graph);
+
+  auto counts = CountOps(graph.get());
+  EXPECT_EQ(counts["dropout"], 2);
+  EXPECT_EQ(counts["sigmoid"], 2);
+  EXPECT_EQ(counts["scale"], 2);
+  EXPECT_EQ(counts["fetch"], 2);
+  EXPECT_EQ(InputsOf(graph.get(), "d"),
+            std::vector<std::string>({"d1", "d2"}));
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,165 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/search_padding_eliminate_pass.h"
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// Returns true if `node` computes every output row from the same input row
+// and keeps the LoD of its input. `data_arg` is set to its data input.
+bool IsRowWiseOp(Node* node, std::string* data_arg) {
+  static const std::set<std::string> kActivations{
+      "relu", "relu6", "leaky_relu", "sigmoid", "tanh"};
+  auto* op_info = node->stmt()->op_info();
+  const auto& op_type = op_info->Type();
+  if (op_type == "search_seq_fc" || kActivations.count(op_type)) {
+    *data_arg = "X";
+    return true;
+  }
+  if (op_type == "fc" && op_info->HasAttr("in_num_col_dims") &&
+      op_info->GetAttr<int>("in_num_col_dims") == 1) {
+    *data_arg = "Input";
+    return true;
+  }
+  return false;
+}
+
+Node* FindArgNode(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) {
+      return link;
+    }
+  }
+  return nullptr;
+}
+
+Node* FindInput(Node* op_node, const std::string& arg) {
+  auto* op_info = op_node->stmt()->op_info();
+  if (!op_info->HasInput(arg) || op_info->Input(arg).size() != 1) {
+    return nullptr;
+  }
+  return FindArgNode(op_node->inlinks, op_info->Input(arg).front());
+}
+
+Node* FindOutput(Node* op_node, const std::string& arg) {
+  auto* op_info = op_node->stmt()->op_info();
+  if (!op_info->HasOutput(arg) || op_info->Output(arg).size() != 1) {
+    return nullptr;
+  }
+  return FindArgNode(op_node->outlinks, op_info->Output(arg).front());
+}
+
+}  // namespace
+
+bool SearchPaddingEliminatePass::EliminateDepadding(SSAGraph* graph,
+                                                    Node* depad_node) {
+  Node* pad_var = FindInput(depad_node, "Pad");
+  Node* src_var = FindInput(depad_node, "Src");
+  Node* out_var = FindOutput(depad_node, "Out");
+  if (!pad_var || !src_var || !out_var) return false;
+
+  // Walk up from Pad to search_group_padding, `chain` is in reverse order.
+  std::vector<Node*> chain;
+  Node* var = pad_var;
+  Node* padding_node = nullptr;
+  while (padding_node == nullptr) {
+    if (var->inlinks.size() != 1 || !var->inlinks.front()->IsStmt()) {
+      return false;
+    }
+    Node* producer = var->inlinks.front();
+    if (producer->AsStmt().op_type() == "search_group_padding") {
+      if (chain.empty() || FindOutput(producer, "Out_emb_padding") != var) {
+        return false;
+      }
+      padding_node = producer;
+      break;
+    }
+    std::string data_arg;
+    if (!IsRowWiseOp(producer, &data_arg)) return false;
+    // The padded rows must not be visible to anything but the chain.
+    if (var->outlinks.size() != 1 || producer->outlinks.size() != 1) {
+      return false;
+    }
+    chain.push_back(producer);
+    var = FindInput(producer, data_arg);
+    if (!var) return false;
+  }
+  Node* emb_var = var;
+  Node* x_var = FindInput(padding_node, "X");
+  if (!x_var) return false;
+  // Depadding must restore exactly the rows of X.
+  if (src_var != x_var && src_var != FindOutput(padding_node, "Out_new")) {
+    return false;
+  }
+  VLOG(3) << "Run " << chain.size() << " ops of "
+          << padding_node->AsStmt().op_type() << " over unpadded rows of "
+          << x_var->AsArg().name;
+
+  // The first op of the chain reads X instead of the padded tensor.
+  Node* first_node = chain.back();
+  auto first_info = *first_node->stmt()->op_info();
+  first_info.UpdateAllInputs(emb_var->AsArg().name, x_var->AsArg().name);
+  first_node->AsStmt().ResetOp(first_info, graph->valid_places());
+  RemoveDirectedLink(emb_var, first_node);
+  DirectedLink(x_var, first_node);
+
+  // The last op of the chain writes the output of depadding.
+  Node* last_node = chain.front();
+  auto last_info = *last_node->stmt()->op_info();
+  last_info.UpdateAllOutputs(pad_var->AsArg().name, out_var->AsArg().name);
+  last_node->AsStmt().ResetOp(last_info, graph->valid_places());
+  DirectedLink(last_node, out_var);
+  GraphSafeRemoveNodes(graph, {pad_var, depad_node});
+
+  // Drop search_group_padding once none of its outputs is used.
+  std::set<const Node*> nodes_to_remove{padding_node};
+  for (auto* out : padding_node->outlinks) {
+    if (!out->outlinks.empty()) return true;
+    nodes_to_remove.insert(out);
+  }
+  GraphSafeRemoveNodes(graph, nodes_to_remove);
+  return true;
+}
+
+void SearchPaddingEliminatePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  std::vector<Node*> depad_nodes;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (node->AsStmt().op_type() == "search_seq_depadding") {
+      depad_nodes.push_back(node);
+    }
+  }
+  int eliminated = 0;
+  for (auto* node : depad_nodes) {
+    eliminated += EliminateDepadding(graph.get(), node);
+  }
+  VLOG(3) << "Eliminated " << eliminated << " search padding pairs.";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(search_padding_eliminate_pass,
+                  paddle::lite::mir::SearchPaddingEliminatePass)
+    .BindTargets({TARGET(kX86)})
+    .ExcludeTargets({TARGET(kXPU)});
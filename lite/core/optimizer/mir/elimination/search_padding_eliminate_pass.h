@@ -0,0 +1,56 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// search_group_padding pads every sequence of a LoD tensor to the longest
+// one, and search_seq_depadding gathers the valid rows back. When only
+// row-wise ops sit between them, the padded rows are computed and thrown
+// away, so the ops can run over the packed (unpadded) rows directly:
+//
+//          X                                 X
+//          |                                 |
+//  search_group_padding                search_seq_fc
+//          |                                 |
+//    search_seq_fc           ->             relu
+//          |                                 |
+//         relu                              Out
+//          |
+//  search_seq_depadding(Src=X)
+//          |
+//         Out
+//
+// Row-wise ops are the ones that keep the LoD of their input: search_seq_fc,
+// fc with in_num_col_dims == 1 and the unary activations.
+class SearchPaddingEliminatePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool EliminateDepadding(SSAGraph* graph, Node* depad_node);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,330 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/transpose_eliminate_pass.h"
+#include <algorithm>
+#include <list>
+#include <set>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+#include "lite/core/optimizer/mir/type_precision_cast_pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+bool IsTranspose(Node* node) {
+  const auto& type = node->AsStmt().op_type();
+  return type == "transpose" || type == "transpose2";
+}
+
+bool IsReshape(Node* node) {
+  const auto& type = node->AsStmt().op_type();
+  return type == "reshape" || type == "reshape2";
+}
+
+Node* FindArgNode(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) {
+      return link;
+    }
+  }
+  return nullptr;
+}
+
+Node* InputNode(Node* op_node, const std::string& param) {
+  auto* op_info = op_node->AsStmt().op_info();
+  if (!op_info->HasInput(param) || op_info->Input(param).size() != 1) {
+    return nullptr;
+  }
+  return FindArgNode(op_node->inlinks, op_info->Input(param).front());
+}
+
+Node* OutputNode(Node* op_node, const std::string& param) {
+  auto* op_info = op_node->AsStmt().op_info();
+  if (!op_info->HasOutput(param) || op_info->Output(param).size() != 1) {
+    return nullptr;
+  }
+  return FindArgNode(op_node->outlinks, op_info->Output(param).front());
+}
+
+// Whether the readers of `var` may read another var instead
+bool IsIntermediate(Node* var) {
+  auto& arg = var->AsArg();
+  if (arg.is_weight || arg.is_persist || var->inlinks.size() != 1) {
+    return false;
+  }
+  for (auto* reader : var->outlinks) {
+    if (reader->AsStmt().op_type() == "fetch") return false;
+  }
+  return true;
+}
+
+// The XShape of transpose2 and reshape2 is only read by the backward ops
+bool XShapeUnused(Node* op_node) {
+  auto* xshape = OutputNode(op_node, "XShape");
+  return xshape == nullptr || xshape->outlinks.empty();
+}
+
+std::vector<int> Axis(Node* op_node) {
+  return op_node->AsStmt().op_info()->GetAttr<std::vector<int>>("axis");
+}
+
+bool IsIdentity(const std::vector<int>& axis) {
+  for (size_t i = 0; i < axis.size(); i++) {
+    if (axis[i] != static_cast<int>(i)) return false;
+  }
+  return true;
+}
+
+std::set<const Node*> OpAndOutputs(Node* op_node) {
+  std::set<const Node*> nodes(op_node->outlinks.begin(),
+                              op_node->outlinks.end());
+  nodes.insert(op_node);
+  return nodes;
+}
+
+// Redirect the readers of `from` to `to`
+void ReplaceReads(SSAGraph* graph, Node* from, Node* to) {
+  const auto& from_name = from->AsArg().name;
+  const auto& to_name = to->AsArg().name;
+  std::vector<Node*> readers(from->outlinks.begin(), from->outlinks.end());
+  for (auto* reader : readers) {
+    UpdateInputs(reader->AsStmt().op().get(), from_name, to_name);
+    auto updated_op_info = *reader->AsStmt().op_info();
+    reader->AsStmt().ResetOp(updated_op_info, graph->valid_places());
+    RemoveDirectedLink(from, reader);
+    DirectedLink(to, reader);
+  }
+}
+
+}  // namespace
+
+bool TransposeEliminatePass::RemoveIdentity(SSAGraph* graph, Node* op_node) {
+  if (!IsTranspose(op_node) || !IsIdentity(Axis(op_node)) ||
+      !XShapeUnused(op_node)) {
+    return false;
+  }
+  auto* x = InputNode(op_node, "X");
+  auto* out = OutputNode(op_node, "Out");
+  if (!x || !out || !IsIntermediate(out)) return false;
+  ReplaceReads(graph, out, x);
+  GraphSafeRemoveNodes(graph, OpAndOutputs(op_node));
+  return true;
+}
+
+bool TransposeEliminatePass::MergeTransposes(SSAGraph* graph, Node* op_node) {
+  if (!IsTranspose(op_node)) return false;
+  auto* middle = InputNode(op_node, "X");
+  if (!middle || middle->outlinks.size() != 1 || !IsIntermediate(middle)) {
+    return false;
+  }
+  auto* first = middle->inlinks.front();
+  if (!IsTranspose(first) || !XShapeUnused(first)) return false;
+  auto* x = InputNode(first, "X");
+  auto first_axis = Axis(first);
+  auto second_axis = Axis(op_node);
+  if (!x || first_axis.size() != second_axis.size()) return false;
+  // Out[i] = middle[second_axis[i]] = x[first_axis[second_axis[i]]]
+  std::vector<int> axis(second_axis.size());
+  for (size_t i = 0; i < axis.size(); i++) {
+    axis[i] = first_axis[second_axis[i]];
+  }
+  auto op_desc = *op_node->AsStmt().op_info();
+  op_desc.SetInput("X", {x->AsArg().name});
+  op_desc.SetAttr("axis", axis);
+  op_node->AsStmt().ResetOp(op_desc, graph->valid_places());
+  GraphSafeRemoveNodes(graph, OpAndOutputs(first));
+  DirectedLink(x, op_node);
+  return true;
+}
+
+bool TransposeEliminatePass::FoldIntoMatmul(SSAGraph* graph, Node* op_node) {
+  if (!IsTranspose(op_node) || !XShapeUnused(op_node)) return false;
+  auto axis = Axis(op_node);
+  const int rank = static_cast<int>(axis.size());
+  if (rank < 2 || axis[rank - 1] != rank - 2 || axis[rank - 2] != rank - 1) {
+    return false;
+  }
+  for (int i = 0; i < rank - 2; i++) {
+    if (axis[i] != i) return false;
+  }
+  // The transposed weights are left to constant folding and the fc fusions
+  auto* x = InputNode(op_node, "X");
+  auto* out = OutputNode(op_node, "Out");
+  if (!x || x->AsArg().is_weight || x->AsArg().is_persist || !out ||
+      out->outlinks.size() != 1 || !IsIntermediate(out)) {
+    return false;
+  }
+  auto* matmul = out->outlinks.front();
+  auto* matmul_info = matmul->AsStmt().op_info();
+  const auto& type = matmul_info->Type();
+  if (type != "matmul" && type != "matmul_v2") return false;
+  // The per-channel scales of a quantized Y follow its layout
+  if (matmul_info->HasAttr("enable_int8") &&
+      matmul_info->GetAttr<bool>("enable_int8")) {
+    return false;
+  }
+  const auto& name = out->AsArg().name;
+  const bool is_x = matmul_info->Input("X").front() == name;
+  const bool is_y = matmul_info->Input("Y").front() == name;
+  if (is_x == is_y) return false;
+  std::string attr;
+  if (type == "matmul") {
+    attr = is_x ? "transpose_X" : "transpose_Y";
+  } else {
+    attr = is_x ? "trans_x" : "trans_y";
+  }
+  const bool transposed =
+      matmul_info->HasAttr(attr) && matmul_info->GetAttr<bool>(attr);
+  auto op_desc = *matmul_info;
+  op_desc.SetInput(is_x ? "X" : "Y", {x->AsArg().name});
+  op_desc.SetAttr(attr, !transposed);
+  matmul->AsStmt().ResetOp(op_desc, graph->valid_places());
+  GraphSafeRemoveNodes(graph, OpAndOutputs(op_node));
+  DirectedLink(x, matmul);
+  return true;
+}
+
+bool TransposeEliminatePass::ReplaceWithReshape(SSAGraph* graph,
+                                                Node* op_node) {
+  if (!IsTranspose(op_node) || !XShapeUnused(op_node)) return false;
+  auto* x = InputNode(op_node, "X");
+  auto* out = OutputNode(op_node, "Out");
+  if (!x || !out) return false;
+  auto axis = Axis(op_node);
+  auto op = op_node->AsStmt().op();
+  auto* var = op->scope()->FindVar(x->AsArg().name);
+  if (!var || !var->IsType<lite::Tensor>()) return false;
+  auto in_dims = var->Get<lite::Tensor>().dims().Vectorize();
+  if (in_dims.size() != axis.size() || IsIdentity(axis)) return false;
+  // The axes of size other than 1 keep their order, at most one of them is
+  // unknown until runtime
+  std::vector<int> shape;
+  int last = -1;
+  int unknown = 0;
+  for (auto i : axis) {
+    const int64_t dim = in_dims[i];
+    if (dim == 1) {
+      shape.push_back(1);
+      continue;
+    }
+    if (i < last) return false;
+    last = i;
+    if (dim <= 0) unknown++;
+    shape.push_back(dim <= 0 ? -1 : static_cast<int>(dim));
+  }
+  if (unknown > 1) return false;
+
+  auto* xshape = OutputNode(op_node, "XShape");
+  const std::string type = xshape ? "reshape2" : "reshape";
+  cpp::OpDesc op_desc;
+  op_desc.SetType(type);
+  op_desc.SetInput("X", {x->AsArg().name});
+  op_desc.SetOutput("Out", {out->AsArg().name});
+  if (xshape) op_desc.SetOutput("XShape", {xshape->AsArg().name});
+  op_desc.SetAttr("shape", shape);
+  auto reshape_op = LiteOpRegistry::Global().Create(type);
+  reshape_op->Attach(op_desc, op->scope());
+  auto* reshape_node =
+      graph->GraphCreateInstructNode(reshape_op, op->valid_places());
+  GraphSafeRemoveNodes(graph, {op_node});
+  IR_NODE_LINK_TO(x, reshape_node);
+  IR_NODE_LINK_TO(reshape_node, out);
+  if (xshape) {
+    IR_NODE_LINK_TO(reshape_node, xshape);
+  }
+  return true;
+}
+
+bool TransposeEliminatePass::MergeReshapes(SSAGraph* graph, Node* op_node) {
+  if (!IsReshape(op_node)) return false;
+  auto* op_info = op_node->AsStmt().op_info();
+  for (auto param : {"Shape", "ShapeTensor"}) {
+    if (op_info->HasInput(param) && !op_info->Input(param).empty()) {
+      return false;
+    }
+  }
+  // A 0 copies a dim of the dropped input
+  if (!op_info->HasAttr("shape")) return false;
+  auto shape = op_info->GetAttr<std::vector<int>>("shape");
+  if (std::find(shape.begin(), shape.end(), 0) != shape.end()) return false;
+  auto* middle = InputNode(op_node, "X");
+  if (!middle || middle->outlinks.size() != 1 || !IsIntermediate(middle)) {
+    return false;
+  }
+  auto* first = middle->inlinks.front();
+  if (!IsReshape(first) || !XShapeUnused(first)) return false;
+  auto* x = InputNode(first, "X");
+  if (!x) return false;
+  auto op_desc = *op_info;
+  op_desc.SetInput("X", {x->AsArg().name});
+  op_node->AsStmt().ResetOp(op_desc, graph->valid_places());
+  GraphSafeRemoveNodes(graph, OpAndOutputs(first));
+  DirectedLink(x, op_node);
+  return true;
+}
+
+int TransposeEliminatePass::Rewrite(SSAGraph* graph,
+                                    const std::vector<Rule>& rules) {
+  int rewrites = 0;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    // Start over after every rewrite, the removed nodes are freed
+    for (auto* node : graph->StmtTopologicalOrder()) {
+      for (auto rule : rules) {
+        if ((this->*rule)(graph, node)) {
+          changed = true;
+          break;
+        }
+      }
+      if (changed) break;
+    }
+    if (changed) rewrites++;
+  }
+  return rewrites;
+}
+
+void TransposeEliminatePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // Transposes are merged first, so that the merged ones may still fold
+  // into a matmul or become reshapes
+  int merged = Rewrite(graph.get(),
+                       {&TransposeEliminatePass::RemoveIdentity,
+                        &TransposeEliminatePass::MergeTransposes});
+  int folded =
+      Rewrite(graph.get(), {&TransposeEliminatePass::FoldIntoMatmul});
+  int reshapes =
+      Rewrite(graph.get(), {&TransposeEliminatePass::ReplaceWithReshape});
+  int merged_reshapes =
+      Rewrite(graph.get(), {&TransposeEliminatePass::MergeReshapes});
+  if (merged + folded + reshapes + merged_reshapes > 0) {
+    LOG(INFO) << "Transpose elimination: removed " << merged
+              << " transposes by merging, folded " << folded
+              << " into matmuls, turned " << reshapes
+              << " into reshapes and merged " << merged_reshapes
+              << " reshapes.";
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(transpose_eliminate_pass,
+                  paddle::lite::mir::TransposeEliminatePass)
+    .BindTargets({TARGET(kX86)})
+    .ExcludeTargets({TARGET(kXPU), TARGET(kNNAdapter), TARGET(kOpenCL)});
@@ -0,0 +1,59 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Removes the data movement of the transpose and reshape chains around the
+// matmuls of transformer and detection models:
+// 1. transpose -> transpose: merged into one transpose by the composed axis,
+//    which is dropped if it is the identity (e.g. 0213 followed by 0213).
+// 2. transpose -> matmul/matmul_v2: a transpose swapping the last two axes
+//    of a matmul input is folded into transpose_X/transpose_Y or
+//    trans_x/trans_y.
+// 3. A transpose only moving axes of size 1 is a reshape, and is replaced
+//    by one, which lite_inplace_fuse_pass later turns into a view sharing
+//    the input buffer.
+// 4. reshape -> reshape: the first one is dropped if the second has a static
+//    shape without 0.
+// Only the intermediate vars read by a single op, neither persistable nor
+// fetched, are removed.
+class TransposeEliminatePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  using Rule = bool (TransposeEliminatePass::*)(SSAGraph*, Node*);
+  // Applies the rules until none of them matches, returns the rewrites
+  int Rewrite(SSAGraph* graph, const std::vector<Rule>& rules);
+
+  bool RemoveIdentity(SSAGraph* graph, Node* op_node);
+  bool MergeTransposes(SSAGraph* graph, Node* op_node);
+  bool FoldIntoMatmul(SSAGraph* graph, Node* op_node);
+  bool ReplaceWithReshape(SSAGraph* graph, Node* op_node);
+  bool MergeReshapes(SSAGraph* graph, Node* op_node);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,192 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/transpose_eliminate_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                const std::vector<int64_t>& shape = {}) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(VarDescAPI::VarDataType::FP32);
+  var_desc->SetShape(shape);
+  var_desc->SetPersistable(false);
+}
+
+void AddTransposeDesc(cpp::BlockDesc* block_desc,
+                      const std::string& x,
+                      const std::string& out,
+                      const std::vector<int>& axis) {
+  AddVarDesc(block_desc, out);
+  AddVarDesc(block_desc, out + "_xshape");
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("transpose2");
+  op_desc->SetInput("X", {x});
+  op_desc->SetOutput("Out", {out});
+  op_desc->SetOutput("XShape", {out + "_xshape"});
+  op_desc->SetAttr<std::vector<int>>("axis", axis);
+}
+
+void AddReluDesc(cpp::BlockDesc* block_desc,
+                 const std::string& x,
+                 const std::string& out) {
+  AddVarDesc(block_desc, out);
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("relu");
+  op_desc->SetInput("X", {x});
+  op_desc->SetOutput("Out", {out});
+}
+
+std::unique_ptr<SSAGraph> BuildAndApply(
+    const std::shared_ptr<cpp::ProgramDesc>& program_desc) {
+  auto scope = std::make_shared<Scope>();
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kAny)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  TransposeEliminatePass pass;
+  pass.Apply(graph);
+  return graph;
+}
+
+std::vector<std::string> StmtTypes(SSAGraph* graph) {
+  std::vector<std::string> types;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    types.push_back(node->AsStmt().op_type());
+  }
+  return types;
+}
+
+// The op writing `out`
+const OpInfo* ProducerOf(SSAGraph* graph, const std::string& out) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    for (auto* arg : node->outlinks) {
+      if (arg->AsArg().name == out) return node->AsStmt().op_info();
+    }
+  }
+  return nullptr;
+}
+
+// x -> transpose2(0213) -> t1 -> transpose2(0213) -> t2 -> relu -> r1
+// y -> transpose2(0213) -> t3 -> transpose2(0132) -> t4 -> relu -> r2
+TEST(TransposeEliminatePass, merge_transposes) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x");
+  AddVarDesc(block_desc, "y");
+  AddTransposeDesc(block_desc, "x", "t1", {0, 2, 1, 3});
+  AddTransposeDesc(block_desc, "t1", "t2", {0, 2, 1, 3});
+  AddReluDesc(block_desc, "t2", "r1");
+  AddTransposeDesc(block_desc, "y", "t3", {0, 2, 1, 3});
+  AddTransposeDesc(block_desc, "t3", "t4", {0, 1, 3, 2});
+  AddReluDesc(block_desc, "t4", "r2");
+
+  auto graph = BuildAndApply(program_desc);
+
+  // The pair composing to the identity is dropped
+  auto* relu = ProducerOf(graph.get(), "r1");
+  ASSERT_TRUE(relu);
+  EXPECT_EQ(relu->Input("X"), std::vector<std::string>({"x"}));
+  // The other pair becomes one transpose of the composed axis
+  auto* transpose = ProducerOf(graph.get(), "t4");
+  ASSERT_TRUE(transpose);
+  EXPECT_EQ(transpose->Input("X"), std::vector<std::string>({"y"}));
+  EXPECT_EQ(transpose->GetAttr<std::vector<int>>("axis"),
+            std::vector<int>({0, 2, 3, 1}));
+  int transposes = 0;
+  for (auto& type : StmtTypes(graph.get())) {
+    if (type == "transpose2") transposes++;
+  }
+  EXPECT_EQ(transposes, 1);
+}
+
+// a -> transpose2(021) -> at, b -> transpose2(021) -> bt,
+// (at, bt) -> matmul or matmul_v2 -> out, where only Y was transposed
+TEST(TransposeEliminatePass, fold_into_matmul) {
+  for (std::string type : {"matmul", "matmul_v2"}) {
+    const std::string attr_x = type == "matmul" ? "transpose_X" : "trans_x";
+    const std::string attr_y = type == "matmul" ? "transpose_Y" : "trans_y";
+    auto program_desc = std::make_shared<cpp::ProgramDesc>();
+    auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+    AddVarDesc(block_desc, "a");
+    AddVarDesc(block_desc, "b");
+    AddTransposeDesc(block_desc, "a", "at", {0, 2, 1});
+    AddTransposeDesc(block_desc, "b", "bt", {0, 2, 1});
+    AddVarDesc(block_desc, "out");
+    auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+    op_desc->SetType(type);
+    op_desc->SetInput("X", {"at"});
+    op_desc->SetInput("Y", {"bt"});
+    op_desc->SetOutput("Out", {"out"});
+    op_desc->SetAttr<bool>(attr_x, false);
+    op_desc->SetAttr<bool>(attr_y, true);
+    op_desc->SetAttr<float>("alpha", 1.f);
+
+    auto graph = BuildAndApply(program_desc);
+
+    EXPECT_EQ(StmtTypes(graph.get()), std::vector<std::string>({type}));
+    auto* matmul = ProducerOf(graph.get(), "out");
+    ASSERT_TRUE(matmul);
+    EXPECT_EQ(matmul->Input("X"), std::vector<std::string>({"a"}));
+    EXPECT_EQ(matmul->Input("Y"), std::vector<std::string>({"b"}));
+    EXPECT_TRUE(matmul->GetAttr<bool>(attr_x)) << type;
+    EXPECT_FALSE(matmul->GetAttr<bool>(attr_y)) << type;
+  }
+}
+
+// x[-1, 1, 16] -> transpose2(102) -> t1 -> relu -> r1 only moves an axis of
+// size 1, while y[2, 1, 3] -> transpose2(210) -> t2 -> relu -> r2 reorders
+// the data.
+TEST(TransposeEliminatePass, unit_axis_transpose_to_reshape) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x", {-1, 1, 16});
+  AddVarDesc(block_desc, "y", {2, 1, 3});
+  AddTransposeDesc(block_desc, "x", "t1", {1, 0, 2});
+  AddReluDesc(block_desc, "t1", "r1");
+  AddTransposeDesc(block_desc, "y", "t2", {2, 1, 0});
+  AddReluDesc(block_desc, "t2", "r2");
+
+  auto graph = BuildAndApply(program_desc);
+
+  auto* reshape = ProducerOf(graph.get(), "t1");
+  ASSERT_TRUE(reshape);
+  EXPECT_EQ(reshape->Type(), "reshape2");
+  EXPECT_EQ(reshape->Input("X"), std::vector<std::string>({"x"}));
+  EXPECT_EQ(reshape->GetAttr<std::vector<int>>("shape"),
+            std::vector<int>({1, -1, 16}));
+  EXPECT_EQ(reshape->Output("XShape"),
+            std::vector<std::string>({"t1_xshape"}));
+  auto* transpose = ProducerOf(graph.get(), "t2");
+  ASSERT_TRUE(transpose);
+  EXPECT_EQ(transpose->Type(), "transpose2");
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
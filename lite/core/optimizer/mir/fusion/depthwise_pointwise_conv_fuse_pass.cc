@@ -0,0 +1,282 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/depthwise_pointwise_conv_fuse_pass.h"
+#include <list>
+#include <set>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+Node* FindArgNode(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) {
+      return link;
+    }
+  }
+  return nullptr;
+}
+
+const lite::Tensor* FindTensor(Node* op_node, const std::string& name) {
+  auto* var = op_node->AsStmt().op()->scope()->FindVar(name);
+  if (!var || !var->IsType<lite::Tensor>()) return nullptr;
+  return &var->Get<lite::Tensor>();
+}
+
+// Returns the weight node read by `param` of the op, nullptr if the op has
+// no such input. `*valid` is cleared if the input is not a float weight.
+Node* FindWeight(Node* op_node, const std::string& param, bool* valid) {
+  auto* op_info = op_node->AsStmt().op_info();
+  if (!op_info->HasInput(param) || op_info->Input(param).empty()) {
+    return nullptr;
+  }
+  auto* node = FindArgNode(op_node->inlinks, op_info->Input(param).front());
+  if (!node || !node->AsArg().is_weight) {
+    *valid = false;
+    return nullptr;
+  }
+  auto* tensor = FindTensor(op_node, node->AsArg().name);
+  if (!tensor || tensor->precision() != PRECISION(kFloat)) {
+    *valid = false;
+    return nullptr;
+  }
+  return node;
+}
+
+// Reads the activation fused by lite_conv_activation_fuse_pass into the
+// act_type and act_params attrs of depthwise_pointwise_conv2d.
+bool ReadActivation(const OpInfo& op_info,
+                    std::string* act_type,
+                    std::vector<float>* act_params) {
+  act_type->clear();
+  act_params->assign(3, 0.f);
+  if (!op_info.HasAttr("with_act") || !op_info.GetAttr<bool>("with_act")) {
+    return true;
+  }
+  *act_type = op_info.GetAttr<std::string>("act_type");
+  if (*act_type == "relu") {
+    return true;
+  } else if (*act_type == "relu6") {
+    (*act_params)[0] = op_info.GetAttr<float>("fuse_brelu_threshold");
+  } else if (*act_type == "leaky_relu") {
+    (*act_params)[0] = op_info.GetAttr<float>("leaky_relu_alpha");
+  } else if (*act_type == "hard_swish") {
+    (*act_params)[0] = op_info.GetAttr<float>("hard_swish_threshold");
+    (*act_params)[1] = op_info.GetAttr<float>("hard_swish_scale");
+    (*act_params)[2] = op_info.GetAttr<float>("hard_swish_offset");
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// The checks shared by both convs: float, 2-D, dilation 1, explicit
+// paddings, no fused elementwise op. The paddings are returned as
+// {top, bottom, left, right}.
+bool IsPlainConv(Node* op_node, std::vector<int>* paddings) {
+  auto* op_info = op_node->AsStmt().op_info();
+  if (op_node->outlinks.size() != 1) return false;
+  if (op_info->HasAttr("enable_int8") &&
+      op_info->GetAttr<bool>("enable_int8")) {
+    return false;
+  }
+  if (op_info->HasInput("ResidualData") &&
+      !op_info->Input("ResidualData").empty()) {
+    return false;
+  }
+  for (auto attr : {"fuse_elementwise_op_type", "scale_activation_type"}) {
+    if (op_info->HasAttr(attr) &&
+        !op_info->GetAttr<std::string>(attr).empty()) {
+      return false;
+    }
+  }
+  if (op_info->HasAttr("padding_algorithm") &&
+      op_info->GetAttr<std::string>("padding_algorithm") != "EXPLICIT" &&
+      !op_info->GetAttr<std::string>("padding_algorithm").empty()) {
+    return false;
+  }
+  if (op_info->HasAttr("dilations")) {
+    for (auto dilation : op_info->GetAttr<std::vector<int>>("dilations")) {
+      if (dilation != 1) return false;
+    }
+  }
+  auto strides = op_info->GetAttr<std::vector<int>>("strides");
+  *paddings = op_info->GetAttr<std::vector<int>>("paddings");
+  if (strides.size() != 2) return false;
+  if (paddings->size() == 2) {
+    const int pad_h = (*paddings)[0];
+    const int pad_w = (*paddings)[1];
+    *paddings = {pad_h, pad_h, pad_w, pad_w};
+  }
+  return paddings->size() == 4;
+}
+
+}  // namespace
+
+void DepthwisePointwiseConvFusePass::Apply(
+    const std::unique_ptr<SSAGraph>& graph) {
+  std::set<const Node*> fused;
+  for (auto* dw : graph->StmtTopologicalOrder()) {
+    if (fused.count(dw)) continue;
+    auto* dw_info = dw->AsStmt().op_info();
+    const auto dw_type = dw_info->Type();
+    if (dw_type != "depthwise_conv2d" && dw_type != "conv2d") continue;
+    std::vector<int> dw_paddings;
+    if (!IsPlainConv(dw, &dw_paddings)) continue;
+    bool valid = true;
+    auto* input = FindArgNode(dw->inlinks, dw_info->Input("Input").front());
+    auto* dw_filter = FindWeight(dw, "Filter", &valid);
+    auto* dw_bias = FindWeight(dw, "Bias", &valid);
+    if (!valid || !input || !dw_filter) continue;
+    auto dw_dims = FindTensor(dw, dw_filter->AsArg().name)->dims();
+    const int groups =
+        dw_info->HasAttr("groups") ? dw_info->GetAttr<int>("groups") : 1;
+    if (dw_dims.size() != 4 || dw_dims[1] != 1 || groups != dw_dims[0]) {
+      continue;
+    }
+    std::string dw_act_type;
+    std::vector<float> dw_act_params;
+    if (!ReadActivation(*dw_info, &dw_act_type, &dw_act_params)) continue;
+
+    // The depthwise output is only read by the pointwise conv
+    auto* middle = dw->outlinks.front();
+    if (middle->outlinks.size() != 1 || middle->AsArg().is_weight ||
+        middle->AsArg().is_persist) {
+      continue;
+    }
+    auto* pw = middle->outlinks.front();
+    auto* pw_info = pw->AsStmt().op_info();
+    std::vector<int> pw_paddings;
+    if (pw_info->Type() != "conv2d" || !IsPlainConv(pw, &pw_paddings) ||
+        pw_info->Input("Input").front() != middle->AsArg().name) {
+      continue;
+    }
+    auto* pw_filter = FindWeight(pw, "Filter", &valid);
+    auto* pw_bias = FindWeight(pw, "Bias", &valid);
+    if (!valid || !pw_filter) continue;
+    auto pw_dims = FindTensor(pw, pw_filter->AsArg().name)->dims();
+    if (pw_dims.size() != 4 || pw_dims[1] != dw_dims[0] || pw_dims[2] != 1 ||
+        pw_dims[3] != 1 ||
+        (pw_info->HasAttr("groups") && pw_info->GetAttr<int>("groups") != 1) ||
+        pw_info->GetAttr<std::vector<int>>("strides") !=
+            std::vector<int>({1, 1}) ||
+        pw_paddings != std::vector<int>({0, 0, 0, 0})) {
+      continue;
+    }
+    std::string pw_act_type;
+    std::vector<float> pw_act_params;
+    if (!ReadActivation(*pw_info, &pw_act_type, &pw_act_params)) continue;
+
+    // The shortcut of an inverted residual block
+    Node* out = pw->outlinks.front();
+    Node* add = nullptr;
+    Node* residual = nullptr;
+    if (out->outlinks.size() == 1 && !out->AsArg().is_weight &&
+        !out->AsArg().is_persist) {
+      auto* next = out->outlinks.front();
+      auto* next_info = next->AsStmt().op_info();
+      const auto& out_name = out->AsArg().name;
+      if (next_info->Type() == "elementwise_add" &&
+          next->inlinks.size() == 2 && next->outlinks.size() == 1 &&
+          !(next_info->HasAttr("enable_int8") &&
+            next_info->GetAttr<bool>("enable_int8")) &&
+          !(next_info->HasAttr("fuse_scale") &&
+            next_info->GetAttr<bool>("fuse_scale"))) {
+        auto x_name = next_info->Input("X").front();
+        auto y_name = next_info->Input("Y").front();
+        auto other_name = x_name == out_name ? y_name : x_name;
+        auto* out_tensor = FindTensor(next, out_name);
+        auto* other_tensor = FindTensor(next, other_name);
+        // Only the adds of two tensors of the same dims
+        if (x_name != y_name && out_tensor && other_tensor &&
+            other_tensor->precision() == PRECISION(kFloat) &&
+            out_tensor->dims().size() == 4 &&
+            out_tensor->dims() == other_tensor->dims()) {
+          add = next;
+          residual = FindArgNode(next->inlinks, other_name);
+        }
+      }
+    }
+    if (add) {
+      out = add->outlinks.front();
+    }
+
+    cpp::OpDesc op_desc;
+    op_desc.SetType("depthwise_pointwise_conv2d");
+    op_desc.SetInput("Input", {input->AsArg().name});
+    op_desc.SetInput("DwFilter", {dw_filter->AsArg().name});
+    if (dw_bias) op_desc.SetInput("DwBias", {dw_bias->AsArg().name});
+    op_desc.SetInput("PwFilter", {pw_filter->AsArg().name});
+    if (pw_bias) op_desc.SetInput("PwBias", {pw_bias->AsArg().name});
+    if (residual) {
+      op_desc.SetInput("ResidualData", {residual->AsArg().name});
+    }
+    op_desc.SetOutput("Output", {out->AsArg().name});
+    op_desc.SetAttr("strides", dw_info->GetAttr<std::vector<int>>("strides"));
+    op_desc.SetAttr("paddings", dw_paddings);
+    op_desc.SetAttr("dw_act_type", dw_act_type);
+    op_desc.SetAttr("dw_act_params", dw_act_params);
+    op_desc.SetAttr("pw_act_type", pw_act_type);
+    op_desc.SetAttr("pw_act_params", pw_act_params);
+
+    auto dw_op = dw->AsStmt().op();
+    auto fused_op =
+        LiteOpRegistry::Global().Create("depthwise_pointwise_conv2d");
+    fused_op->Attach(op_desc, dw_op->scope());
+    auto* fused_node =
+        graph->GraphCreateInstructNode(fused_op, dw_op->valid_places());
+    VLOG(3) << "Fuse " << dw_type << " and conv2d into "
+            << out->AsArg().name;
+
+    std::set<const Node*> nodes_to_remove{dw, middle, pw};
+    if (add) {
+      nodes_to_remove.insert(add);
+      nodes_to_remove.insert(pw->outlinks.front());
+    }
+    fused.insert(nodes_to_remove.begin(), nodes_to_remove.end());
+    GraphSafeRemoveNodes(graph.get(), nodes_to_remove);
+
+    IR_NODE_LINK_TO(input, fused_node);
+    IR_NODE_LINK_TO(dw_filter, fused_node);
+    if (dw_bias) {
+      IR_NODE_LINK_TO(dw_bias, fused_node);
+    }
+    IR_NODE_LINK_TO(pw_filter, fused_node);
+    if (pw_bias) {
+      IR_NODE_LINK_TO(pw_bias, fused_node);
+    }
+    // The shortcut is often the block input itself
+    if (residual && residual != input) {
+      IR_NODE_LINK_TO(residual, fused_node);
+    }
+    IR_NODE_LINK_TO(fused_node, out);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_depthwise_pointwise_conv_fuse_pass,
+                  paddle::lite::mir::DepthwisePointwiseConvFusePass)
+    .BindTargets({TARGET(kX86)})
+    .ExcludeTargets({TARGET(kXPU), TARGET(kNNAdapter), TARGET(kOpenCL)})
+    .BindKernel("depthwise_pointwise_conv2d");
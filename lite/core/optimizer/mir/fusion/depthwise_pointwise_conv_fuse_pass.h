@@ -0,0 +1,51 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Fuses the depthwise conv of an inverted residual block (MobileNetV2/V3,
+// PP-LCNet, PicoDet) with the 1x1 conv reading it, and with the residual
+// add after them if any:
+//
+//          X                           X    Residual
+//          |                           |   /
+//   depthwise_conv2d(+act)     depthwise_pointwise_conv2d
+//          |                  ->             |
+//     conv2d 1x1(+act)                      Out
+//          |    Residual
+//    elementwise_add
+//          |
+//         Out
+//
+// The kernel consumes every tile of the depthwise output while it is still in
+// cache, the large intermediate feature map is never written to memory. Run
+// after the conv bias, bn and activation fusions, only float convs with
+// explicit paddings, dilation 1 and relu/relu6/leaky_relu/hard_swish are
+// fused.
+class DepthwisePointwiseConvFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,286 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <list>
+#include <set>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+const std::set<std::string>& BinaryChainOps() {
+  static const std::set<std::string> kOps{"elementwise_add",
+                                          "elementwise_sub",
+                                          "elementwise_mul",
+                                          "elementwise_div",
+                                          "elementwise_max",
+                                          "elementwise_min"};
+  return kOps;
+}
+
+const std::set<std::string>& UnaryChainOps() {
+  static const std::set<std::string> kOps{"relu",
+                                          "relu6",
+                                          "leaky_relu",
+                                          "sigmoid",
+                                          "tanh",
+                                          "swish",
+                                          "hard_swish",
+                                          "hard_sigmoid",
+                                          "gelu",
+                                          "exp",
+                                          "abs",
+                                          "square",
+                                          "sqrt",
+                                          "scale"};
+  return kOps;
+}
+
+Node* FindArgNode(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) {
+      return link;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the float tensor created from the var desc, or nullptr if its
+// precision or shape is unknown.
+const lite::Tensor* FindFloatTensor(Node* op_node, const std::string& name) {
+  auto* var = op_node->AsStmt().op()->scope()->FindVar(name);
+  if (!var || !var->IsType<lite::Tensor>()) return nullptr;
+  const auto* tensor = &var->Get<lite::Tensor>();
+  if (tensor->precision() != PRECISION(kFloat) || tensor->dims().empty()) {
+    return nullptr;
+  }
+  return tensor;
+}
+
+// Whether Y broadcasts into X along `axis`, following the elementwise ops.
+// Leading and trailing dims of size 1 in Y are ignored.
+bool BroadcastsInto(const DDim& x_dims, const DDim& y_dims, int axis) {
+  const int x_rank = static_cast<int>(x_dims.size());
+  const int y_rank = static_cast<int>(y_dims.size());
+  if (axis == -1) {
+    axis = x_rank - y_rank;
+  }
+  int y_begin = 0;
+  int y_end = y_rank;
+  while (y_begin < y_end && y_dims[y_begin] == 1) {
+    ++y_begin;
+    ++axis;
+  }
+  while (y_end > y_begin && y_dims[y_end - 1] == 1) {
+    --y_end;
+  }
+  if (y_begin == y_end) return true;
+  if (axis < 0 || axis + y_end - y_begin > x_rank) return false;
+  for (int i = y_begin; i < y_end; ++i) {
+    if (x_dims[axis + i - y_begin] != y_dims[i]) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ElementwiseChainFusePass::AppendStep(Node* op_node,
+                                          Node* value,
+                                          Chain* chain) {
+  if (!op_node->IsStmt() || op_node->outlinks.size() != 1) return false;
+  auto* op_info = op_node->stmt()->op_info();
+  const auto op_type = op_info->Type();
+  const bool binary = BinaryChainOps().count(op_type) > 0;
+  if (!binary && !UnaryChainOps().count(op_type)) return false;
+  // Quantized ops and ops that already carry a fused activation are left to
+  // their own kernels.
+  if (op_info->HasAttr("enable_int8") &&
+      op_info->GetAttr<bool>("enable_int8")) {
+    return false;
+  }
+  if (op_info->HasAttr("activation_type") &&
+      !op_info->GetAttr<std::string>("activation_type").empty()) {
+    return false;
+  }
+  if (!FindFloatTensor(op_node, op_node->outlinks.front()->AsArg().name)) {
+    return false;
+  }
+
+  float params[3] = {0.f, 0.f, 0.f};
+  int input = -1;
+  int axis = -1;
+  int reversed = 0;
+  Node* operand = nullptr;
+  if (binary) {
+    if (op_node->inlinks.size() != 2) return false;
+    const auto x_name = op_info->Input("X").front();
+    const auto y_name = op_info->Input("Y").front();
+    const auto& value_name = value->AsArg().name;
+    std::string other_name;
+    if (value_name == x_name && value_name != y_name) {
+      other_name = y_name;
+    } else if (value_name == y_name && value_name != x_name) {
+      other_name = x_name;
+      reversed = 1;
+    } else {
+      return false;
+    }
+    if (op_info->HasAttr("axis")) {
+      axis = op_info->GetAttr<int>("axis");
+    }
+    if (other_name != chain->input->AsArg().name) {
+      auto* x = FindFloatTensor(op_node, chain->input->AsArg().name);
+      auto* other = FindFloatTensor(op_node, other_name);
+      if (!x || !other) return false;
+      // The value never grows: a reversed operand has to match it exactly.
+      if (reversed) {
+        if (!(other->dims() == x->dims())) return false;
+        axis = -1;
+      } else if (!BroadcastsInto(x->dims(), other->dims(), axis)) {
+        return false;
+      }
+      operand = FindArgNode(op_node->inlinks, other_name);
+      if (!operand) return false;
+    }
+  } else {
+    if (op_node->inlinks.size() != 1) return false;
+    if (op_type == "relu6") {
+      params[0] = op_info->GetAttr<float>("threshold");
+    } else if (op_type == "leaky_relu") {
+      params[0] = op_info->GetAttr<float>("alpha");
+    } else if (op_type == "swish") {
+      params[0] = op_info->GetAttr<float>("beta");
+    } else if (op_type == "hard_swish") {
+      params[0] = op_info->GetAttr<float>("threshold");
+      params[1] = op_info->GetAttr<float>("scale");
+      params[2] = op_info->GetAttr<float>("offset");
+    } else if (op_type == "hard_sigmoid") {
+      params[0] = op_info->GetAttr<float>("slope");
+      params[1] = op_info->GetAttr<float>("offset");
+    } else if (op_type == "gelu") {
+      params[0] = op_info->HasAttr("approximate") &&
+                          op_info->GetAttr<bool>("approximate")
+                      ? 1.f
+                      : 0.f;
+    } else if (op_type == "scale") {
+      params[0] = op_info->GetAttr<float>("scale");
+      params[1] = op_info->GetAttr<float>("bias");
+      params[2] = op_info->GetAttr<bool>("bias_after_scale") ? 1.f : 0.f;
+    }
+  }
+
+  if (operand) {
+    const auto& name = operand->AsArg().name;
+    auto it = chain->operand_index.find(name);
+    if (it == chain->operand_index.end()) {
+      input = static_cast<int>(chain->operands.size());
+      chain->operand_index[name] = input;
+      chain->operands.push_back(operand);
+    } else {
+      input = it->second;
+    }
+  }
+  chain->ops.push_back(op_node);
+  chain->step_types.push_back(op_type);
+  chain->step_inputs.push_back(input);
+  chain->step_axes.push_back(axis);
+  chain->step_reversed.push_back(reversed);
+  chain->step_params.insert(chain->step_params.end(), params, params + 3);
+  return true;
+}
+
+void ElementwiseChainFusePass::InsertChainOp(SSAGraph* graph,
+                                             const Chain& chain) {
+  Node* out = chain.ops.back()->outlinks.front();
+  std::vector<std::string> operand_names;
+  for (auto* operand : chain.operands) {
+    operand_names.push_back(operand->AsArg().name);
+  }
+  cpp::OpDesc op_desc;
+  op_desc.SetType("elementwise_chain");
+  op_desc.SetInput("X", {chain.input->AsArg().name});
+  op_desc.SetInput("Y", operand_names);
+  op_desc.SetOutput("Out", {out->AsArg().name});
+  op_desc.SetAttr("step_types", chain.step_types);
+  op_desc.SetAttr("step_inputs", chain.step_inputs);
+  op_desc.SetAttr("step_axes", chain.step_axes);
+  op_desc.SetAttr("step_reversed", chain.step_reversed);
+  op_desc.SetAttr("step_params", chain.step_params);
+
+  auto first_op = chain.ops.front()->stmt()->op();
+  auto chain_op = LiteOpRegistry::Global().Create("elementwise_chain");
+  chain_op->Attach(op_desc, first_op->scope());
+  auto* new_op_node =
+      graph->GraphCreateInstructNode(chain_op, first_op->valid_places());
+
+  // Drop the ops and every intermediate value of the chain.
+  std::set<const Node*> nodes_to_remove;
+  for (size_t i = 0; i < chain.ops.size(); ++i) {
+    nodes_to_remove.insert(chain.ops[i]);
+    if (i + 1 < chain.ops.size()) {
+      nodes_to_remove.insert(chain.ops[i]->outlinks.front());
+    }
+  }
+  GraphSafeRemoveNodes(graph, nodes_to_remove);
+
+  IR_NODE_LINK_TO(chain.input, new_op_node);
+  for (auto* operand : chain.operands) {
+    IR_NODE_LINK_TO(operand, new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, out);
+}
+
+void ElementwiseChainFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  std::set<const Node*> fused;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (fused.count(node)) continue;
+    auto* op_info = node->stmt()->op_info();
+    if (!op_info->HasInput("X") || op_info->Input("X").size() != 1) continue;
+    Chain chain;
+    chain.input = FindArgNode(node->inlinks, op_info->Input("X").front());
+    if (!chain.input ||
+        !FindFloatTensor(node, chain.input->AsArg().name) ||
+        !AppendStep(node, chain.input, &chain)) {
+      continue;
+    }
+    // Extend while the running value feeds exactly one chainable op.
+    Node* value = node->outlinks.front();
+    while (value->outlinks.size() == 1 && !value->AsArg().is_weight &&
+           !value->AsArg().is_persist &&
+           AppendStep(value->outlinks.front(), value, &chain)) {
+      value = chain.ops.back()->outlinks.front();
+    }
+    if (chain.ops.size() < 2) continue;
+    VLOG(3) << "Fuse " << chain.ops.size() << " elementwise ops from "
+            << chain.input->AsArg().name;
+    fused.insert(chain.ops.begin(), chain.ops.end());
+    InsertChainOp(graph.get(), chain);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_elementwise_chain_fuse_pass,
+                  paddle::lite::mir::ElementwiseChainFusePass)
+    .BindTargets({TARGET(kX86)})
+    .ExcludeTargets({TARGET(kXPU), TARGET(kNNAdapter), TARGET(kOpenCL)})
+    .BindKernel("elementwise_chain");
@@ -0,0 +1,70 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Folds a chain of two or more elementwise, activation and scale ops into
+// one elementwise_chain op, e.g. the hard_swish/SE tails of MobileNetV3 or
+// the bias + GELU + residual add of transformer blocks:
+//
+//        X      Y                      X   Y
+//        |      |                      |   |
+//   elementwise_add              elementwise_chain
+//          |              ->   (add, sigmoid, mul X)
+//       sigmoid                        |
+//          |   X                      Out
+//   elementwise_mul
+//          |
+//         Out
+//
+// Only the running value may be consumed inside the chain, it keeps the
+// shape of X: every other operand is X itself or a float tensor whose shape
+// (taken from the var desc) broadcasts into X. The var desc dims may be -1,
+// if an operand does not broadcast into X at runtime the kernel runs the
+// steps one by one instead.
+class ElementwiseChainFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  struct Chain {
+    Node* input{nullptr};
+    std::vector<Node*> ops;
+    std::vector<Node*> operands;
+    std::map<std::string, int> operand_index;
+    std::vector<std::string> step_types;
+    std::vector<int> step_inputs;
+    std::vector<int> step_axes;
+    std::vector<int> step_reversed;
+    std::vector<float> step_params;
+  };
+
+  // Appends `op_node`, which consumes the running value `value`, to `chain`.
+  bool AppendStep(Node* op_node, Node* value, Chain* chain);
+  void InsertChainOp(SSAGraph* graph, const Chain& chain);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,128 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/lookup_table_sequence_pool_fuser.h"
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// """
+// fuse {lookup_table(_v2), sequence_pool} => fused_embedding_seq_pool
+//   ids     W                         ids     W
+//    |      |                          |      |
+//    v      v                          v      v
+//   lookup_table            =>   fused_embedding_seq_pool
+//        |                                |
+//        v                                v
+//   sequence_pool(SUM/AVERAGE)           out
+//        |
+//        v
+//       out
+// """
+void LookupTableSequencePoolFuser::BuildPattern() {
+  // create input nodes.
+  auto* ids =
+      VarNode("ids")->assert_is_op_input(lookup_type_, "Ids")->AsInput();
+  auto* w = VarNode("w")->assert_is_op_input(lookup_type_, "W")->AsInput();
+
+  // create op nodes
+  auto* lookup_table = OpNode("lookup_table", lookup_type_)
+                           ->assert_is_op(lookup_type_)
+                           ->AsIntermediate();
+  auto pool_type_teller = [](const Node* node) -> bool {
+    auto* op_info = node->stmt()->op_info();
+    auto pool_type = op_info->GetAttr<std::string>("pooltype");
+    if (pool_type != "SUM" && pool_type != "AVERAGE") return false;
+    // Empty sequences are filled with pad_value by sequence_pool
+    return !op_info->HasAttr("pad_value") ||
+           op_info->GetAttr<float>("pad_value") == 0.f;
+  };
+  auto* sequence_pool = OpNode("sequence_pool", "sequence_pool")
+                            ->assert_is_op("sequence_pool")
+                            ->assert_node_satisfied(pool_type_teller)
+                            ->AsIntermediate();
+
+  // create intermediate nodes
+  auto* lookup_table_out = VarNode("lookup_table_out")
+                               ->assert_is_op_output(lookup_type_, "Out")
+                               ->assert_is_op_input("sequence_pool", "X")
+                               ->assert_only_one_output()
+                               ->AsIntermediate();
+  auto* sequence_pool_idx =
+      VarNode("sequence_pool_idx")
+          ->assert_is_op_output("sequence_pool", "MaxIndex")
+          ->AsIntermediate();
+
+  // create output node
+  auto* out =
+      VarNode("out")->assert_is_op_output("sequence_pool", "Out")->AsOutput();
+
+  // create topology.
+  *ids >> *lookup_table >> *lookup_table_out >> *sequence_pool >> *out;
+  *w >> *lookup_table;
+  *sequence_pool >> *sequence_pool_idx;
+}
+
+void LookupTableSequencePoolFuser::InsertNewNode(SSAGraph* graph,
+                                                 const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto fuse_op = LiteOpRegistry::Global().Create("fused_embedding_seq_pool");
+  auto lookup_table = matched.at("lookup_table")->stmt()->op();
+  auto* scope = lookup_table->scope();
+  auto& valid_places = lookup_table->valid_places();
+  fuse_op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(fuse_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("ids"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("w"), new_op_node);
+  // The scales of a row-wise quantized table are not part of the pattern
+  for (auto* in : matched.at("lookup_table")->inlinks) {
+    if (op_desc.HasInput("W_scale") &&
+        in->arg()->name == op_desc.Input("W_scale").front()) {
+      IR_NODE_LINK_TO(in, new_op_node);
+    }
+  }
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc LookupTableSequencePoolFuser::GenOpDesc(
+    const key2nodes_t& matched) {
+  auto* lookup_op_desc = matched.at("lookup_table")->stmt()->op_info();
+  auto* pool_op_desc = matched.at("sequence_pool")->stmt()->op_info();
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_embedding_seq_pool");
+  op_desc.SetInput("Ids", {matched.at("ids")->arg()->name});
+  op_desc.SetInput("W", {matched.at("w")->arg()->name});
+  if (lookup_op_desc->HasInput("W_scale") &&
+      !lookup_op_desc->Input("W_scale").empty()) {
+    op_desc.SetInput("W_scale", lookup_op_desc->Input("W_scale"));
+  }
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  op_desc.SetAttr<int64_t>(
+      "padding_idx", lookup_op_desc->GetAttr<int64_t>("padding_idx"));
+  op_desc.SetAttr<std::string>(
+      "pooltype", pool_op_desc->GetAttr<std::string>("pooltype"));
+  op_desc.SetAttr<std::string>("lookup_type", lookup_type_);
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
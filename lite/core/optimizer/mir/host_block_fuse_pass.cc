@@ -0,0 +1,72 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/host_block_fuse_pass.h"
+#include <vector>
+#include "lite/core/fused_host_block.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+bool HostBlockFusePass::IsFusable(Node* node) const {
+  auto& stmt = node->AsStmt();
+  if (!fusable_ops_.count(stmt.op_type())) return false;
+  auto target = stmt.picked_kernel().target();
+  if (target != TARGET(kHost) && target != TARGET(kX86)) return false;
+  auto* op_info = stmt.op_info();
+  for (auto& arg_name : op_info->InputArgumentNames()) {
+    if (shape_value_inputs_.count(arg_name) &&
+        !op_info->Input(arg_name).empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HostBlockFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  int block_id = 0;
+  int fused_ops = 0;
+  std::vector<Node*> run;
+  auto flush = [&]() {
+    if (run.size() >= min_block_size_) {
+      for (auto* node : run) {
+        node->AsStmt().mutable_op_info()->SetAttr<int>(kFusedHostBlockAttr,
+                                                       block_id);
+      }
+      fused_ops += static_cast<int>(run.size());
+      block_id++;
+    }
+    run.clear();
+  };
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    if (IsFusable(node)) {
+      run.push_back(node);
+    } else {
+      flush();
+    }
+  }
+  flush();
+  VLOG(4) << "Clustered " << fused_ops << " host ops into " << block_id
+          << " fused host blocks";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(host_block_fuse_pass, paddle::lite::mir::HostBlockFusePass)
+    .BindTargets({TARGET(kHost), TARGET(kX86)});
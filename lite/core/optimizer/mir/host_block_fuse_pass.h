@@ -0,0 +1,95 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Cluster the runs of cheap host/x86 ops (compare, logical, cast, fill_*,
+ * shape, slice, gather, ...) which are found in the control flow parts of
+ * detection and NLP models. The ops of a run are marked with the same
+ * `kFusedHostBlockAttr` id, and the runtime program executes every marked
+ * run as one FusedHostBlock, which skips the per-op InferShape while the
+ * input shapes don't change. Only the ops whose output shapes depend on the
+ * input shapes alone are clustered, e.g. a slice with a StartsTensor input
+ * is not.
+ */
+class HostBlockFusePass : public mir::StmtPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool IsFusable(Node* node) const;
+
+  // Clustering one op only saves the framework overhead of a single op
+  const size_t min_block_size_{2};
+  const std::set<std::string> fusable_ops_{"equal",
+                                           "not_equal",
+                                           "less_than",
+                                           "less_equal",
+                                           "greater_than",
+                                           "greater_equal",
+                                           "logical_and",
+                                           "logical_or",
+                                           "logical_not",
+                                           "logical_xor",
+                                           "cast",
+                                           "assign",
+                                           "shape",
+                                           "fill_constant",
+                                           "fill_constant_batch_size_like",
+                                           "fill_any_like",
+                                           "fill_zeros_like",
+                                           "gather",
+                                           "where",
+                                           "slice",
+                                           "scale",
+                                           "squeeze",
+                                           "squeeze2",
+                                           "unsqueeze",
+                                           "unsqueeze2",
+                                           "reshape",
+                                           "reshape2",
+                                           "flatten",
+                                           "flatten2",
+                                           "expand_as",
+                                           "stack",
+                                           "elementwise_add",
+                                           "elementwise_sub",
+                                           "elementwise_mul",
+                                           "elementwise_div"};
+  // Inputs whose values, not only shapes, decide the output shapes
+  const std::set<std::string> shape_value_inputs_{"Shape",
+                                                  "ShapeTensor",
+                                                  "ShapeTensorList",
+                                                  "StartsTensor",
+                                                  "EndsTensor",
+                                                  "StartsTensorList",
+                                                  "EndsTensorList",
+                                                  "AxesTensor",
+                                                  "AxesTensorList",
+                                                  "Axis"};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
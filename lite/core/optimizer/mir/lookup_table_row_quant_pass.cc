@@ -0,0 +1,117 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/lookup_table_row_quant_pass.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void LookupTableRowQuantPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  if (!enabled_) return;
+  // The scale node of every quantized table, shared tables are quantized once
+  std::map<std::string, Node*> scale_nodes;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    const std::string op_type = node->stmt()->op_type();
+    if (std::find(lookup_ops_.begin(), lookup_ops_.end(), op_type) ==
+        lookup_ops_.end()) {
+      continue;
+    }
+    auto* op_info = node->stmt()->mutable_op_info();
+    if (op_info->HasInput("W_scale") && !op_info->Input("W_scale").empty()) {
+      continue;
+    }
+    auto w_name = op_info->Input("W").front();
+    Node* w_node = nullptr;
+    for (auto* in : node->inlinks) {
+      if (in->IsArg() && in->arg()->name == w_name) w_node = in;
+    }
+    if (w_node == nullptr || !w_node->arg()->is_weight) continue;
+    bool only_lookup = true;
+    for (auto* out : w_node->outlinks) {
+      only_lookup &= std::find(lookup_ops_.begin(),
+                               lookup_ops_.end(),
+                               out->stmt()->op_type()) != lookup_ops_.end();
+    }
+    if (!only_lookup) {
+      VLOG(4) << "Skip " << w_name << " because it is used by other ops.";
+      continue;
+    }
+
+    auto* scope = node->stmt()->op()->scope();
+    auto scale_name = w_name + "_row_scale";
+    if (!scale_nodes.count(w_name)) {
+      auto* w = scope->FindVar(w_name)->GetMutable<Tensor>();
+      if (w->precision() != PRECISION(kFloat) || w->dims().size() != 2) {
+        continue;
+      }
+      const int64_t rows = w->dims()[0];
+      const int64_t width = w->dims()[1];
+      Tensor fp32_table;
+      fp32_table.CopyDataFrom(*w);
+      const float* src = fp32_table.data<float>();
+
+      auto* scale = scope->Var(scale_name)->GetMutable<Tensor>();
+      scale->Resize({rows});
+      float* scale_data = scale->mutable_data<float>();
+      scale->set_persistable(true);
+      scale->set_precision(PRECISION(kFloat));
+      w->clear();
+      int8_t* dst = w->mutable_data<int8_t>();
+      w->set_precision(PRECISION(kInt8));
+      for (int64_t i = 0; i < rows; i++) {
+        const float* row = src + i * width;
+        float abs_max = 0.f;
+        for (int64_t j = 0; j < width; j++) {
+          abs_max = std::max(abs_max, std::fabs(row[j]));
+        }
+        scale_data[i] = abs_max > 0.f ? abs_max / 127.f : 1.f;
+        const float inv_scale = 1.f / scale_data[i];
+        for (int64_t j = 0; j < width; j++) {
+          float q = std::round(row[j] * inv_scale);
+          dst[i * width + j] =
+              static_cast<int8_t>(std::min(std::max(q, -127.f), 127.f));
+        }
+      }
+      auto* scale_node = graph->NewArgumentNode(scale_name);
+      scale_node->AsArg().is_weight = true;
+      scale_node->AsArg().is_persist = true;
+      scale_nodes[w_name] = scale_node;
+      VLOG(4) << "Quantize " << w_name << " row-wise to int8, " << rows
+              << " rows.";
+    }
+
+    op_info->SetInput("W_scale", {scale_name});
+    auto updated_op_info = *op_info;
+    node->stmt()->ResetOp(updated_op_info, graph->valid_places());
+    DirectedLink(scale_nodes[w_name], node);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lookup_table_row_quant_pass,
+                  paddle::lite::mir::LookupTableRowQuantPass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("lookup_table");
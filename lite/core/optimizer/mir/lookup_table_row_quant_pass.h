@@ -0,0 +1,48 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Quantize the fp32 tables of lookup_table/lookup_table_v2 row by row. Every
+ * row is stored as int8 and dequantized by its own abs_max scale, which is
+ * saved in the new persistable input `W_scale`. The x86 lookup kernels gather
+ * the int8 rows directly, so the table is 4x smaller both in the model file
+ * and in memory. Tables shared with non-lookup ops are left untouched.
+ * It's enabled by the int8 post_quant_dynamic config(quant_model=true,
+ * quant_type=QUANT_INT8).
+ */
+class LookupTableRowQuantPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+  void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+ private:
+  bool enabled_{false};
+  const std::vector<std::string> lookup_ops_{"lookup_table",
+                                             "lookup_table_v2"};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,178 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/lookup_table_row_quant_pass.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/post_quant_dynamic_pass.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+const int kRows = 6;
+const int kWidth = 5;
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                VarDescAPI::VarDataType data_type,
+                bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(data_type);
+  var_desc->SetPersistable(persistable);
+}
+
+void AddWeight(cpp::BlockDesc* block_desc,
+               Scope* scope,
+               const std::string& name,
+               const DDim& dims) {
+  AddVarDesc(block_desc, name, VarDescAPI::VarDataType::FP32, true);
+  auto* tensor = scope->Var(name)->GetMutable<Tensor>();
+  tensor->Resize(dims);
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = static_cast<float>((i * 7) % 11) * 0.3f - 1.5f;
+  }
+  tensor->set_persistable(true);
+  tensor->set_precision(PRECISION(kFloat));
+}
+
+// ids -> lookup_table(table) -> emb, x -> mul(w) -> y
+std::shared_ptr<cpp::ProgramDesc> EmbeddingDesc(Scope* scope) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "ids", VarDescAPI::VarDataType::INT64);
+  AddVarDesc(block_desc, "emb", VarDescAPI::VarDataType::FP32);
+  AddVarDesc(block_desc, "x", VarDescAPI::VarDataType::FP32);
+  AddVarDesc(block_desc, "y", VarDescAPI::VarDataType::FP32);
+  AddWeight(block_desc, scope, "table", DDim({kRows, kWidth}));
+  AddWeight(block_desc, scope, "w", DDim({kWidth, 3}));
+
+  auto* lookup_desc = block_desc->AddOp<cpp::OpDesc>();
+  lookup_desc->SetType("lookup_table");
+  lookup_desc->SetInput("W", {"table"});
+  lookup_desc->SetInput("Ids", {"ids"});
+  lookup_desc->SetOutput("Out", {"emb"});
+  lookup_desc->SetAttr<int64_t>("padding_idx", -1);
+
+  auto* mul_desc = block_desc->AddOp<cpp::OpDesc>();
+  mul_desc->SetType("mul");
+  mul_desc->SetInput("X", {"x"});
+  mul_desc->SetInput("Y", {"w"});
+  mul_desc->SetOutput("Out", {"y"});
+  mul_desc->SetAttr<int>("x_num_col_dims", 1);
+  mul_desc->SetAttr<int>("y_num_col_dims", 1);
+  return program_desc;
+}
+
+Node* FindStmt(SSAGraph* graph, const std::string& op_type) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (node->AsStmt().op_type() == op_type) return node;
+  }
+  return nullptr;
+}
+
+// The int8 post_quant_dynamic config runs lookup_table_row_quant_pass and
+// then post_quant_dynamic_pass, the row-quantized table must be left to the
+// lookup kernel.
+TEST(LookupTableRowQuantPass, with_post_quant_dynamic) {
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = EmbeddingDesc(scope.get());
+  Tensor fp32_table;
+  fp32_table.CopyDataFrom(scope->FindVar("table")->Get<Tensor>());
+
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kAny)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  LookupTableRowQuantPass row_quant_pass;
+  row_quant_pass.SetEnabled(true);
+  row_quant_pass.Apply(graph);
+  PostQuantDynamicPass post_quant_pass;
+  post_quant_pass.SetQuantType(lite_api::QuantType::QUANT_INT8);
+  post_quant_pass.Apply(graph);
+
+  // The table is int8 with fp32 row scales, and the op is not tagged to be
+  // dequantized on load
+  auto* lookup = FindStmt(graph.get(), "lookup_table");
+  ASSERT_TRUE(lookup);
+  auto* op_scope = lookup->AsStmt().op()->scope();
+  auto& table = op_scope->FindVar("table")->Get<Tensor>();
+  auto* row_scale_var = op_scope->FindVar("table_row_scale");
+  ASSERT_TRUE(row_scale_var);
+  auto& row_scale = row_scale_var->Get<Tensor>();
+  EXPECT_EQ(table.precision(), PRECISION(kInt8));
+  EXPECT_EQ(row_scale.precision(), PRECISION(kFloat));
+  EXPECT_EQ(row_scale.numel(), kRows);
+  EXPECT_FALSE(lookup->AsStmt().op_info()->HasAttr("quantization_type"));
+  EXPECT_FALSE(
+      lookup->AsStmt().op_info()->HasAttr("table_row_scale_quant_scale"));
+  // The other weights are still quantized
+  auto* mul = FindStmt(graph.get(), "mul");
+  ASSERT_TRUE(mul);
+  EXPECT_EQ(mul->AsStmt().op_info()->GetAttr<std::string>("quantization_type"),
+            "post_weight_channel_wise_abs_max");
+  EXPECT_EQ(scope->FindVar("w")->Get<Tensor>().precision(), PRECISION(kInt8));
+
+  // The lookup kernel gathers the rows within half a quantization step
+  std::unique_ptr<KernelBase> kernel;
+  for (auto& candidate : lookup->AsStmt().kernels()) {
+    if (candidate->alias() == "def") kernel = std::move(candidate);
+  }
+  ASSERT_TRUE(kernel);
+  std::vector<std::vector<Instruction>> insts(1);
+  insts[0].emplace_back(lookup->AsStmt().op(), std::move(kernel));
+  RuntimeProgram runtime_program(std::move(insts));
+  const std::vector<int64_t> ids{4, 0, 5, 4};
+  auto* ids_tensor = program.exec_scope()->FindVar("ids")->GetMutable<Tensor>();
+  ids_tensor->Resize({static_cast<int64_t>(ids.size()), 1});
+  std::copy(ids.begin(), ids.end(), ids_tensor->mutable_data<int64_t>());
+  runtime_program.Run();
+
+  auto& emb = program.exec_scope()->FindVar("emb")->Get<Tensor>();
+  ASSERT_EQ(emb.numel(), static_cast<int64_t>(ids.size()) * kWidth);
+  const float* emb_data = emb.data<float>();
+  const float* table_data = fp32_table.data<float>();
+  const float* scale_data = row_scale.data<float>();
+  for (size_t i = 0; i < ids.size(); i++) {
+    for (int j = 0; j < kWidth; j++) {
+      EXPECT_NEAR(emb_data[i * kWidth + j],
+                  table_data[ids[i] * kWidth + j],
+                  scale_data[ids[i]] * 0.5f + 1e-6f)
+          << "id " << ids[i] << " col " << j;
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(lookup_table);
+USE_LITE_OP(mul);
+USE_LITE_KERNEL(lookup_table, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(mul, kX86, kFloat, kNCHW, def);
@@ -74,6 +74,8 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
       "fetch",
       "cast",
       "expand",
+      // Shares its input buffer when the input already has the full batch
+      "expand_batch_size_like",
   };
 
   auto insert_invalid_op_nodes_for_specific_target = [&](
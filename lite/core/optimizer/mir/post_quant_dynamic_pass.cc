@@ -15,8 +15,11 @@
 #include "lite/core/optimizer/mir/post_quant_dynamic_pass.h"
 #include <algorithm>
 #include <cmath>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include "lite/api/paddle_place.h"
 #include "lite/core/optimizer/mir/pass_registry.h"
@@ -173,10 +176,18 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
     LOG(FATAL) << "Not support quant type:" << static_cast<int>(quant_type_);
   }
 
+  // The tables quantized by lookup_table_row_quant_pass read their scales
+  // from `W_scale`, the op and the fp32 scales are kept as they are
+  std::set<std::string> row_scales;
   std::vector<mir::Node*> nodes;
   for (auto* node : graph->StmtTopologicalOrder()) {
     if (node->IsStmt()) {
       const std::string op_type = node->stmt()->op_type();
+      const auto* op_info = node->stmt()->op_info();
+      if (op_info->HasInput("W_scale") && !op_info->Input("W_scale").empty()) {
+        for (auto& name : op_info->Input("W_scale")) row_scales.insert(name);
+        continue;
+      }
       auto iter = std::find(quant_ops.begin(), quant_ops.end(), op_type);
       if (iter != quant_ops.end()) {
         nodes.push_back(node);
@@ -184,6 +195,9 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
     }
   }
 
+  // A weight shared by several ops is quantized once, the others reuse the
+  // scales of the first one
+  std::map<std::string, std::pair<int, std::vector<float>>> quantized;
   for (auto* node : nodes) {
     const std::string op_type = node->stmt()->op_type();
     OpInfo* op_info = node->stmt()->mutable_op_info();
@@ -192,21 +206,37 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
       CHECK(in_node->IsArg()) << "The input node should be variable.";
       if (in_node->arg()->is_weight) {
         std::string weight_name = in_node->arg()->name;
+        if (row_scales.count(weight_name)) continue;
         Tensor* weight = scope->FindVar(weight_name)->GetMutable<Tensor>();
         CHECK(weight) << "Can not find the weight in scope.";
-        if (weight->precision() != PrecisionType::kFloat) {
-          LOG(INFO) << "The dtype of weight is not fp32, "
-                    << "so skip quantizing the weight of " << weight_name;
-          continue;
-        }
         auto iter =
             std::find(quant_axis1_ops.begin(), quant_axis1_ops.end(), op_type);
         int quant_axis = iter != quant_axis1_ops.end() ? 1 : 0;
         if (weight->dims().size() == 1) {
           quant_axis = 0;
         }
+        auto quantized_iter = quantized.find(weight_name);
+        if (quantized_iter != quantized.end()) {
+          CHECK_EQ(quantized_iter->second.first, quant_axis)
+              << "The shared weight " << weight_name
+              << " is quantized along different axes";
+          op_info->SetAttr<std::string>("quantization_type",
+                                        "post_weight_channel_wise_abs_max");
+          op_info->SetAttr("quantize_weight_bits", quant_bits);
+          op_info->SetAttr(weight_name + "_quant_scale",
+                           quantized_iter->second.second);
+          continue;
+        }
+        if (weight->precision() != PrecisionType::kFloat) {
+          LOG(INFO) << "The dtype of weight is not fp32, "
+                    << "so skip quantizing the weight of " << weight_name;
+          continue;
+        }
         PostQuantDynamicPerChannel(
             op_info, weight, weight_name, quant_axis, quant_bits);
+        quantized[weight_name] = std::make_pair(
+            quant_axis,
+            op_info->GetAttr<std::vector<float>>(weight_name + "_quant_scale"));
       }
     }
   }
@@ -30,6 +30,8 @@ namespace mir {
  * weights to int8/16. So the size of the quantized weights is reduced 4x/2x.
  * In inference stage, the quantized weights are dequantized to fp32 and run
  * all ops to get output.
+ * The lookup tables already quantized by lookup_table_row_quant_pass, i.e.
+ * the ops with a `W_scale` input, and their fp32 scales are left as they are.
  */
 class PostQuantDynamicPass : public ProgramPass {
  public:
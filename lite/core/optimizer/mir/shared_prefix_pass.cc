@@ -0,0 +1,166 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/shared_prefix_pass.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+#include "lite/core/optimizer/mir/type_precision_cast_pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Ordered so that the state of an op is the max of its inputs
+enum class VarState { kConstant = 0, kShared = 1, kBatched = 2 };
+
+// Whether the leading dim of `var` may be the batch dim, so that it can be
+// repeated to the batch. The outputs of the ops computing shapes, LoDs or
+// reductions are not batched tensors, and the shape from the var desc(see
+// Program::PrepareWorkspace) must be [-1, ...] or [1, ...] if known.
+static bool IsBroadcastable(Node* var) {
+  static const std::set<std::string> kUnbatchedOps{
+      "shape", "size", "lod_reset", "lod_array_length", "arg_max", "arg_min"};
+  for (auto* producer : var->inlinks) {
+    const auto& op_type = producer->AsStmt().op_type();
+    if (kUnbatchedOps.count(op_type) || op_type.find("reduce_") == 0 ||
+        op_type.find("sequence_") == 0) {
+      return false;
+    }
+  }
+  for (auto* reader : var->outlinks) {
+    auto* scope = reader->AsStmt().op()->scope();
+    auto* var_ptr = scope ? scope->FindVar(var->AsArg().name) : nullptr;
+    if (var_ptr == nullptr || !var_ptr->IsType<Tensor>()) continue;
+    const auto& dims = var_ptr->Get<Tensor>().dims();
+    return dims.empty() || dims[0] == -1 || dims[0] == 1;
+  }
+  return true;
+}
+
+void SharedPrefixPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  if (broadcast_inputs_.empty()) return;
+  auto is_broadcast = [&](const std::string& name) {
+    return std::find(broadcast_inputs_.begin(),
+                     broadcast_inputs_.end(),
+                     name) != broadcast_inputs_.end();
+  };
+
+  std::map<Node*, VarState> states;
+  // The first batched input, all the shared vars are expanded to its batch
+  Node* batch_ref = nullptr;
+  // (shared var, the op that reads it) where the batch starts
+  std::vector<std::pair<Node*, Node*>> boundaries;
+  int shared_ops = 0;
+  int total_ops = 0;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& stmt = node->AsStmt();
+    total_ops++;
+    if (stmt.op_type() == "feed") {
+      for (auto* out : node->outlinks) {
+        bool shared = is_broadcast(out->AsArg().name);
+        states[out] = shared ? VarState::kShared : VarState::kBatched;
+        if (!shared && batch_ref == nullptr) batch_ref = out;
+      }
+      continue;
+    }
+    VarState state = VarState::kConstant;
+    for (auto* in : node->inlinks) {
+      if (in->AsArg().is_weight || in->AsArg().is_persist) continue;
+      // A var produced by no op and not persistable comes from outside
+      auto it = states.find(in);
+      state = std::max(state,
+                       it == states.end() ? VarState::kBatched : it->second);
+    }
+    for (auto* out : node->outlinks) {
+      states[out] = state;
+    }
+    if (state == VarState::kShared) {
+      shared_ops++;
+    } else if (state == VarState::kBatched) {
+      for (auto* in : node->inlinks) {
+        auto it = states.find(in);
+        if (it != states.end() && it->second == VarState::kShared) {
+          boundaries.emplace_back(in, node);
+        }
+      }
+    }
+  }
+  if (batch_ref == nullptr || boundaries.empty()) {
+    LOG(INFO) << "No shared prefix to broadcast.";
+    return;
+  }
+  for (auto& boundary : boundaries) {
+    if (!IsBroadcastable(boundary.first)) {
+      LOG(WARNING) << "The leading dim of the shared var "
+                   << boundary.first->AsArg().name
+                   << " is not the batch dim, skip shared_prefix_pass, the "
+                      "broadcast inputs must be fed with the full batch.";
+      return;
+    }
+  }
+
+  // One expand_batch_size_like per shared var, reused by all its readers
+  std::map<Node*, Node*> expanded;
+  for (auto& boundary : boundaries) {
+    auto* shared = boundary.first;
+    auto* reader = boundary.second;
+    auto* scope = reader->AsStmt().op()->scope();
+    const auto& shared_name = shared->AsArg().name;
+    if (!expanded.count(shared)) {
+      auto expand_name = shared_name + "/expand_batch";
+      scope->Var(expand_name);
+      auto* expand_arg = graph->NewArgumentNode(expand_name);
+      cpp::OpDesc op_desc;
+      op_desc.SetType("expand_batch_size_like");
+      op_desc.SetInput("X", {shared_name});
+      op_desc.SetInput("Input", {batch_ref->AsArg().name});
+      op_desc.SetOutput("Out", {expand_name});
+      op_desc.SetAttr("input_dim_idx", 0);
+      op_desc.SetAttr("output_dim_idx", 0);
+      auto expand_op = LiteOpRegistry::Global().Create(op_desc.Type());
+      CHECK(expand_op) << "No op found for " << op_desc.Type();
+      expand_op->Attach(op_desc, scope);
+      auto* expand_inst =
+          graph->GraphCreateInstructNode(expand_op, graph->valid_places());
+      IR_NODE_LINK_TO(shared, expand_inst);
+      IR_NODE_LINK_TO(batch_ref, expand_inst);
+      IR_OP_VAR_LINK(expand_inst, expand_arg);
+      expanded[shared] = expand_arg;
+    }
+    auto* expand_arg = expanded[shared];
+    RemoveDirectedLink(shared, reader);
+    DirectedLink(expand_arg, reader);
+    UpdateInputs(reader->AsStmt().op().get(),
+                 shared_name,
+                 expand_arg->AsArg().name);
+    auto updated_op_info = *reader->AsStmt().op_info();
+    reader->AsStmt().ResetOp(updated_op_info, graph->valid_places());
+  }
+  LOG(INFO) << "Shared prefix: " << shared_ops << " of " << total_ops
+            << " ops run once per request, " << expanded.size()
+            << " vars are broadcast to the batch of "
+            << batch_ref->AsArg().name;
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(shared_prefix_pass, paddle::lite::mir::SharedPrefixPass)
+    .BindTargets({TARGET(kAny)});
@@ -0,0 +1,57 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Run the subgraph that depends only on the broadcast inputs once per request.
+ * The broadcast inputs(CxxConfig::set_broadcast_inputs) are fed with a
+ * leading dim of 1, e.g. the user features of a CTR model, and the other
+ * inputs with the batch of candidate items. Every var is classified as
+ * - constant: depends on no feed,
+ * - shared: depends on broadcast inputs and constants only,
+ * - batched: depends on a batched input.
+ * The ops producing shared vars are the shared prefix and run at batch 1.
+ * Where a shared var is read by an op producing batched vars, an
+ * expand_batch_size_like op repeats it to the batch of the first batched
+ * input, so the rest of the graph sees the same tensors as before.
+ * The leading dim of the shared vars must be the batch dim, the pass leaves
+ * the graph unchanged if a shared var read by the batched ops is produced by
+ * a shape, LoD or reduce op, or its var desc has a leading dim other than -1
+ * or 1, and the broadcast inputs must then be fed with the full batch.
+ */
+class SharedPrefixPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  void SetBroadcastInputs(const std::vector<std::string>& names) {
+    broadcast_inputs_ = names;
+  }
+
+ private:
+  std::vector<std::string> broadcast_inputs_;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
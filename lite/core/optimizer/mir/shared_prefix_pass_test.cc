@@ -0,0 +1,232 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/shared_prefix_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+const int kFeatures = 4;
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                const std::vector<int64_t>& shape,
+                bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(VarDescAPI::VarDataType::FP32);
+  var_desc->SetShape(shape);
+  var_desc->SetPersistable(persistable);
+}
+
+void AddFeedDesc(cpp::BlockDesc* block_desc, const std::string& out, int col) {
+  AddVarDesc(block_desc, out, {-1, kFeatures});
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("feed");
+  op_desc->SetInput("X", {"feed"});
+  op_desc->SetOutput("Out", {out});
+  op_desc->SetAttr<int>("col", col);
+}
+
+void AddScaleDesc(cpp::BlockDesc* block_desc,
+                  const std::string& x,
+                  const std::string& out,
+                  float scale) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("scale");
+  op_desc->SetInput("X", {x});
+  op_desc->SetOutput("Out", {out});
+  op_desc->SetAttr<float>("scale", scale);
+  op_desc->SetAttr<float>("bias", 1.f);
+  op_desc->SetAttr<bool>("bias_after_scale", true);
+}
+
+// feed -> u -> scale -> u1, feed -> i -> scale -> i1,
+// (u1, i1) -> concat(axis 1) -> c -> scale -> out
+// u is the user tower and i the item tower, only u is broadcast.
+// `shared_shape` is the shape of u1 in the var desc.
+std::shared_ptr<cpp::ProgramDesc> TwoTowerDesc(
+    const std::vector<int64_t>& shared_shape) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "feed", {}, true);
+  AddFeedDesc(block_desc, "u", 0);
+  AddFeedDesc(block_desc, "i", 1);
+  AddVarDesc(block_desc, "u1", shared_shape);
+  AddScaleDesc(block_desc, "u", "u1", 2.f);
+  AddVarDesc(block_desc, "i1", {-1, kFeatures});
+  AddScaleDesc(block_desc, "i", "i1", 3.f);
+  AddVarDesc(block_desc, "c", {-1, 2 * kFeatures});
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("concat");
+  op_desc->SetInput("X", {"u1", "i1"});
+  op_desc->SetOutput("Out", {"c"});
+  op_desc->SetAttr<int>("axis", 1);
+  AddVarDesc(block_desc, "out", {-1, 2 * kFeatures});
+  AddScaleDesc(block_desc, "c", "out", 0.5f);
+  return program_desc;
+}
+
+int CountOps(SSAGraph* graph, const std::string& op_type) {
+  int count = 0;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (node->AsStmt().op_type() == op_type) count++;
+  }
+  return count;
+}
+
+// Runs the two tower program on `batch` items, the user features are fed
+// with a batch of 1 if `broadcast` and repeated to the batch if not.
+std::vector<float> RunTwoTower(bool broadcast, int batch) {
+  auto program_desc = TwoTowerDesc({-1, kFeatures});
+  auto scope = std::make_shared<Scope>();
+  scope->Var("feed")->GetMutable<std::vector<Tensor>>();
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kAny)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  if (broadcast) {
+    SharedPrefixPass pass;
+    pass.SetBroadcastInputs({"u"});
+    pass.Apply(graph);
+  }
+  EXPECT_EQ(CountOps(graph.get(), "expand_batch_size_like"),
+            broadcast ? 1 : 0);
+
+  std::vector<std::vector<Instruction>> insts(1);
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& stmt = node->AsStmt();
+    std::unique_ptr<KernelBase> picked;
+    for (auto& kernel : stmt.kernels()) {
+      if (kernel->alias() == "def") picked = std::move(kernel);
+    }
+    CHECK(picked) << "No kernel for " << stmt.op_type();
+    insts[0].emplace_back(stmt.op(), std::move(picked));
+  }
+  RuntimeProgram runtime_program(std::move(insts));
+
+  // The feed ops are skipped by the run, the inputs are set on their
+  // outputs as the predictor does
+  auto& u = *program.exec_scope()->FindVar("u")->GetMutable<Tensor>();
+  auto& i = *program.exec_scope()->FindVar("i")->GetMutable<Tensor>();
+  const int user_rows = broadcast ? 1 : batch;
+  u.Resize({user_rows, kFeatures});
+  auto* u_data = u.mutable_data<float>();
+  for (int r = 0; r < user_rows; r++) {
+    for (int k = 0; k < kFeatures; k++) {
+      u_data[r * kFeatures + k] = static_cast<float>(k) - 1.5f;
+    }
+  }
+  i.Resize({batch, kFeatures});
+  auto* i_data = i.mutable_data<float>();
+  for (int64_t k = 0; k < i.numel(); k++) {
+    i_data[k] = static_cast<float>(k % 7) * 0.25f;
+  }
+  runtime_program.Run();
+
+  auto* out = program.exec_scope()->FindVar("out")->GetMutable<Tensor>();
+  EXPECT_EQ(out->dims(), DDim({batch, 2 * kFeatures}));
+  return std::vector<float>(out->data<float>(),
+                            out->data<float>() + out->numel());
+}
+
+TEST(SharedPrefixPass, same_outputs_as_full_batch) {
+  for (int batch : {1, 5}) {
+    auto expected = RunTwoTower(false, batch);
+    auto broadcast = RunTwoTower(true, batch);
+    ASSERT_EQ(broadcast.size(), expected.size());
+    for (size_t k = 0; k < expected.size(); k++) {
+      EXPECT_FLOAT_EQ(broadcast[k], expected[k]) << "batch " << batch;
+    }
+  }
+}
+
+TEST(SharedPrefixPass, skip_unbatched_shared_vars) {
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kAny)}};
+  // The leading dim of u1 is fixed to 2 in the var desc
+  {
+    auto scope = std::make_shared<Scope>();
+    scope->Var("feed")->GetMutable<std::vector<Tensor>>();
+    Program program(TwoTowerDesc({2, kFeatures}), scope, valid_places);
+    std::unique_ptr<SSAGraph> graph(new SSAGraph());
+    graph->Build(program, valid_places);
+    SharedPrefixPass pass;
+    pass.SetBroadcastInputs({"u"});
+    pass.Apply(graph);
+    EXPECT_EQ(CountOps(graph.get(), "expand_batch_size_like"), 0);
+  }
+  // u1 is a reduction of the user features
+  {
+    auto program_desc = std::make_shared<cpp::ProgramDesc>();
+    auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+    AddVarDesc(block_desc, "feed", {}, true);
+    AddFeedDesc(block_desc, "u", 0);
+    AddFeedDesc(block_desc, "i", 1);
+    AddVarDesc(block_desc, "u1", {-1});
+    auto* reduce_desc = block_desc->AddOp<cpp::OpDesc>();
+    reduce_desc->SetType("reduce_mean");
+    reduce_desc->SetInput("X", {"u"});
+    reduce_desc->SetOutput("Out", {"u1"});
+    reduce_desc->SetAttr<std::vector<int>>("dim", {0});
+    reduce_desc->SetAttr<bool>("keep_dim", false);
+    AddVarDesc(block_desc, "out", {-1, kFeatures});
+    auto* add_desc = block_desc->AddOp<cpp::OpDesc>();
+    add_desc->SetType("elementwise_add");
+    add_desc->SetInput("X", {"i"});
+    add_desc->SetInput("Y", {"u1"});
+    add_desc->SetOutput("Out", {"out"});
+    add_desc->SetAttr<int>("axis", -1);
+
+    auto scope = std::make_shared<Scope>();
+    scope->Var("feed")->GetMutable<std::vector<Tensor>>();
+    Program program(program_desc, scope, valid_places);
+    std::unique_ptr<SSAGraph> graph(new SSAGraph());
+    graph->Build(program, valid_places);
+    SharedPrefixPass pass;
+    pass.SetBroadcastInputs({"u"});
+    pass.Apply(graph);
+    EXPECT_EQ(CountOps(graph.get(), "expand_batch_size_like"), 0);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(scale);
+USE_LITE_OP(concat);
+USE_LITE_OP(reduce_mean);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(expand_batch_size_like);
+USE_LITE_KERNEL(feed, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(scale, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(concat, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(reduce_mean, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(expand_batch_size_like, kHost, kAny, kAny, def);
@@ -0,0 +1,176 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_half_weight_pass.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// fp32 -> fp16 with round-to-nearest-even.
+static uint16_t FP32ToFP16Bits(float value) {
+  uint32_t x;
+  memcpy(&x, &value, sizeof(x));
+  const uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t abs_x = x & 0x7FFFFFFF;
+  if (abs_x >= 0x7F800000) {
+    // inf or nan
+    return sign | 0x7C00 | (abs_x > 0x7F800000 ? 0x200 : 0);
+  }
+  if (abs_x >= 0x477FF000) {
+    // Rounds to a value larger than 65504
+    return sign | 0x7C00;
+  }
+  if (abs_x < 0x38800000) {
+    // Subnormal in fp16, the unit is 2^-24
+    float abs_value;
+    memcpy(&abs_value, &abs_x, sizeof(abs_value));
+    return sign |
+           static_cast<uint16_t>(std::nearbyint(abs_value * 16777216.f));
+  }
+  // Rebias the exponent from 127 to 15 and round the dropped 13 bits
+  abs_x += 0xC8000FFF + ((abs_x >> 13) & 1);
+  return sign | static_cast<uint16_t>(abs_x >> 13);
+}
+
+// fp32 -> bf16 with round-to-nearest-even.
+static uint16_t FP32ToBF16Bits(float value) {
+  uint32_t x;
+  memcpy(&x, &value, sizeof(x));
+  if ((x & 0x7FFFFFFF) > 0x7F800000) {
+    // Keep nan a quiet nan
+    return static_cast<uint16_t>((x >> 16) | 0x40);
+  }
+  x += 0x7FFF + ((x >> 16) & 1);
+  return static_cast<uint16_t>(x >> 16);
+}
+
+static void ConvertWeight(Tensor* weight, lite_api::HalfWeightType type) {
+  Tensor fp32_weight;
+  fp32_weight.CopyDataFrom(*weight);
+  const float* src = fp32_weight.data<float>();
+  const int64_t size = fp32_weight.numel();
+  weight->clear();
+  // fp16/bf16 is not a tensor data type, the raw bits are kept as int16
+  weight->set_precision(PRECISION(kInt16));
+  uint16_t* dst = reinterpret_cast<uint16_t*>(weight->mutable_data<int16_t>());
+  if (type == lite_api::HalfWeightType::HALF_FP16) {
+    for (int64_t i = 0; i < size; i++) {
+      dst[i] = FP32ToFP16Bits(src[i]);
+    }
+  } else {
+    for (int64_t i = 0; i < size; i++) {
+      dst[i] = FP32ToBF16Bits(src[i]);
+    }
+  }
+}
+
+void X86HalfWeightPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  if (type_ == lite_api::HalfWeightType::HALF_NONE) return;
+  const std::string type_str =
+      type_ == lite_api::HalfWeightType::HALF_FP16 ? "fp16" : "bf16";
+
+  // Returns the weight node if the op runs a fp32 x86 kernel that can read
+  // its weight in 16 bits.
+  auto weight_of = [&](Node* node) -> Node* {
+    auto* stmt = node->stmt();
+    auto iter = weight_inputs_.find(stmt->op_type());
+    if (iter == weight_inputs_.end()) return nullptr;
+    if (stmt->kernels().size() != 1 ||
+        stmt->place().target != TARGET(kX86) ||
+        stmt->place().precision != PRECISION(kFloat)) {
+      return nullptr;
+    }
+    auto* op_info = stmt->op_info();
+    if (!op_info->HasInput(iter->second) ||
+        op_info->Input(iter->second).size() != 1) {
+      return nullptr;
+    }
+    const std::string weight_name = op_info->Input(iter->second).front();
+    // The other inputs are read in fp32
+    auto inputs = op_info->input_vars();
+    if (std::count(inputs.begin(), inputs.end(), weight_name) != 1) {
+      return nullptr;
+    }
+    auto* var = stmt->op()->scope()->FindVar(weight_name);
+    if (var == nullptr) return nullptr;
+    const size_t rank = var->Get<Tensor>().dims().size();
+    if (stmt->op_type() == "matmul" ? rank != 2 : rank != 2 && rank != 4) {
+      return nullptr;
+    }
+    for (auto* in : node->inlinks) {
+      if (in->IsArg() && in->arg()->name == weight_name &&
+          in->arg()->is_weight) {
+        return in;
+      }
+    }
+    return nullptr;
+  };
+
+  // A weight shared by several ops, e.g. after graph_dedup_pass, is
+  // converted once and every op reading it is marked
+  std::set<Node*> visited;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto* weight_node = weight_of(node);
+    if (weight_node == nullptr || !visited.insert(weight_node).second) {
+      continue;
+    }
+    const std::string weight_name = weight_node->arg()->name;
+    auto* scope = node->stmt()->op()->scope();
+    auto* weight = scope->FindVar(weight_name)->GetMutable<Tensor>();
+    if (weight->precision() != PRECISION(kFloat)) {
+      VLOG(4) << "Skip " << weight_name << ", it's not a fp32 weight.";
+      continue;
+    }
+    // Every reader must be able to read the 16-bit weight
+    bool all_supported = true;
+    for (auto* out : weight_node->outlinks) {
+      all_supported &= out->IsStmt() && weight_of(out) == weight_node;
+    }
+    if (!all_supported) {
+      VLOG(4) << "Skip " << weight_name
+              << ", it's also read by an op needing it in fp32.";
+      continue;
+    }
+    ConvertWeight(weight, type_);
+    VLOG(4) << "Store " << weight_name << " in " << type_str << " for "
+            << weight_node->outlinks.size() << " ops";
+
+    // Refresh the param of the picked kernels with the new attribute
+    for (auto* out : weight_node->outlinks) {
+      auto* op_info = out->stmt()->mutable_op_info();
+      op_info->SetAttr<std::string>("half_weight_type", type_str);
+      auto op = out->stmt()->op();
+      auto updated_op_info = *op_info;
+      op->Attach(updated_op_info, op->scope());
+      op->AttachKernel(out->stmt()->kernels().front().get());
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(x86_half_weight_pass, paddle::lite::mir::X86HalfWeightPass)
+    .BindTargets({TARGET(kX86)});
@@ -0,0 +1,53 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include "lite/api/paddle_place.h"
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Store the fp32 weights of x86 fc/matmul/conv2d in 16 bits (fp16 or bf16).
+ * The raw 16-bit values are kept in an int16 tensor so the optimized model is
+ * about 2x smaller, and the op is marked with the `half_weight_type`
+ * attribute("fp16" or "bf16"). fc and matmul convert the weights to fp32 on
+ * the fly in the gemm microkernel, conv2d expands them once before running.
+ * It runs after the kernels are picked, like post_quant_dynamic_pass.
+ */
+class X86HalfWeightPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  void SetHalfWeightType(lite_api::HalfWeightType type) { type_ = type; }
+
+ private:
+  lite_api::HalfWeightType type_{lite_api::HalfWeightType::HALF_FP16};
+  // The op types converted by this pass and the name of their weight input.
+  const std::map<std::string, std::string> weight_inputs_{
+      {"fc", "W"},
+      {"matmul", "Y"},
+      {"conv2d", "Filter"},
+      {"depthwise_conv2d", "Filter"}};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,169 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_half_weight_pass.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+const int kM = 2;
+const int kK = 4;
+const int kN = 3;
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(VarDescAPI::VarDataType::FP32);
+  var_desc->SetPersistable(persistable);
+}
+
+void FillTensor(Tensor* tensor, const DDim& dims, float offset) {
+  tensor->Resize(dims);
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = static_cast<float>(i % 5) * 0.25f + offset;
+  }
+}
+
+void AddWeight(cpp::BlockDesc* block_desc,
+               Scope* scope,
+               const std::string& name,
+               float offset) {
+  AddVarDesc(block_desc, name, true);
+  auto* tensor = scope->Var(name)->GetMutable<Tensor>();
+  FillTensor(tensor, DDim({kK, kN}), offset);
+  tensor->set_persistable(true);
+  tensor->set_precision(PRECISION(kFloat));
+}
+
+void AddFcDesc(cpp::BlockDesc* block_desc,
+               const std::string& input,
+               const std::string& w,
+               const std::string& out) {
+  AddVarDesc(block_desc, out);
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("fc");
+  op_desc->SetInput("Input", {input});
+  op_desc->SetInput("W", {w});
+  op_desc->SetOutput("Out", {out});
+  op_desc->SetAttr<int>("in_num_col_dims", 1);
+}
+
+// x -> fc(w) -> a, y -> fc(w) -> b, x -> fc(v) -> c, (e, v) ->
+// elementwise_add -> d, where w is shared by two fcs, as graph_dedup_pass
+// leaves it, and v is also read by an op without a 16-bit kernel.
+TEST(X86HalfWeightPass, convert_shared_weights_once) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  for (auto name : {"x", "y", "e"}) AddVarDesc(block_desc, name);
+  AddWeight(block_desc, scope.get(), "w", -0.5f);
+  AddWeight(block_desc, scope.get(), "v", 0.1f);
+  AddFcDesc(block_desc, "x", "w", "a");
+  AddFcDesc(block_desc, "y", "w", "b");
+  AddFcDesc(block_desc, "x", "v", "c");
+  AddVarDesc(block_desc, "d");
+  auto* add_desc = block_desc->AddOp<cpp::OpDesc>();
+  add_desc->SetType("elementwise_add");
+  add_desc->SetInput("X", {"e"});
+  add_desc->SetInput("Y", {"v"});
+  add_desc->SetOutput("Out", {"d"});
+  add_desc->SetAttr<int>("axis", -1);
+  Tensor fp32_w;
+  fp32_w.CopyDataFrom(scope->FindVar("w")->Get<Tensor>());
+
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kAny)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  // Keep the default kernels only, like the kernel pick does
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& stmt = node->AsStmt();
+    std::vector<std::unique_ptr<KernelBase>> picked;
+    for (auto& kernel : stmt.kernels()) {
+      if (kernel->alias() == "def") picked.push_back(std::move(kernel));
+    }
+    ASSERT_EQ(picked.size(), 1u) << stmt.op_type();
+    stmt.SetKernels(std::move(picked));
+  }
+  X86HalfWeightPass pass;
+  pass.SetHalfWeightType(lite_api::HalfWeightType::HALF_FP16);
+  pass.Apply(graph);
+
+  EXPECT_EQ(scope->FindVar("w")->Get<Tensor>().precision(), PRECISION(kInt16));
+  EXPECT_EQ(scope->FindVar("v")->Get<Tensor>().precision(), PRECISION(kFloat));
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto* op_info = node->AsStmt().op_info();
+    const bool reads_w = op_info->Type() == "fc" &&
+                         op_info->Input("W") == std::vector<std::string>{"w"};
+    EXPECT_EQ(op_info->HasAttr("half_weight_type"), reads_w)
+        << op_info->Output("Out").front();
+  }
+
+  // Both readers of w run on the fp16 copy
+  std::vector<std::vector<Instruction>> insts(1);
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& stmt = node->AsStmt();
+    insts[0].emplace_back(stmt.op(), std::move(stmt.kernels().front()));
+  }
+  RuntimeProgram runtime_program(std::move(insts));
+  auto* exec_scope = program.exec_scope();
+  FillTensor(
+      exec_scope->FindVar("x")->GetMutable<Tensor>(), DDim({kM, kK}), 0.3f);
+  FillTensor(
+      exec_scope->FindVar("y")->GetMutable<Tensor>(), DDim({kM, kK}), -0.2f);
+  FillTensor(
+      exec_scope->FindVar("e")->GetMutable<Tensor>(), DDim({kK, kN}), 0.f);
+  runtime_program.Run();
+
+  const float* w_data = fp32_w.data<float>();
+  for (auto io : {std::make_pair("x", "a"), std::make_pair("y", "b")}) {
+    auto& in_tensor = exec_scope->FindVar(io.first)->Get<Tensor>();
+    const float* in = in_tensor.data<float>();
+    auto& out = exec_scope->FindVar(io.second)->Get<Tensor>();
+    ASSERT_EQ(out.dims(), DDim({kM, kN}));
+    for (int i = 0; i < kM; i++) {
+      for (int j = 0; j < kN; j++) {
+        float ref = 0.f;
+        for (int k = 0; k < kK; k++) ref += in[i * kK + k] * w_data[k * kN + j];
+        EXPECT_NEAR(out.data<float>()[i * kN + j], ref, 1e-3f)
+            << io.second << "[" << i << ", " << j << "]";
+      }
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(fc);
+USE_LITE_OP(elementwise_add);
+USE_LITE_KERNEL(fc, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,225 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_int8_propagation_pass.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Quantized ops which already have x86 kernels with an int8 output
+static const std::set<std::string> kInt8ProducerOps{
+    "conv2d", "depthwise_conv2d", "fc"};
+
+static bool IsCandidate(Node* op_node) {
+  auto* op_info = op_node->AsStmt().op_info();
+  const std::string op_type = op_info->Type();
+  if (op_type == "relu" || op_type == "relu6" || op_type == "hard_swish") {
+    return true;
+  }
+  if (op_type == "pool2d") {
+    auto pooling_type = op_info->GetAttr<std::string>("pooling_type");
+    if (pooling_type != "max" && pooling_type != "avg") return false;
+    if (op_info->GetAttr<std::vector<int>>("ksize").size() != 2) return false;
+    if (op_info->HasAttr("adaptive") && op_info->GetAttr<bool>("adaptive")) {
+      return false;
+    }
+    return !op_info->HasAttr("data_format") ||
+           op_info->GetAttr<std::string>("data_format") != "NHWC";
+  }
+  if (op_type == "elementwise_add" || op_type == "elementwise_mul") {
+    return !op_info->HasAttr("fuse_scale") ||
+           !op_info->GetAttr<bool>("fuse_scale");
+  }
+  if (op_type == "concat") {
+    return !op_info->HasInput("AxisTensor") ||
+           op_info->Input("AxisTensor").empty();
+  }
+  return false;
+}
+
+// The per-tensor scale of `var_node`, from the quantization info of its
+// consumers or producer, or from the producer's output threshold.
+static bool FindTensorScale(Node* var_node, float* scale) {
+  const std::string& var_name = var_node->arg()->name;
+  for (auto* op_node : var_node->outlinks) {
+    auto* op_info = op_node->AsStmt().op_info();
+    if (op_info->HasInputScale(var_name) &&
+        op_info->GetInputScale(var_name).size() == 1) {
+      *scale = op_info->GetInputScale(var_name)[0];
+      return true;
+    }
+  }
+  for (auto* op_node : var_node->inlinks) {
+    auto* op_info = op_node->AsStmt().op_info();
+    if (op_info->HasOutputScale(var_name)) {
+      if (op_info->GetOutputScale(var_name).size() != 1) return false;
+      *scale = op_info->GetOutputScale(var_name)[0];
+      return true;
+    }
+    std::string threshold_name = "out_threshold";
+    std::string argname;
+    int index;
+    if (!op_info->HasAttr(threshold_name) &&
+        op_info->GetOutputArgname(var_name, &argname) &&
+        op_info->GetOutputIndex(var_name, &index)) {
+      threshold_name = argname + to_string(index) + "_threshold";
+    }
+    if (op_info->HasAttr(threshold_name)) {
+      *scale = op_info->GetAttr<float>(threshold_name) / 127.f;
+      return true;
+    }
+  }
+  return false;
+}
+
+// The scale bound of an op output which is not quantized in the model but
+// is never larger than its inputs, e.g. relu or max pooling.
+static bool DeriveOutputScale(Node* op_node,
+                              const std::vector<float>& in_scales,
+                              float* scale) {
+  auto* op_info = op_node->AsStmt().op_info();
+  const std::string op_type = op_info->Type();
+  if (op_type == "relu" || op_type == "hard_swish" || op_type == "pool2d") {
+    *scale = in_scales[0];
+  } else if (op_type == "relu6") {
+    *scale =
+        std::min(in_scales[0], op_info->GetAttr<float>("threshold") / 127.f);
+  } else if (op_type == "concat") {
+    *scale = *std::max_element(in_scales.begin(), in_scales.end());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void X86Int8PropagationPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  bool has_int8_place = false;
+  for (auto& place : graph->valid_places()) {
+    has_int8_place |= place.target == TARGET(kX86) &&
+                      place.precision == PRECISION(kInt8);
+  }
+  if (!has_int8_place) return;
+
+  // The candidates and their input scales, in topological order
+  std::vector<Node*> candidates;
+  std::map<Node*, std::map<std::string, float>> input_scales;
+  // Scales derived for the outputs of the candidates
+  std::map<std::string, float> derived_scales;
+  for (auto* op_node : graph->StmtTopologicalOrder()) {
+    if (!op_node->IsStmt()) continue;
+    auto* op_info = op_node->AsStmt().op_info();
+    if (op_info->HasAttr("enable_int8") || !IsCandidate(op_node)) continue;
+    std::map<std::string, float> scales;
+    std::vector<float> in_scales;
+    bool ok = true;
+    for (auto* in_node : op_node->inlinks) {
+      if (in_node->AsArg().is_weight || in_node->AsArg().is_persist) {
+        ok = false;
+        break;
+      }
+      const std::string& var_name = in_node->arg()->name;
+      float scale = 0.f;
+      if (!FindTensorScale(in_node, &scale)) {
+        if (!derived_scales.count(var_name)) {
+          ok = false;
+          break;
+        }
+        scale = derived_scales[var_name];
+      }
+      if (scale <= 0.f) {
+        ok = false;
+        break;
+      }
+      scales[var_name] = scale;
+      in_scales.push_back(scale);
+    }
+    if (!ok || in_scales.empty()) continue;
+    candidates.push_back(op_node);
+    input_scales[op_node] = scales;
+    float out_scale;
+    if (DeriveOutputScale(op_node, in_scales, &out_scale)) {
+      for (auto* out_node : op_node->outlinks) {
+        derived_scales[out_node->arg()->name] = out_scale;
+      }
+    }
+  }
+
+  // Keep an op only if its inputs can stay in int8, i.e. they are produced by
+  // int8 ops and every other consumer takes int8 too, otherwise marking it
+  // would only move the calib op. Dropping one candidate may break the
+  // inputs of another, so repeat until nothing changes.
+  std::set<Node*> selected(candidates.begin(), candidates.end());
+  auto is_int8_op = [&](Node* op_node) {
+    if (selected.count(op_node)) return true;
+    auto* op_info = op_node->AsStmt().op_info();
+    return op_info->HasAttr("enable_int8") &&
+           op_info->GetAttr<bool>("enable_int8");
+  };
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto* op_node : candidates) {
+      if (!selected.count(op_node)) continue;
+      bool keep = true;
+      for (auto* in_node : op_node->inlinks) {
+        if (in_node->inlinks.size() != 1) {
+          keep = false;
+          break;
+        }
+        auto* producer = in_node->inlinks.front();
+        keep = selected.count(producer) ||
+               (is_int8_op(producer) &&
+                kInt8ProducerOps.count(producer->AsStmt().op_type()));
+        for (auto* consumer : in_node->outlinks) {
+          keep = keep && is_int8_op(consumer);
+        }
+        if (!keep) break;
+      }
+      if (!keep) {
+        selected.erase(op_node);
+        changed = true;
+      }
+    }
+  }
+
+  for (auto* op_node : candidates) {
+    if (!selected.count(op_node)) continue;
+    auto& stmt = op_node->AsStmt();
+    auto* op_info = stmt.mutable_op_info();
+    for (auto& it : input_scales[op_node]) {
+      if (!op_info->HasInputScale(it.first)) {
+        op_info->SetInputScale(it.first, {it.second});
+      }
+    }
+    op_info->SetAttr("enable_int8", true);
+    VLOG(4) << "Run " << stmt.op_type() << " in int8 on x86";
+    auto updated_op_info = *op_info;
+    stmt.ResetOp(updated_op_info, graph->valid_places());
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(x86_int8_propagation_pass,
+                  paddle::lite::mir::X86Int8PropagationPass)
+    .BindTargets({TARGET(kX86)});
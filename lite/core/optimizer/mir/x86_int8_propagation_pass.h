@@ -0,0 +1,42 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Extend the int8 regions of a quantized model through pool2d,
+ * elementwise_add/mul, concat, relu, relu6 and hard_swish on x86.
+ * The quant passes only mark conv/fc-like ops with `enable_int8`, so the
+ * tensors around these ops are dequantized and requantized by calib ops.
+ * An op is marked here if every activation input is produced by an int8 op,
+ * is consumed only by int8 ops and has a known per-tensor scale (from the
+ * quantization info or the producer's output threshold). Its input scales
+ * are recorded, static_kernel_pick_pass then picks its int8_out or fp32_out
+ * kernel like for conv.
+ */
+class X86Int8PropagationPass : public mir::StmtPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
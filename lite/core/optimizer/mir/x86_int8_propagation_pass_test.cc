@@ -0,0 +1,150 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_int8_propagation_pass.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(VarDescAPI::VarDataType::FP32);
+  var_desc->SetPersistable(persistable);
+}
+
+// An fc with an int8 output of threshold 12.7 if `int8` is set
+void AddFCDesc(cpp::BlockDesc* block_desc,
+               Scope* scope,
+               const std::string& input,
+               const std::string& out,
+               bool int8) {
+  auto w = out + "_w";
+  auto bias = out + "_bias";
+  AddVarDesc(block_desc, w, true);
+  AddVarDesc(block_desc, bias, true);
+  AddVarDesc(block_desc, out);
+  auto* w_tensor = scope->Var(w)->GetMutable<Tensor>();
+  w_tensor->Resize({8, 8});
+  w_tensor->mutable_data<float>();
+  w_tensor->set_persistable(true);
+  auto* bias_tensor = scope->Var(bias)->GetMutable<Tensor>();
+  bias_tensor->Resize({8});
+  bias_tensor->mutable_data<float>();
+  bias_tensor->set_persistable(true);
+
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("fc");
+  op_desc->SetInput("Input", {input});
+  op_desc->SetInput("W", {w});
+  op_desc->SetInput("Bias", {bias});
+  op_desc->SetOutput("Out", {out});
+  op_desc->SetAttr<int>("in_num_col_dims", 1);
+  if (int8) {
+    op_desc->SetAttr<bool>("enable_int8", true);
+    op_desc->SetAttr<float>("out_threshold", 12.7f);
+  }
+}
+
+void AddUnaryDesc(cpp::BlockDesc* block_desc,
+                  const std::string& type,
+                  const std::string& input,
+                  const std::string& out) {
+  AddVarDesc(block_desc, out);
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  op_desc->SetInput("X", {input});
+  op_desc->SetOutput("Out", {out});
+  if (type == "pool2d") {
+    op_desc->SetAttr<std::string>("pooling_type", "max");
+    op_desc->SetAttr<std::vector<int>>("ksize", {2, 2});
+    op_desc->SetAttr<bool>("global_pooling", false);
+    op_desc->SetAttr<std::vector<int>>("strides", {2, 2});
+    op_desc->SetAttr<std::vector<int>>("paddings", {0, 0});
+  }
+}
+
+// x -> fc(int8) -> a -> relu -> b -> pool2d -> p: relu and pool2d stay int8
+// x -> fc(fp32) -> c -> relu -> r: the producer is not int8
+// x -> fc(int8) -> e -> relu -> g, e -> softmax -> s: a consumer is not int8
+TEST(X86Int8PropagationPass, mark_int8_ops) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVarDesc(block_desc, "x");
+  AddFCDesc(block_desc, scope.get(), "x", "a", true);
+  AddUnaryDesc(block_desc, "relu", "a", "b");
+  AddUnaryDesc(block_desc, "pool2d", "b", "p");
+  AddFCDesc(block_desc, scope.get(), "x", "c", false);
+  AddUnaryDesc(block_desc, "relu", "c", "r");
+  AddFCDesc(block_desc, scope.get(), "x", "e", true);
+  AddUnaryDesc(block_desc, "relu", "e", "g");
+  AddUnaryDesc(block_desc, "softmax", "e", "s");
+
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kInt8)},
+                                  Place{TARGET(kX86), PRECISION(kFloat)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  X86Int8PropagationPass pass;
+  pass.Apply(graph);
+
+  // Whether the op producing each var runs in int8
+  std::map<std::string, bool> int8_outputs;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto* op_info = node->AsStmt().op_info();
+    bool int8 = op_info->HasAttr("enable_int8") &&
+                op_info->GetAttr<bool>("enable_int8");
+    for (auto& name : op_info->output_vars()) {
+      int8_outputs[name] = int8;
+    }
+  }
+  std::map<std::string, bool> expected{{"a", true},
+                                       {"b", true},
+                                       {"p", true},
+                                       {"c", false},
+                                       {"r", false},
+                                       {"e", true},
+                                       {"g", false},
+                                       {"s", false}};
+  EXPECT_EQ(int8_outputs, expected);
+
+  // The scale of the relu input comes from the fc threshold
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt() || node->AsStmt().op_type() != "relu") continue;
+    auto* op_info = node->AsStmt().op_info();
+    if (op_info->Input("X").front() != "a") continue;
+    ASSERT_TRUE(op_info->HasInputScale("a"));
+    EXPECT_FLOAT_EQ(op_info->GetInputScale("a")[0], 0.1f);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
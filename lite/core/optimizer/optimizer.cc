@@ -145,6 +145,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "scale_calc_offline_pass",
        "unsqueeze_calc_offline_pass",
        "ssd_boxes_calc_offline_pass",
+       "constant_folding_pass",
        // A minimal set of op fusion pass.
        "op_fusion_minimal_set_pass",
        // For the fully quantization model, the quantization parameters of the
@@ -173,8 +174,10 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        // TODO(Superjomn) Refine the fusion related design to select fusion
        // kernels for devices automatically.
        "lite_conv_activation_fuse_pass",              //
+       "lite_depthwise_pointwise_conv_fuse_pass",     //
        "lite_var_conv_2d_activation_fuse_pass",       //
        "lite_match_matrix_activation_fuse_pass",      //
+       "transpose_eliminate_pass",                    //
        "lite_squeeze2_matmul_fuse_pass",              //
        "lite_reshape2_matmul_fuse_pass",              //
        "lite_matmul_element_add_fuse_pass",           //
@@ -184,10 +187,14 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "lite_transpose_softmax_transpose_fuse_pass",  //
        "lite_interpolate_fuse_pass",                  //
        "identity_scale_eliminate_pass",               //
+       "lite_elementwise_chain_fuse_pass",            //
        "lite_scales_fuse_pass",                       //
        "lite_sequence_reverse_embedding_fuse_pass",   //
+       "lookup_table_row_quant_pass",                 //
+       "lite_lookup_table_sequence_pool_fuse_pass",   //
        "elementwise_mul_constant_eliminate_pass",     //
        "lite_sequence_pool_concat_fuse_pass",         //
+       "search_padding_eliminate_pass",               //
        "lite_scale_activation_fuse_pass",             //
        "lite_scaleacts_fuse_pass",                    //
        "lite_elementwise_scale_fuse_pass",            //
@@ -202,6 +209,8 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "identity_dropout_eliminate_pass",
        "sparse_conv_detect_pass",
        "keepdims_convert_pass",
+       // After the fusions, which may rewrite the weights of the fused ops
+       "graph_dedup_pass",
        "__xpu__max_pooling_pad_zero_detect_fuse_pass",
        "__xpu__graph_dedup_pass",
        "__xpu__resnet_fuse_pass",
@@ -227,6 +236,10 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "mlu_subgraph_pass",
        "fpga_concat_fuse_pass",
        "control_flow_op_unused_inputs_and_outputs_eliminate_pass",
+       // Run the ops depending only on the broadcast inputs at batch 1, after
+       // the fusions so that fused ops are classified as a whole
+       "shared_prefix_pass",
+       "x86_int8_propagation_pass",
        "static_kernel_pick_pass",  // pick original kernel from graph
 
        "remove_tf_redundant_ops_pass",
@@ -271,6 +284,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "runtime_context_assign_pass",
        "argument_type_display_pass",
        "lite_inplace_fuse_pass",
+       "host_block_fuse_pass",
 #if !(defined(LITE_WITH_FPGA) || defined(LITE_WITH_PRECISION_PROFILE))
        "memory_optimize_pass",
        "xpu_memory_optimize_pass"
@@ -298,13 +312,16 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
         std::remove(
             passes_local.begin(), passes_local.end(), "lite_conv_bn_fuse_pass"),
         passes_local.end());
-    // duplicated nodes can't be removed if referenced in different subgraphs
-    passes_local.erase(std::remove(passes_local.begin(),
-                                   passes_local.end(),
-                                   "__xpu__graph_dedup_pass"),
-                       passes_local.end());
-    LOG(INFO) << "skip __xpu__graph_dedup_pass because of multiple subgraphs["
-              << program.block_size() << "]";
+    // nodes can't be removed or renamed if referenced in different subgraphs
+    for (auto pass : {"graph_dedup_pass",
+                      "__xpu__graph_dedup_pass",
+                      "transpose_eliminate_pass"}) {
+      passes_local.erase(
+          std::remove(passes_local.begin(), passes_local.end(), pass),
+          passes_local.end());
+      LOG(INFO) << "skip " << pass << " because of multiple subgraphs["
+                << program.block_size() << "]";
+    }
   }
 
   // multi_stream_analysis_pass must be in the front of
@@ -48,6 +48,7 @@ const std::set<std::string> kSubblockSkippedPasses(
      "range_calc_offline_pass",
      "assign_value_calc_offline_pass",
      "ssd_boxes_calc_offline_pass",
+     "constant_folding_pass",
      "p_norm_fill_constant_max_div_fuse_pass"});
 
 /*
@@ -258,7 +258,8 @@ void RuntimeProgram::SaveRuntimProgramIntoProgramDesc(
 RuntimeProgram::RuntimeProgram(
     const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
     Scope* exec_scope,
-    int block_idx)
+    int block_idx,
+    const std::vector<model_parser::ReadyToRunKernel>* kernels)
     : exec_scope_(exec_scope) {
   CHECK(program_desc);
   auto block_size = program_desc->BlocksSize();
@@ -269,6 +270,9 @@ RuntimeProgram::RuntimeProgram(
   auto block_desc = program_desc->GetBlock<cpp::BlockDesc>(block_idx);
   instructions_.resize(kRootBlockIdx + 1);
   auto op_size = block_desc->OpsSize();
+  if (kernels) {
+    CHECK_EQ(kernels->size(), op_size);
+  }
   for (size_t op_idx = 0; op_idx < op_size; op_idx++) {
     auto op_desc = block_desc->GetOp<cpp::OpDesc>(op_idx);
     CHECK(op_desc);
@@ -307,15 +311,20 @@ RuntimeProgram::RuntimeProgram(
     }
     op->Attach(*op_desc, exec_scope_);
     std::unique_ptr<KernelBase> kernel;
-    if (op_desc->HasAttr(kKernelTypeAttr)) {
+    if (kernels || op_desc->HasAttr(kKernelTypeAttr)) {
       // Create op and pick up the best kernel according to the
-      // kKernelTypeAttr attribute
-      auto kernel_type = op_desc->GetAttr<std::string>(kKernelTypeAttr);
+      // ready-to-run section or the kKernelTypeAttr attribute
       std::string alias;
       Place place;
-      KernelBase::ParseKernelType(kernel_type, &op_type, &alias, &place);
-      VLOG(3) << "Found the attr '" << kKernelTypeAttr << "': " << kernel_type
-              << " for " << op_type;
+      if (kernels) {
+        alias = (*kernels)[op_idx].alias;
+        place = (*kernels)[op_idx].place;
+      } else {
+        auto kernel_type = op_desc->GetAttr<std::string>(kKernelTypeAttr);
+        KernelBase::ParseKernelType(kernel_type, &op_type, &alias, &place);
+        VLOG(3) << "Found the attr '" << kKernelTypeAttr
+                << "': " << kernel_type << " for " << op_type;
+      }
 
 // Error message: if current kernel is not supported, WITH_EXTRA lib is
 // suggested.
@@ -338,18 +347,14 @@ RuntimeProgram::RuntimeProgram(
           op_type + "' is not supported by Paddle-Lite.";
 #endif
 
-      auto kernels = op->CreateKernels({place});
-      if (kernels.size() == 0 && place.target == TargetType::kARM) {
+      // Only the picked kernel is created, the other kernels of the place
+      // are never constructed.
+      kernel = op->CreateKernel(place, alias);
+      if (!kernel && place.target == TargetType::kARM) {
         place.target = TargetType::kHost;
-        kernels = op->CreateKernels({place});
+        kernel = op->CreateKernel(place, alias);
       }
-      CHECK_GT(kernels.size(), 0) << kernels_error_message;
-      auto it = std::find_if(
-          kernels.begin(), kernels.end(), [&](std::unique_ptr<KernelBase>& it) {
-            return it->alias() == alias;
-          });
-      CHECK(it != kernels.end());
-      kernel = std::move(*it);
+      CHECK(kernel) << kernels_error_message;
     } else {
       // TODO(hong19860320) add kernel picking according to the type of input
       // and output tensors
@@ -395,6 +400,83 @@ void RuntimeProgram::SaveOutput() {
 }
 #endif
 
+// Whether `inst` reads or writes any of the variables of `pending`.
+static bool SharesVariables(const Instruction& inst,
+                            const Instruction& pending) {
+  std::set<std::string> vars;
+  for (auto& name : pending.op()->op_info()->input_vars()) vars.insert(name);
+  for (auto& name : pending.op()->op_info()->output_vars()) vars.insert(name);
+  for (auto& name : inst.op()->op_info()->input_vars()) {
+    if (vars.count(name)) return true;
+  }
+  for (auto& name : inst.op()->op_info()->output_vars()) {
+    if (vars.count(name)) return true;
+  }
+  return false;
+}
+
+// Wait for the pending instructions which share variables with `inst`.
+static void WaitSharedPendingInstructions(
+    const Instruction& inst, std::vector<Instruction*>* pending_insts) {
+  for (auto it = pending_insts->begin(); it != pending_insts->end();) {
+    if (SharesVariables(inst, **it)) {
+      (*it)->mutable_kernel()->Wait();
+      it = pending_insts->erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void RuntimeProgram::InitFusedHostBlocks() {
+  fused_host_blocks_.clear();
+  fused_host_block_ids_.clear();
+// The profilers and the FPGA monitor account every instruction separately
+#if !defined(LITE_WITH_PROFILE) && !defined(LITE_WITH_PRECISION_PROFILE) && \
+    !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
+  auto& insts = instructions_[kRootBlockIdx];
+  auto block_id_of = [](Instruction& inst) -> int {
+    auto* op_info = inst.op()->op_info();
+    auto* kernel = inst.kernel();
+    if (op_info == nullptr || kernel == nullptr ||
+        !op_info->HasAttr(kFusedHostBlockAttr)) {
+      return -1;
+    }
+    if (kernel->target() != TARGET(kHost) && kernel->target() != TARGET(kX86)) {
+      return -1;
+    }
+    return op_info->GetAttr<int>(kFusedHostBlockAttr);
+  };
+  std::vector<int> ids(insts.size(), -1);
+  size_t begin = 0;
+  while (begin < insts.size()) {
+    int id = block_id_of(insts[begin]);
+    size_t end = begin + 1;
+    while (id >= 0 && end < insts.size() && block_id_of(insts[end]) == id) {
+      ++end;
+    }
+    if (end - begin > 1) {
+      std::vector<Instruction*> block_insts;
+      for (size_t i = begin; i < end; i++) {
+        block_insts.push_back(&insts[i]);
+      }
+      std::unique_ptr<FusedHostBlock> block(new FusedHostBlock(block_insts));
+      if (block->Init()) {
+        for (size_t i = begin; i < end; i++) {
+          ids[i] = static_cast<int>(fused_host_blocks_.size());
+        }
+        fused_host_blocks_.emplace_back(std::move(block));
+      }
+    }
+    begin = end;
+  }
+  if (!fused_host_blocks_.empty()) {
+    VLOG(4) << "Fused " << fused_host_blocks_.size() << " host blocks";
+    fused_host_block_ids_ = std::move(ids);
+  }
+#endif
+}
+
 void RuntimeProgram::Run() {
 #ifdef LITE_WITH_PRECISION_PROFILE
   auto inst_precision_profiler = paddle::lite::profile::PrecisionProfiler();
@@ -418,7 +500,13 @@ void RuntimeProgram::Run() {
 
   int idx = -1;
 
+  // The instructions whose kernels are still running asynchronously
+  std::vector<Instruction*> pending_insts;
   auto& insts = instructions_[kRootBlockIdx];
+  if (thread_schedule_ != lite_api::LITE_THREADS_FIXED && !thread_selector_) {
+    thread_selector_.reset(
+        new ThreadCountSelector(thread_schedule_, insts.size()));
+  }
   for (auto& inst : insts) {
     ++idx;
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
@@ -446,7 +534,24 @@ void RuntimeProgram::Run() {
     inst.Flush(idx);
 #endif
 
+    if (!fused_host_block_ids_.empty() && fused_host_block_ids_[idx] >= 0) {
+      auto* block = fused_host_blocks_[fused_host_block_ids_[idx]].get();
+      // The whole block runs at its first instruction
+      if (block->instructions().front() != &inst) continue;
+      for (auto* block_inst : block->instructions()) {
+        WaitSharedPendingInstructions(*block_inst, &pending_insts);
+      }
+      block->Run();
+      continue;
+    }
+
+    WaitSharedPendingInstructions(inst, &pending_insts);
+    if (thread_selector_) thread_selector_->Begin(idx, &inst);
     inst.Run();
+    if (thread_selector_) thread_selector_->End(idx);
+    if (inst.kernel()->IsPending()) {
+      pending_insts.push_back(&inst);
+    }
 
 #ifdef LITE_WITH_FPGA
     monitor.postRun(inst);
@@ -461,6 +566,9 @@ void RuntimeProgram::Run() {
 #endif
 #endif  // LITE_WITH_PRECISION_PROFILE
   }
+  for (auto* inst : pending_insts) {
+    inst->mutable_kernel()->Wait();
+  }
 
 #ifdef LITE_WITH_METAL
   if (metal_ctx_) {
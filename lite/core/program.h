@@ -19,10 +19,13 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/core/fused_host_block.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/thread_selector.h"
 #include "lite/model_parser/cpp_desc.h"
+#include "lite/model_parser/ready_to_run.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/profiler.h"
 #endif
@@ -36,8 +39,6 @@
 namespace paddle {
 namespace lite {
 
-static const char kKernelTypeAttr[] = "__@kernel_type_attr@__";
-
 // A program is used to represent a code program, in Paddle, a code program
 // contains:
 // - main block, which is a list of OpLite
@@ -131,6 +132,7 @@ struct Instruction {
   friend STL::ostream& operator<<(STL::ostream& os, const Instruction& other);
 
   const OpLite* op() const { return op_.get(); }
+  OpLite* mutable_op() { return op_.get(); }
   const KernelBase* kernel() const { return kernel_.get(); }
   KernelBase* mutable_kernel() { return kernel_.get(); }
 
@@ -208,10 +210,13 @@ class LITE_API RuntimeProgram {
       : instructions_(std::move(insts)) {
     Init();
   }
+  // `kernels` are the kernels of the ops of the block read from the
+  // ready-to-run section of the model, if any.
   explicit RuntimeProgram(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
       Scope* exec_scope,
-      int block_idx = kRootBlockIdx);
+      int block_idx = kRootBlockIdx,
+      const std::vector<model_parser::ReadyToRunKernel>* kernels = nullptr);
   ~RuntimeProgram() {
 #ifdef LITE_WITH_OPENCL
     // save program kernel cache & tuned params
@@ -284,6 +289,7 @@ class LITE_API RuntimeProgram {
         }
       }
     }
+    InitFusedHostBlocks();
   }
 
   void Run();
@@ -294,6 +300,12 @@ class LITE_API RuntimeProgram {
   void set_exec_scope(Scope* x) { exec_scope_ = x; }
   Scope* exec_scope() { return exec_scope_; }
 
+  // See ConfigBase::set_thread_schedule
+  void set_thread_schedule(lite_api::ThreadScheduleMode mode) {
+    thread_schedule_ = mode;
+    thread_selector_.reset();
+  }
+
   const std::vector<Instruction>& instructions(
       int block_idx = kRootBlockIdx) const {
     return instructions_[block_idx];
@@ -327,7 +339,16 @@ class LITE_API RuntimeProgram {
 
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
+  // Group the consecutive instructions marked by host_block_fuse_pass
+  void InitFusedHostBlocks();
+
   std::vector<std::vector<Instruction>> instructions_;
+  std::vector<std::unique_ptr<FusedHostBlock>> fused_host_blocks_;
+  // The index of the fused host block of every root instruction, -1 if none
+  std::vector<int> fused_host_block_ids_;
+  lite_api::ThreadScheduleMode thread_schedule_{lite_api::LITE_THREADS_FIXED};
+  // Created at the first run, once the thread pool is set up
+  std::unique_ptr<ThreadCountSelector> thread_selector_;
   Scope* exec_scope_{};
   int64_t version_{0};
 
@@ -0,0 +1,171 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/program.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <functional>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "lite/backends/host/host_allocator.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+
+// x -> relu -> y -> softmax -> z
+std::unique_ptr<RuntimeProgram> BuildProgram(Scope* scope) {
+  std::vector<std::vector<Instruction>> insts(1);
+  std::vector<std::pair<std::string, std::string>> ops{{"x", "y"}, {"y", "z"}};
+  std::vector<std::string> op_types{"relu", "softmax"};
+  for (size_t i = 0; i < op_types.size(); i++) {
+    scope->Var(ops[i].second)->GetMutable<Tensor>();
+    cpp::OpDesc desc;
+    desc.SetType(op_types[i]);
+    desc.SetInput("X", {ops[i].first});
+    desc.SetOutput("Out", {ops[i].second});
+    auto op = LiteOpRegistry::Global().Create(op_types[i]);
+    CHECK(op);
+    op->Attach(desc, scope);
+    auto kernels =
+        op->CreateKernels({Place{TARGET(kX86), PRECISION(kFloat)}});
+    CHECK(!kernels.empty());
+    insts[0].emplace_back(std::move(op), std::move(kernels.front()));
+  }
+  return std::unique_ptr<RuntimeProgram>(new RuntimeProgram(std::move(insts)));
+}
+
+TEST(RuntimeProgram, no_allocation_in_steady_state) {
+  Scope scope;
+  auto* x = scope.Var("x")->GetMutable<Tensor>();
+  x->Resize({2, 3, 8, 16});
+  auto* x_data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    x_data[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  auto program = BuildProgram(&scope);
+
+  auto* stats = HostMemoryStats::Create();
+  {
+    ScopedHostMemoryStats guard(stats);
+    // The first run allocates the outputs, the following ones reuse them
+    program->Run();
+    int64_t allocations = stats->allocations();
+    EXPECT_GT(allocations, 0);
+    for (int i = 0; i < 3; i++) {
+      program->Run();
+      EXPECT_EQ(stats->allocations(), allocations);
+    }
+  }
+  stats->Release();
+
+  auto* z = scope.FindVar("z")->GetMutable<Tensor>();
+  ASSERT_EQ(z->dims(), x->dims());
+  const float* z_data = z->data<float>();
+  for (int64_t row = 0; row < z->numel() / 16; row++) {
+    float sum = 0.f;
+    for (int j = 0; j < 16; j++) sum += z_data[row * 16 + j];
+    EXPECT_NEAR(sum, 1.f, 1e-5f);
+  }
+}
+
+// Calls `run` in Run, or on a worker thread and stays pending until Wait if
+// `async` is set, like the NNAdapter subgraph kernel of an async device.
+class FakeKernel : public KernelLite<TARGET(kHost), PRECISION(kAny)> {
+ public:
+  FakeKernel(std::function<void()> run, bool async)
+      : run_(run), async_(async) {}
+
+  void Run() override {
+    if (!async_) {
+      run_();
+      return;
+    }
+    worker_ = std::thread(run_);
+    pending_ = true;
+  }
+
+  bool IsPending() const override { return pending_; }
+
+  void Wait() override {
+    if (worker_.joinable()) worker_.join();
+    pending_ = false;
+  }
+
+ private:
+  std::function<void()> run_;
+  bool async_{false};
+  bool pending_{false};
+  std::thread worker_;
+};
+
+// x -> device(async) -> y -> relu -> z, and a -> relu -> b on the cpu which
+// is independent of the device op and overlaps with it.
+TEST(RuntimeProgram, overlap_pending_kernels) {
+  Scope scope;
+  for (auto name : {"x", "a"}) {
+    scope.Var(name)->GetMutable<Tensor>()->Resize({1, 4});
+  }
+  std::atomic<bool> device_done{false};
+  bool overlapped = false;
+  bool waited = false;
+  std::vector<std::function<void()>> runs{
+      [&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        device_done = true;
+      },
+      [&] { overlapped = !device_done; },
+      [&] { waited = device_done; }};
+  std::vector<std::pair<std::string, std::string>> ops{
+      {"x", "y"}, {"a", "b"}, {"y", "z"}};
+  std::vector<std::vector<Instruction>> insts(1);
+  for (size_t i = 0; i < ops.size(); i++) {
+    scope.Var(ops[i].second)->GetMutable<Tensor>();
+    cpp::OpDesc desc;
+    desc.SetType("relu");
+    desc.SetInput("X", {ops[i].first});
+    desc.SetOutput("Out", {ops[i].second});
+    auto op = LiteOpRegistry::Global().Create("relu");
+    CHECK(op);
+    op->Attach(desc, &scope);
+    std::unique_ptr<KernelBase> kernel(new FakeKernel(runs[i], i == 0));
+    insts[0].emplace_back(std::move(op), std::move(kernel));
+  }
+  RuntimeProgram program(std::move(insts));
+
+  for (int i = 0; i < 2; i++) {
+    device_done = false;
+    overlapped = false;
+    waited = false;
+    program.Run();
+    // The cpu op ran while the device op was in flight, the reader of its
+    // output waited for it and nothing is pending once Run returns
+    EXPECT_TRUE(overlapped);
+    EXPECT_TRUE(waited);
+    EXPECT_TRUE(device_done);
+    EXPECT_FALSE(program.instructions()[0].kernel()->IsPending());
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(relu);
+USE_LITE_OP(softmax);
+USE_LITE_KERNEL(relu, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(softmax, kX86, kFloat, kNCHW, def);
@@ -14,6 +14,7 @@
 
 #include "lite/core/thread_pool.h"
 #include <string.h>
+#include <algorithm>
 #include "lite/utils/log/logging.h"
 
 namespace paddle {
@@ -40,6 +41,21 @@ void ThreadPool::Destroy() {
   }
 }
 
+int ThreadPool::ThreadNum() {
+  return nullptr == gInstance ? 1 : gInstance->thread_num_;
+}
+
+// Set per calling thread, so predictors running on different threads keep
+// their own limits.
+static thread_local int gThreadLimit = 0;
+
+void ThreadPool::SetThreadLimit(int limit) { gThreadLimit = limit; }
+
+int ThreadPool::ActiveThreadNum() {
+  int thread_num = ThreadNum();
+  return gThreadLimit > 0 ? (std::min)(gThreadLimit, thread_num) : thread_num;
+}
+
 ThreadPool::ThreadPool(int number) {
   thread_num_ = number;
   for (int i = 0; i < thread_num_; ++i) {
@@ -91,20 +107,22 @@ void ThreadPool::ReleaseThreadPool() {
 }
 
 void ThreadPool::Enqueue(TASK_BASIC&& task) {
-  if (task.second <= 1 || (nullptr == gInstance)) {
+  int thread_num = ActiveThreadNum();
+  if (task.second <= 1 || thread_num <= 1) {
     for (int i = 0; i < task.second; ++i) {
       task.first(i, 0);
     }
     return;
   }
   int work_size = task.second;
-  if (work_size > gInstance->thread_num_) {
-    gInstance->tasks_.first = [work_size, &task](int index, int tId) {
-      for (int v = tId; v < work_size; v += gInstance->thread_num_) {
+  if (work_size > thread_num) {
+    gInstance->tasks_.first = [work_size, thread_num, &task](int index,
+                                                             int tId) {
+      for (int v = tId; v < work_size; v += thread_num) {
         task.first(v, tId);  // nested lambda func
       }
     };
-    work_size = gInstance->thread_num_;
+    work_size = thread_num;
   } else {
     gInstance->tasks_.first = std::move(task.first);
   }
@@ -133,21 +151,22 @@ void ThreadPool::Enqueue(TASK_COMMON&& task) {
   int start = std::get<2>(task);
   int step = std::get<3>(task);
   int work_size = (end - start + step - 1) / step;
-  if (work_size <= 1 || (nullptr == gInstance)) {
+  int thread_num = ActiveThreadNum();
+  if (work_size <= 1 || thread_num <= 1) {
     for (int v = start; v < end; v += step) {
       std::get<0>(task)(v, 0);
     }
     return;
   }
-  if (work_size > gInstance->thread_num_) {
+  if (work_size > thread_num) {
     gInstance->tasks_.first = ([=, &task](int index, int tId) {
       auto start_index = start + tId * step;
-      auto stride = gInstance->thread_num_ * step;
+      auto stride = thread_num * step;
       for (int v = start_index; v < end; v += stride) {
         std::get<0>(task)(v, tId);  // nested lambda func
       }
     });
-    work_size = gInstance->thread_num_;
+    work_size = thread_num;
   } else {
     gInstance->tasks_.first = ([=, &task](int index, int tId) {
       auto v = start + tId * step;
@@ -37,6 +37,13 @@ class ThreadPool {
   static void ReleaseThreadPool();
   static int Init(int number);
   static void Destroy();
+  // Number of threads of the pool, 1 if it has not been created.
+  static int ThreadNum();
+  // Cap the number of threads the tasks enqueued by the calling thread run
+  // on, 0 removes the cap.
+  static void SetThreadLimit(int limit);
+  // Number of threads the tasks of the calling thread run on.
+  static int ActiveThreadNum();
 
  private:
   static ThreadPool* gInstance;
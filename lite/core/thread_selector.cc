@@ -0,0 +1,221 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_selector.h"
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <string>
+#include "lite/core/program.h"
+#ifdef LITE_USE_THREAD_POOL
+#include "lite/core/thread_pool.h"
+#elif defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace paddle {
+namespace lite {
+
+// The least work worth another thread, about 20us of a CPU core
+static const int64_t kMacsPerThread = 1 << 18;
+static const int64_t kBytesPerThread = 1 << 18;
+// Timed runs per candidate of the measured mode
+static const int kTuneRuns = 3;
+// Fewer threads win if they are at most this much slower
+static const float kTuneTolerance = 1.05f;
+
+static int64_t NowUS() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static const Tensor* FindTensor(Scope* scope, const std::string& name) {
+  auto* var = scope->FindVar(name);
+  if (var == nullptr || !var->IsType<Tensor>()) return nullptr;
+  return &var->Get<Tensor>();
+}
+
+static int64_t TensorBytes(const Tensor& tensor) {
+  int64_t elem_size = PrecisionTypeLength(tensor.precision());
+  return tensor.dims().production() * (elem_size > 0 ? elem_size : 4);
+}
+
+ThreadCountSelector::ThreadCountSelector(lite_api::ThreadScheduleMode mode,
+                                         size_t num_insts)
+    : mode_(mode), states_(num_insts) {
+#ifdef LITE_USE_THREAD_POOL
+  max_threads_ = ThreadPool::ThreadNum();
+#elif defined(_OPENMP)
+  max_threads_ = omp_get_max_threads();
+#endif
+}
+
+void ThreadCountSelector::Bind(InstState* state, Instruction* inst) {
+  state->bound = true;
+  state->inst = inst;
+  auto target = inst->kernel()->target();
+  state->cpu = target == TARGET(kHost) || target == TARGET(kX86) ||
+               target == TARGET(kARM);
+  auto* op = inst->mutable_op();
+  if (!state->cpu || op->scope() == nullptr) {
+    state->cpu = false;
+    return;
+  }
+  for (auto& name : op->op_info()->input_vars()) {
+    auto* tensor = FindTensor(op->scope(), name);
+    if (tensor != nullptr) state->inputs.push_back(tensor);
+  }
+  for (auto& name : op->op_info()->output_vars()) {
+    auto* tensor = FindTensor(op->scope(), name);
+    if (tensor != nullptr) state->outputs.push_back(tensor);
+  }
+}
+
+int ThreadCountSelector::CostModelThreads(const InstState& state) const {
+  auto* op = state.inst->mutable_op();
+  auto* op_info = op->op_info();
+  const auto& op_type = op_info->Type();
+  auto input_dims = [&](const std::string& param) -> DDim {
+    if (!op_info->HasInput(param) || op_info->Input(param).empty()) {
+      return DDim();
+    }
+    auto* tensor = FindTensor(op->scope(), op_info->Input(param).front());
+    return tensor == nullptr ? DDim() : tensor->dims();
+  };
+  // The multiply-adds of one output element
+  int64_t macs_per_output = 1;
+  auto filter_dims = input_dims("Filter");
+  auto w_dims = input_dims("W");
+  if (filter_dims.size() >= 2 && filter_dims[0] > 0) {
+    // conv2d, depthwise_conv2d, conv2d_transpose, ...
+    macs_per_output = filter_dims.production() / filter_dims[0];
+  } else if (w_dims.size() == 2) {
+    // fc
+    macs_per_output = w_dims[0];
+  } else if (op_type == "mul" || op_type == "matmul" ||
+             op_type == "matmul_v2" || op_type == "bmm") {
+    auto x_dims = input_dims("X");
+    bool trans_x = false;
+    for (auto attr : {"transpose_X", "trans_x"}) {
+      if (op_info->HasAttr(attr)) trans_x = op_info->GetAttr<bool>(attr);
+    }
+    if (x_dims.size() >= 2) {
+      macs_per_output = x_dims[x_dims.size() - (trans_x ? 2 : 1)];
+    }
+  }
+  int64_t outputs = 0;
+  int64_t bytes = 0;
+  for (auto* tensor : state.outputs) {
+    outputs += tensor->dims().production();
+    bytes += TensorBytes(*tensor);
+  }
+  for (auto* tensor : state.inputs) {
+    bytes += TensorBytes(*tensor);
+  }
+  int64_t threads = (std::max)(outputs * macs_per_output / kMacsPerThread,
+                               bytes / kBytesPerThread);
+  return static_cast<int>(
+      (std::max)(int64_t(1), (std::min)(threads, int64_t(max_threads_))));
+}
+
+void ThreadCountSelector::Decide(Choice* choice) {
+  // Prefer the fewest threads close to the fastest, they save CPU time
+  float best_us = *std::min_element(choice->min_us.begin(),
+                                    choice->min_us.end());
+  for (size_t i = 0; i < choice->candidates.size(); i++) {
+    if (choice->min_us[i] <= best_us * kTuneTolerance) {
+      choice->threads = choice->candidates[i];
+      break;
+    }
+  }
+  choice->candidates.clear();
+  choice->min_us.clear();
+}
+
+void ThreadCountSelector::LimitThreads(int threads) {
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool::SetThreadLimit(threads);
+#elif defined(_OPENMP)
+  omp_set_num_threads(threads > 0 ? threads : max_threads_);
+#endif
+}
+
+void ThreadCountSelector::Begin(size_t idx, Instruction* inst) {
+  current_ = nullptr;
+  if (max_threads_ <= 1 || idx >= states_.size()) return;
+  auto* state = &states_[idx];
+  if (!state->bound) Bind(state, inst);
+  if (!state->cpu) return;
+
+  int64_t elements = 0;
+  for (auto* tensor : state->inputs) {
+    elements += tensor->dims().production();
+  }
+  int bucket = 0;
+  for (; elements > 0; elements >>= 1) bucket++;
+  auto* choice = &state->buckets[bucket];
+
+  int threads = max_threads_;
+  if (choice->threads > 0) {
+    threads = choice->threads;
+  } else if (choice->warmed_up) {
+    threads = choice->candidates[choice->candidate];
+  }
+  // Set on every run, also to lift it, so a limit left behind by a run that
+  // threw before End is never inherited.
+  limited_ = threads != max_threads_;
+  LimitThreads(limited_ ? threads : 0);
+  if (choice->threads == 0) {
+    current_ = choice;
+    start_us_ = NowUS();
+  }
+}
+
+void ThreadCountSelector::End(size_t idx) {
+  if (limited_) {
+    LimitThreads(0);
+    limited_ = false;
+  }
+  auto* choice = current_;
+  if (choice == nullptr) return;
+  current_ = nullptr;
+
+  if (!choice->warmed_up) {
+    // The first run at a bucket allocates the outputs, it is not timed
+    choice->warmed_up = true;
+    if (mode_ == lite_api::LITE_THREADS_COST_MODEL) {
+      choice->threads = CostModelThreads(states_[idx]);
+      return;
+    }
+    for (int threads = 1; threads < max_threads_; threads *= 2) {
+      choice->candidates.push_back(threads);
+    }
+    choice->candidates.push_back(max_threads_);
+    choice->min_us.assign(choice->candidates.size(), 0.f);
+    return;
+  }
+
+  float elapsed_us = static_cast<float>(NowUS() - start_us_);
+  auto& min_us = choice->min_us[choice->candidate];
+  min_us = choice->runs == 0 ? elapsed_us : (std::min)(min_us, elapsed_us);
+  if (++choice->runs < kTuneRuns) return;
+  choice->runs = 0;
+  if (++choice->candidate < choice->candidates.size()) return;
+  Decide(choice);
+  VLOG(4) << states_[idx].inst->op()->Type() << " runs on " << choice->threads
+          << " threads";
+}
+
+}  // namespace lite
+}  // namespace paddle
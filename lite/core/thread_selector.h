@@ -0,0 +1,85 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "lite/api/paddle_place.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+// Picks the number of threads every CPU instruction of a RuntimeProgram runs
+// with, see ConfigBase::set_thread_schedule. The inputs of an instruction are
+// bucketed by their total number of elements in powers of two, and every
+// bucket gets its own choice:
+// - cost model: the first run at a bucket uses all of the threads, then the
+//   MACs and bytes of that run decide how many threads the op is worth.
+// - measured: after an untimed first run, 1, 2, 4, ... and all of the threads
+//   are timed in turn, and the fewest threads within 5% of the fastest win.
+// The choice is applied as a limit of the calling thread on the lite thread
+// pool, or on OpenMP when the kernels are built with it.
+class ThreadCountSelector {
+ public:
+  ThreadCountSelector(lite_api::ThreadScheduleMode mode, size_t num_insts);
+
+  // Called around the run of `inst`, the `idx`-th root instruction. End
+  // lifts the limit Begin set on the calling thread.
+  void Begin(size_t idx, Instruction* inst);
+  void End(size_t idx);
+
+ private:
+  struct Choice {
+    // 0 until decided
+    int threads{0};
+    bool warmed_up{false};
+    // The candidates of the measured mode
+    std::vector<int> candidates;
+    size_t candidate{0};
+    int runs{0};
+    std::vector<float> min_us;
+  };
+
+  struct InstState {
+    bool bound{false};
+    // Only the instructions of the CPU targets are scheduled
+    bool cpu{false};
+    Instruction* inst{nullptr};
+    std::vector<const Tensor*> inputs;
+    std::vector<const Tensor*> outputs;
+    std::map<int, Choice> buckets;
+  };
+
+  void Bind(InstState* state, Instruction* inst);
+  int CostModelThreads(const InstState& state) const;
+  void Decide(Choice* choice);
+  void LimitThreads(int threads);
+
+  lite_api::ThreadScheduleMode mode_;
+  int max_threads_{1};
+  std::vector<InstState> states_;
+  // The undecided choice being run and the start of the run
+  Choice* current_{nullptr};
+  int64_t start_us_{0};
+  // Whether Begin limited the threads of the calling thread
+  bool limited_{false};
+};
+
+}  // namespace lite
+}  // namespace paddle
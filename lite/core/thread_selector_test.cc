@@ -0,0 +1,209 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_selector.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/core/thread_pool.h"
+
+namespace paddle {
+namespace lite {
+
+const int kPoolThreads = 4;
+
+TEST(ThreadPool, thread_limit_caps_enqueue) {
+  ThreadPool::Init(kPoolThreads);
+  ASSERT_EQ(ThreadPool::ThreadNum(), kPoolThreads);
+  for (int limit : {1, 2, 3, 0}) {
+    ThreadPool::SetThreadLimit(limit);
+    const int active = limit > 0 ? limit : kPoolThreads;
+    EXPECT_EQ(ThreadPool::ActiveThreadNum(), active);
+    // Fewer and more tasks than threads
+    for (int work_size : {2, 3, 10}) {
+      std::vector<std::atomic<int>> runs(work_size);
+      std::vector<std::atomic<int>> runs_common(work_size);
+      for (int i = 0; i < work_size; i++) {
+        runs[i] = 0;
+        runs_common[i] = 0;
+      }
+      std::atomic<int> max_tid{0};
+      auto record_tid = [&](int tid) {
+        int prev = max_tid;
+        while (tid > prev && !max_tid.compare_exchange_weak(prev, tid)) {
+        }
+      };
+      ThreadPool::Enqueue({[&](int index, int tid) {
+                             runs[index]++;
+                             record_tid(tid);
+                           },
+                           work_size});
+      ThreadPool::Enqueue(std::make_tuple(
+          [&](int index, int tid) {
+            runs_common[index]++;
+            record_tid(tid);
+          },
+          work_size,
+          0,
+          1));
+      for (int i = 0; i < work_size; i++) {
+        EXPECT_EQ(runs[i], 1) << "limit " << limit << " index " << i;
+        EXPECT_EQ(runs_common[i], 1) << "limit " << limit << " index " << i;
+      }
+      EXPECT_LT(max_tid, active) << "limit " << limit;
+    }
+  }
+  ThreadPool::SetThreadLimit(0);
+}
+
+#ifdef LITE_USE_THREAD_POOL
+// Records the number of threads the lite thread pool would run it on
+class ThreadCountKernel : public KernelLite<TARGET(kHost), PRECISION(kAny)> {
+ public:
+  explicit ThreadCountKernel(int* threads) : threads_(threads) {}
+
+  void Run() override { *threads_ = ThreadPool::ActiveThreadNum(); }
+
+ private:
+  int* threads_;
+};
+
+// Runs x -> relu -> y with `x` of `dims` under `selector` and returns the
+// number of threads it ran on.
+int RunWithSelector(ThreadCountSelector* selector,
+                    Instruction* inst,
+                    Scope* scope,
+                    const DDim& dims,
+                    const int* threads) {
+  auto* x = scope->FindVar("x")->GetMutable<Tensor>();
+  x->Resize(dims);
+  x->mutable_data<float>();
+  selector->Begin(0, inst);
+  inst->Run();
+  selector->End(0);
+  // The limit only lasts for the run of the instruction
+  EXPECT_EQ(ThreadPool::ActiveThreadNum(), kPoolThreads);
+  return *threads;
+}
+
+// x -> relu -> y in `scope`, whose kernel records its threads in `threads`
+std::unique_ptr<Instruction> MakeReluInstruction(Scope* scope, int* threads) {
+  scope->Var("x")->GetMutable<Tensor>();
+  scope->Var("y")->GetMutable<Tensor>();
+  cpp::OpDesc desc;
+  desc.SetType("relu");
+  desc.SetInput("X", {"x"});
+  desc.SetOutput("Out", {"y"});
+  auto op = LiteOpRegistry::Global().Create("relu");
+  CHECK(op);
+  op->Attach(desc, scope);
+  std::unique_ptr<KernelBase> kernel(new ThreadCountKernel(threads));
+  return std::unique_ptr<Instruction>(
+      new Instruction(std::move(op), std::move(kernel)));
+}
+
+TEST(ThreadCountSelector, settle_per_bucket) {
+  ThreadPool::Init(kPoolThreads);
+  ASSERT_EQ(ThreadPool::ThreadNum(), kPoolThreads);
+  // The inputs of 4 and 1M elements are in different buckets
+  const DDim small_dims({1, 4});
+  const DDim large_dims({1, 1 << 20});
+  for (auto mode :
+       {lite_api::LITE_THREADS_COST_MODEL, lite_api::LITE_THREADS_MEASURED}) {
+    Scope scope;
+    int threads = 0;
+    auto inst_ptr = MakeReluInstruction(&scope, &threads);
+    auto& inst = *inst_ptr;
+    ThreadCountSelector selector(mode, 1);
+
+    // The first run of a bucket uses all of the threads, the cost model
+    // decides after it and the measured mode tries 1, 2 and 4 threads for 3
+    // runs each.
+    const int tune_runs =
+        mode == lite_api::LITE_THREADS_COST_MODEL ? 1 : 1 + 3 * 3;
+    EXPECT_EQ(RunWithSelector(&selector, &inst, &scope, small_dims, &threads),
+              kPoolThreads);
+    for (int i = 1; i < tune_runs; i++) {
+      RunWithSelector(&selector, &inst, &scope, small_dims, &threads);
+    }
+    int small_threads =
+        RunWithSelector(&selector, &inst, &scope, small_dims, &threads);
+    EXPECT_GE(small_threads, 1);
+    EXPECT_LE(small_threads, kPoolThreads);
+    if (mode == lite_api::LITE_THREADS_COST_MODEL) {
+      // 32 bytes are not worth a second thread
+      EXPECT_EQ(small_threads, 1);
+    }
+
+    // A new bucket is scheduled on its own
+    EXPECT_EQ(RunWithSelector(&selector, &inst, &scope, large_dims, &threads),
+              kPoolThreads);
+    for (int i = 1; i < tune_runs; i++) {
+      RunWithSelector(&selector, &inst, &scope, large_dims, &threads);
+    }
+    int large_threads =
+        RunWithSelector(&selector, &inst, &scope, large_dims, &threads);
+    if (mode == lite_api::LITE_THREADS_COST_MODEL) {
+      // 8M bytes are worth all of the threads
+      EXPECT_EQ(large_threads, kPoolThreads);
+    }
+
+    // Both choices stay settled
+    for (int i = 0; i < 3; i++) {
+      EXPECT_EQ(RunWithSelector(&selector, &inst, &scope, small_dims, &threads),
+                small_threads);
+      EXPECT_EQ(RunWithSelector(&selector, &inst, &scope, large_dims, &threads),
+                large_threads);
+    }
+  }
+}
+
+// A run that threw between Begin and End leaves its limit on the thread, the
+// next run must not inherit it.
+TEST(ThreadCountSelector, lift_stale_limit) {
+  ThreadPool::Init(kPoolThreads);
+  ASSERT_EQ(ThreadPool::ThreadNum(), kPoolThreads);
+  Scope scope;
+  int threads = 0;
+  auto inst_ptr = MakeReluInstruction(&scope, &threads);
+  auto& inst = *inst_ptr;
+  ThreadCountSelector selector(lite_api::LITE_THREADS_COST_MODEL, 1);
+  const DDim small_dims({1, 4});
+  const DDim large_dims({1, 1 << 20});
+  // Settles on a single thread for the small bucket
+  RunWithSelector(&selector, &inst, &scope, small_dims, &threads);
+  ASSERT_EQ(RunWithSelector(&selector, &inst, &scope, small_dims, &threads),
+            1);
+  auto* x = scope.FindVar("x")->GetMutable<Tensor>();
+  x->Resize(small_dims);
+  selector.Begin(0, &inst);
+  inst.Run();
+  EXPECT_EQ(ThreadPool::ActiveThreadNum(), 1);
+  // End is skipped, the next run at a new bucket uses all of the threads
+  EXPECT_EQ(RunWithSelector(&selector, &inst, &scope, large_dims, &threads),
+            kPoolThreads);
+  ThreadPool::SetThreadLimit(0);
+}
+#endif  // LITE_USE_THREAD_POOL
+
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(relu);
@@ -0,0 +1,77 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/expand_batch_size_like_compute.h"
+#include <string.h>
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+void ExpandBatchSizeLikeCompute::Run() {
+  auto& param = Param<operators::ExpandBatchSizeLikeParam>();
+  const auto* x = param.x;
+  auto* out = param.out;
+  const auto x_dims = x->dims();
+  const int axis = param.output_dim_idx;
+  const int64_t batch_size = out->dims()[axis];
+  if (x_dims[axis] == batch_size) {
+    // Nothing to broadcast, e.g. the request was fed with the full batch
+    out->ShareDataWith(*x);
+    return;
+  }
+  // Copy the bytes of one slice `batch_size` times, so any precision works
+  const size_t elem_size = PrecisionTypeLength(x->precision());
+  const int64_t outer = x_dims.count(0, axis);
+  const size_t slice_size =
+      x_dims.count(axis + 1, x_dims.size()) * elem_size;
+  auto out_dims = out->dims();
+  out->set_precision(x->precision());
+  auto* dst = static_cast<char*>(
+      out->mutable_data(TARGET(kHost), out_dims.production() * elem_size));
+  const char* src = static_cast<const char*>(x->raw_data());
+  for (int64_t i = 0; i < outer; i++) {
+    for (int64_t j = 0; j < batch_size; j++) {
+      memcpy(dst, src, slice_size);
+      dst += slice_size;
+    }
+    src += slice_size;
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(expand_batch_size_like,
+                     kHost,
+                     kAny,
+                     kAny,
+                     paddle::lite::kernels::host::ExpandBatchSizeLikeCompute,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kHost),
+                                      PRECISION(kAny),
+                                      DATALAYOUT(kAny))})
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kHost),
+                                      PRECISION(kAny),
+                                      DATALAYOUT(kAny))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kHost),
+                                       PRECISION(kAny),
+                                       DATALAYOUT(kAny))})
+    .Finalize();
@@ -15,11 +15,16 @@
 #include "lite/kernels/nnadapter/engine.h"
 #include <sys/time.h>
 #include <time.h>
+#include <cstring>
 #include <functional>
+#include <iomanip>
+#include <limits>
+#include <set>
 #include <utility>
 #include "lite/core/op_registry.h"
 #include "lite/kernels/nnadapter/converter/converter.h"
 #include "lite/utils/env.h"
+#include "lite/utils/hash.h"
 #include "lite/utils/md5.h"
 
 namespace paddle {
@@ -54,6 +59,54 @@ std::string GenerateModelCacheToken(
   return MD5(os.str());
 }
 
+// The weights may be large, so they are hashed a word at a time instead of
+// being copied into a string for MD5
+static size_t HashBytes(const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  size_t hash = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    CombineHash(word, &hash);
+  }
+  for (; i < size; i++) {
+    CombineHash(bytes[i], &hash);
+  }
+  return hash;
+}
+
+static void SerializeAttribute(const cpp::OpDesc* op_desc,
+                               const std::string& name,
+                               std::ostream* os) {
+  switch (op_desc->GetAttrType(name)) {
+#define SERIALIZE_ATTRIBUTE(type, dtype)  \
+  case OpAttrType::type:                  \
+    *os << op_desc->GetAttr<dtype>(name); \
+    break;
+#define SERIALIZE_VECTOR_ATTRIBUTE(type, dtype)        \
+  case OpAttrType::type:                               \
+    for (const auto& value :                           \
+         op_desc->GetAttr<std::vector<dtype>>(name)) { \
+      *os << value << ",";                             \
+    }                                                  \
+    break;
+    SERIALIZE_ATTRIBUTE(INT, int32_t)
+    SERIALIZE_ATTRIBUTE(FLOAT, float)
+    SERIALIZE_ATTRIBUTE(STRING, std::string)
+    SERIALIZE_ATTRIBUTE(BOOLEAN, bool)
+    SERIALIZE_ATTRIBUTE(LONG, int64_t)
+    SERIALIZE_VECTOR_ATTRIBUTE(INTS, int32_t)
+    SERIALIZE_VECTOR_ATTRIBUTE(FLOATS, float)
+    SERIALIZE_VECTOR_ATTRIBUTE(STRINGS, std::string)
+    SERIALIZE_VECTOR_ATTRIBUTE(LONGS, int64_t)
+#undef SERIALIZE_ATTRIBUTE
+#undef SERIALIZE_VECTOR_ATTRIBUTE
+    default:
+      break;
+  }
+}
+
 void* AccessModelInput(void* memory,
                        NNAdapterOperandType* type,
                        void* device_buffer) {
@@ -114,10 +167,14 @@ void* AccessModelOutput(void* memory,
   return tensor->raw_data();
 }
 
-Program::~Program() {
-  if (execution_) {
-    NNAdapterExecution_destroy_invoke(execution_);
+DeviceContext::~DeviceContext() {
+  NNAdapterContext_destroy_invoke(context_);
+  for (auto* device : devices_) {
+    NNAdapterDevice_release_invoke(device);
   }
+}
+
+CompiledProgram::~CompiledProgram() {
   if (compilation_) {
     NNAdapterCompilation_destroy_invoke(compilation_);
   }
@@ -126,7 +183,7 @@ Program::~Program() {
   }
 }
 
-bool Program::LoadFromCache(const std::string& model_cache_token,
+bool CompiledProgram::LoadFromCache(const std::string& model_cache_token,
                             std::vector<char>* model_cache_buffer,
                             const std::string& model_cache_dir) {
   CHECK(!model_cache_token.empty());
@@ -136,7 +193,7 @@ bool Program::LoadFromCache(const std::string& model_cache_token,
                                                   model_cache_buffer->data(),
                                                   model_cache_buffer->size(),
                                                   model_cache_dir.c_str(),
-                                                  context_,
+                                                  device_context_->context_,
                                                   &compilation_);
   if (result != NNADAPTER_NO_ERROR) {
     LOG(WARNING) << "Warning: Failed to create a compilation from the model "
@@ -152,7 +209,7 @@ bool Program::LoadFromCache(const std::string& model_cache_token,
   return true;
 }
 
-bool Program::BuildAndCacheToFile(const cpp::BlockDesc* block_desc,
+bool CompiledProgram::BuildAndCacheToFile(const cpp::BlockDesc* block_desc,
                                   Scope* exec_scope,
                                   const std::vector<Variable>& input_vars,
                                   std::vector<Variable>* output_vars,
@@ -162,7 +219,7 @@ bool Program::BuildAndCacheToFile(const cpp::BlockDesc* block_desc,
   // operations and operands for building NNAdapter model(hardware-indepedent)
   CHECK(!model_cache_token.empty());
   int result = NNAdapterModel_create_invoke(&model_);
-  Converter converter(model_, context_);
+  Converter converter(model_, device_context_->context_);
   if (converter.Apply(block_desc, exec_scope, input_vars, output_vars) !=
       NO_ERROR) {
     return false;
@@ -173,7 +230,7 @@ bool Program::BuildAndCacheToFile(const cpp::BlockDesc* block_desc,
                                               nullptr,
                                               0,
                                               model_cache_dir.c_str(),
-                                              context_,
+                                              device_context_->context_,
                                               &compilation_);
   if (result != NNADAPTER_NO_ERROR) {
     NNAdapterModel_destroy_invoke(model_);
@@ -193,13 +250,45 @@ bool Program::BuildAndCacheToFile(const cpp::BlockDesc* block_desc,
   return true;
 }
 
+void CompiledProgram::Acquire(Program* program) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (owner_) {
+    if (owner_thread_ == std::this_thread::get_id()) {
+      auto owner = owner_;
+      lock.unlock();
+      CHECK_EQ(owner->Wait(), static_cast<int>(NNADAPTER_NO_ERROR))
+          << "Program execute failed.";
+      lock.lock();
+      continue;
+    }
+    cond_.wait(lock);
+  }
+  owner_ = program;
+  owner_thread_ = std::this_thread::get_id();
+}
+
+void CompiledProgram::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  owner_ = nullptr;
+  owner_thread_ = std::thread::id();
+  cond_.notify_all();
+}
+
+Program::~Program() {
+  Wait();
+  if (execution_) {
+    NNAdapterExecution_destroy_invoke(execution_);
+  }
+}
+
 bool Program::SetInputsAndOutputs(std::vector<Variable>* input_vars,
                                   std::vector<Variable>* output_vars) {
   CHECK(IsValid());
   // Query the information of inputs and outputs
   uint32_t input_count, output_count;
+  auto compilation = compiled_program_->compilation_;
   int result = NNAdapterCompilation_queryInputsAndOutputs_invoke(
-      compilation_, &input_count, NULL, &output_count, NULL);
+      compilation, &input_count, NULL, &output_count, NULL);
   if (result != NNADAPTER_NO_ERROR) {
     LOG(FATAL) << "Failed to query the count of inputs and outputs from the "
                   "compilation("
@@ -209,7 +298,7 @@ bool Program::SetInputsAndOutputs(std::vector<Variable>* input_vars,
   CHECK_EQ(input_count, input_vars->size());
   CHECK_EQ(output_count, output_vars->size());
   // Create an execution for executing the compiled device program
-  result = NNAdapterExecution_create_invoke(compilation_, &execution_);
+  result = NNAdapterExecution_create_invoke(compilation, &execution_);
   if (result != NNADAPTER_NO_ERROR) {
     LOG(FATAL) << "Create a execution failed(" << result << ") !";
     return false;
@@ -240,7 +329,9 @@ int Program::Execute() {
     return 1e+6 * time.tv_sec + time.tv_usec;
   };
   auto start_time = GetCurrentUS();
+  compiled_program_->Acquire(this);
   int result = NNAdapterExecution_compute_invoke(execution_);
+  compiled_program_->Release();
   if (result != NNADAPTER_NO_ERROR) {
     LOG(WARNING) << "Warning: Failed to run the execution(" << result << ")!";
     return result;
@@ -249,6 +340,30 @@ int Program::Execute() {
   return NNADAPTER_NO_ERROR;
 }
 
+int Program::ExecuteAsync() {
+  CHECK(IsReady());
+  CHECK(!event_) << "The last execution is still running!";
+  // Released by `Wait`
+  compiled_program_->Acquire(this);
+  int result = NNAdapterExecution_computeAsync_invoke(execution_, &event_);
+  if (result != NNADAPTER_NO_ERROR) {
+    event_ = nullptr;
+    compiled_program_->Release();
+    LOG(WARNING) << "Warning: Failed to start the execution(" << result
+                 << ")!";
+  }
+  return result;
+}
+
+int Program::Wait() {
+  if (!event_) return NNADAPTER_NO_ERROR;
+  int result = NNAdapterEvent_wait_invoke(event_);
+  NNAdapterEvent_destroy_invoke(event_);
+  event_ = nullptr;
+  compiled_program_->Release();
+  return result;
+}
+
 Engine::Engine(KernelContext* ctx,
                const cpp::BlockDesc* block_desc,
                Scope* exec_scope,
@@ -322,21 +437,53 @@ Engine::Engine(KernelContext* ctx,
       context_properties.c_str(),
       ctx->As<NNAdapterContext>().NNAdapterContextCallback(exec_scope_),
       &context_);
+  device_context_ = std::make_shared<DeviceContext>(devices_, context_);
   // Get the model cache dir from the scope
   model_cache_dir_ =
       ctx_->As<NNAdapterContext>().NNAdapterModelCacheDir(exec_scope_);
   VLOG(3) << "NNAdapter model_cache_dir: " << model_cache_dir_;
+  async_execution_ =
+      ctx_->As<NNAdapterContext>().NNAdapterAsyncExecution(exec_scope_);
+  VLOG(3) << "NNAdapter async_execution: " << async_execution_;
 }
 
 Engine::~Engine() {
+  Wait();
+  last_program_.reset();
   programs_.clear();
-  NNAdapterContext_destroy_invoke(context_);
-  for (auto* device : devices_) {
-    NNAdapterDevice_release_invoke(device);
-  }
+  device_context_.reset();
+}
+
+bool Engine::IsPending() const {
+  return last_program_ && last_program_->IsPending();
+}
+
+void Engine::Wait() {
+  if (!IsPending()) return;
+  CHECK_EQ(last_program_->Wait(), static_cast<int>(NNADAPTER_NO_ERROR))
+      << "Program execute failed.";
 }
 
 bool Engine::Run() {
+  Wait();
+  // The input shapes are only checked by the synchronous execution, so the
+  // program is launched asynchronously if the shapes are the same as the ones
+  // of the last successful run.
+  bool same_input_dims =
+      last_program_ && last_input_dims_.size() == input_vars_.size();
+  for (size_t i = 0; same_input_dims && i < input_vars_.size(); i++) {
+    same_input_dims = last_input_dims_[i] == input_vars_[i].value->dims();
+  }
+  if (async_execution_ && same_input_dims) {
+    CHECK_EQ(last_program_->ExecuteAsync(),
+             static_cast<int>(NNADAPTER_NO_ERROR))
+        << "Program execute failed.";
+    return true;
+  }
+  last_input_dims_.resize(input_vars_.size());
+  for (size_t i = 0; i < input_vars_.size(); i++) {
+    last_input_dims_[i] = input_vars_[i].value->dims();
+  }
   // Try to execute all cached programs.
   for (auto program : programs_) {
     int ret = program->Execute();
@@ -348,46 +495,157 @@ bool Engine::Run() {
     }
     CHECK_EQ(ret, static_cast<int>(NNADAPTER_NO_ERROR))
         << "Program execute failed.";
+    last_program_ = program;
     return true;
   }
   // Rebuild the device program corresponding to the input dimensions if not
   // find valid program.
   VLOG(1) << "Warning: No suitable program found for current input shapes, try "
              "generating a new program online.";
+  auto program = std::make_shared<Program>(GetCompiledProgram());
+  CHECK(program->IsValid());
+  CHECK(program->SetInputsAndOutputs(&input_vars_, &output_vars_));
+  programs_.push_back(program);
+  int ret = program->Execute();
+  CHECK_EQ(ret, static_cast<int>(NNADAPTER_NO_ERROR))
+      << "Program execute failed.";
+  last_program_ = program;
+  return true;
+}
+
+std::string Engine::GenerateSubgraphKey() {
+  std::ostringstream os;
+  os << std::setprecision(std::numeric_limits<float>::max_digits10);
+  std::set<std::string> input_names;
+  for (const auto& input_var : input_vars_) {
+    input_names.insert(input_var.name);
+  }
+  std::set<std::string> produced_names;
+  auto op_count = block_desc_->OpsSize();
+  for (size_t i = 0; i < op_count; i++) {
+    auto op_desc = block_desc_->GetOp<cpp::OpDesc>(i);
+    os << op_desc->Type() << ";";
+    for (const auto& input : op_desc->inputs()) {
+      os << input.first << ":";
+      for (const auto& name : input.second) {
+        os << name << ",";
+      }
+    }
+    for (const auto& output : op_desc->outputs()) {
+      os << output.first << ":";
+      for (const auto& name : output.second) {
+        os << name << ",";
+        produced_names.insert(name);
+      }
+    }
+    for (const auto& attr_name : op_desc->AttrNames()) {
+      os << attr_name << "=";
+      SerializeAttribute(op_desc, attr_name, &os);
+      os << ";";
+    }
+  }
+  // The weights are the variables which are neither the inputs of the
+  // subgraph nor produced by its operators
+  std::set<std::string> weight_names;
+  for (size_t i = 0; i < op_count; i++) {
+    auto op_desc = block_desc_->GetOp<cpp::OpDesc>(i);
+    for (const auto& input : op_desc->inputs()) {
+      for (const auto& name : input.second) {
+        if (input_names.count(name) || produced_names.count(name)) continue;
+        weight_names.insert(name);
+      }
+    }
+  }
+  for (const auto& name : weight_names) {
+    auto tensor = exec_scope_->FindTensor(name);
+    if (!tensor || !tensor->IsInitialized()) continue;
+    os << name << tensor->dims() << PrecisionToStr(tensor->precision());
+    auto target = tensor->target();
+    if (target == TARGET(kHost) || target == TARGET(kARM) ||
+        target == TARGET(kX86)) {
+      os << HashBytes(tensor->raw_data(), tensor->memory_size());
+    } else {
+      os << tensor->raw_data();
+    }
+  }
+  os << ctx_->As<NNAdapterContext>().NNAdapterContextProperties(exec_scope_);
+  os << reinterpret_cast<void*>(
+      ctx_->As<NNAdapterContext>().NNAdapterContextCallback(exec_scope_));
+  return MD5(os.str());
+}
+
+std::shared_ptr<CompiledProgram> Engine::GetCompiledProgram() {
   std::vector<std::string> device_names;
   for (auto* device : devices_) {
     const char* name = nullptr;
     NNAdapterDevice_getName_invoke(device, &name);
     device_names.push_back(name);
   }
-  auto program = std::make_shared<Program>(context_);
-  // Take the model cache buffer from the scope
-  std::vector<char> model_cache_buffer;
   // Generate a cache token based on the input names and shapes
   auto model_cache_token = GenerateModelCacheToken(device_names, input_vars_);
   VLOG(3) << "NNAdapter model_cache_token: " << model_cache_token;
-  ctx_->As<NNAdapterContext>().NNAdapterModelCacheBuffers(
-      exec_scope_, model_cache_token, &model_cache_buffer);
-  VLOG(3) << "NNAdapter model_cache_buffer size: " << model_cache_buffer.size();
-  // Load the compiled device program from the model cache buffer or file
-  if (!program->LoadFromCache(
-          model_cache_token, &model_cache_buffer, model_cache_dir_)) {
-    // Compile the model online to generate the device program and cache it to
-    // the file
-    CHECK(program->BuildAndCacheToFile(block_desc_,
-                                       exec_scope_,
-                                       input_vars_,
-                                       &output_vars_,
-                                       model_cache_token,
-                                       model_cache_dir_));
+  auto build = [&]() -> std::shared_ptr<NNAdapterCompiledProgram> {
+    auto compiled_program = std::make_shared<CompiledProgram>(device_context_);
+    // Take the model cache buffer from the scope
+    std::vector<char> model_cache_buffer;
+    ctx_->As<NNAdapterContext>().NNAdapterModelCacheBuffers(
+        exec_scope_, model_cache_token, &model_cache_buffer);
+    VLOG(3) << "NNAdapter model_cache_buffer size: "
+            << model_cache_buffer.size();
+    auto output_vars = output_vars_;
+    // Load the compiled device program from the model cache buffer or file
+    if (!compiled_program->LoadFromCache(
+            model_cache_token, &model_cache_buffer, model_cache_dir_)) {
+      // Compile the model online to generate the device program and cache it
+      // to the file
+      CHECK(compiled_program->BuildAndCacheToFile(block_desc_,
+                                                  exec_scope_,
+                                                  input_vars_,
+                                                  &output_vars,
+                                                  model_cache_token,
+                                                  model_cache_dir_));
+    }
+    for (const auto& output_var : output_vars) {
+      compiled_program->output_names_.push_back(output_var.name);
+    }
+    return compiled_program;
+  };
+  // The compiled programs are shared between the predictors by the keys of
+  // the subgraph, its weights, the input shapes and types, the devices and
+  // the context properties
+  std::shared_ptr<NNAdapterCompiledProgram> compiled_program;
+  auto& program_cache = NNAdapterProgramCache::Global();
+  if (program_cache.Capacity() > 0) {
+    if (subgraph_key_.empty()) {
+      subgraph_key_ = GenerateSubgraphKey();
+    }
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<float>::max_digits10);
+    os << subgraph_key_ << model_cache_token;
+    for (const auto& input_var : input_vars_) {
+      os << PrecisionToStr(input_var.value->precision())
+         << input_var.quant_scale << input_var.quant_zero_point;
+    }
+    compiled_program = program_cache.Get(MD5(os.str()), build);
+  } else {
+    compiled_program = build();
   }
-  CHECK(program->IsValid());
-  CHECK(program->SetInputsAndOutputs(&input_vars_, &output_vars_));
-  programs_.push_back(program);
-  int ret = program->Execute();
-  CHECK_EQ(ret, static_cast<int>(NNADAPTER_NO_ERROR))
-      << "Program execute failed.";
-  return true;
+  CHECK(compiled_program) << "Failed to compile the device program.";
+  auto result = std::static_pointer_cast<CompiledProgram>(compiled_program);
+  // Drop the output variables which are useless for the converter, such as
+  // 'XShape' in reshape2 and transpose2
+  if (result->output_names_.size() != output_vars_.size()) {
+    std::vector<Variable> valid_output_vars;
+    for (const auto& name : result->output_names_) {
+      for (const auto& output_var : output_vars_) {
+        if (output_var.name != name) continue;
+        valid_output_vars.push_back(output_var);
+        break;
+      }
+    }
+    output_vars_ = valid_output_vars;
+  }
+  return result;
 }
 
 }  // namespace nnadapter
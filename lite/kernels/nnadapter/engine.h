@@ -14,12 +14,16 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 #include "lite/backends/nnadapter/nnadapter_wrapper.h"
+#include "lite/backends/nnadapter/program_cache.h"
 #include "lite/core/program.h"
 
 namespace paddle {
@@ -35,10 +39,31 @@ typedef struct {
   int32_t quant_zero_point{0};
 } Variable;
 
-class Program {
+// The devices and the context which the programs are compiled with, they are
+// shared with the compiled programs because the programs may outlive the
+// engine in the program cache
+class DeviceContext {
  public:
-  explicit Program(::NNAdapterContext* context) : context_(context) {}
-  ~Program();
+  DeviceContext(const std::vector<NNAdapterDevice*>& devices,
+                ::NNAdapterContext* context)
+      : devices_(devices), context_(context) {}
+  ~DeviceContext();
+
+ public:
+  std::vector<NNAdapterDevice*> devices_;
+  ::NNAdapterContext* context_{nullptr};
+};
+
+class Program;
+
+// A compiled device program, it's shared by the engines of all of the
+// predictors in the process through NNAdapterProgramCache and each of them
+// creates its own execution
+class CompiledProgram : public NNAdapterCompiledProgram {
+ public:
+  explicit CompiledProgram(std::shared_ptr<DeviceContext> device_context)
+      : device_context_(device_context) {}
+  ~CompiledProgram();
   // Load the compiled device program from buffer or file
   bool LoadFromCache(const std::string& model_cache_token,
                      std::vector<char>* model_cache_buffer,
@@ -51,19 +76,48 @@ class Program {
                            std::vector<Variable>* output_vars,
                            const std::string& model_cache_token,
                            const std::string& model_cache_dir);
+  bool IsValid() { return compilation_ != nullptr; }
+  // The device programs of the drivers are stateful, so only one execution
+  // can run at a time. If the running one was launched asynchronously by the
+  // calling thread, it's waited here instead of deadlocking.
+  void Acquire(Program* program);
+  void Release();
+
+ public:
+  NNAdapterModel* model_{nullptr};
+  NNAdapterCompilation* compilation_{nullptr};
+  std::shared_ptr<DeviceContext> device_context_;
+  // The names of the output variables which are kept by the converter
+  std::vector<std::string> output_names_;
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  Program* owner_{nullptr};
+  std::thread::id owner_thread_;
+};
+
+class Program {
+ public:
+  explicit Program(std::shared_ptr<CompiledProgram> compiled_program)
+      : compiled_program_(compiled_program) {}
+  ~Program();
   // Create an execution, set the model input and output variables and the
   // functions to access them
   bool SetInputsAndOutputs(std::vector<Variable>* input_vars,
                            std::vector<Variable>* output_vars);
   int Execute();
-  bool IsValid() { return context_ && compilation_; }
+  // Start the execution without waiting for it, `Wait` returns its result
+  int ExecuteAsync();
+  int Wait();
+  bool IsPending() const { return event_ != nullptr; }
+  bool IsValid() { return compiled_program_ && compiled_program_->IsValid(); }
   bool IsReady() { return IsValid() && execution_; }
 
  public:
-  NNAdapterModel* model_{nullptr};
-  NNAdapterCompilation* compilation_{nullptr};
+  std::shared_ptr<CompiledProgram> compiled_program_;
   NNAdapterExecution* execution_{nullptr};
-  ::NNAdapterContext* context_{nullptr};
+  NNAdapterEvent* event_{nullptr};
 };
 
 class Engine {
@@ -77,8 +131,18 @@ class Engine {
          const std::vector<float>& output_scales);
   ~Engine();
   bool Run();
+  // Whether the device is still running the last asynchronous execution
+  bool IsPending() const;
+  void Wait();
 
  private:
+  // Hash the operators and the weights of the subgraph, the context
+  // properties and the callback for the keys of the program cache
+  std::string GenerateSubgraphKey();
+  // Get the compiled program for the current input shapes from the program
+  // cache, or load/build it if it's not cached
+  std::shared_ptr<CompiledProgram> GetCompiledProgram();
+
   KernelContext* ctx_{nullptr};
   const cpp::BlockDesc* block_desc_{nullptr};
   Scope* exec_scope_{nullptr};
@@ -86,8 +150,17 @@ class Engine {
   std::vector<Variable> output_vars_;
   std::vector<NNAdapterDevice*> devices_;
   ::NNAdapterContext* context_{nullptr};
+  std::shared_ptr<DeviceContext> device_context_;
   std::vector<std::shared_ptr<Program>> programs_;
   std::string model_cache_dir_{""};
+  // Once a program has run with the current input shapes, the following runs
+  // with the same shapes are launched asynchronously if it's enabled
+  bool async_execution_{false};
+  std::shared_ptr<Program> last_program_;
+  std::vector<DDim> last_input_dims_;
+  // Identifies the subgraph and its weights in the keys of the program cache,
+  // it's generated at the first time a program is compiled
+  std::string subgraph_key_;
 };
 
 }  // namespace nnadapter
@@ -45,6 +45,14 @@ void SubgraphCompute::Run() {
   engine_->Run();
 }
 
+bool SubgraphCompute::IsPending() const {
+  return engine_ && engine_->IsPending();
+}
+
+void SubgraphCompute::Wait() {
+  if (engine_) engine_->Wait();
+}
+
 }  // namespace nnadapter
 }  // namespace kernels
 }  // namespace lite
@@ -34,6 +34,10 @@ class SubgraphCompute : public KernelLite<TARGET(kNNAdapter),
 
   void Run() override;
 
+  bool IsPending() const override;
+
+  void Wait() override;
+
   virtual ~SubgraphCompute() = default;
 
  private:
@@ -25,6 +25,7 @@
 #include "lite/backends/x86/fluid/eigen.h"
 #include "lite/backends/x86/math/activation.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/quantized_ops.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
@@ -393,6 +394,51 @@ class HardSwishComputeCompute
   virtual ~HardSwishComputeCompute() = default;
 };
 
+// relu, relu6 and hard_swish on int8 input, `OutT` is int8_t or float.
+template <typename OutT>
+class ActivationInt8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::ActivationParam;
+
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::ActivationParam>();
+    switch (param.active_type) {
+      case lite_api::ActivationType::kRelu:
+        act_param_.type = lite::x86::math::Int8ActivationType::kRelu;
+        break;
+      case lite_api::ActivationType::kRelu6:
+        act_param_.type = lite::x86::math::Int8ActivationType::kRelu6;
+        act_param_.threshold = param.threshold;
+        break;
+      case lite_api::ActivationType::kHardSwish:
+        act_param_.type = lite::x86::math::Int8ActivationType::kHardSwish;
+        act_param_.hard_swish_threshold = param.hard_swish_threshold;
+        act_param_.hard_swish_scale = param.hard_swish_scale;
+        act_param_.hard_swish_offset = param.hard_swish_offset;
+        break;
+      default:
+        LOG(FATAL) << "Unsupported int8 activation type "
+                   << lite_api::ActivationTypeToStr(param.active_type);
+    }
+  }
+
+  void Run() override {
+    auto& param = *param_.get_mutable<operators::ActivationParam>();
+    lite::x86::math::int8_activation(param.X->template data<int8_t>(),
+                                     param.Out->template mutable_data<OutT>(),
+                                     param.X->dims().production(),
+                                     param.input_scale,
+                                     param.output_scale,
+                                     act_param_);
+  }
+
+  virtual ~ActivationInt8Compute() = default;
+
+ private:
+  lite::x86::math::Int8ActivationParam act_param_;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,97 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/activation_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static float ActivationRef(lite_api::ActivationType type, float v) {
+  switch (type) {
+    case lite_api::ActivationType::kRelu:
+      return std::max(v, 0.f);
+    case lite_api::ActivationType::kRelu6:
+      return std::min(std::max(v, 0.f), 6.f);
+    case lite_api::ActivationType::kHardSwish:
+      return v * std::min(std::max(v + 3.f, 0.f), 6.f) / 6.f;
+    default:
+      LOG(FATAL) << "Unsupported activation type";
+  }
+  return 0.f;
+}
+
+TEST(activation_x86, int8_run_test) {
+  const float in_scale = 0.05f;
+  lite::Tensor x;
+  x.Resize({2, 3, 5, 7});
+  auto x_data = x.mutable_data<int8_t>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+  }
+
+  for (auto type : {lite_api::ActivationType::kRelu,
+                    lite_api::ActivationType::kRelu6,
+                    lite_api::ActivationType::kHardSwish}) {
+    // The same scale takes the int8 copy path of relu
+    for (float out_scale : {in_scale, 0.03f}) {
+      lite::Tensor out_fp32, out_int8;
+      out_fp32.Resize(x.dims());
+      out_int8.Resize(x.dims());
+      operators::ActivationParam param;
+      param.X = &x;
+      param.active_type = type;
+      param.enable_int8 = true;
+      param.input_scale = in_scale;
+      param.output_scale = out_scale;
+
+      ActivationInt8Compute<float> act_fp32_out;
+      param.Out = &out_fp32;
+      act_fp32_out.SetParam(param);
+      act_fp32_out.PrepareForRun();
+      act_fp32_out.Run();
+      ActivationInt8Compute<int8_t> act_int8_out;
+      param.Out = &out_int8;
+      act_int8_out.SetParam(param);
+      act_int8_out.PrepareForRun();
+      act_int8_out.Run();
+
+      auto out_fp32_data = out_fp32.data<float>();
+      auto out_int8_data = out_int8.data<int8_t>();
+      for (int64_t i = 0; i < x.numel(); i++) {
+        float ref = ActivationRef(type, x_data[i] * in_scale);
+        EXPECT_NEAR(out_fp32_data[i], ref, 1e-4);
+        float expected = std::min(
+            std::max(std::nearbyint(ref / out_scale), -127.f), 127.f);
+        EXPECT_NEAR(out_int8_data[i], expected, 1);
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(relu, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(relu, kX86, kInt8, kNCHW, fp32_out);
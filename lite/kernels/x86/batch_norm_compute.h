@@ -17,6 +17,7 @@
 #include <random>
 #include <string>
 #include "lite/backends/x86/fluid/eigen.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -147,9 +148,13 @@ class BatchNormCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
         EigenArrayMap<T> y_arr(
             param.y->template mutable_data<T>(), sample_size, N * C);
         ConstEigenArrayMap<T> x_arr(x->template data<T>(), sample_size, N * C);
-        for (int nc = 0; nc < N * C; ++nc) {
-          y_arr.col(nc) = x_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
-        }
+        lite::x86::RunParallelFor(
+            0, N * C, [&](int64_t begin, int64_t end) {
+              for (int64_t nc = begin; nc < end; ++nc) {
+                y_arr.col(nc) =
+                    x_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
+              }
+            });
         break;
       }
       default:
@@ -49,3 +49,16 @@ REGISTER_LITE_KERNEL(concat,
                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
     .Finalize();
+
+typedef paddle::lite::kernels::x86::ConcatInt8Compute<int8_t> ConcatInt8_Int8;
+typedef paddle::lite::kernels::x86::ConcatInt8Compute<float> ConcatInt8_Fp32;
+
+REGISTER_LITE_KERNEL(concat, kX86, kInt8, kNCHW, ConcatInt8_Int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(concat, kX86, kInt8, kNCHW, ConcatInt8_Fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
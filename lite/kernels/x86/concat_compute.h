@@ -15,6 +15,7 @@
 
 #include <Eigen/Core>
 #include <vector>
+#include "lite/backends/x86/math/quantized_ops.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -78,6 +79,49 @@ class ConcatCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   virtual ~ConcatCompute() = default;
 };
 
+// Int8 inputs, `OutT` is int8_t or float. Every input is requantized to the
+// output scale while it is copied, inputs already at that scale are copied
+// as is.
+template <typename OutT>
+class ConcatInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::ConcatParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    CHECK(param.axis_tensor == nullptr)
+        << "int8 concat does not support AxisTensor";
+    CHECK_EQ(param.x_input_scales.size(), param.x.size());
+    const auto& x_dims = param.x[0]->dims();
+    int axis = param.axis;
+    if (axis < 0) {
+      axis += static_cast<int>(x_dims.size());
+    }
+
+    auto* out = param.output;
+    OutT* output_data = out->template mutable_data<OutT>();
+    int offset_concat_axis = 0;
+    int num_concat = count(0, axis, x_dims);
+    int concat_input_size = count(axis + 1, x_dims.size(), x_dims);
+    const int top_concat_axis = out->dims()[axis];
+    for (size_t i = 0; i < param.x.size(); ++i) {
+      const int8_t* bottom_data = param.x[i]->template data<int8_t>();
+      const int64_t bottom_concat_axis = param.x[i]->dims()[axis];
+      for (int n = 0; n < num_concat; ++n) {
+        lite::x86::math::int8_requantize(
+            bottom_data + n * bottom_concat_axis * concat_input_size,
+            output_data +
+                (n * top_concat_axis + offset_concat_axis) * concat_input_size,
+            bottom_concat_axis * concat_input_size,
+            param.x_input_scales[i],
+            param.output_scale);
+      }
+      offset_concat_axis += bottom_concat_axis;
+    }
+  }
+  virtual ~ConcatInt8Compute() = default;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
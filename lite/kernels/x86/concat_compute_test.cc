@@ -0,0 +1,95 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/concat_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(concat_x86, int8_run_test) {
+  // The first input is already at the output scale and copied as is
+  const std::vector<float> in_scales{0.05f, 0.02f};
+  const float out_scale = 0.05f;
+  const std::vector<std::vector<int64_t>> in_shapes{{2, 3, 4}, {2, 5, 4}};
+  const int axis = 1;
+  std::vector<lite::Tensor> x(in_shapes.size());
+  std::vector<lite::Tensor*> x_ptrs;
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i].Resize(in_shapes[i]);
+    auto x_data = x[i].mutable_data<int8_t>();
+    for (int64_t j = 0; j < x[i].numel(); j++) {
+      x_data[j] = static_cast<int8_t>((j * (37 + 16 * i)) % 255 - 127);
+    }
+    x_ptrs.push_back(&x[i]);
+  }
+  std::vector<int64_t> out_shape{2, 8, 4};
+
+  // The dequantized inputs concatenated in fp32
+  std::vector<float> ref;
+  for (int n = 0; n < out_shape[0]; n++) {
+    for (size_t i = 0; i < x.size(); i++) {
+      int64_t size = in_shapes[i][axis] * in_shapes[i][2];
+      auto x_data = x[i].data<int8_t>() + n * size;
+      for (int64_t j = 0; j < size; j++) {
+        ref.push_back(x_data[j] * in_scales[i]);
+      }
+    }
+  }
+
+  lite::Tensor out_fp32, out_int8;
+  out_fp32.Resize(out_shape);
+  out_int8.Resize(out_shape);
+  operators::ConcatParam param;
+  param.x = x_ptrs;
+  param.axis = axis;
+  param.enable_int8 = true;
+  param.x_input_scales = in_scales;
+  param.output_scale = out_scale;
+
+  ConcatInt8Compute<float> concat_fp32_out;
+  param.output = &out_fp32;
+  concat_fp32_out.SetParam(param);
+  concat_fp32_out.Run();
+  ConcatInt8Compute<int8_t> concat_int8_out;
+  param.output = &out_int8;
+  concat_int8_out.SetParam(param);
+  concat_int8_out.Run();
+
+  ASSERT_EQ(static_cast<int64_t>(ref.size()), out_fp32.numel());
+  auto out_fp32_data = out_fp32.data<float>();
+  auto out_int8_data = out_int8.data<int8_t>();
+  for (size_t i = 0; i < ref.size(); i++) {
+    EXPECT_NEAR(out_fp32_data[i], ref[i], 1e-5);
+    float expected = std::min(
+        std::max(std::nearbyint(ref[i] / out_scale), -127.f), 127.f);
+    EXPECT_NEAR(out_int8_data[i], expected, 1);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(concat, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(concat, kX86, kInt8, kNCHW, fp32_out);
@@ -15,6 +15,7 @@
 #include "lite/kernels/x86/conv_compute.h"
 #include <utility>
 #include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/backends/x86/math/gemm_half_weight.h"
 #include "lite/kernels/x86/conv_depthwise.h"
 #include "lite/kernels/x86/conv_direct.h"
 
@@ -82,6 +83,17 @@ namespace x86 {
 template <>
 void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   PREPARE_PARAM
+  if (!param.half_weight_type.empty()) {
+    // The filter is stored in fp16/bf16 by x86_half_weight_pass, conv is
+    // compute bound so it's expanded to fp32 once for all the impls below.
+    weights_.Resize(param.filter->dims());
+    lite::x86::math::half_to_float(
+        lite::x86::math::GetHalfType(param.half_weight_type),
+        reinterpret_cast<const uint16_t*>(param.filter->data<int16_t>()),
+        weights_.mutable_data<float>(),
+        param.filter->numel());
+    param.filter = &weights_;
+  }
   //! todo add conv_5x5_depthwise implement
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
   if (kernel_w == 1 && stride_w == 1 && paddings[0] == 0 && kps_equal &&
@@ -0,0 +1,71 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/depthwise_pointwise_conv_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/math/conv_depthwise_pointwise.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace x86_math = paddle::lite::x86::math;
+
+void DepthwisePointwiseConvCompute::Run() {
+  auto& param = Param<param_t>();
+  auto& ctx = ctx_->As<X86Context>();
+  const auto& x_dims = param.x->dims();
+  const auto& out_dims = param.output->dims();
+  if (param.residual) {
+    CHECK_EQ(param.residual->dims(), out_dims)
+        << "The residual of depthwise_pointwise_conv2d must have the shape "
+           "of the output";
+  }
+  const int batch = x_dims[0];
+  const int channels = x_dims[1];
+  const int out_h = out_dims[2];
+  const int out_w = out_dims[3];
+  const int threads = static_cast<int>(lite::x86::GetMaxThreads());
+  const int tile_rows = x86_math::depthwise_pointwise_tile_rows(
+      batch, channels, out_h, out_w, threads);
+  const int64_t tasks =
+      static_cast<int64_t>(batch) * ((out_h + tile_rows - 1) / tile_rows);
+  const int num_buffers =
+      static_cast<int>((std::min)(static_cast<int64_t>(threads), tasks));
+  buffer_.Resize({num_buffers, channels * tile_rows * out_w});
+  x86_math::conv_depthwise_pointwise(
+      param, ctx, tile_rows, buffer_.mutable_data<float>(), num_buffers);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(depthwise_pointwise_conv2d,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::DepthwisePointwiseConvCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("DwFilter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("DwBias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("PwFilter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("PwBias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("ResidualData", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,169 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/depthwise_pointwise_conv_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/backends/x86/math/conv_depthwise_pointwise.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static void FillTensor(lite::Tensor* tensor, int seed) {
+  auto* data = tensor->mutable_data<float>();
+  for (int i = 0; i < tensor->numel(); i++) {
+    data[i] = static_cast<float>((i * 7 + seed) % 17) * 0.125f - 1.f;
+  }
+}
+
+// relu6 on the depthwise output, hard_swish on the 1x1 output
+static void DepthwisePointwiseConvRef(
+    const operators::DepthwisePointwiseConvParam& param, float* out) {
+  const auto& x_dims = param.x->dims();
+  const auto& dw_dims = param.dw_filter->dims();
+  const auto& out_dims = param.output->dims();
+  const int n = x_dims[0], c = x_dims[1], ih = x_dims[2], iw = x_dims[3];
+  const int kh = dw_dims[2], kw = dw_dims[3];
+  const int oc = out_dims[1], oh = out_dims[2], ow = out_dims[3];
+  const float* x = param.x->data<float>();
+  const float* dw = param.dw_filter->data<float>();
+  const float* pw = param.pw_filter->data<float>();
+  std::vector<float> mid(c * oh * ow);
+  for (int b = 0; b < n; b++) {
+    for (int ci = 0; ci < c; ci++) {
+      for (int y = 0; y < oh; y++) {
+        for (int x_ = 0; x_ < ow; x_++) {
+          float sum = param.dw_bias ? param.dw_bias->data<float>()[ci] : 0.f;
+          for (int ky = 0; ky < kh; ky++) {
+            for (int kx = 0; kx < kw; kx++) {
+              int iy = y * param.strides[0] - param.paddings[0] + ky;
+              int ix = x_ * param.strides[1] - param.paddings[2] + kx;
+              if (iy < 0 || iy >= ih || ix < 0 || ix >= iw) continue;
+              sum += x[((b * c + ci) * ih + iy) * iw + ix] *
+                     dw[(ci * kh + ky) * kw + kx];
+            }
+          }
+          mid[(ci * oh + y) * ow + x_] = (std::min)((std::max)(sum, 0.f), 6.f);
+        }
+      }
+    }
+    for (int o = 0; o < oc; o++) {
+      for (int i = 0; i < oh * ow; i++) {
+        float sum = param.pw_bias ? param.pw_bias->data<float>()[o] : 0.f;
+        for (int ci = 0; ci < c; ci++) {
+          sum += pw[o * c + ci] * mid[ci * oh * ow + i];
+        }
+        sum = sum * (std::min)((std::max)(sum + 3.f, 0.f), 6.f) / 6.f;
+        int index = (b * oc + o) * oh * ow + i;
+        if (param.residual) sum += param.residual->data<float>()[index];
+        out[index] = sum;
+      }
+    }
+  }
+}
+
+TEST(depthwise_pointwise_conv2d_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("depthwise_pointwise_conv2d");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(depthwise_pointwise_conv2d_x86, compute) {
+  for (int kernel : {3, 5}) {
+    for (int stride : {1, 2}) {
+      for (bool with_bias : {true, false}) {
+        for (bool with_residual : {true, false}) {
+          const int n = 2, c = 13, h = 17, w = 11, oc = 9;
+          const int pad = kernel / 2;
+          const int oh = (h + 2 * pad - kernel) / stride + 1;
+          const int ow = (w + 2 * pad - kernel) / stride + 1;
+          lite::Tensor x, dw_filter, dw_bias, pw_filter, pw_bias, residual,
+              out;
+          x.Resize({n, c, h, w});
+          dw_filter.Resize({c, 1, kernel, kernel});
+          dw_bias.Resize({c});
+          pw_filter.Resize({oc, c, 1, 1});
+          pw_bias.Resize({oc});
+          residual.Resize({n, oc, oh, ow});
+          out.Resize({n, oc, oh, ow});
+          FillTensor(&x, 0);
+          FillTensor(&dw_filter, 1);
+          FillTensor(&dw_bias, 2);
+          FillTensor(&pw_filter, 3);
+          FillTensor(&pw_bias, 4);
+          FillTensor(&residual, 5);
+
+          operators::DepthwisePointwiseConvParam param;
+          param.x = &x;
+          param.dw_filter = &dw_filter;
+          param.dw_bias = with_bias ? &dw_bias : nullptr;
+          param.pw_filter = &pw_filter;
+          param.pw_bias = with_bias ? &pw_bias : nullptr;
+          param.residual = with_residual ? &residual : nullptr;
+          param.output = &out;
+          param.strides = {stride, stride};
+          param.paddings = {pad, pad, pad, pad};
+          param.dw_activation_param.has_active = true;
+          param.dw_activation_param.active_type =
+              lite_api::ActivationType::kRelu6;
+          param.dw_activation_param.Relu_clipped_coef = 6.f;
+          param.pw_activation_param.has_active = true;
+          param.pw_activation_param.active_type =
+              lite_api::ActivationType::kHardSwish;
+
+          DepthwisePointwiseConvCompute conv;
+          std::unique_ptr<KernelContext> ctx(new KernelContext);
+          ctx->As<X86Context>();
+          conv.SetContext(std::move(ctx));
+          conv.SetParam(param);
+          conv.Run();
+
+          std::vector<float> ref(out.numel());
+          DepthwisePointwiseConvRef(param, ref.data());
+          auto* out_data = out.data<float>();
+          for (int i = 0; i < out.numel(); i++) {
+            EXPECT_NEAR(out_data[i], ref[i], 1e-4);
+          }
+
+          // Several tiles per image, shared by two buffers
+          X86Context x86_ctx;
+          for (int tile_rows : {1, 4}) {
+            std::vector<float> buffer(2 * c * tile_rows * ow);
+            std::fill(out.mutable_data<float>(),
+                      out.mutable_data<float>() + out.numel(),
+                      0.f);
+            lite::x86::math::conv_depthwise_pointwise(
+                param, x86_ctx, tile_rows, buffer.data(), 2);
+            for (int i = 0; i < out.numel(); i++) {
+              EXPECT_NEAR(out_data[i], ref[i], 1e-4);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(depthwise_pointwise_conv2d, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,217 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/elementwise_chain_compute.h"
+#include <algorithm>
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace x86_math = paddle::lite::x86::math;
+
+// Y is broadcast into X like in the elementwise ops: X[i] meets
+// Y[(i / post) % n]. Leading and trailing dims of size 1 in Y are ignored.
+static bool GetChainBroadcast(const DDim& x_dims,
+                              const DDim& y_dims,
+                              int axis,
+                              int64_t* n,
+                              int64_t* post) {
+  const int x_rank = static_cast<int>(x_dims.size());
+  const int y_rank = static_cast<int>(y_dims.size());
+  if (axis == -1) {
+    axis = x_rank - y_rank;
+  }
+  int y_begin = 0;
+  int y_end = y_rank;
+  while (y_begin < y_end && y_dims[y_begin] == 1) {
+    ++y_begin;
+    ++axis;
+  }
+  while (y_end > y_begin && y_dims[y_end - 1] == 1) {
+    --y_end;
+  }
+  *n = 1;
+  *post = 1;
+  if (y_begin == y_end) {
+    return true;
+  }
+  if (axis < 0 || axis + y_end - y_begin > x_rank) {
+    return false;
+  }
+  for (int i = y_begin; i < y_end; ++i) {
+    if (x_dims[axis + i - y_begin] != y_dims[i]) {
+      return false;
+    }
+    *n *= y_dims[i];
+  }
+  for (int i = axis + y_end - y_begin; i < x_rank; ++i) {
+    *post *= x_dims[i];
+  }
+  return true;
+}
+
+// Pads `dims` with 1 to `rank` dims like the elementwise ops: the dims are
+// placed at `axis`, or at the end if axis is -1.
+static std::vector<int64_t> AlignDims(const std::vector<int64_t>& dims,
+                                      int rank,
+                                      int axis) {
+  const int dims_rank = static_cast<int>(dims.size());
+  if (dims_rank == rank) return dims;
+  std::vector<int64_t> aligned(rank, 1);
+  const int offset = axis == -1 ? rank - dims_rank : axis;
+  CHECK(offset >= 0 && offset + dims_rank <= rank);
+  std::copy(dims.begin(), dims.end(), aligned.begin() + offset);
+  return aligned;
+}
+
+// Repeats `src` of `src_dims` along its dims of size 1 into `dst` of
+// `dst_dims`, both of the same rank.
+static void BroadcastTo(const float* src,
+                        const std::vector<int64_t>& src_dims,
+                        const std::vector<int64_t>& dst_dims,
+                        float* dst) {
+  const int rank = static_cast<int>(dst_dims.size());
+  std::vector<int64_t> src_strides(rank, 0);
+  int64_t stride = 1;
+  int64_t num = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    src_strides[i] = src_dims[i] == 1 ? 0 : stride;
+    stride *= src_dims[i];
+    num *= dst_dims[i];
+  }
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t k = 0; k < num; ++k) {
+    int64_t offset = 0;
+    for (int i = 0; i < rank; ++i) {
+      offset += index[i] * src_strides[i];
+    }
+    dst[k] = src[offset];
+    for (int i = rank - 1; i >= 0 && ++index[i] == dst_dims[i]; --i) {
+      index[i] = 0;
+    }
+  }
+}
+
+void ElementwiseChainCompute::PrepareForRun() {
+  auto& param = Param<param_t>();
+  steps_.resize(param.step_types.size());
+  for (size_t k = 0; k < steps_.size(); ++k) {
+    auto& step = steps_[k];
+    CHECK(x86_math::GetChainOpType(param.step_types[k], &step.type))
+        << "Unsupported elementwise chain step: " << param.step_types[k];
+    std::copy(param.step_params.begin() + k * 3,
+              param.step_params.begin() + k * 3 + 3,
+              step.params);
+    step.reversed = param.step_reversed[k] != 0;
+  }
+}
+
+void ElementwiseChainCompute::Run() {
+  auto& param = Param<param_t>();
+  const auto& x_dims = param.X->dims();
+  const float* x = param.X->data<float>();
+  for (size_t k = 0; k < steps_.size(); ++k) {
+    auto& step = steps_[k];
+    if (!x86_math::IsBinaryChainOp(step.type)) continue;
+    const int index = param.step_inputs[k];
+    if (index < 0) {
+      step.operand = x;
+      step.n = x_dims.production();
+      step.post = 1;
+      continue;
+    }
+    const auto* y = param.Y[index];
+    // The fuse pass only saw the shapes of the var descs
+    if (!GetChainBroadcast(
+            x_dims, y->dims(), param.step_axes[k], &step.n, &step.post)) {
+      VLOG(4) << "elementwise_chain: Y[" << index << "] " << y->dims()
+              << " can not be broadcast to X " << x_dims
+              << ", run the steps one by one";
+      RunUnfused();
+      return;
+    }
+    step.operand = y->data<float>();
+  }
+  float* out = param.Out->mutable_data<float>();
+  x86_math::elementwise_chain(x, x_dims.production(), steps_, out);
+}
+
+void ElementwiseChainCompute::RunUnfused() {
+  auto& param = Param<param_t>();
+  std::vector<int64_t> value_dims = param.X->dims().Vectorize();
+  std::vector<float> value(param.X->data<float>(),
+                           param.X->data<float>() + param.X->numel());
+  for (size_t k = 0; k < steps_.size(); ++k) {
+    auto step = steps_[k];
+    if (x86_math::IsBinaryChainOp(step.type)) {
+      const int index = param.step_inputs[k];
+      const auto* y = index < 0 ? param.X : param.Y[index];
+      const int axis = index < 0 ? -1 : param.step_axes[k];
+      // The smaller operand is aligned into the larger one at `axis`, and
+      // both are repeated along their dims of size 1
+      const int rank = std::max(value_dims.size(), y->dims().size());
+      auto value_aligned = AlignDims(value_dims, rank, axis);
+      auto y_aligned = AlignDims(y->dims().Vectorize(), rank, axis);
+      std::vector<int64_t> out_dims(rank);
+      int64_t num = 1;
+      for (int i = 0; i < rank; ++i) {
+        CHECK(value_aligned[i] == y_aligned[i] || value_aligned[i] == 1 ||
+              y_aligned[i] == 1)
+            << "elementwise_chain: step " << k << " can not broadcast "
+            << DDim(value_dims) << " and " << y->dims();
+        out_dims[i] = std::max(value_aligned[i], y_aligned[i]);
+        num *= out_dims[i];
+      }
+      if (value_aligned != out_dims) {
+        std::vector<float> expanded(num);
+        BroadcastTo(value.data(), value_aligned, out_dims, expanded.data());
+        value.swap(expanded);
+      }
+      std::vector<float> expanded_y;
+      step.operand = y->data<float>();
+      if (y_aligned != out_dims) {
+        expanded_y.resize(num);
+        BroadcastTo(step.operand, y_aligned, out_dims, expanded_y.data());
+        step.operand = expanded_y.data();
+      }
+      step.n = num;
+      step.post = 1;
+      value_dims = out_dims;
+      x86_math::elementwise_chain(value.data(), num, {step}, value.data());
+    } else {
+      x86_math::elementwise_chain(
+          value.data(), value.size(), {step}, value.data());
+    }
+  }
+  param.Out->Resize(value_dims);
+  std::copy(value.begin(), value.end(), param.Out->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(elementwise_chain,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::ElementwiseChainCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
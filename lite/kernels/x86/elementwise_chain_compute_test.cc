@@ -0,0 +1,143 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/elementwise_chain_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(elementwise_chain_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("elementwise_chain");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(elementwise_chain_x86, compute) {
+  const int n = 2, c = 19, h = 13, w = 11;
+  lite::Tensor x, channel, residual, out;
+  x.Resize({n, c, h, w});
+  channel.Resize({c});
+  residual.Resize({n, c, h, w});
+  out.Resize({n, c, h, w});
+  auto* x_data = x.mutable_data<float>();
+  auto* channel_data = channel.mutable_data<float>();
+  auto* residual_data = residual.mutable_data<float>();
+  for (int i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 23) * 0.25f - 2.5f;
+    residual_data[i] = static_cast<float>(i % 7) * 0.5f - 1.f;
+  }
+  for (int i = 0; i < c; i++) {
+    channel_data[i] = static_cast<float>(i) * 0.1f - 0.7f;
+  }
+
+  // sigmoid(x) * x * channel[c], residual - value, hard_swish, scale
+  operators::ElementwiseChainParam param;
+  param.X = &x;
+  param.Y = {&channel, &residual};
+  param.Out = &out;
+  param.step_types = {"sigmoid",
+                      "elementwise_mul",
+                      "elementwise_mul",
+                      "elementwise_sub",
+                      "hard_swish",
+                      "scale"};
+  param.step_inputs = {-1, -1, 0, 1, -1, -1};
+  param.step_axes = {-1, -1, 1, -1, -1, -1};
+  param.step_reversed = {0, 0, 0, 1, 0, 0};
+  param.step_params = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                       0.f, 0.f, 0.f, 6.f, 6.f, 3.f, 0.5f, 1.f, 1.f};
+
+  ElementwiseChainCompute kernel;
+  kernel.SetParam(param);
+  kernel.PrepareForRun();
+  kernel.Run();
+
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < x.numel(); i++) {
+    float v = x_data[i];
+    v = v / (1.f + std::exp(-v));
+    v *= channel_data[(i / (h * w)) % c];
+    v = residual_data[i] - v;
+    v = v * std::min(std::max(v + 3.f, 0.f), 6.f) / 6.f;
+    v = v * 0.5f + 1.f;
+    EXPECT_NEAR(out_data[i], v, 1e-5);
+  }
+}
+
+// The var descs had -1 dims, at runtime X is [1, c] and Y is [n, c], so Y no
+// longer broadcasts into X and the steps run one by one.
+TEST(elementwise_chain_x86, unfused_fallback) {
+  const int n = 3, c = 5;
+  lite::Tensor x, y, bias, out;
+  x.Resize({1, c});
+  y.Resize({n, c});
+  bias.Resize({n, 1});
+  out.Resize({1, c});
+  auto* x_data = x.mutable_data<float>();
+  auto* y_data = y.mutable_data<float>();
+  auto* bias_data = bias.mutable_data<float>();
+  for (int i = 0; i < c; i++) {
+    x_data[i] = static_cast<float>(i) * 0.5f - 1.f;
+  }
+  for (int i = 0; i < n * c; i++) {
+    y_data[i] = static_cast<float>(i % 4) * 0.25f - 0.5f;
+  }
+  for (int i = 0; i < n; i++) {
+    bias_data[i] = static_cast<float>(i) - 1.f;
+  }
+
+  // relu(x + y) * x - bias, where bias[n, 1] is repeated along c
+  operators::ElementwiseChainParam param;
+  param.X = &x;
+  param.Y = {&y, &bias};
+  param.Out = &out;
+  param.step_types = {"elementwise_add",
+                      "relu",
+                      "elementwise_mul",
+                      "elementwise_sub"};
+  param.step_inputs = {0, -1, -1, 1};
+  param.step_axes = {-1, -1, -1, -1};
+  param.step_reversed = {0, 0, 0, 0};
+  param.step_params = std::vector<float>(12, 0.f);
+
+  ElementwiseChainCompute kernel;
+  kernel.SetParam(param);
+  kernel.PrepareForRun();
+  kernel.Run();
+
+  ASSERT_EQ(out.dims(), DDim({n, c}));
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < c; j++) {
+      float v = std::max(x_data[j] + y_data[i * c + j], 0.f);
+      v = v * x_data[j] - bias_data[i];
+      EXPECT_NEAR(out_data[i * c + j], v, 1e-5) << i << ", " << j;
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(elementwise_chain, kX86, kFloat, kNCHW, def);
@@ -20,6 +20,7 @@
 #include <vector>
 #include "lite/backends/x86/math/elementwise.h"
 #include "lite/backends/x86/math/elementwise_common_broadcast_config.h"
+#include "lite/backends/x86/math/quantized_ops.h"
 #include "lite/kernels/host/elementwise_op_func.h"
 
 namespace paddle {
@@ -350,6 +351,101 @@ void elementwise_compute_template(paddle::lite::KernelBase* kernel,
     }                                                                         \
   }
 
+template <typename OutT>
+void elementwise_int8_compute(const operators::ElementwiseParam& param,
+                              bool is_mul) {
+  const auto& x_dims = param.X->dims();
+  const auto& y_dims = param.Y->dims();
+  const int8_t* x_data = param.X->template data<int8_t>();
+  const int8_t* y_data = param.Y->template data<int8_t>();
+  OutT* out_data = param.Out->template mutable_data<OutT>();
+  const float x_scale = param.x_input_scale;
+  const float y_scale = param.y_input_scale;
+  const float out_scale = param.output_scale;
+  int axis = param.axis;
+  int pre, n, post;
+
+  if (x_dims == y_dims) {
+    x86_math::int8_elementwise(x_data,
+                               y_data,
+                               out_data,
+                               1,
+                               x_dims.production(),
+                               1,
+                               x_scale,
+                               y_scale,
+                               out_scale,
+                               is_mul);
+  } else if (is_fast_broadcast(x_dims, y_dims, axis, &pre, &n, &post)) {
+    x86_math::int8_elementwise(x_data,
+                               y_data,
+                               out_data,
+                               pre,
+                               n,
+                               post,
+                               x_scale,
+                               y_scale,
+                               out_scale,
+                               is_mul);
+  } else if (axis == -1 &&
+             is_fast_broadcast(y_dims, x_dims, axis, &pre, &n, &post)) {
+    // add and mul are commutative, broadcast x over y instead
+    x86_math::int8_elementwise(y_data,
+                               x_data,
+                               out_data,
+                               pre,
+                               n,
+                               post,
+                               y_scale,
+                               x_scale,
+                               out_scale,
+                               is_mul);
+  } else {
+    const auto& out_dims = param.Out->dims();
+    const int rank = static_cast<int>(out_dims.size());
+    // Aligns an input with the output at `axis` and computes its strides,
+    // which are 0 on the broadcast dimensions.
+    auto broadcast_strides = [&](const DDim& dims) {
+      std::vector<int64_t> extended(rank, 1);
+      int offset = static_cast<int>(dims.size()) == rank
+                       ? 0
+                       : (axis == -1 ? rank - static_cast<int>(dims.size())
+                                     : axis);
+      for (size_t i = 0; i < dims.size(); ++i) {
+        CHECK_LT(offset + static_cast<int>(i), rank);
+        extended[offset + i] = dims[i];
+      }
+      std::vector<int64_t> strides(rank, 0);
+      int64_t stride = 1;
+      for (int i = rank - 1; i >= 0; --i) {
+        strides[i] = extended[i] == 1 ? 0 : stride;
+        stride *= extended[i];
+      }
+      return strides;
+    };
+    x86_math::int8_elementwise_broadcast(x_data,
+                                         y_data,
+                                         out_data,
+                                         out_dims.Vectorize(),
+                                         broadcast_strides(x_dims),
+                                         broadcast_strides(y_dims),
+                                         x_scale,
+                                         y_scale,
+                                         out_scale,
+                                         is_mul);
+  }
+}
+
+template <typename OutT>
+void ElementwiseAddInt8Compute<OutT>::Run() {
+  elementwise_int8_compute<OutT>(Param<operators::ElementwiseParam>(), false);
+}
+
+template <typename OutT>
+void ElementwiseMulInt8Compute<OutT>::Run() {
+  elementwise_int8_compute<OutT>(Param<operators::ElementwiseParam>(), true);
+}
+
 // clang-format off
 ElementwiseOpCompute(Add)
 ElementwiseOpActivationCompute(Add)
@@ -736,3 +832,40 @@ REGISTER_LITE_KERNEL(elementwise_min,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
     .Finalize();
+
+typedef paddle::lite::kernels::x86::ElementwiseAddInt8Compute<int8_t>
+    AddInt8_Int8;
+typedef paddle::lite::kernels::x86::ElementwiseAddInt8Compute<float>
+    AddInt8_Fp32;
+typedef paddle::lite::kernels::x86::ElementwiseMulInt8Compute<int8_t>
+    MulInt8_Int8;
+typedef paddle::lite::kernels::x86::ElementwiseMulInt8Compute<float>
+    MulInt8_Fp32;
+
+REGISTER_LITE_KERNEL(
+    elementwise_add, kX86, kInt8, kNCHW, AddInt8_Int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    elementwise_add, kX86, kInt8, kNCHW, AddInt8_Fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    elementwise_mul, kX86, kInt8, kNCHW, MulInt8_Int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    elementwise_mul, kX86, kInt8, kNCHW, MulInt8_Fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
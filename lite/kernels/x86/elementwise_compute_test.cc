@@ -0,0 +1,139 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/elementwise_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The offset of the element of an input of `dims` which is broadcast to the
+// output element at `out_index`, the input is aligned to the output at
+// `axis` like the elementwise ops do.
+static int64_t BroadcastOffset(const std::vector<int64_t>& out_index,
+                               const std::vector<int64_t>& dims,
+                               int axis) {
+  int rank = static_cast<int>(out_index.size());
+  int start = static_cast<int>(dims.size()) == rank
+                  ? 0
+                  : (axis == -1 ? rank - static_cast<int>(dims.size()) : axis);
+  int64_t offset = 0;
+  for (size_t i = 0; i < dims.size(); i++) {
+    offset = offset * dims[i] + (dims[i] == 1 ? 0 : out_index[start + i]);
+  }
+  return offset;
+}
+
+struct Int8ElementwiseCase {
+  std::vector<int64_t> x_shape;
+  std::vector<int64_t> y_shape;
+  std::vector<int64_t> out_shape;
+  int axis;
+};
+
+TEST(elementwise_x86, int8_run_test) {
+  const float x_scale = 0.05f;
+  const float y_scale = 0.03f;
+  // The same shapes, the fast broadcasts of y and x, and a general one
+  std::vector<Int8ElementwiseCase> cases{
+      {{2, 3, 4, 5}, {2, 3, 4, 5}, {2, 3, 4, 5}, -1},
+      {{2, 3, 4, 5}, {3}, {2, 3, 4, 5}, 1},
+      {{2, 3, 4, 5}, {4, 5}, {2, 3, 4, 5}, -1},
+      {{4, 5}, {2, 3, 4, 5}, {2, 3, 4, 5}, -1},
+      {{2, 1, 4}, {3, 1}, {2, 3, 4}, -1}};
+
+  for (bool is_mul : {false, true}) {
+    const float out_scale = is_mul ? 0.2f : 0.08f;
+    for (auto& c : cases) {
+      lite::Tensor x, y, out_fp32, out_int8;
+      x.Resize(c.x_shape);
+      y.Resize(c.y_shape);
+      auto x_data = x.mutable_data<int8_t>();
+      auto y_data = y.mutable_data<int8_t>();
+      for (int64_t i = 0; i < x.numel(); i++) {
+        x_data[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+      }
+      for (int64_t i = 0; i < y.numel(); i++) {
+        y_data[i] = static_cast<int8_t>((i * 53) % 255 - 127);
+      }
+      out_fp32.Resize(c.out_shape);
+      out_int8.Resize(c.out_shape);
+
+      operators::ElementwiseParam param;
+      param.X = &x;
+      param.Y = &y;
+      param.axis = c.axis;
+      param.enable_int8 = true;
+      param.x_input_scale = x_scale;
+      param.y_input_scale = y_scale;
+      param.output_scale = out_scale;
+      if (is_mul) {
+        ElementwiseMulInt8Compute<float> mul_fp32_out;
+        param.Out = &out_fp32;
+        mul_fp32_out.SetParam(param);
+        mul_fp32_out.Run();
+        ElementwiseMulInt8Compute<int8_t> mul_int8_out;
+        param.Out = &out_int8;
+        mul_int8_out.SetParam(param);
+        mul_int8_out.Run();
+      } else {
+        ElementwiseAddInt8Compute<float> add_fp32_out;
+        param.Out = &out_fp32;
+        add_fp32_out.SetParam(param);
+        add_fp32_out.Run();
+        ElementwiseAddInt8Compute<int8_t> add_int8_out;
+        param.Out = &out_int8;
+        add_int8_out.SetParam(param);
+        add_int8_out.Run();
+      }
+
+      auto out_fp32_data = out_fp32.data<float>();
+      auto out_int8_data = out_int8.data<int8_t>();
+      std::vector<int64_t> out_index(c.out_shape.size(), 0);
+      for (int64_t i = 0; i < out_fp32.numel(); i++) {
+        float xv = x_data[BroadcastOffset(out_index, c.x_shape, c.axis)] *
+                   x_scale;
+        float yv = y_data[BroadcastOffset(out_index, c.y_shape, c.axis)] *
+                   y_scale;
+        float ref = is_mul ? xv * yv : xv + yv;
+        EXPECT_NEAR(out_fp32_data[i], ref, 1e-4);
+        float expected = std::min(
+            std::max(std::nearbyint(ref / out_scale), -127.f), 127.f);
+        EXPECT_NEAR(out_int8_data[i], expected, 1);
+        for (int d = static_cast<int>(out_index.size()) - 1; d >= 0; d--) {
+          if (++out_index[d] < c.out_shape[d]) break;
+          out_index[d] = 0;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(elementwise_add, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(elementwise_add, kX86, kInt8, kNCHW, fp32_out);
+USE_LITE_KERNEL(elementwise_mul, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(elementwise_mul, kX86, kInt8, kNCHW, fp32_out);
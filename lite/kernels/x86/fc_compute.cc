@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/fc_compute.h"
+#include "lite/backends/x86/math/gemm_half_weight.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/math/gemm_skinny.h"
 #include "lite/backends/x86/math/saturate.h"
 
 namespace paddle {
@@ -159,6 +161,79 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   const float* w_data = w->template data<float>();
   float* output_data = output->template mutable_data<float>();
 
+  // The weight is stored in fp16/bf16 by x86_half_weight_pass
+  if (!param.half_weight_type.empty()) {
+    auto half_type = lite::x86::math::GetHalfType(param.half_weight_type);
+    const uint16_t* w_half =
+        reinterpret_cast<const uint16_t*>(w->template data<int16_t>());
+    if (M <= lite::x86::math::kHalfGemmMaxM) {
+      if (packed_w_src_ != w_half) {
+        packed_w_.Resize(
+            {lite::x86::math::skinny_packed_size(w_dims0, w_dims1)});
+        lite::x86::math::pack_skinny_weight(
+            false,
+            w_dims0,
+            w_dims1,
+            w_half,
+            w_dims[1],
+            reinterpret_cast<uint16_t*>(packed_w_.mutable_data<int16_t>()));
+        packed_w_src_ = w_half;
+      }
+      lite::x86::math::gemm_skinny_half(
+          half_type,
+          M,
+          w_dims1,
+          w_dims0,
+          1.f,
+          input_data,
+          w_dims0,
+          reinterpret_cast<const uint16_t*>(packed_w_.data<int16_t>()),
+          bias ? bias->template data<float>() : nullptr,
+          with_relu,
+          output_data,
+          w_dims1);
+      return;
+    }
+    // Large batches are compute bound, expand the weight once and run in
+    // fp32
+    if (w_fp32_src_ != w_half) {
+      w_fp32_.Resize(w_dims);
+      lite::x86::math::half_to_float(
+          half_type, w_half, w_fp32_.mutable_data<float>(), w->numel());
+      w_fp32_src_ = w_half;
+    }
+    w_data = w_fp32_.data<float>();
+  }
+
+  // Small batches on a constant weight are bandwidth bound, stream the
+  // packed weight through the skinny GEMM instead.
+  if (!padding_weights && param.half_weight_type.empty() &&
+      M <= lite::x86::math::kSkinnyGemmMaxM && w->persistable()) {
+    if (packed_w_src_ != w_data) {
+      packed_w_.Resize(
+          {lite::x86::math::skinny_packed_size(w_dims0, w_dims1)});
+      lite::x86::math::pack_skinny_weight(false,
+                                          w_dims0,
+                                          w_dims1,
+                                          w_data,
+                                          w_dims1,
+                                          packed_w_.mutable_data<float>());
+      packed_w_src_ = w_data;
+    }
+    lite::x86::math::gemm_skinny(M,
+                                 w_dims1,
+                                 w_dims0,
+                                 1.f,
+                                 input_data,
+                                 w_dims0,
+                                 packed_w_.data<float>(),
+                                 bias ? bias->template data<float>() : nullptr,
+                                 with_relu,
+                                 output_data,
+                                 w_dims1);
+    return;
+  }
+
   auto& context = ctx_->As<X86Context>();
   FCFunctor<lite::TargetType::kX86, float> fc;
   fc(context,
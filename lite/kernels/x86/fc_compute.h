@@ -38,6 +38,15 @@ class FcCompute : public KernelLite<TARGET(kX86), PType> {
   virtual void Run();
 
   virtual ~FcCompute() = default;
+
+ private:
+  // The weight packed for gemm_skinny or gemm_skinny_half, filled by the
+  // first small-M run.
+  Tensor packed_w_;
+  const void* packed_w_src_{nullptr};
+  // The fp16/bf16 weight expanded to fp32, filled by the first large-M run.
+  Tensor w_fp32_;
+  const void* w_fp32_src_{nullptr};
 };
 
 }  // namespace x86
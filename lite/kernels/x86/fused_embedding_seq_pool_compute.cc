@@ -0,0 +1,66 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void FusedEmbeddingSeqPoolCompute::Run() {
+  auto& param = Param<param_t>();
+  auto table = GetEmbeddingTable(param);
+  const auto& lod = param.Ids->lod().back();
+  int64_t seq_num = static_cast<int64_t>(lod.size()) - 1;
+  float* out = param.Out->mutable_data<float>();
+  lite::x86::math::lookup_table_seq_pool(table,
+                                         param.Ids->data<int64_t>(),
+                                         lod.data(),
+                                         seq_num,
+                                         param.padding_idx,
+                                         param.pool_type == "AVERAGE",
+                                         out);
+
+  // Keep the same output lod as sequence_pool
+  std::vector<uint64_t> offset_new;
+  if (param.Ids->lod().size() == 2) {
+    offset_new = param.Ids->lod()[0];
+  } else {
+    offset_new.resize(seq_num + 1);
+    for (int64_t i = 0; i <= seq_num; i++) {
+      offset_new[i] = i;
+    }
+  }
+  param.Out->mutable_lod()->clear();
+  param.Out->mutable_lod()->push_back(offset_new);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fused_embedding_seq_pool,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::FusedEmbeddingSeqPoolCompute,
+                     def)
+    .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindInput("W_scale", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Ids", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,108 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static void fused_embedding_seq_pool_ref(const float* w,
+                                         int emb_size,
+                                         const int64_t* ids,
+                                         const std::vector<uint64_t>& lod,
+                                         int64_t padding_idx,
+                                         bool average,
+                                         float* out) {
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    for (int j = 0; j < emb_size; j++) {
+      float sum = 0.f;
+      for (uint64_t i = lod[s]; i < lod[s + 1]; i++) {
+        if (ids[i] == padding_idx) continue;
+        sum += w[ids[i] * emb_size + j];
+      }
+      if (average && lod[s + 1] > lod[s]) {
+        sum /= static_cast<float>(lod[s + 1] - lod[s]);
+      }
+      out[s * emb_size + j] = sum;
+    }
+  }
+}
+
+TEST(fused_embedding_seq_pool_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("fused_embedding_seq_pool");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(fused_embedding_seq_pool_x86, compute) {
+  int vocab_size = 50;
+  int emb_size = 19;
+  std::vector<uint64_t> lod{0, 3, 3, 10, 24, 25};
+  int ids_num = static_cast<int>(lod.back());
+  int64_t padding_idx = 7;
+
+  for (std::string pool_type : {"SUM", "AVERAGE"}) {
+    FusedEmbeddingSeqPoolCompute kernel;
+    operators::FusedEmbeddingSeqPoolParam param;
+    lite::Tensor w, ids, out;
+    w.Resize({vocab_size, emb_size});
+    ids.Resize({ids_num, 1});
+    ids.set_lod({lod});
+    out.Resize({static_cast<int64_t>(lod.size()) - 1, emb_size});
+
+    auto* w_data = w.mutable_data<float>();
+    for (int i = 0; i < vocab_size * emb_size; i++) {
+      w_data[i] = static_cast<float>(i % 13) * 0.25f - 1.f;
+    }
+    auto* ids_data = ids.mutable_data<int64_t>();
+    for (int i = 0; i < ids_num; i++) {
+      ids_data[i] = (i * 3) % vocab_size;
+    }
+
+    param.W = &w;
+    param.Ids = &ids;
+    param.Out = &out;
+    param.padding_idx = padding_idx;
+    param.pool_type = pool_type;
+    kernel.SetParam(param);
+    kernel.PrepareForRun();
+    kernel.Run();
+
+    std::vector<float> out_ref(out.numel());
+    fused_embedding_seq_pool_ref(w_data,
+                                 emb_size,
+                                 ids_data,
+                                 lod,
+                                 padding_idx,
+                                 pool_type == "AVERAGE",
+                                 out_ref.data());
+    auto* out_data = out.data<float>();
+    for (int i = 0; i < out.numel(); i++) {
+      EXPECT_NEAR(out_data[i], out_ref[i], 1e-5);
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_embedding_seq_pool, kX86, kFloat, kNCHW, def);
@@ -14,7 +14,7 @@
 #pragma once
 
 #include <vector>
-#include "lite/backends/x86/fluid/eigen.h"
+#include "lite/backends/x86/math/lookup_table.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -23,6 +23,27 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
+// Describes the table of W for the x86 math routines.
+template <typename ParamT>
+lite::x86::math::EmbeddingTable GetEmbeddingTable(const ParamT& param) {
+  lite::x86::math::EmbeddingTable table;
+  const auto& table_dims = param.W->dims();
+  table.row_number = table_dims[0];
+  table.row_width = table_dims[1];
+  table.precision = param.W->precision();
+  if (table.precision != PRECISION(kFP16) &&
+      table.precision != PRECISION(kInt8)) {
+    table.precision = PRECISION(kFloat);
+  }
+  table.data = param.W->raw_data();
+  if (table.precision == PRECISION(kInt8)) {
+    CHECK(param.W_scale) << "Row-wise int8 table requires Input(W_scale).";
+    CHECK_EQ(param.W_scale->numel(), table.row_number);
+    table.row_scales = param.W_scale->template data<float>();
+  }
+  return table;
+}
+
 template <typename T>
 class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -32,28 +53,13 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto &param = *param_.get_mutable<operators::LookupTableParam>();
     auto *ids_t = param.Ids;
     auto *output_t = param.Out;
-    int64_t padding_idx = param.padding_idx;
     const int64_t *ids = ids_t->template data<int64_t>();
     int64_t ids_numel = ids_t->dims().production();
 
-    auto *table_t = param.W;
-    int64_t row_number = table_t->dims()[0];
-    int64_t row_width = table_t->dims()[1];
-
-    const T *table = table_t->template data<T>();
+    auto table = GetEmbeddingTable(param);
     T *output = output_t->template mutable_data<T>();
-    memset(output, 0, output_t->dims().production() * sizeof(T));
-    for (int64_t i = 0; i < ids_numel; ++i) {
-      if (padding_idx != -1 && ids[i] == padding_idx) {
-        memset(output + i * row_width, 0, row_width * sizeof(T));
-      } else {
-        CHECK_LT(ids[i], row_number);
-        CHECK_GE(ids[i], 0);
-        memcpy(output + i * row_width,
-               table + ids[i] * row_width,
-               row_width * sizeof(T));
-      }
-    }
+    lite::x86::math::lookup_table(
+        table, ids, ids_numel, param.padding_idx, output);
   }
 
   virtual ~LookupTableCompute() = default;
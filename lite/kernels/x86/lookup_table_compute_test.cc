@@ -17,6 +17,7 @@
 #include <cmath>
 #include <string>
 #include <vector>
+#include "lite/backends/x86/fluid/float16.h"
 #include "lite/core/op_registry.h"
 
 namespace paddle {
@@ -74,6 +75,96 @@ TEST(lookup_table_x86, compute) {
   }
 }
 
+TEST(lookup_table_x86, int8_row_quant) {
+  LookupTableCompute<float> lookup_table;
+  operators::LookupTableParam param;
+  lite::Tensor w, w_scale, ids, out;
+
+  int vocab_size = 17;
+  int emb_size = 37;
+  int ids_num = 64;
+  int64_t padding_idx = 3;
+
+  w.Resize({vocab_size, emb_size});
+  w_scale.Resize({vocab_size});
+  ids.Resize({ids_num, 1});
+  out.Resize({ids_num, emb_size});
+
+  auto* w_data = w.mutable_data<int8_t>();
+  auto* scale_data = w_scale.mutable_data<float>();
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (int i = 0; i < vocab_size * emb_size; i++) {
+    w_data[i] = static_cast<int8_t>(i % 255 - 127);
+  }
+  for (int i = 0; i < vocab_size; i++) {
+    scale_data[i] = 0.01f * (i + 1);
+  }
+  for (int i = 0; i < ids_num; i++) {
+    ids_data[i] = (i * 7) % vocab_size;
+  }
+
+  param.W = &w;
+  param.W_scale = &w_scale;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = padding_idx;
+  lookup_table.SetParam(param);
+  lookup_table.Run();
+
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < ids_num; i++) {
+    int64_t id = ids_data[i];
+    for (int j = 0; j < emb_size; j++) {
+      float ref = id == padding_idx
+                      ? 0.f
+                      : w_data[id * emb_size + j] * scale_data[id];
+      EXPECT_NEAR(out_data[i * emb_size + j], ref, 1e-5);
+    }
+  }
+}
+
+TEST(lookup_table_x86, fp16_table) {
+  LookupTableCompute<float> lookup_table;
+  operators::LookupTableParam param;
+  lite::Tensor w, ids, out;
+
+  int vocab_size = 11;
+  int emb_size = 21;
+  int ids_num = 30;
+
+  w.Resize({vocab_size, emb_size});
+  ids.Resize({ids_num, 1});
+  out.Resize({ids_num, emb_size});
+
+  auto* w_data = w.mutable_data<int16_t>();
+  w.set_precision(PRECISION(kFP16));
+  std::vector<float> w_ref(vocab_size * emb_size);
+  for (int i = 0; i < vocab_size * emb_size; i++) {
+    lite::fluid::float16 h(static_cast<float>(i % 64) / 8.f);
+    w_data[i] = static_cast<int16_t>(h.x);
+    w_ref[i] = static_cast<float>(h);
+  }
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (int i = 0; i < ids_num; i++) {
+    ids_data[i] = (i * 5) % vocab_size;
+  }
+
+  param.W = &w;
+  param.Ids = &ids;
+  param.Out = &out;
+  lookup_table.SetParam(param);
+  lookup_table.Run();
+
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < ids_num; i++) {
+    for (int j = 0; j < emb_size; j++) {
+      EXPECT_NEAR(out_data[i * emb_size + j],
+                  w_ref[ids_data[i] * emb_size + j],
+                  1e-5);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -14,6 +14,7 @@
 
 #include "lite/kernels/x86/match_matrix_tensor_compute.h"
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
@@ -50,9 +51,9 @@ void MatchMatrixTensorCompute<T>::Run() {
   auto* t_data = w->template data<T>();
   auto* out_data = out->template mutable_data<T>();
   auto* bottom_l_trans_data = tmp->template mutable_data<T>();
-  memset(out_data, 0.0, out->dims()[0] * out->dims()[1] * sizeof(T));
-  memset(bottom_l_trans_data, 0.0, tmp->dims()[0] * tmp->dims()[1] * sizeof(T));
 
+  // Both GEMMs below write every element with beta = 0, `out` and `tmp` are
+  // not cleared first.
   auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
   blas.GEMM(CblasNoTrans,
             CblasNoTrans,
@@ -68,16 +69,22 @@ void MatchMatrixTensorCompute<T>::Run() {
             bottom_l_trans_data,
             dim_t * dim_in);
 
-  for (size_t b = 0; b < x->lod()[0].size() - 1; b++) {
-    for (int t = 0; t < dim_t; t++) {
+  // One small GEMM per (sequence, t) over the packed rows, the groups are
+  // independent and split across threads.
+  const int64_t batch = static_cast<int64_t>(offset_l.size()) - 1;
+  auto match = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      int64_t b = i / dim_t;
+      int t = i % dim_t;
       int len_l = offset_l[b + 1] - offset_l[b];
       int len_r = offset_r[b + 1] - offset_r[b];
+      if (len_l == 0 || len_r == 0) {
+        continue;
+      }
       auto* top_data = out_data + top_offset[b] + t * len_l * len_r;
       const auto* l_t_data =
           bottom_l_trans_data + offset_l[b] * dim_t * dim_in + t * dim_in;
       const auto* r_data = bottom_r_data + offset_r[b] * dim_in;
-
-      auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
       blas.GEMM(CblasNoTrans,
                 CblasTrans,
                 len_l,
@@ -92,7 +99,8 @@ void MatchMatrixTensorCompute<T>::Run() {
                 top_data,
                 len_r);
     }
-  }
+  };
+  lite::x86::RunParallelFor(0, batch * dim_t, match);
 
   int batch_size = x->lod()[0].size() - 1;
   int lod_lv1_size = batch_size * dim_t;
@@ -14,6 +14,8 @@
 #pragma once
 
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_half_weight.h"
+#include "lite/backends/x86/math/gemm_skinny.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -64,10 +66,98 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto mat_dim_b = lite::x86::math::CreateMatrixDescriptor(
         ColumnMatrixFromVector(y->dims()), 0, param.transpose_Y);
     auto scale = static_cast<T>(param.alpha);
+    if (!param.half_weight_type.empty()) {
+      // Y is a 2-D weight stored in fp16/bf16 by x86_half_weight_pass
+      auto half_type = lite::x86::math::GetHalfType(param.half_weight_type);
+      const uint16_t* y_half =
+          reinterpret_cast<const uint16_t*>(y->template data<int16_t>());
+      auto y_dims = y->dims();
+      CHECK_EQ(y_dims.size(), 2UL);
+      const int K = param.transpose_Y ? y_dims[1] : y_dims[0];
+      const int N = param.transpose_Y ? y_dims[0] : y_dims[1];
+      const int M = x->numel() / K;
+      if (!param.transpose_X && M <= lite::x86::math::kHalfGemmMaxM) {
+        if (packed_y_src_ != y_half) {
+          packed_y_.Resize({lite::x86::math::skinny_packed_size(K, N)});
+          lite::x86::math::pack_skinny_weight(
+              param.transpose_Y,
+              K,
+              N,
+              y_half,
+              y_dims[1],
+              reinterpret_cast<uint16_t*>(packed_y_.mutable_data<int16_t>()));
+          packed_y_src_ = y_half;
+        }
+        lite::x86::math::gemm_skinny_half(
+            half_type,
+            M,
+            N,
+            K,
+            param.alpha,
+            x->template data<float>(),
+            K,
+            reinterpret_cast<const uint16_t*>(packed_y_.data<int16_t>()),
+            nullptr,
+            false,
+            out->template mutable_data<float>(),
+            N);
+        return;
+      }
+      // Expanded once, large batches are compute bound
+      if (y_fp32_src_ != y_half) {
+        y_fp32_.Resize(y_dims);
+        lite::x86::math::half_to_float(
+            half_type, y_half, y_fp32_.mutable_data<float>(), y->numel());
+        y_fp32_src_ = y_half;
+      }
+      blas.MatMul(*x, mat_dim_a, y_fp32_, mat_dim_b, scale, out, T(0));
+      return;
+    }
+    if (!param.transpose_X && y->dims().size() == 2 && y->persistable()) {
+      // Small batches on a constant weight are bandwidth bound, stream the
+      // packed weight through the skinny GEMM instead.
+      const int K = param.transpose_Y ? y->dims()[1] : y->dims()[0];
+      const int N = param.transpose_Y ? y->dims()[0] : y->dims()[1];
+      const int M = x->numel() / K;
+      if (M <= lite::x86::math::kSkinnyGemmMaxM) {
+        const float* y_data = y->template data<float>();
+        if (packed_y_src_ != y_data) {
+          packed_y_.Resize({lite::x86::math::skinny_packed_size(K, N)});
+          lite::x86::math::pack_skinny_weight(param.transpose_Y,
+                                              K,
+                                              N,
+                                              y_data,
+                                              y->dims()[1],
+                                              packed_y_.mutable_data<float>());
+          packed_y_src_ = y_data;
+        }
+        lite::x86::math::gemm_skinny(M,
+                                     N,
+                                     K,
+                                     param.alpha,
+                                     x->template data<float>(),
+                                     K,
+                                     packed_y_.data<float>(),
+                                     nullptr,
+                                     false,
+                                     out->template mutable_data<float>(),
+                                     N);
+        return;
+      }
+    }
     blas.MatMul(*x, mat_dim_a, *y, mat_dim_b, scale, out, T(0));
   }
 
   virtual ~MatMulCompute() = default;
+
+ private:
+  // The weight packed for gemm_skinny or gemm_skinny_half, filled by the
+  // first small-M run.
+  Tensor packed_y_;
+  const void* packed_y_src_{nullptr};
+  // The fp16/bf16 weight expanded to fp32, filled by the first large-M run.
+  Tensor y_fp32_;
+  const void* y_fp32_src_{nullptr};
 };
 
 }  // namespace x86
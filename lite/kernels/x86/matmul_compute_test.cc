@@ -14,11 +14,14 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "lite/backends/x86/fluid/float16.h"
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/matmul_compute.h"
 
@@ -80,6 +83,120 @@ TEST(matmul_x86, run_test) {
   }
 }
 
+TEST(matmul_x86, half_weight) {
+  for (std::string half_type : {"fp16", "bf16"}) {
+    // Both the microkernel path and the expanded fp32 path
+    for (int64_t m : {3, 20}) {
+      const int64_t k = 37;
+      const int64_t n = 45;
+      lite::Tensor x, y, out;
+      x.Resize({m, k});
+      y.Resize({k, n});
+      out.Resize({m, n});
+      auto* x_data = x.mutable_data<float>();
+      for (int64_t i = 0; i < x.numel(); i++) {
+        x_data[i] = static_cast<float>(i % 13) / 13.f - 0.5f;
+      }
+      // The 16-bit weight and the fp32 values it represents
+      auto* y_data = reinterpret_cast<uint16_t*>(y.mutable_data<int16_t>());
+      std::vector<float> y_ref(y.numel());
+      for (int64_t i = 0; i < y.numel(); i++) {
+        float value = static_cast<float>(i % 7) / 4.f - 0.75f;
+        if (half_type == "fp16") {
+          fluid::float16 h(value);
+          y_data[i] = h.x;
+          y_ref[i] = static_cast<float>(h);
+        } else {
+          uint32_t bits;
+          memcpy(&bits, &value, sizeof(bits));
+          y_data[i] = static_cast<uint16_t>(bits >> 16);
+          bits = static_cast<uint32_t>(y_data[i]) << 16;
+          memcpy(&y_ref[i], &bits, sizeof(bits));
+        }
+      }
+
+      MatMulCompute<float> matmul;
+      operators::MatMulParam param;
+      param.X = &x;
+      param.Y = &y;
+      param.Out = &out;
+      param.alpha = 0.5f;
+      param.half_weight_type = half_type;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      matmul.SetContext(std::move(ctx));
+      matmul.SetParam(param);
+      // The second run reuses the fp32 weight expanded by the first one
+      for (int run = 0; run < 2; run++) {
+        memset(out.mutable_data<float>(), 0, out.numel() * sizeof(float));
+        matmul.Run();
+
+        auto* out_data = out.data<float>();
+        for (int64_t i = 0; i < m; i++) {
+          for (int64_t j = 0; j < n; j++) {
+            float ref = 0.f;
+            for (int64_t p = 0; p < k; p++) {
+              ref += x_data[i * k + p] * y_ref[p * n + j];
+            }
+            EXPECT_NEAR(out_data[i * n + j], 0.5f * ref, 1e-4);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(matmul_x86, skinny_weight) {
+  for (bool trans_y : {false, true}) {
+    // Both the skinny path and the general path
+    for (int64_t m : {1, 3, 9}) {
+      const int64_t k = 37;
+      const int64_t n = 45;
+      lite::Tensor x, y, out;
+      x.Resize({m, k});
+      y.Resize(trans_y ? std::vector<int64_t>{n, k}
+                       : std::vector<int64_t>{k, n});
+      y.set_persistable(true);
+      out.Resize({m, n});
+      auto* x_data = x.mutable_data<float>();
+      for (int64_t i = 0; i < x.numel(); i++) {
+        x_data[i] = static_cast<float>(i % 13) / 13.f - 0.5f;
+      }
+      auto* y_data = y.mutable_data<float>();
+      for (int64_t i = 0; i < y.numel(); i++) {
+        y_data[i] = static_cast<float>(i % 7) / 4.f - 0.75f;
+      }
+
+      MatMulCompute<float> matmul;
+      operators::MatMulParam param;
+      param.X = &x;
+      param.Y = &y;
+      param.Out = &out;
+      param.alpha = 0.5f;
+      param.transpose_Y = trans_y;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      matmul.SetContext(std::move(ctx));
+      matmul.SetParam(param);
+      // The second run reuses the packed weight
+      for (int repeat = 0; repeat < 2; repeat++) {
+        matmul.Run();
+        auto* out_data = out.data<float>();
+        for (int64_t i = 0; i < m; i++) {
+          for (int64_t j = 0; j < n; j++) {
+            float ref = 0.f;
+            for (int64_t p = 0; p < k; p++) {
+              ref += x_data[i * k + p] *
+                     (trans_y ? y_data[j * k + p] : y_data[p * n + j]);
+            }
+            EXPECT_NEAR(out_data[i * n + j], 0.5f * ref, 1e-4);
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,253 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/matmul_v2_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// Products smaller than this (M * N * K) don't scale over threads inside one
+// GEMM, batches of them are split across threads instead.
+static constexpr int64_t kSmallGemmSize = 1 << 18;
+
+MatMulV2Shape GetMatMulV2Shape(const DDim& x_dims,
+                               const DDim& y_dims,
+                               bool trans_x,
+                               bool trans_y) {
+  std::vector<int64_t> dims_x = x_dims.data();
+  std::vector<int64_t> dims_y = y_dims.data();
+  if (dims_x.size() == 1) {
+    dims_x.insert(dims_x.begin(), 1);
+  }
+  if (dims_y.size() == 1) {
+    dims_y.push_back(1);
+  }
+  const size_t rank_x = dims_x.size();
+  const size_t rank_y = dims_y.size();
+
+  MatMulV2Shape shape;
+  shape.M = trans_x ? dims_x[rank_x - 1] : dims_x[rank_x - 2];
+  shape.K = trans_x ? dims_x[rank_x - 2] : dims_x[rank_x - 1];
+  shape.N = trans_y ? dims_y[rank_y - 2] : dims_y[rank_y - 1];
+  const int64_t k_y = trans_y ? dims_y[rank_y - 1] : dims_y[rank_y - 2];
+  CHECK_EQ(shape.K, k_y) << "matmul_v2: mismatched x_dims(" << x_dims
+                         << ") and y_dims(" << y_dims << ")";
+
+  // Right-align the batch dims of both operands.
+  const size_t rank = std::max(rank_x, rank_y) - 2;
+  std::vector<int64_t> batch_x(rank, 1);
+  std::vector<int64_t> batch_y(rank, 1);
+  std::vector<int64_t> batch_out(rank, 1);
+  std::copy(dims_x.begin(), dims_x.end() - 2, batch_x.end() - (rank_x - 2));
+  std::copy(dims_y.begin(), dims_y.end() - 2, batch_y.end() - (rank_y - 2));
+  for (size_t i = 0; i < rank; ++i) {
+    CHECK(batch_x[i] == batch_y[i] || batch_x[i] == 1 || batch_y[i] == 1)
+        << "matmul_v2: can not broadcast x_dims(" << x_dims << ") and y_dims("
+        << y_dims << ")";
+    batch_out[i] = std::max(batch_x[i], batch_y[i]);
+  }
+
+  // Element strides of every batch dim, broadcast dims don't advance.
+  std::vector<int64_t> stride_x(rank, 0);
+  std::vector<int64_t> stride_y(rank, 0);
+  int64_t size_x = static_cast<int64_t>(shape.M) * shape.K;
+  int64_t size_y = static_cast<int64_t>(shape.K) * shape.N;
+  int64_t batch = 1;
+  for (int i = static_cast<int>(rank) - 1; i >= 0; --i) {
+    stride_x[i] = batch_x[i] == 1 ? 0 : size_x;
+    stride_y[i] = batch_y[i] == 1 ? 0 : size_y;
+    size_x *= batch_x[i];
+    size_y *= batch_y[i];
+    batch *= batch_out[i];
+  }
+  shape.batch = static_cast<int>(batch);
+
+  shape.x_offsets.resize(batch);
+  shape.y_offsets.resize(batch);
+  std::vector<int64_t> index(rank, 0);
+  int64_t offset_x = 0;
+  int64_t offset_y = 0;
+  for (int64_t b = 0; b < batch; ++b) {
+    shape.x_offsets[b] = offset_x;
+    shape.y_offsets[b] = offset_y;
+    for (int i = static_cast<int>(rank) - 1; i >= 0; --i) {
+      offset_x += stride_x[i];
+      offset_y += stride_y[i];
+      if (++index[i] < batch_out[i]) break;
+      offset_x -= stride_x[i] * batch_out[i];
+      offset_y -= stride_y[i] * batch_out[i];
+      index[i] = 0;
+    }
+  }
+
+  if (batch > 1) {
+    shape.x_stride = shape.x_offsets[1];
+    shape.y_stride = shape.y_offsets[1];
+    for (int64_t b = 2; b < batch && shape.uniform_stride; ++b) {
+      shape.uniform_stride = shape.x_offsets[b] == b * shape.x_stride &&
+                             shape.y_offsets[b] == b * shape.y_stride;
+    }
+  }
+  return shape;
+}
+
+template <>
+void MatMulV2Compute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
+  auto& context = ctx_->As<X86Context>();
+  auto& param = Param<param_t>();
+  const bool trans_x = param.transpose_X;
+  const bool trans_y = param.transpose_Y;
+  const auto shape =
+      GetMatMulV2Shape(param.X->dims(), param.Y->dims(), trans_x, trans_y);
+  const float* x_data = param.X->data<float>();
+  const float* y_data = param.Y->data<float>();
+  float* out_data = param.Out->mutable_data<float>();
+
+  const int M = shape.M;
+  const int N = shape.N;
+  const int K = shape.K;
+  const int lda = trans_x ? M : K;
+  const int ldb = trans_y ? K : N;
+  const int64_t out_stride = static_cast<int64_t>(M) * N;
+  auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, float>(context);
+  auto batch_gemm = [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      blas.GEMM(trans_x,
+                trans_y,
+                M,
+                N,
+                K,
+                param.alpha,
+                x_data + shape.x_offsets[b],
+                lda,
+                y_data + shape.y_offsets[b],
+                ldb,
+                0.f,
+                out_data + b * out_stride,
+                N);
+    }
+  };
+
+  const int64_t gemm_size = out_stride * K;
+  if (shape.batch > 1 && (gemm_size < kSmallGemmSize ||
+                          shape.batch >= lite::x86::GetMaxThreads())) {
+    // Enough independent products to keep every thread busy, e.g. the
+    // per-head QK^T and attention x V products of transformers.
+    lite::x86::RunParallelFor(0, shape.batch, batch_gemm);
+  } else if (shape.batch > 1 && shape.uniform_stride) {
+    blas.BatchedGEMM(trans_x ? CblasTrans : CblasNoTrans,
+                     trans_y ? CblasTrans : CblasNoTrans,
+                     M,
+                     N,
+                     K,
+                     param.alpha,
+                     x_data,
+                     y_data,
+                     0.f,
+                     out_data,
+                     shape.batch,
+                     shape.x_stride,
+                     shape.y_stride);
+  } else {
+    batch_gemm(0, shape.batch);
+  }
+}
+
+template <>
+void MatMulV2Compute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
+  auto& param = Param<param_t>();
+  const bool trans_x = param.transpose_X;
+  const bool trans_y = param.transpose_Y;
+  const auto shape =
+      GetMatMulV2Shape(param.X->dims(), param.Y->dims(), trans_x, trans_y);
+  const int8_t* x_data = param.X->data<int8_t>();
+  const int8_t* y_data = param.Y->data<int8_t>();
+  float* out_data = param.Out->mutable_data<float>();
+
+  const int M = shape.M;
+  const int N = shape.N;
+  const int K = shape.K;
+  const auto& weight_scale = param.weight_scale;
+  CHECK(!weight_scale.empty()) << "matmul_v2 int8 requires the Y scale";
+  const bool per_column = weight_scale.size() > 1;
+  if (per_column) {
+    CHECK_EQ(weight_scale.size(), static_cast<size_t>(N))
+        << "weight scale size is not 1 or N, not support yet.";
+  }
+  // out = alpha * input_scale * weight_scale[n] * (x * y), the per-row part
+  // is folded into the requantization of the int8 GEMM.
+  std::vector<float> row_scale(M, param.input_scale * param.alpha);
+  const float col_scale = per_column ? 1.f : weight_scale[0];
+  const int64_t out_stride = static_cast<int64_t>(M) * N;
+  auto batch_gemm = [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const int8_t* x_ptr = x_data + shape.x_offsets[b];
+      float* out_ptr = out_data + b * out_stride;
+      lite::x86::math::generate_gemm_s8u8_x86_kern<float> gemm(
+          trans_x,
+          trans_y,
+          M,
+          N,
+          K,
+          x_ptr,
+          N,
+          row_scale.data(),
+          col_scale,
+          1.f,
+          nullptr,
+          0,
+          1.f);
+      gemm.compute(x_ptr, y_data + shape.y_offsets[b], out_ptr);
+      if (per_column) {
+        for (int m = 0; m < M; ++m) {
+          for (int n = 0; n < N; ++n) {
+            out_ptr[m * N + n] *= weight_scale[n];
+          }
+        }
+      }
+    }
+  };
+  // The int8 GEMM is single threaded, always split the batch.
+  lite::x86::RunParallelFor(0, shape.batch, batch_gemm);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::MatMulV2Compute<PRECISION(kFloat),
+                                                    PRECISION(kFloat)>
+    MatMulV2_f32_f32;
+typedef paddle::lite::kernels::x86::MatMulV2Compute<PRECISION(kInt8),
+                                                    PRECISION(kFloat)>
+    MatMulV2_int8_f32;
+
+REGISTER_LITE_KERNEL(matmul_v2, kX86, kFloat, kNCHW, MatMulV2_f32_f32, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(matmul_v2, kX86, kInt8, kNCHW, MatMulV2_int8_f32, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
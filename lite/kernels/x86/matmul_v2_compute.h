@@ -0,0 +1,65 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/matmul_v2_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/**
+ * The GEMM problem of a matmul_v2: `batch` products of [M, K] x [K, N].
+ * x_offsets[i] / y_offsets[i] are the element offsets of the operands of the
+ * i-th product, broadcast batch dims repeat an offset instead of expanding
+ * the operand in memory.
+ */
+struct MatMulV2Shape {
+  int M{1};
+  int N{1};
+  int K{1};
+  int batch{1};
+  std::vector<int64_t> x_offsets;
+  std::vector<int64_t> y_offsets;
+  // Set if the offsets are arithmetic progressions, a stride of 0 means the
+  // operand is shared by every product.
+  bool uniform_stride{true};
+  int64_t x_stride{0};
+  int64_t y_stride{0};
+};
+
+MatMulV2Shape GetMatMulV2Shape(const DDim& x_dims,
+                               const DDim& y_dims,
+                               bool trans_x,
+                               bool trans_y);
+
+template <PrecisionType PType, PrecisionType OutType>
+class MatMulV2Compute : public KernelLite<TARGET(kX86), PType> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void Run() override;
+
+  virtual ~MatMulV2Compute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
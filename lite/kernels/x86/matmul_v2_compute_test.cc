@@ -0,0 +1,259 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/matmul_compute.h"
+#include "lite/kernels/x86/matmul_v2_compute.h"
+#include "lite/utils/timer.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+typedef MatMulV2Compute<PRECISION(kFloat), PRECISION(kFloat)> MatMulV2Fp32;
+typedef MatMulV2Compute<PRECISION(kInt8), PRECISION(kFloat)> MatMulV2Int8;
+
+// Reference result, out[b] = alpha * op(x[bx]) * op(y[by]) with the batch
+// indices broadcast one dim at a time.
+template <typename T>
+static std::vector<float> matmul_v2_ref(const std::vector<int64_t>& x_shape,
+                                        const T* x,
+                                        const std::vector<int64_t>& y_shape,
+                                        const T* y,
+                                        bool trans_x,
+                                        bool trans_y,
+                                        float alpha) {
+  auto shape = GetMatMulV2Shape(DDim(x_shape), DDim(y_shape), trans_x, trans_y);
+  const int M = shape.M;
+  const int N = shape.N;
+  const int K = shape.K;
+  std::vector<float> out(static_cast<size_t>(shape.batch) * M * N);
+  for (int b = 0; b < shape.batch; ++b) {
+    const T* xb = x + shape.x_offsets[b];
+    const T* yb = y + shape.y_offsets[b];
+    for (int m = 0; m < M; ++m) {
+      for (int n = 0; n < N; ++n) {
+        float sum = 0.f;
+        for (int k = 0; k < K; ++k) {
+          float xv = trans_x ? xb[k * M + m] : xb[m * K + k];
+          float yv = trans_y ? yb[n * K + k] : yb[k * N + n];
+          sum += xv * yv;
+        }
+        out[(b * M + m) * N + n] = alpha * sum;
+      }
+    }
+  }
+  return out;
+}
+
+template <typename KernelT>
+static void run_matmul_v2(KernelT* kernel, operators::MatMulParam* param) {
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel->SetContext(std::move(ctx));
+  kernel->SetParam(*param);
+  kernel->Run();
+}
+
+TEST(matmul_v2_x86, retrive_op) {
+  auto matmul_v2 = KernelRegistry::Global().Create("matmul_v2");
+  ASSERT_FALSE(matmul_v2.empty());
+  ASSERT_TRUE(matmul_v2.front());
+}
+
+TEST(matmul_v2_x86, broadcast_shape) {
+  auto shape = GetMatMulV2Shape(DDim({2, 1, 3, 4}), DDim({3, 4, 5}), 0, 0);
+  EXPECT_EQ(shape.batch, 6);
+  EXPECT_EQ(shape.M, 3);
+  EXPECT_EQ(shape.N, 5);
+  EXPECT_EQ(shape.K, 4);
+  EXPECT_FALSE(shape.uniform_stride);
+  std::vector<int64_t> x_offsets{0, 0, 0, 12, 12, 12};
+  std::vector<int64_t> y_offsets{0, 20, 40, 0, 20, 40};
+  EXPECT_EQ(shape.x_offsets, x_offsets);
+  EXPECT_EQ(shape.y_offsets, y_offsets);
+
+  // A 2-D weight shared by every batch
+  shape = GetMatMulV2Shape(DDim({4, 3, 8}), DDim({8, 5}), 0, 0);
+  EXPECT_EQ(shape.batch, 4);
+  EXPECT_TRUE(shape.uniform_stride);
+  EXPECT_EQ(shape.x_stride, 24);
+  EXPECT_EQ(shape.y_stride, 0);
+}
+
+TEST(matmul_v2_x86, fp32) {
+  struct Case {
+    std::vector<int64_t> x_shape;
+    std::vector<int64_t> y_shape;
+    bool trans_x;
+    bool trans_y;
+  };
+  std::vector<Case> cases{{{2, 3, 4}, {4, 5}, false, false},
+                          {{4}, {2, 4, 5}, false, false},
+                          {{2, 3, 4}, {4}, false, false},
+                          {{7}, {7}, false, false},
+                          {{2, 1, 3, 4}, {3, 4, 5}, false, false},
+                          {{3, 1, 4, 6}, {1, 2, 5, 4}, true, true},
+                          {{2, 3, 6, 4}, {2, 3, 6, 4}, false, true},
+                          {{2, 3, 6, 4}, {2, 3, 6, 5}, true, false},
+                          {{2, 12, 16, 64}, {2, 12, 16, 64}, false, true}};
+  for (auto& c : cases) {
+    lite::Tensor x, y, out;
+    x.Resize(c.x_shape);
+    y.Resize(c.y_shape);
+    auto* x_data = x.mutable_data<float>();
+    auto* y_data = y.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>(i % 11) / 11.f - 0.5f;
+    }
+    for (int64_t i = 0; i < y.numel(); i++) {
+      y_data[i] = static_cast<float>(i % 7) / 7.f - 0.5f;
+    }
+
+    operators::MatMulParam param;
+    param.X = &x;
+    param.Y = &y;
+    param.Out = &out;
+    param.transpose_X = c.trans_x;
+    param.transpose_Y = c.trans_y;
+    param.alpha = 0.5f;
+    auto ref = matmul_v2_ref(
+        c.x_shape, x_data, c.y_shape, y_data, c.trans_x, c.trans_y, 0.5f);
+    out.Resize({static_cast<int64_t>(ref.size())});
+    MatMulV2Fp32 matmul_v2;
+    run_matmul_v2(&matmul_v2, &param);
+
+    auto* out_data = out.data<float>();
+    for (size_t i = 0; i < ref.size(); i++) {
+      EXPECT_NEAR(out_data[i], ref[i], 1e-4) << "x_dims(" << x.dims()
+                                             << ") y_dims(" << y.dims() << ")";
+    }
+  }
+}
+
+TEST(matmul_v2_x86, int8) {
+  for (bool per_column : {false, true}) {
+    for (bool trans_y : {false, true}) {
+      const std::vector<int64_t> x_shape{2, 3, 5, 24};
+      const std::vector<int64_t> y_shape =
+          trans_y ? std::vector<int64_t>{3, 9, 24}
+                  : std::vector<int64_t>{3, 24, 9};
+      const int N = 9;
+      lite::Tensor x, y, out;
+      x.Resize(x_shape);
+      y.Resize(y_shape);
+      auto* x_data = x.mutable_data<int8_t>();
+      auto* y_data = y.mutable_data<int8_t>();
+      // Kept within 7 bits, the u8 x s8 pair sums of the AVX2 GEMM saturate
+      // at int16 otherwise.
+      for (int64_t i = 0; i < x.numel(); i++) {
+        x_data[i] = static_cast<int8_t>(i % 127 - 63);
+      }
+      for (int64_t i = 0; i < y.numel(); i++) {
+        y_data[i] = static_cast<int8_t>((i * 7) % 200 - 100);
+      }
+
+      operators::MatMulParam param;
+      param.X = &x;
+      param.Y = &y;
+      param.Out = &out;
+      param.transpose_Y = trans_y;
+      param.alpha = 2.f;
+      param.input_scale = 0.01f;
+      if (per_column) {
+        for (int n = 0; n < N; n++) {
+          param.weight_scale.push_back(0.001f * (n + 1));
+        }
+      } else {
+        param.weight_scale = {0.002f};
+      }
+      auto acc = matmul_v2_ref(
+          x_shape, x_data, y_shape, y_data, false, trans_y, param.alpha);
+      out.Resize({static_cast<int64_t>(acc.size())});
+      MatMulV2Int8 matmul_v2;
+      run_matmul_v2(&matmul_v2, &param);
+
+      auto* out_data = out.data<float>();
+      for (size_t i = 0; i < acc.size(); i++) {
+        float w_scale = per_column ? param.weight_scale[i % N]
+                                   : param.weight_scale[0];
+        float ref = acc[i] * param.input_scale * w_scale;
+        EXPECT_NEAR(out_data[i], ref, 1e-3 + std::fabs(ref) * 1e-4);
+      }
+    }
+  }
+}
+
+// The attention products of ViT-B/16 (197 tokens) and ERNIE-base (128
+// tokens), 12 heads of 64, compared with the matmul kernel.
+TEST(matmul_v2_x86, attention_benchmark) {
+  const int repeats = 10;
+  for (int64_t seq_len : {197, 128}) {
+    for (bool qk : {true, false}) {
+      std::vector<int64_t> x_shape{1, 12, seq_len, qk ? 64 : seq_len};
+      std::vector<int64_t> y_shape{1, 12, seq_len, 64};
+      lite::Tensor x, y, out;
+      x.Resize(x_shape);
+      y.Resize(y_shape);
+      out.Resize({1, 12, seq_len, qk ? seq_len : 64});
+      auto* x_data = x.mutable_data<float>();
+      auto* y_data = y.mutable_data<float>();
+      for (int64_t i = 0; i < x.numel(); i++) {
+        x_data[i] = static_cast<float>(i % 13) / 13.f;
+      }
+      for (int64_t i = 0; i < y.numel(); i++) {
+        y_data[i] = static_cast<float>(i % 5) / 5.f;
+      }
+      operators::MatMulParam param;
+      param.X = &x;
+      param.Y = &y;
+      param.Out = &out;
+      param.transpose_Y = qk;
+
+      std::string name = string_format("seq_len=%d %s",
+                                       static_cast<int>(seq_len),
+                                       qk ? "QK^T" : "attention x V");
+      Timer v2_timer("matmul_v2 " + name);
+      Timer v1_timer("matmul " + name);
+      MatMulV2Fp32 matmul_v2;
+      MatMulCompute<float> matmul;
+      for (int i = 0; i < repeats; i++) {
+        v2_timer.Start();
+        run_matmul_v2(&matmul_v2, &param);
+        v2_timer.Stop();
+        v1_timer.Start();
+        run_matmul_v2(&matmul, &param);
+        v1_timer.Stop();
+      }
+      v2_timer.Print();
+      v1_timer.Print();
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(matmul_v2, kX86, kFloat, kNCHW, def);
@@ -17,6 +17,7 @@
 #include "lite/backends/x86/fluid/eigen.h"
 #include "lite/backends/x86/math/math_function.h"
 #include "lite/backends/x86/math/pooling.h"
+#include "lite/backends/x86/math/quantized_ops.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -81,6 +82,42 @@ class PoolCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   virtual ~PoolCompute() = default;
 };
 
+// Int8 input, `OutT` is int8_t or float.
+template <typename OutT>
+class PoolInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::PoolParam;
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    const auto& x_dims = param.x->dims();
+    const auto& out_dims = param.output->dims();
+    CHECK_EQ(x_dims.size(), 4UL) << "int8 pool2d only supports 4-D input";
+    CHECK(!param.adaptive) << "int8 pool2d does not support adaptive pooling";
+    CHECK(param.pooling_type == "max" || param.pooling_type == "avg")
+        << "Unsupported pooling type " << param.pooling_type;
+    if (param.global_pooling) {
+      for (size_t i = 0; i < param.ksize.size(); ++i) {
+        param.ksize[i] = static_cast<int>(x_dims[i + 2]);
+      }
+    }
+    lite::x86::math::int8_pool2d(param.x->template data<int8_t>(),
+                                 param.output->template mutable_data<OutT>(),
+                                 out_dims[0] * out_dims[1],
+                                 x_dims[2],
+                                 x_dims[3],
+                                 out_dims[2],
+                                 out_dims[3],
+                                 param.ksize,
+                                 param.strides,
+                                 *param.paddings,
+                                 param.pooling_type == "max",
+                                 param.exclusive,
+                                 param.input_scale,
+                                 param.output_scale);
+  }
+  virtual ~PoolInt8Compute() = default;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -14,8 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -79,9 +82,86 @@ TEST(pool2d_x86, run_test) {
   }
 }
 
+TEST(pool2d_x86, int8_run_test) {
+  const float in_scale = 0.05f;
+  // A width of 40 runs the vector paths, an equal output scale the copy of
+  // the int8 maxima
+  for (auto x_shape : {std::vector<int64_t>{2, 3, 7, 7},
+                       std::vector<int64_t>{1, 2, 9, 40}}) {
+    for (float out_scale : {0.04f, in_scale}) {
+      lite::Tensor x_int8, x_fp32;
+      x_int8.Resize(lite::DDim(x_shape));
+      x_fp32.Resize(lite::DDim(x_shape));
+      auto x_int8_data = x_int8.mutable_data<int8_t>();
+      auto x_fp32_data = x_fp32.mutable_data<float>();
+      for (int64_t i = 0; i < x_int8.dims().production(); i++) {
+        x_int8_data[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+        x_fp32_data[i] = x_int8_data[i] * in_scale;
+      }
+      // 3x3 windows of stride 2 and padding 1
+      std::vector<int64_t> out_shape{x_shape[0],
+                                     x_shape[1],
+                                     (x_shape[2] - 1) / 2 + 1,
+                                     (x_shape[3] - 1) / 2 + 1};
+
+      for (std::string pooling_type : {"max", "avg"}) {
+        for (bool exclusive : {true, false}) {
+          lite::Tensor ref, out_fp32, out_int8;
+          ref.Resize(lite::DDim(out_shape));
+          out_fp32.Resize(lite::DDim(out_shape));
+          out_int8.Resize(lite::DDim(out_shape));
+
+          operators::PoolParam param;
+          param.strides = {2, 2};
+          param.paddings = std::make_shared<std::vector<int>>(
+              std::vector<int>{1, 1, 1, 1});
+          param.ksize = {3, 3};
+          param.pooling_type = pooling_type;
+          param.exclusive = exclusive;
+
+          PoolCompute<float> pool2d;
+          std::unique_ptr<KernelContext> ctx(new KernelContext);
+          ctx->As<X86Context>();
+          pool2d.SetContext(std::move(ctx));
+          param.x = &x_fp32;
+          param.output = &ref;
+          pool2d.SetParam(param);
+          pool2d.Run();
+
+          param.x = &x_int8;
+          param.enable_int8 = true;
+          param.input_scale = in_scale;
+          param.output_scale = out_scale;
+          PoolInt8Compute<float> pool2d_fp32_out;
+          param.output = &out_fp32;
+          pool2d_fp32_out.SetParam(param);
+          pool2d_fp32_out.Run();
+          PoolInt8Compute<int8_t> pool2d_int8_out;
+          param.output = &out_int8;
+          pool2d_int8_out.SetParam(param);
+          pool2d_int8_out.Run();
+
+          auto ref_data = ref.data<float>();
+          auto out_fp32_data = out_fp32.data<float>();
+          auto out_int8_data = out_int8.data<int8_t>();
+          for (int i = 0; i < ref.dims().production(); i++) {
+            EXPECT_NEAR(out_fp32_data[i], ref_data[i], 1e-5);
+            float expected = std::min(
+                std::max(std::nearbyint(ref_data[i] / out_scale), -127.f),
+                127.f);
+            EXPECT_NEAR(out_int8_data[i], expected, 1);
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(pool2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(pool2d, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(pool2d, kX86, kInt8, kNCHW, fp32_out);
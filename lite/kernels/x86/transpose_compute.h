@@ -17,6 +17,7 @@
 #include <Eigen/Core>
 #include <vector>
 #include "lite/backends/x86/math/math_function.h"
+#include "lite/backends/x86/math/transpose.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
@@ -64,6 +65,24 @@ inline void TransCompute(const int dim,
   }
 }
 
+// The blocked kernels only cover float
+template <typename T>
+inline bool TransBlocked(const lite::Tensor& in,
+                         lite::Tensor* out,
+                         const std::vector<int>& axis) {
+  return false;
+}
+
+template <>
+inline bool TransBlocked<float>(const lite::Tensor& in,
+                                lite::Tensor* out,
+                                const std::vector<int>& axis) {
+  return paddle::lite::x86::math::transpose_blocked(in.data<float>(),
+                                                    out->mutable_data<float>(),
+                                                    in.dims().Vectorize(),
+                                                    axis);
+}
+
 template <typename T>
 class TransposeCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -75,6 +94,7 @@ class TransposeCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto* out = param.output;
     out->template mutable_data<T>();
     int ndims = param.axis.size();
+    if (TransBlocked<T>(*x, out, param.axis)) return;
     auto& context = ctx_->As<X86Context>();
     TransCompute<lite::TargetType::kX86, T>(
         ndims, context, *x, out, param.axis);
@@ -94,6 +114,7 @@ class Transpose2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto* out = param.output;
     out->template mutable_data<T>();
     int ndims = param.axis.size();
+    if (TransBlocked<T>(*x, out, param.axis)) return;
     auto& context = ctx_->As<X86Context>();
     TransCompute<lite::TargetType::kX86, T>(
         ndims, context, *x, out, param.axis);
@@ -74,6 +74,79 @@ TEST(transpose_x86, run_test) {
   }
 }
 
+static void transpose_ref(const lite::Tensor& x,
+                          const std::vector<int>& axis,
+                          lite::Tensor* out) {
+  auto in_dims = x.dims().Vectorize();
+  const int rank = static_cast<int>(axis.size());
+  std::vector<int64_t> out_dims(rank);
+  std::vector<int64_t> in_strides(rank, 1);
+  for (int i = rank - 2; i >= 0; i--) {
+    in_strides[i] = in_strides[i + 1] * in_dims[i + 1];
+  }
+  for (int i = 0; i < rank; i++) {
+    out_dims[i] = in_dims[axis[i]];
+  }
+  out->Resize(out_dims);
+  const float* x_data = x.data<float>();
+  float* out_data = out->mutable_data<float>();
+  for (int64_t j = 0; j < out->numel(); j++) {
+    int64_t rest = j;
+    int64_t offset = 0;
+    for (int i = rank - 1; i >= 0; i--) {
+      offset += rest % out_dims[i] * in_strides[axis[i]];
+      rest /= out_dims[i];
+    }
+    out_data[j] = x_data[offset];
+  }
+}
+
+TEST(transpose_x86, blocked) {
+  // The permutations of attention and detection heads, with sizes off the
+  // 8x8 tiles and the 64x64 blocks, and a few the blocked kernels leave to
+  // Eigen
+  std::vector<std::pair<std::vector<int64_t>, std::vector<int>>> cases{
+      {{2, 12, 37, 64}, {0, 2, 1, 3}},
+      {{2, 3, 70, 33}, {0, 2, 3, 1}},
+      {{1, 255, 13, 13}, {0, 2, 3, 1}},
+      {{2, 9, 5, 131}, {0, 3, 1, 2}},
+      {{3, 67, 45}, {0, 2, 1}},
+      {{129, 7}, {1, 0}},
+      {{4, 1, 9, 1}, {0, 3, 2, 1}},
+      {{2, 1, 8, 16}, {0, 2, 1, 3}},
+      {{2, 3, 4, 5}, {0, 3, 2, 1}},
+      {{2, 3, 4, 5, 6}, {4, 2, 0, 3, 1}}};
+  for (auto& test_case : cases) {
+    lite::Tensor x;
+    lite::Tensor out;
+    lite::Tensor out_ref;
+    x.Resize(test_case.first);
+    auto* x_data = x.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>(i % 1013) * 0.5f - 100.f;
+    }
+    transpose_ref(x, test_case.second, &out_ref);
+    out.Resize(out_ref.dims());
+
+    TransposeCompute<float> transpose;
+    operators::TransposeParam param;
+    param.x = &x;
+    param.output = &out;
+    param.axis = test_case.second;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    transpose.SetContext(std::move(ctx));
+    transpose.SetParam(param);
+    transpose.Run();
+
+    const float* out_data = out.data<float>();
+    const float* ref_data = out_ref.data<float>();
+    for (int64_t j = 0; j < out.numel(); j++) {
+      ASSERT_EQ(out_data[j], ref_data[j]) << "dims " << x.dims() << " at " << j;
+    }
+  }
+}
+
 // transpose2
 TEST(transpose2_x86, retrive_op) {
   auto transpose2 = KernelRegistry::Global().Create("transpose2");
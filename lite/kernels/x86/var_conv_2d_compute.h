@@ -15,6 +15,7 @@
 
 #include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/tensor.h"
@@ -86,43 +87,48 @@ class VarConv2DCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     int kernel_win_size = kernel_h * kernel_w;
     int half_kernel_h = kernel_h / 2;
     int half_kernel_w = kernel_w / 2;
-    for (int b = 0; b < batch; ++b) {
-      int t_offset = top_offset[b];
-      int b_offset = bottom_offset[b];
-      int width = offset_x[b + 1] - offset_x[b];
-      int height = offset_y[b + 1] - offset_y[b];
-      if (width == 0 || height == 0) {
-        continue;
-      }
-      int top_im_x = (width - 1) / stride_w + 1;
-      int top_im_y = (height - 1) / stride_h + 1;
-      int top_x = top_im_y * top_im_x;
-      for (int z = 0; z < input_channel; ++z) {
-        int row_offset = kernel_win_size * z;
-        int im_offset = z * width * height;
-        for (int y = 0; y < height; y += stride_h) {
-          for (int x = 0; x < width; x += stride_w) {
-            int col_offset = x / stride_w + y / stride_h * top_im_x;
-            for (int ky = 0; ky < kernel_h; ++ky) {
-              for (int kx = 0; kx < kernel_w; ++kx) {
-                int im_y = y + ky - half_kernel_h;
-                int im_x = x + kx - half_kernel_w;
-                if (im_x >= 0 && im_x < width && im_y >= 0 && im_y < height) {
-                  top_data[t_offset +
-                           (row_offset + ky * kernel_w + kx) * top_x +
-                           col_offset] =
-                      bottom_data[b_offset + im_offset + im_y * width + im_x];
-                } else {
-                  top_data[t_offset +
-                           (row_offset + ky * kernel_w + kx) * top_x +
-                           col_offset] = 0;
+    // Every sequence unfolds into its own slice of `col`, so the sequences
+    // are split across threads.
+    auto im2col = [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        int t_offset = top_offset[b];
+        int b_offset = bottom_offset[b];
+        int width = offset_x[b + 1] - offset_x[b];
+        int height = offset_y[b + 1] - offset_y[b];
+        if (width == 0 || height == 0) {
+          continue;
+        }
+        int top_im_x = (width - 1) / stride_w + 1;
+        int top_im_y = (height - 1) / stride_h + 1;
+        int top_x = top_im_y * top_im_x;
+        for (int z = 0; z < input_channel; ++z) {
+          int row_offset = kernel_win_size * z;
+          int im_offset = z * width * height;
+          for (int y = 0; y < height; y += stride_h) {
+            for (int x = 0; x < width; x += stride_w) {
+              int col_offset = x / stride_w + y / stride_h * top_im_x;
+              for (int ky = 0; ky < kernel_h; ++ky) {
+                for (int kx = 0; kx < kernel_w; ++kx) {
+                  int im_y = y + ky - half_kernel_h;
+                  int im_x = x + kx - half_kernel_w;
+                  if (im_x >= 0 && im_x < width && im_y >= 0 && im_y < height) {
+                    top_data[t_offset +
+                             (row_offset + ky * kernel_w + kx) * top_x +
+                             col_offset] =
+                        bottom_data[b_offset + im_offset + im_y * width + im_x];
+                  } else {
+                    top_data[t_offset +
+                             (row_offset + ky * kernel_w + kx) * top_x +
+                             col_offset] = 0;
+                  }
                 }
               }
             }
           }
         }
       }
-    }
+    };
+    lite::x86::RunParallelFor(0, batch, im2col);
   }
 
   void Run() override {
@@ -183,26 +189,30 @@ class VarConv2DCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     const auto* col_data = col->template data<T>();
 
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
-    for (int b = 0; b < batch; ++b) {
-      int top_im_size = (top_offset[b + 1] - top_offset[b]) / output_channel;
-      if (top_im_size == 0) {
-        continue;
-      }
+    // The per-sequence GEMMs share W and write disjoint slices of `top`.
+    auto gemm = [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        int top_im_size = (top_offset[b + 1] - top_offset[b]) / output_channel;
+        if (top_im_size == 0) {
+          continue;
+        }
 
-      blas.GEMM(false,
-                false,
-                output_channel,
-                top_im_size,
-                input_channel * kernel_h * kernel_w,
-                1.0,
-                w_data,
-                input_channel * kernel_h * kernel_w,
-                col_data + col_offset[b],
-                top_im_size,
-                0.0,
-                top_data + top_offset[b],
-                top_im_size);
-    }
+        blas.GEMM(false,
+                  false,
+                  output_channel,
+                  top_im_size,
+                  input_channel * kernel_h * kernel_w,
+                  1.0,
+                  w_data,
+                  input_channel * kernel_h * kernel_w,
+                  col_data + col_offset[b],
+                  top_im_size,
+                  0.0,
+                  top_data + top_offset[b],
+                  top_im_size);
+      }
+    };
+    lite::x86::RunParallelFor(0, batch, gemm);
   }
 
   virtual ~VarConv2DCompute() = default;
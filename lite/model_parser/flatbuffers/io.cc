@@ -58,14 +58,20 @@ void FillParam(const std::string& name,
   prog->SetData(tensor.raw_data(), tensor.memory_size());
 }
 
-void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param) {
+void FillTensor(lite::Tensor* tensor,
+                const ParamDescReadAPI& param,
+                model_parser::ParallelCopier* copier) {
   CHECK(tensor);
   tensor->Resize(param.Dim());
   tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
   auto* dst = tensor->mutable_data(param.byte_size());
   CHECK(dst);
   CHECK(param.GetData());
-  std::memcpy(dst, param.GetData(), param.byte_size());
+  if (copier) {
+    copier->Add(dst, param.GetData(), param.byte_size());
+  } else {
+    std::memcpy(dst, param.GetData(), param.byte_size());
+  }
   tensor->set_persistable(true);
 }
 #ifdef LITE_WITH_FLATBUFFERS_DESC
@@ -99,10 +105,17 @@ void ParamSerializer::ForwardWrite(const lite::Scope& scope,
 
     const size_t param_bytes = buf_->size();
     CHECK(param_bytes) << "The bytes size of param can not be zero";
-    constexpr uint32_t offset = sizeof(uint32_t);
+    // The offset covers the padding that aligns the param in the file.
+    const size_t param_begin = writer_->current() + 2 * sizeof(uint32_t);
+    const uint32_t padding_bytes =
+        (kParamAlignment - param_begin % kParamAlignment) % kParamAlignment;
+    const uint32_t offset = sizeof(uint32_t) + padding_bytes;
     const uint32_t total_size = param_bytes + offset;
     writer_->Write<uint32_t>(total_size);
     writer_->Write<uint32_t>(offset);
+    for (uint32_t i = 0; i < padding_bytes; ++i) {
+      writer_->Write<uint8_t>(0U);
+    }
     writer_->Write(buf_->data(), param_bytes);
   }
 }
@@ -125,15 +138,36 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
       *reinterpret_cast<uint32_t const*>(data + sizeof(uint16_t));
 
   buf_->ResetLazy(max_tensor_size);
+  // Aligned params of a mapped model are viewed in place, the tensors are
+  // allocated here and their data is copied on several threads at the end.
+  model_parser::ParallelCopier copier;
   for (size_t i = 0; i < params_size; ++i) {
     uint32_t total_size = reader_->Read<uint32_t>();
     uint32_t offset = reader_->Read<uint32_t>();
     uint32_t param_bytes = total_size - offset;
-    ReadBytesToBuffer(offset - sizeof(offset));
-    ReadBytesToBuffer(param_bytes);
+    const size_t padding_bytes = offset - sizeof(offset);
+    const char* mapped = static_cast<const char*>(
+        reader_->Map(padding_bytes + param_bytes));
+    if (mapped == nullptr) {
+      ReadBytesToBuffer(padding_bytes);
+      ReadBytesToBuffer(param_bytes);
+    } else if (reinterpret_cast<uintptr_t>(mapped + padding_bytes) %
+                   kParamAlignment ==
+               0) {
+      fbs::ParamDescView param(mapped + padding_bytes, param_bytes);
+      FillTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(),
+                 param,
+                 &copier);
+      continue;
+    } else {
+      // Models saved before the params were aligned.
+      buf_->ResetLazy(param_bytes);
+      std::memcpy(buf_->data(), mapped + padding_bytes, param_bytes);
+    }
     fbs::ParamDescView param(buf_.get());
     FillTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(), param);
   }
+  copier.Run();
 }
 
 void ParamDeserializer::ReadHeader() {
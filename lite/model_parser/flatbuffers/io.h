@@ -31,7 +31,16 @@ void FillParam(const std::string& name,
                const lite::Tensor& tensor,
                ParamDescWriteAPI* prog);
 
-void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param);
+// If `copier` is given, the tensor is only allocated and the copy of the
+// param data is left to the copier.
+void FillTensor(lite::Tensor* tensor,
+                const ParamDescReadAPI& param,
+                model_parser::ParallelCopier* copier = nullptr);
+
+// The params written by ParamSerializer start at multiples of
+// kParamAlignment in the model file, so they can be viewed in place once the
+// file is mapped.
+constexpr size_t kParamAlignment = 8;
 
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 class ParamSerializer {
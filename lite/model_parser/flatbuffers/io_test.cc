@@ -129,6 +129,39 @@ TEST(CombinedParamsDesc, Scope) {
     check_params(scope_3);
   }
 }
+
+TEST(ParamDeserializer, LargeParams) {
+  const std::string path{"io_test.large_params.fbs"};
+  Scope scope;
+  std::set<std::string> param_names;
+  // Large enough to be copied on several threads.
+  for (int i = 0; i < 6; ++i) {
+    std::string name = "var_" + std::to_string(i);
+    Tensor* tensor = scope.Var(name)->GetMutable<Tensor>();
+    set_tensor<float>(tensor, std::vector<int64_t>({1000 + i, 1000}));
+    param_names.insert(name);
+  }
+  {
+    model_parser::BinaryFileWriter writer{path};
+    // Shift the params so that they have to be padded.
+    const uint8_t shift = 0;
+    writer.Write(&shift, sizeof(shift));
+    fbs::ParamSerializer serializer{&writer};
+    serializer.ForwardWrite(scope, param_names);
+  }
+
+  Scope loaded_scope;
+  model_parser::BinaryFileReader reader(path, sizeof(uint8_t));
+  fbs::ParamDeserializer deserializer(&reader);
+  deserializer.ForwardRead(&loaded_scope);
+  EXPECT_TRUE(reader.ReachEnd());
+  for (const auto& name : param_names) {
+    const Tensor& tensor = scope.FindVar(name)->Get<Tensor>();
+    Variable* var = loaded_scope.FindVar(name);
+    ASSERT_TRUE(var != nullptr);
+    EXPECT_TRUE(TensorCompareWith(tensor, var->Get<Tensor>()));
+  }
+}
 #endif  // LITE_WITH_FLATBUFFERS_DESC
 
 }  // namespace fbs
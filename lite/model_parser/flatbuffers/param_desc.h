@@ -42,6 +42,16 @@ class ParamDescView : public ParamDescReadAPI {
         flatbuffers::GetRoot<paddle::lite::fbs::proto::ParamDesc>(buf->data());
     Init();
   }
+  // Views a param in place, e.g. in a mapped model file. `data` should be
+  // aligned to 8 bytes.
+  ParamDescView(const void* data, size_t size) {
+    CHECK(data) << "The pointer of data can not be nullptr";
+    flatbuffers::Verifier verifier(static_cast<const uint8_t*>(data), size);
+    CHECK(verifier.VerifyBuffer<paddle::lite::fbs::proto::ParamDesc>(nullptr))
+        << "Param verification failed.";
+    desc_ = flatbuffers::GetRoot<paddle::lite::fbs::proto::ParamDesc>(data);
+    Init();
+  }
   explicit ParamDescView(proto::ParamDesc const* desc) : desc_(desc) { Init(); }
   void Init() {
     CHECK(desc_);
@@ -43,12 +43,13 @@ namespace lite {
 #ifndef LITE_ON_TINY_PUBLISH
 void LoadLoDTensor(model_parser::pb::LoDTensorDeserializer *loader,
                    model_parser::ByteReader *reader,
-                   Variable *var) {
+                   Variable *var,
+                   model_parser::ParallelCopier *copier = nullptr) {
+  CHECK(var) << "The input argument var is nullptr.";
   auto *tensor = var->GetMutable<lite::Tensor>();
   CHECK(tensor) << "Can not get allocation of the tensor.";
   CHECK(loader) << "The input argument loader is nullptr.";
-  CHECK(var) << "The input argument var is nullptr.";
-  loader->ForwardRead(tensor, reader);
+  loader->ForwardRead(tensor, reader, copier);
 }
 
 std::unique_ptr<framework::proto::ProgramDesc> LoadProgram(
@@ -57,7 +58,15 @@ std::unique_ptr<framework::proto::ProgramDesc> LoadProgram(
       new framework::proto::ProgramDesc);
   if (model_buffer.is_empty()) {
     model_parser::BinaryFileReader file(path);
-    main_program->ParseFromString(file.ReadToString(file.length()));
+    const size_t length = file.length();
+    // Parse the mapped file in place rather than from a copy of it.
+    const void *data = file.Map(length);
+    if (data) {
+      CHECK(main_program->ParseFromArray(data, static_cast<int>(length)))
+          << "Failed to parse the program from " << path;
+    } else {
+      main_program->ParseFromString(file.ReadToString(length));
+    }
   } else {
     main_program->ParseFromString(model_buffer.get_program());
   }
@@ -109,10 +118,14 @@ void LoadCombinedParamsPb(const std::string &path,
     CHECK(reader->length())
         << "The model needs weights but the weight file is not existed.";
   }
+  // The tensors are allocated while walking through the params, their data
+  // is copied from the mapped params on several threads at the end.
+  model_parser::ParallelCopier copier;
   for (size_t i = 0; i < paramlist.size(); ++i) {
     auto *var = scope->Var(paramlist[i]);
-    LoadLoDTensor(&loader, reader.get(), var);
+    LoadLoDTensor(&loader, reader.get(), var, &copier);
   }
+  copier.Run();
   CHECK(reader->ReachEnd()) << "You are not allowed to load partial data via"
                             << " LoadCombinedParamsPb, use LoadParam instead.";
 }
@@ -181,21 +194,30 @@ void LoadNonCombinedParamsPb(const std::string &model_dir,
                              Scope *scope) {
   auto *main_block = cpp_prog->GetBlock<cpp::BlockDesc>(0);
   std::string log_info = "Loading non-combined params data from " + model_dir;
+  // The mapped param files are kept until their data has been copied.
+  std::vector<std::unique_ptr<model_parser::BinaryFileReader>> readers;
+  model_parser::ParallelCopier copier;
+  model_parser::pb::LoDTensorDeserializer loader;
   // Check param files format
   // default format: non-combined params
   for (auto &var : main_block->GetVars()) {
     if (IsParamVarDesc(*var)) {
       if (IsFileExists(model_dir + "/" + var->Name())) {
         VLOG(4) << "reading weight " << var->Name();
-        model_parser::BinaryFileReader reader(model_dir + "/" + var->Name());
-        model_parser::pb::LoDTensorDeserializer loader;
+        std::unique_ptr<model_parser::BinaryFileReader> reader(
+            new model_parser::BinaryFileReader(model_dir + "/" + var->Name()));
+        const size_t pending_bytes = copier.bytes();
         switch (var->GetType()) {
           case VarDescAPI::Type::LOD_TENSOR:
-            LoadLoDTensor(&loader, &reader, scope->Var(var->Name()));
+            LoadLoDTensor(
+                &loader, reader.get(), scope->Var(var->Name()), &copier);
             break;
           default:
             CHECK(false) << "unknown weight type";
         }
+        if (copier.bytes() != pending_bytes) {
+          readers.push_back(std::move(reader));
+        }
       } else {
         std::string params_path{""};
         // format 1. model_dir/params
@@ -218,6 +240,7 @@ void LoadNonCombinedParamsPb(const std::string &model_dir,
       }
     }
   }
+  copier.Run();
   OPT_LOG << log_info;
 }
 
@@ -507,11 +530,15 @@ void SaveModelNaive(const std::string &model_file,
   // Meta_version(uint16), default value is 2.
   uint16_t meta_version = 2;
   // You can modify meta_version by register environment variable
-  // 'PADDLE_LITE_MODEL_VERSION1'
+  // 'PADDLE_LITE_MODEL_VERSION1' or 'PADDLE_LITE_MODEL_VERSION3'. Version 3
+  // adds the ready-to-run section, and can not be loaded by the runtimes
+  // released before it.
   const char *PADDLE_LITE_EXPERIMENTAL_MODEL =
       std::getenv("PADDLE_LITE_MODEL_VERSION1");
   if (PADDLE_LITE_EXPERIMENTAL_MODEL != nullptr) {
     meta_version = 1;
+  } else if (std::getenv("PADDLE_LITE_MODEL_VERSION3") != nullptr) {
+    meta_version = 3;
   }
   // Save meta_version(uint16) into file
   writer.Write(&meta_version, sizeof(uint16_t));
@@ -522,6 +549,17 @@ void SaveModelNaive(const std::string &model_file,
   writer.Write(paddle_version.c_str(), paddle_version_length);
   VLOG(4) << "paddle_version:" << paddle_version;
 
+  // Save the ready-to-run section(uint64 size + data) into file, it is empty
+  // if the program can only be loaded from the topology.
+  if (meta_version == 3) {
+    std::string ready_to_run =
+        model_parser::ReadyToRunProgram::Serialize(cpp_prog);
+    uint64_t ready_to_run_size = ready_to_run.size();
+    writer.Write(&ready_to_run_size, sizeof(uint64_t));
+    writer.Write(ready_to_run.data(), ready_to_run_size);
+    VLOG(4) << "save ready_to_run_size:" << ready_to_run_size;
+  }
+
   /* 1. Get topolygy description from cpp::ProgramDesc */
   fbs::ProgramDesc fbs_prog;
   TransformProgramDescCppToAny(cpp_prog, &fbs_prog);
@@ -554,7 +592,8 @@ void SaveModelNaive(const std::string &model_file,
       writer.Write(buffer.data(), buffer.size());
       break;
     }
-    case 2: {
+    case 2:
+    case 3: {
       fbs::ParamSerializer serializer{&writer};
       // 3.2 Save params into naive model
       serializer.ForwardWrite(exec_scope, unique_var_names);
@@ -562,7 +601,7 @@ void SaveModelNaive(const std::string &model_file,
     }
     default: {
       LOG(FATAL) << "Error: Unsupported opt meta_version, "
-                    "meta_version should be set as 1 or 2.";
+                    "meta_version should be set as 1, 2 or 3.";
       break;
     }
   }
@@ -759,13 +798,18 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
  * |       |    PART         |   Precision |   Length(byte) |
  * |   1   |  meta_version   |   uint16_t  |       2        |
  * |   2   |  opt_version    |   char[16]  |      16        |
- * |   3   |  topo_size      |   uint64_t  |       8        |
- * |   4   |  topo_data      |   char[]    | topo_size byte |
- * |   5   |  param_data     |   char[]    |                |
+ * |   3   |  rtr_size       |   uint64_t  |       8        |
+ * |   4   |  rtr_data       |   char[]    | rtr_size byte  |
+ * |   5   |  topo_size      |   uint64_t  |       8        |
+ * |   6   |  topo_data      |   char[]    | topo_size byte |
+ * |   7   |  param_data     |   char[]    |                |
  * ----------------------------------------------------------
  *  Meaning of each part:
  *      meta_version: meata_version, 0 default.
  *      opt_version:  lite_version of opt tool that transformed this model.
+ *      rtr_size:     length of `rtr_data`, only for meta_version 3.
+ *      rtr_data:     the ready-to-run section, see ReadyToRunProgram. The
+ *                    topology is skipped if the main block is read from it.
  *      topo_size:    length of `topo_data`.
  *      topo_data:    contains model's topology data.
  *      param_data:   contains model's params data.
@@ -773,7 +817,8 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
 
 void LoadModelNaiveFromFile(const std::string &filename,
                             Scope *scope,
-                            cpp::ProgramDesc *cpp_prog) {
+                            cpp::ProgramDesc *cpp_prog,
+                            model_parser::ReadyToRunProgram *ready_to_run) {
   CHECK(cpp_prog);
   CHECK(scope);
   // ModelFile
@@ -802,6 +847,9 @@ void LoadModelNaiveFromFile(const std::string &filename,
     case 2:
       LoadModelFbsFromFile(&reader, scope, cpp_prog, 2);
       break;
+    case 3:
+      LoadModelFbsFromFile(&reader, scope, cpp_prog, 3, ready_to_run);
+      break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
                     "you use the correct interface and model file.";
@@ -865,10 +913,47 @@ void LoadModelNaiveV0FromFile(const std::string &filename,
   VLOG(4) << "Load naive buffer model in '" << filename << "' successfully";
 }
 #endif  // LITE_ON_TINY_PUBLISH
+
+// Reads the ready-to-run section of a meta_version 3 model into
+// `ready_to_run`. Returns true if the main block was added to `cpp_prog`
+// from it, then the topology is not needed.
+static bool LoadReadyToRunSection(
+    const model_parser::ByteReader *reader,
+    cpp::ProgramDesc *cpp_prog,
+    model_parser::ReadyToRunProgram *ready_to_run) {
+  uint64_t ready_to_run_size;
+  reader->Read(&ready_to_run_size, sizeof(uint64_t));
+  VLOG(4) << "ready_to_run_size: " << ready_to_run_size;
+  if (ready_to_run_size == 0) return false;
+  std::string buf;
+  auto *data = static_cast<const char *>(reader->Map(ready_to_run_size));
+  if (!data) {
+    buf.resize(ready_to_run_size);
+    reader->Read(&buf[0], ready_to_run_size);
+    data = buf.data();
+  }
+  model_parser::ReadyToRunProgram local;
+  if (!ready_to_run) ready_to_run = &local;
+#ifdef LITE_ON_FLATBUFFERS_DESC_VIEW
+  ready_to_run->Load(data, ready_to_run_size, nullptr);
+  return false;
+#else
+  return ready_to_run->Load(data, ready_to_run_size, cpp_prog);
+#endif
+}
+
+static void SkipBytes(const model_parser::ByteReader *reader, size_t size) {
+  if (!reader->Map(size)) {
+    model_parser::Buffer buf(size);
+    reader->Read(buf.data(), size);
+  }
+}
+
 void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
                           Scope *scope,
                           cpp::ProgramDesc *cpp_prog,
-                          uint16_t meta_version) {
+                          uint16_t meta_version,
+                          model_parser::ReadyToRunProgram *ready_to_run) {
   CHECK(cpp_prog);
   CHECK(scope);
   CHECK_EQ(cpp_prog->BlocksSize(), 0);
@@ -889,24 +974,32 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
                  << static_cast<const char *>(opt_version)
                  << "\n      version of current Paddle-Lite:" << paddle_version;
   }
+  bool main_block_loaded =
+      meta_version == 3 &&
+      LoadReadyToRunSection(reader, cpp_prog, ready_to_run);
+
   // (3)get topo_size
   uint64_t topo_size;
   reader->Read(&topo_size, sizeof(uint64_t));
   VLOG(4) << "topo_size: " << topo_size;
 
+  if (main_block_loaded) {
+    SkipBytes(reader, topo_size);
+  } else {
 #ifdef LITE_ON_FLATBUFFERS_DESC_VIEW
-  lite::model_parser::Buffer buf(topo_size);
-  reader->Read(buf.data(), topo_size);
-  cpp_prog->Init(std::move(buf));
+    lite::model_parser::Buffer buf(topo_size);
+    reader->Read(buf.data(), topo_size);
+    cpp_prog->Init(std::move(buf));
 #elif LITE_ON_TINY_PUBLISH
-  LOG(FATAL) << "Since no data structure of Flatbuffers has been constructed, "
-                "the model cannot be loaded.";
+    LOG(FATAL) << "Since no data structure of Flatbuffers has been "
+                  "constructed, the model cannot be loaded.";
 #else
-  lite::model_parser::Buffer buf(topo_size);
-  reader->Read(buf.data(), topo_size);
-  fbs::ProgramDesc program(buf);
-  TransformProgramDescAnyToCpp(program, cpp_prog);
+    lite::model_parser::Buffer buf(topo_size);
+    reader->Read(buf.data(), topo_size);
+    fbs::ProgramDesc program(buf);
+    TransformProgramDescAnyToCpp(program, cpp_prog);
 #endif
+  }
 
   /* 2. Load scope from params.fbs */
   switch (meta_version) {
@@ -918,8 +1011,9 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
       fbs::deprecated::SetScopeWithCombinedParams(scope, params);
       break;
     }
-    case 2: {
-      /* load scope from param.fbs with meta_version=2 */
+    case 2:
+    case 3: {
+      /* load scope from param.fbs with meta_version=2,3 */
       fbs::ParamDeserializer deserializer(reader);
       deserializer.ForwardRead(scope);
       break;
@@ -932,7 +1026,8 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
 
 void LoadModelNaiveFromMemory(const std::string &model_buffer,
                               Scope *scope,
-                              cpp::ProgramDesc *cpp_prog) {
+                              cpp::ProgramDesc *cpp_prog,
+                              model_parser::ReadyToRunProgram *ready_to_run) {
   CHECK(cpp_prog);
   CHECK(scope);
   cpp_prog->ClearBlocks();
@@ -959,6 +1054,9 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
     case 2:
       LoadModelFbsFromMemory(&reader, scope, cpp_prog, 2);
       break;
+    case 3:
+      LoadModelFbsFromMemory(&reader, scope, cpp_prog, 3, ready_to_run);
+      break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
                     "you use the correct interface and model file.";
@@ -1003,34 +1101,43 @@ void LoadModelNaiveV0FromMemory(const std::string &model_buffer,
 }
 #endif
 ///////////////////////////////////////////////////////////////////
-// Meta_version=1,2
+// Meta_version=1,2,3
 ///////////////////////////////////////////////////////////////////
 void LoadModelFbsFromMemory(model_parser::StringBufferReader *reader,
                             Scope *scope,
                             cpp::ProgramDesc *cpp_prog,
-                            uint16_t meta_version) {
+                            uint16_t meta_version,
+                            model_parser::ReadyToRunProgram *ready_to_run) {
   // (1)get opt version
   char opt_version[16];
   const uint64_t paddle_version_length = 16 * sizeof(char);
   reader->Read(opt_version, paddle_version_length);
   VLOG(4) << "Opt_version:" << static_cast<const char *>(opt_version);
 
+  bool main_block_loaded =
+      meta_version == 3 &&
+      LoadReadyToRunSection(reader, cpp_prog, ready_to_run);
+
   // (2)get prog_size and prog_data
   uint64_t prog_size;
   reader->Read(&prog_size, sizeof(uint64_t));
   VLOG(4) << "prog_size:" << prog_size;
 
-  model_parser::Buffer prog_data(prog_size);
-  reader->Read(prog_data.data(), prog_size);
+  if (main_block_loaded) {
+    SkipBytes(reader, prog_size);
+  } else {
+    model_parser::Buffer prog_data(prog_size);
+    reader->Read(prog_data.data(), prog_size);
 #ifdef LITE_ON_FLATBUFFERS_DESC_VIEW
-  cpp_prog->Init(std::move(prog_data));
+    cpp_prog->Init(std::move(prog_data));
 #elif LITE_ON_TINY_PUBLISH
-  LOG(FATAL) << "Since no data structure of Flatbuffers has been constructed, "
-                "the model cannot be loaded.";
+    LOG(FATAL) << "Since no data structure of Flatbuffers has been "
+                  "constructed, the model cannot be loaded.";
 #else
-  fbs::ProgramDesc program(prog_data);
-  TransformProgramDescAnyToCpp(program, cpp_prog);
+    fbs::ProgramDesc program(prog_data);
+    TransformProgramDescAnyToCpp(program, cpp_prog);
 #endif
+  }
   switch (meta_version) {
     case 1: {
       size_t params_size = reader->length() - sizeof(uint16_t) -
@@ -1041,7 +1148,8 @@ void LoadModelFbsFromMemory(model_parser::StringBufferReader *reader,
       fbs::deprecated::SetScopeWithCombinedParams(scope, params);
       break;
     }
-    case 2: {
+    case 2:
+    case 3: {
       fbs::ParamDeserializer deserializer(reader);
       deserializer.ForwardRead(scope);
       break;
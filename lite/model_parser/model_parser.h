@@ -28,6 +28,7 @@
 #include "lite/core/scope.h"
 #include "lite/core/variable.h"
 #include "lite/model_parser/compatible_pb.h"
+#include "lite/model_parser/ready_to_run.h"
 
 namespace paddle {
 namespace lite {
@@ -139,21 +140,31 @@ void LoadNonCombinedParamsPb(const std::string& model_dir,
                              const lite_api::CxxModelBuffer& model_buffer,
                              Scope* scope);
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader* reader,
-                          Scope* scope,
-                          cpp::ProgramDesc* cpp_prog,
-                          uint16_t meta_version);
+// The ready-to-run section of a meta_version 3 model is read into
+// `ready_to_run` if it is not nullptr.
+void LoadModelFbsFromFile(
+    model_parser::BinaryFileReader* reader,
+    Scope* scope,
+    cpp::ProgramDesc* cpp_prog,
+    uint16_t meta_version,
+    model_parser::ReadyToRunProgram* ready_to_run = nullptr);
 
-void LoadModelNaiveFromFile(const std::string& filename,
-                            lite::Scope* scope,
-                            cpp::ProgramDesc* prog);
+void LoadModelNaiveFromFile(
+    const std::string& filename,
+    lite::Scope* scope,
+    cpp::ProgramDesc* prog,
+    model_parser::ReadyToRunProgram* ready_to_run = nullptr);
 
-void LoadModelNaiveFromMemory(const std::string& model_buffer,
-                              lite::Scope* scope,
-                              cpp::ProgramDesc* cpp_prog);
-void LoadModelFbsFromMemory(model_parser::StringBufferReader* reader,
-                            Scope* scope,
-                            cpp::ProgramDesc* cpp_prog,
-                            uint16_t meta_version);
+void LoadModelNaiveFromMemory(
+    const std::string& model_buffer,
+    lite::Scope* scope,
+    cpp::ProgramDesc* cpp_prog,
+    model_parser::ReadyToRunProgram* ready_to_run = nullptr);
+void LoadModelFbsFromMemory(
+    model_parser::StringBufferReader* reader,
+    Scope* scope,
+    cpp::ProgramDesc* cpp_prog,
+    uint16_t meta_version,
+    model_parser::ReadyToRunProgram* ready_to_run = nullptr);
 }  // namespace lite
 }  // namespace paddle
@@ -16,8 +16,10 @@
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include "lite/core/scope.h"
+#include "lite/utils/timer.h"
 
 DEFINE_string(model_dir, "", "");
+DEFINE_int32(load_repeats, 5, "repeats of the load time tests");
 
 namespace paddle {
 namespace lite {
@@ -139,5 +141,62 @@ TEST(ModelParser, LoadModelNaiveFromMemory) {
   LoadModelNaiveFromMemory(model_buffer, &scope, &prog);
 }
 
+// Load time of the formats, using the models saved by the tests above.
+TEST(ModelParser, LoadTimePb) {
+  CHECK(!FLAGS_model_dir.empty());
+  Timer non_combined_timer("LoadModelPb");
+  Timer combined_timer("LoadModelPb(combined)");
+  const std::string combined_dir = FLAGS_model_dir + ".saved.pb.combined";
+  for (int i = 0; i < FLAGS_load_repeats; ++i) {
+    {
+      cpp::ProgramDesc prog;
+      Scope scope;
+      non_combined_timer.Start();
+      LoadModelPb(FLAGS_model_dir, "", "", &scope, &prog);
+      non_combined_timer.Stop();
+    }
+    {
+      cpp::ProgramDesc prog;
+      Scope scope;
+      combined_timer.Start();
+      LoadModelPb(combined_dir,
+                  combined_dir + "/model",
+                  combined_dir + "/params",
+                  &scope,
+                  &prog,
+                  true);
+      combined_timer.Stop();
+    }
+  }
+  non_combined_timer.Print();
+  combined_timer.Print();
+}
+
+TEST(ModelParser, LoadTimeNaive) {
+  CHECK(!FLAGS_model_dir.empty());
+  Timer file_timer("LoadModelNaiveFromFile");
+  Timer memory_timer("LoadModelNaiveFromMemory");
+  const std::string model_path = FLAGS_model_dir + ".saved.nb";
+  const std::string model_buffer = lite::ReadFile(model_path);
+  for (int i = 0; i < FLAGS_load_repeats; ++i) {
+    {
+      cpp::ProgramDesc prog;
+      Scope scope;
+      file_timer.Start();
+      LoadModelNaiveFromFile(model_path, &scope, &prog);
+      file_timer.Stop();
+    }
+    {
+      cpp::ProgramDesc prog;
+      Scope scope;
+      memory_timer.Start();
+      LoadModelNaiveFromMemory(model_buffer, &scope, &prog);
+      memory_timer.Stop();
+    }
+  }
+  file_timer.Print();
+  memory_timer.Print();
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -65,7 +65,8 @@ const void* get_allocation(const lite::Tensor& tensor) {
 namespace pb {
 
 void LoDTensorDeserializer::ForwardRead(lite::Tensor* tensor,
-                                        ByteReader* reader) {
+                                        ByteReader* reader,
+                                        ParallelCopier* copier) {
   CHECK(tensor) << "The input tensor is nullptr.";
   CHECK(reader) << "The input reader is nullptr.";
   CHECK(!reader->ReachEnd()) << "Nothing to read.";
@@ -94,7 +95,12 @@ void LoDTensorDeserializer::ForwardRead(lite::Tensor* tensor,
           lite::ConvertPrecisionType(tensor_reader.GetDataType()));
       void* data = tensor::get_allocation(tensor);
       size_t size = tensor::get_bytes_size(*tensor);
-      reader->Read(data, size);
+      const void* src = copier ? reader->Map(size) : nullptr;
+      if (src) {
+        copier->Add(data, src, size);
+      } else {
+        reader->Read(data, size);
+      }
 #else
       LOG(FATAL) << "Tiny-publish mode is not supported to read the 0 "
                     "version model.";
@@ -54,7 +54,11 @@ class LoDTensorDeserializer {
  public:
   LoDTensorDeserializer() : buf_(new Buffer) {}
 
-  void ForwardRead(lite::Tensor* tensor, ByteReader* reader);
+  // If `copier` is given and the reader can be mapped, the tensor is only
+  // allocated and the copy of its data is left to the copier.
+  void ForwardRead(lite::Tensor* tensor,
+                   ByteReader* reader,
+                   ParallelCopier* copier = nullptr);
 
  private:
   std::unique_ptr<Buffer> buf_;
@@ -0,0 +1,332 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/model_parser/ready_to_run.h"
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include "lite/utils/log/cp_logging.h"
+#include "lite/utils/string.h"
+
+namespace paddle {
+namespace lite {
+namespace model_parser {
+
+constexpr uint16_t ReadyToRunProgram::kVersion;
+
+namespace {
+
+class SectionWriter {
+ public:
+  template <typename T>
+  void Write(T value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  void WriteString(const std::string& str) {
+    Write<uint32_t>(str.size());
+    buffer_.append(str);
+  }
+  template <typename T>
+  void WriteVector(const std::vector<T>& values) {
+    Write<uint32_t>(values.size());
+    for (auto& value : values) Write<T>(value);
+  }
+  void WriteVector(const std::vector<std::string>& values) {
+    Write<uint32_t>(values.size());
+    for (auto& value : values) WriteString(value);
+  }
+  std::string* mutable_buffer() { return &buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+class SectionReader {
+ public:
+  SectionReader(const char* data, size_t size) : data_(data), size_(size) {}
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Consume(sizeof(T)), sizeof(T));
+    return value;
+  }
+  std::string ReadString() {
+    auto size = Read<uint32_t>();
+    return std::string(Consume(size), size);
+  }
+  template <typename T>
+  std::vector<T> ReadVector() {
+    std::vector<T> values(Read<uint32_t>());
+    for (auto& value : values) value = Read<T>();
+    return values;
+  }
+  std::vector<std::string> ReadStrings() {
+    std::vector<std::string> values(Read<uint32_t>());
+    for (auto& value : values) value = ReadString();
+    return values;
+  }
+  const char* Consume(size_t size) {
+    CHECK_LE(size, size_ - cur_) << "The ready-to-run section is truncated.";
+    const char* ptr = data_ + cur_;
+    cur_ += size;
+    return ptr;
+  }
+  bool ReachEnd() const { return cur_ == size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t cur_{0};
+};
+
+#ifndef LITE_ON_TINY_PUBLISH
+bool WriteAttrs(const cpp::OpDesc& op_desc, SectionWriter* writer) {
+  auto attr_names = op_desc.AttrNames();
+  writer->Write<uint32_t>(attr_names.size());
+  for (auto& name : attr_names) {
+    auto type = op_desc.GetAttrType(name);
+    writer->WriteString(name);
+    writer->Write<int32_t>(static_cast<int32_t>(type));
+#define WRITE_ATTR(type__, T, write__)         \
+  case OpAttrType::type__:                     \
+    writer->write__(op_desc.GetAttr<T>(name)); \
+    break;
+    switch (type) {
+      WRITE_ATTR(INT, int32_t, Write<int32_t>)
+      WRITE_ATTR(FLOAT, float, Write<float>)
+      WRITE_ATTR(STRING, std::string, WriteString)
+      WRITE_ATTR(BOOLEAN, bool, Write<uint8_t>)
+      WRITE_ATTR(LONG, int64_t, Write<int64_t>)
+      WRITE_ATTR(BLOCK, int16_t, Write<int16_t>)
+      WRITE_ATTR(INTS, std::vector<int32_t>, WriteVector)
+      WRITE_ATTR(FLOATS, std::vector<float>, WriteVector)
+      WRITE_ATTR(LONGS, std::vector<int64_t>, WriteVector)
+      WRITE_ATTR(STRINGS, std::vector<std::string>, WriteVector)
+      default:
+        VLOG(3) << "The attr " << name << " of " << op_desc.Type()
+                << " can not be written into the ready-to-run section.";
+        return false;
+    }
+#undef WRITE_ATTR
+  }
+  return true;
+}
+
+bool WriteArguments(
+    const std::map<std::string, std::vector<std::string>>& arguments,
+    const std::unordered_map<std::string, uint32_t>& slots,
+    SectionWriter* writer) {
+  writer->Write<uint32_t>(arguments.size());
+  for (auto& argument : arguments) {
+    writer->WriteString(argument.first);
+    writer->Write<uint32_t>(argument.second.size());
+    for (auto& var_name : argument.second) {
+      auto it = slots.find(var_name);
+      if (it == slots.end()) return false;
+      writer->Write<uint32_t>(it->second);
+    }
+  }
+  return true;
+}
+#endif  // LITE_ON_TINY_PUBLISH
+
+#ifndef LITE_ON_FLATBUFFERS_DESC_VIEW
+void ReadAttrs(SectionReader* reader, cpp::OpDesc* op_desc) {
+  auto attr_size = reader->Read<uint32_t>();
+  for (uint32_t i = 0; i < attr_size; ++i) {
+    auto name = reader->ReadString();
+    auto type = static_cast<OpAttrType>(reader->Read<int32_t>());
+#define READ_ATTR(type__, T, read__)           \
+  case OpAttrType::type__:                     \
+    op_desc->SetAttr<T>(name, reader->read__); \
+    break;
+    switch (type) {
+      READ_ATTR(INT, int32_t, Read<int32_t>())
+      READ_ATTR(FLOAT, float, Read<float>())
+      READ_ATTR(STRING, std::string, ReadString())
+      READ_ATTR(BOOLEAN, bool, Read<uint8_t>() != 0)
+      READ_ATTR(LONG, int64_t, Read<int64_t>())
+      READ_ATTR(BLOCK, int16_t, Read<int16_t>())
+      READ_ATTR(INTS, std::vector<int32_t>, ReadVector<int32_t>())
+      READ_ATTR(FLOATS, std::vector<float>, ReadVector<float>())
+      READ_ATTR(LONGS, std::vector<int64_t>, ReadVector<int64_t>())
+      READ_ATTR(STRINGS, std::vector<std::string>, ReadStrings())
+      default:
+        LOG(FATAL) << "Unsupported attr type " << static_cast<int>(type)
+                   << " in the ready-to-run section.";
+    }
+#undef READ_ATTR
+  }
+}
+#endif  // LITE_ON_FLATBUFFERS_DESC_VIEW
+
+// Reads the var names of the inputs or outputs of an op, the names are only
+// looked up if `arguments` is not nullptr.
+void ReadArguments(
+    SectionReader* reader,
+    const std::vector<ReadyToRunVar>& vars,
+    std::map<std::string, std::vector<std::string>>* arguments) {
+  auto argument_size = reader->Read<uint32_t>();
+  for (uint32_t i = 0; i < argument_size; ++i) {
+    auto name = reader->ReadString();
+    auto slots = reader->ReadVector<uint32_t>();
+    if (!arguments) continue;
+    auto& var_names = (*arguments)[name];
+    var_names.reserve(slots.size());
+    for (auto slot : slots) {
+      CHECK_LT(slot, vars.size()) << "Invalid var slot " << slot
+                                  << " in the ready-to-run section.";
+      var_names.push_back(vars[slot].name);
+    }
+  }
+}
+
+}  // namespace
+
+#ifndef LITE_ON_TINY_PUBLISH
+std::string ReadyToRunProgram::Serialize(const cpp::ProgramDesc& cpp_prog) {
+  if (cpp_prog.BlocksSize() != 1) return "";
+  auto& block_desc = *cpp_prog.GetBlock<cpp::BlockDesc>(0);
+  SectionWriter writer;
+  writer.Write<uint16_t>(kVersion);
+  writer.Write<uint8_t>(cpp_prog.HasVersion());
+  writer.Write<int64_t>(cpp_prog.HasVersion() ? cpp_prog.Version() : 0);
+  writer.Write<int32_t>(block_desc.ParentIdx());
+  writer.Write<int32_t>(block_desc.ForwardBlockIdx());
+
+  std::unordered_map<std::string, uint32_t> slots;
+  writer.Write<uint32_t>(block_desc.VarsSize());
+  for (size_t i = 0; i < block_desc.VarsSize(); ++i) {
+    auto& var_desc = *block_desc.GetVar<cpp::VarDesc>(i);
+    slots.emplace(var_desc.Name(), i);
+    writer.WriteString(var_desc.Name());
+    writer.Write<int32_t>(static_cast<int32_t>(var_desc.GetType()));
+    writer.Write<int32_t>(static_cast<int32_t>(var_desc.GetDataType()));
+    writer.Write<uint8_t>(var_desc.Persistable());
+    writer.WriteVector(var_desc.GetShape());
+  }
+
+  writer.Write<uint32_t>(block_desc.OpsSize());
+  for (size_t i = 0; i < block_desc.OpsSize(); ++i) {
+    auto& op_desc = *block_desc.GetOp<cpp::OpDesc>(i);
+    if (!op_desc.HasAttr(kKernelTypeAttr)) return "";
+    // op_type/alias/target/precision/layout
+    auto kernel_type = op_desc.GetAttr<std::string>(kKernelTypeAttr);
+    auto parts = Split(kernel_type, "/");
+    if (parts.size() != 5u) return "";
+    writer.WriteString(op_desc.Type());
+    writer.Write<int32_t>(std::stoi(parts[2]));
+    writer.Write<int32_t>(std::stoi(parts[3]));
+    writer.Write<int32_t>(std::stoi(parts[4]));
+    writer.WriteString(parts[1]);
+    if (!WriteArguments(op_desc.inputs(), slots, &writer) ||
+        !WriteArguments(op_desc.outputs(), slots, &writer)) {
+      return "";
+    }
+    // The attr blob is prefixed with its size, so that it can be skipped
+    // when the op descs are read from the topology.
+    SectionWriter attrs;
+    if (!WriteAttrs(op_desc, &attrs)) return "";
+    writer.WriteString(*attrs.mutable_buffer());
+  }
+  return std::move(*writer.mutable_buffer());
+}
+#endif  // LITE_ON_TINY_PUBLISH
+
+bool ReadyToRunProgram::Load(const char* data,
+                             size_t size,
+                             cpp::ProgramDesc* cpp_prog) {
+  vars_.clear();
+  kernels_.clear();
+  SectionReader reader(data, size);
+  auto version = reader.Read<uint16_t>();
+  if (version != kVersion) {
+    LOG(WARNING) << "Unsupported ready-to-run section version " << version
+                 << ", the topology of the model is used instead.";
+    return false;
+  }
+  bool has_version = reader.Read<uint8_t>() != 0;
+  auto program_version = reader.Read<int64_t>();
+  auto parent_idx = reader.Read<int32_t>();
+  auto forward_block_idx = reader.Read<int32_t>();
+
+  vars_.resize(reader.Read<uint32_t>());
+  for (auto& var : vars_) {
+    var.name = reader.ReadString();
+    var.type = static_cast<VarDataType>(reader.Read<int32_t>());
+    var.data_type = static_cast<VarDataType>(reader.Read<int32_t>());
+    var.persistable = reader.Read<uint8_t>() != 0;
+    var.shape = reader.ReadVector<int64_t>();
+  }
+
+#ifdef LITE_ON_FLATBUFFERS_DESC_VIEW
+  CHECK(!cpp_prog) << "The op descs are read from the topology in the "
+                      "flatbuffers desc view.";
+  (void)has_version;
+  (void)program_version;
+  (void)parent_idx;
+  (void)forward_block_idx;
+#else
+  cpp::BlockDesc* block_desc = nullptr;
+  if (cpp_prog) {
+    cpp_prog->ClearBlocks();
+    if (has_version) cpp_prog->SetVersion(program_version);
+    block_desc = cpp_prog->AddBlock<cpp::BlockDesc>();
+    block_desc->SetIdx(0);
+    block_desc->SetParentIdx(parent_idx);
+    block_desc->SetForwardBlockIdx(forward_block_idx);
+    for (auto& var : vars_) {
+      auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+      var_desc->SetName(var.name);
+      var_desc->SetType(var.type);
+      var_desc->SetDataType(var.data_type);
+      var_desc->SetPersistable(var.persistable);
+      var_desc->SetShape(var.shape);
+    }
+  }
+#endif
+
+  kernels_.resize(reader.Read<uint32_t>());
+  for (auto& kernel : kernels_) {
+    auto op_type = reader.ReadString();
+    kernel.place.target = static_cast<TargetType>(reader.Read<int32_t>());
+    kernel.place.precision = static_cast<PrecisionType>(reader.Read<int32_t>());
+    kernel.place.layout = static_cast<DataLayoutType>(reader.Read<int32_t>());
+    kernel.alias = reader.ReadString();
+#ifndef LITE_ON_FLATBUFFERS_DESC_VIEW
+    if (block_desc) {
+      auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+      op_desc->SetType(op_type);
+      ReadArguments(&reader, vars_, op_desc->mutable_inputs());
+      ReadArguments(&reader, vars_, op_desc->mutable_outputs());
+      auto attrs_size = reader.Read<uint32_t>();
+      SectionReader attrs(reader.Consume(attrs_size), attrs_size);
+      ReadAttrs(&attrs, op_desc);
+      CHECK(attrs.ReachEnd()) << "Invalid attrs of " << op_type
+                              << " in the ready-to-run section.";
+      continue;
+    }
+#endif
+    ReadArguments(&reader, vars_, nullptr);
+    ReadArguments(&reader, vars_, nullptr);
+    reader.Consume(reader.Read<uint32_t>());
+  }
+  CHECK(reader.ReachEnd()) << "Invalid ready-to-run section.";
+  return true;
+}
+
+}  // namespace model_parser
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,89 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lite/core/target_wrapper.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace model_parser {
+
+// The kernel opt picked for an op of the main block.
+struct ReadyToRunKernel {
+  std::string alias;
+  Place place;
+};
+
+struct ReadyToRunVar {
+  std::string name;
+  VarDataType type{VarDataType::LOD_TENSOR};
+  VarDataType data_type{VarDataType::FP32};
+  bool persistable{false};
+  std::vector<int64_t> shape;
+};
+
+/*
+ * The ready-to-run section of a meta_version 3 naive buffer model. It holds
+ * the main block of the optimized program in the form the predictor builds
+ * it from:
+ * - a var table, the ops refer to their vars by slot index into it and the
+ *   shapes known at opt time are kept with the vars,
+ * - the kernel of every op as enum values and alias, so the kernel is
+ *   created directly instead of parsing the kernel type attr,
+ * - the attrs of every op as a typed blob.
+ *
+ * Layout, all the sizes and counts are uint32 unless noted:
+ *   version(uint16) | has_version(uint8) | program version(int64)
+ *   | parent_idx(int32) | forward_block_idx(int32)
+ *   | var count | var * [name | type(int32) | data_type(int32)
+ *                        | persistable(uint8) | rank | dims(int64) * rank]
+ *   | op count | op * [type | target(int32) | precision(int32)
+ *                      | layout(int32) | alias
+ *                      | inputs | outputs | attr blob size | attr blob]
+ * where inputs/outputs are [arg count | arg * [name | count | slot * count]],
+ * the attr blob is [attr count | attr * [name | type(int32) | value]] and a
+ * string is [size | bytes].
+ */
+class ReadyToRunProgram {
+ public:
+  static constexpr uint16_t kVersion = 1;
+
+#ifndef LITE_ON_TINY_PUBLISH
+  // Encodes the main block of `cpp_prog`. Returns an empty string if the
+  // program can not be described by the section, e.g. it has sub-blocks or
+  // an op without a picked kernel, then the topology is used to load it.
+  static std::string Serialize(const cpp::ProgramDesc& cpp_prog);
+#endif
+
+  // Decodes the section. The main block is also added to `cpp_prog` if it
+  // is not nullptr. Returns false if the section is of an unknown version.
+  bool Load(const char* data, size_t size, cpp::ProgramDesc* cpp_prog);
+
+  bool empty() const { return kernels_.empty(); }
+  const std::vector<ReadyToRunVar>& vars() const { return vars_; }
+  const std::vector<ReadyToRunKernel>& kernels() const { return kernels_; }
+
+ private:
+  std::vector<ReadyToRunVar> vars_;
+  std::vector<ReadyToRunKernel> kernels_;
+};
+
+}  // namespace model_parser
+}  // namespace lite
+}  // namespace paddle
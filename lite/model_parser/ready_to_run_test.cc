@@ -0,0 +1,188 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/model_parser/ready_to_run.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace model_parser {
+
+void AddVar(cpp::BlockDesc* block,
+            const std::string& name,
+            bool persistable,
+            const std::vector<int64_t>& shape,
+            VarDescAPI::Type type = VarDescAPI::Type::LOD_TENSOR) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(type);
+  var->SetDataType(VarDescAPI::VarDataType::FP32);
+  var->SetPersistable(persistable);
+  var->SetShape(shape);
+}
+
+// feed -> fc -> fetch, with the kernels picked by opt.
+void BuildProgram(cpp::ProgramDesc* program) {
+  program->SetVersion(2005000);
+  auto* block = program->AddBlock<cpp::BlockDesc>();
+  block->SetIdx(0);
+  block->SetParentIdx(-1);
+  block->SetForwardBlockIdx(-1);
+  AddVar(block, "feed", true, {}, VarDescAPI::Type::FEED_MINIBATCH);
+  AddVar(block, "fetch", true, {}, VarDescAPI::Type::FETCH_LIST);
+  AddVar(block, "x", false, {-1, 16});
+  AddVar(block, "w", true, {16, 8});
+  AddVar(block, "b", true, {8});
+  AddVar(block, "out", false, {-1, 8});
+
+  auto* feed = block->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int32_t>("col", 0);
+  feed->SetAttr<std::string>(kKernelTypeAttr, "feed/def/1/0/1");
+
+  auto* fc = block->AddOp<cpp::OpDesc>();
+  fc->SetType("fc");
+  fc->SetInput("Input", {"x"});
+  fc->SetInput("W", {"w"});
+  fc->SetInput("Bias", {"b"});
+  fc->SetOutput("Out", {"out"});
+  fc->SetAttr<int32_t>("in_num_col_dims", 1);
+  fc->SetAttr<float>("alpha", 0.5f);
+  fc->SetAttr<bool>("padding_weights", false);
+  fc->SetAttr<int64_t>("workspace", 1LL << 40);
+  fc->SetAttr<std::string>("activation_type", "relu");
+  fc->SetAttr<std::vector<int32_t>>("ints", {1, -2, 3});
+  fc->SetAttr<std::vector<float>>("floats", {0.25f, 4.f});
+  fc->SetAttr<std::vector<int64_t>>("longs", {-1, 1LL << 33});
+  fc->SetAttr<std::vector<std::string>>("strings", {"a", "", "bc"});
+  fc->SetAttr<std::string>(kKernelTypeAttr, "fc/def/2/1/1");
+
+  auto* fetch = block->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int32_t>("col", 0);
+  fetch->SetAttr<std::string>(kKernelTypeAttr, "fetch/def/1/0/1");
+}
+
+TEST(ReadyToRunProgram, round_trip) {
+  cpp::ProgramDesc program;
+  BuildProgram(&program);
+  std::string section = ReadyToRunProgram::Serialize(program);
+  ASSERT_FALSE(section.empty());
+
+  ReadyToRunProgram ready_to_run;
+  cpp::ProgramDesc loaded;
+  ASSERT_TRUE(ready_to_run.Load(section.data(), section.size(), &loaded));
+  EXPECT_EQ(loaded.Version(), 2005000);
+  ASSERT_EQ(loaded.BlocksSize(), 1u);
+  auto& src_block = *program.GetBlock<cpp::BlockDesc>(0);
+  auto& block = *loaded.GetBlock<cpp::BlockDesc>(0);
+  EXPECT_EQ(block.ParentIdx(), -1);
+
+  ASSERT_EQ(block.VarsSize(), src_block.VarsSize());
+  ASSERT_EQ(ready_to_run.vars().size(), src_block.VarsSize());
+  for (size_t i = 0; i < block.VarsSize(); ++i) {
+    auto& src_var = *src_block.GetVar<cpp::VarDesc>(i);
+    auto& var = *block.GetVar<cpp::VarDesc>(i);
+    EXPECT_EQ(var.Name(), src_var.Name());
+    EXPECT_EQ(var.GetType(), src_var.GetType());
+    EXPECT_EQ(var.Persistable(), src_var.Persistable());
+    EXPECT_EQ(var.GetShape(), src_var.GetShape());
+    EXPECT_EQ(ready_to_run.vars()[i].shape, src_var.GetShape());
+  }
+
+  ASSERT_EQ(block.OpsSize(), src_block.OpsSize());
+  for (size_t i = 0; i < block.OpsSize(); ++i) {
+    auto& src_op = *src_block.GetOp<cpp::OpDesc>(i);
+    auto& op = *block.GetOp<cpp::OpDesc>(i);
+    EXPECT_EQ(op.Type(), src_op.Type());
+    EXPECT_EQ(op.inputs(), src_op.inputs());
+    EXPECT_EQ(op.outputs(), src_op.outputs());
+    EXPECT_EQ(op.AttrNames(), src_op.AttrNames());
+    EXPECT_EQ(op.attr_types(), src_op.attr_types());
+  }
+  auto& fc = *block.GetOp<cpp::OpDesc>(1);
+  EXPECT_EQ(fc.GetAttr<int32_t>("in_num_col_dims"), 1);
+  EXPECT_EQ(fc.GetAttr<float>("alpha"), 0.5f);
+  EXPECT_FALSE(fc.GetAttr<bool>("padding_weights"));
+  EXPECT_EQ(fc.GetAttr<int64_t>("workspace"), 1LL << 40);
+  EXPECT_EQ(fc.GetAttr<std::string>("activation_type"), "relu");
+  EXPECT_EQ(fc.GetAttr<std::vector<int32_t>>("ints"),
+            std::vector<int32_t>({1, -2, 3}));
+  EXPECT_EQ(fc.GetAttr<std::vector<float>>("floats"),
+            std::vector<float>({0.25f, 4.f}));
+  EXPECT_EQ(fc.GetAttr<std::vector<int64_t>>("longs"),
+            std::vector<int64_t>({-1, 1LL << 33}));
+  EXPECT_EQ(fc.GetAttr<std::vector<std::string>>("strings"),
+            std::vector<std::string>({"a", "", "bc"}));
+
+  auto& kernels = ready_to_run.kernels();
+  ASSERT_EQ(kernels.size(), 3u);
+  EXPECT_EQ(kernels[1].alias, "def");
+  EXPECT_EQ(kernels[1].place.target, TARGET(kX86));
+  EXPECT_EQ(kernels[1].place.precision, PRECISION(kFloat));
+  EXPECT_EQ(kernels[1].place.layout, DATALAYOUT(kNCHW));
+  EXPECT_EQ(kernels[0].place.target, TARGET(kHost));
+  EXPECT_EQ(kernels[0].place.precision, PRECISION(kUnk));
+}
+
+TEST(ReadyToRunProgram, load_without_program_desc) {
+  cpp::ProgramDesc program;
+  BuildProgram(&program);
+  std::string section = ReadyToRunProgram::Serialize(program);
+  ReadyToRunProgram ready_to_run;
+  ASSERT_TRUE(ready_to_run.Load(section.data(), section.size(), nullptr));
+  EXPECT_EQ(ready_to_run.vars().size(), 6u);
+  EXPECT_EQ(ready_to_run.kernels().size(), 3u);
+}
+
+TEST(ReadyToRunProgram, fallback_to_topology) {
+  // An op without a picked kernel or reading an undeclared var
+  cpp::ProgramDesc program;
+  BuildProgram(&program);
+  program.GetBlock<cpp::BlockDesc>(0)->GetOp<cpp::OpDesc>(1)->DeleteAttr(
+      kKernelTypeAttr);
+  EXPECT_TRUE(ReadyToRunProgram::Serialize(program).empty());
+  cpp::ProgramDesc undeclared_var;
+  BuildProgram(&undeclared_var);
+  undeclared_var.GetBlock<cpp::BlockDesc>(0)->GetOp<cpp::OpDesc>(2)->SetInput(
+      "X", {"undeclared"});
+  EXPECT_TRUE(ReadyToRunProgram::Serialize(undeclared_var).empty());
+
+  // Sub-blocks
+  cpp::ProgramDesc multi_block;
+  BuildProgram(&multi_block);
+  multi_block.AddBlock<cpp::BlockDesc>();
+  EXPECT_TRUE(ReadyToRunProgram::Serialize(multi_block).empty());
+
+  // A section of a newer version
+  cpp::ProgramDesc single_block;
+  BuildProgram(&single_block);
+  std::string section = ReadyToRunProgram::Serialize(single_block);
+  section[0] = static_cast<char>(ReadyToRunProgram::kVersion + 1);
+  ReadyToRunProgram ready_to_run;
+  cpp::ProgramDesc loaded;
+  EXPECT_FALSE(ready_to_run.Load(section.data(), section.size(), &loaded));
+  EXPECT_TRUE(ready_to_run.empty());
+  EXPECT_EQ(loaded.BlocksSize(), 0u);
+}
+
+}  // namespace model_parser
+}  // namespace lite
+}  // namespace paddle
@@ -103,6 +103,18 @@ bool ActivationOp::AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) {
 
   VLOG(4) << "opdesc.Type():" << opdesc.Type();
 
+  // For Int8
+  const OpInfo* op_info = static_cast<const OpInfo*>(&opdesc);
+  if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
+    param_.enable_int8 = op_info->GetAttr<bool>("enable_int8");
+    auto input_scale_name = "X0_scale";
+    auto output_scale_name = "Out0_scale";
+    if (op_info->HasInputScale(input_scale_name, true))
+      param_.input_scale = op_info->GetInputScale(input_scale_name, true)[0];
+    if (op_info->HasOutputScale(output_scale_name, true))
+      param_.output_scale = op_info->GetOutputScale(output_scale_name, true)[0];
+  }
+
   param_.Out = scope->FindVar(out_name)->GetMutable<lite::Tensor>();
   return true;
 }
@@ -91,6 +91,22 @@ bool ConcatOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
       }
     }
   }
+  // For Int8
+  const OpInfo *op_info = static_cast<const OpInfo *>(&op_desc);
+  if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
+    param_.enable_int8 = op_info->GetAttr<bool>("enable_int8");
+    param_.x_input_scales.clear();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      auto input_scale_name = "X" + to_string(i) + "_scale";
+      param_.x_input_scales.push_back(
+          op_info->HasInputScale(input_scale_name, true)
+              ? op_info->GetInputScale(input_scale_name, true)[0]
+              : 1.f);
+    }
+    auto output_scale_name = "Out0_scale";
+    if (op_info->HasOutputScale(output_scale_name, true))
+      param_.output_scale = op_info->GetOutputScale(output_scale_name, true)[0];
+  }
   return true;
 }
 
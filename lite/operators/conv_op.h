@@ -191,6 +191,10 @@ class ConvOpLite : public OpLite {
     if (op_desc.HasAttr("padding_algorithm")) {
       padding_algorithm_ = op_desc.GetAttr<std::string>("padding_algorithm");
     }
+    if (op_desc.HasAttr("half_weight_type")) {
+      param_.half_weight_type =
+          op_desc.GetAttr<std::string>("half_weight_type");
+    }
     // For Int8
     const OpInfo* op_info = static_cast<const OpInfo*>(&op_desc);
     if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
@@ -0,0 +1,116 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/depthwise_pointwise_conv_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+// act_params are {relu6 threshold or leaky_relu alpha, 0, 0} or the
+// {threshold, scale, offset} of hard_swish.
+static void SetActivation(const std::string &act_type,
+                          const std::vector<float> &act_params,
+                          ActivationParam *act_param) {
+  act_param->has_active = !act_type.empty();
+  if (act_type.empty()) return;
+  CHECK_EQ(act_params.size(), 3UL);
+  if (act_type == "relu") {
+    act_param->active_type = lite_api::ActivationType::kRelu;
+  } else if (act_type == "relu6") {
+    act_param->active_type = lite_api::ActivationType::kRelu6;
+    act_param->Relu_clipped_coef = act_params[0];
+  } else if (act_type == "leaky_relu") {
+    act_param->active_type = lite_api::ActivationType::kLeakyRelu;
+    act_param->Leaky_relu_alpha = act_params[0];
+  } else if (act_type == "hard_swish") {
+    act_param->active_type = lite_api::ActivationType::kHardSwish;
+    act_param->hard_swish_threshold = act_params[0];
+    act_param->hard_swish_scale = act_params[1];
+    act_param->hard_swish_offset = act_params[2];
+  } else {
+    LOG(FATAL) << "Unsupported activation of depthwise_pointwise_conv2d: "
+               << act_type;
+  }
+}
+
+bool DepthwisePointwiseConvOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.x)
+  CHECK_OR_FALSE(param_.dw_filter)
+  CHECK_OR_FALSE(param_.pw_filter)
+  CHECK_OR_FALSE(param_.output)
+  const auto &x_dims = param_.x->dims();
+  const auto &dw_dims = param_.dw_filter->dims();
+  const auto &pw_dims = param_.pw_filter->dims();
+  CHECK_EQ_OR_FALSE(x_dims.size(), 4UL)
+  CHECK_EQ_OR_FALSE(dw_dims.size(), 4UL)
+  CHECK_EQ_OR_FALSE(pw_dims.size(), 4UL)
+  CHECK_EQ_OR_FALSE(dw_dims[0], x_dims[1])
+  CHECK_EQ_OR_FALSE(dw_dims[1], 1)
+  CHECK_EQ_OR_FALSE(pw_dims[1], x_dims[1])
+  CHECK_EQ_OR_FALSE(pw_dims[2] * pw_dims[3], 1)
+  CHECK_EQ_OR_FALSE(param_.strides.size(), 2UL)
+  CHECK_EQ_OR_FALSE(param_.paddings.size(), 4UL)
+  return true;
+}
+
+bool DepthwisePointwiseConvOp::InferShapeImpl() const {
+  const auto &x_dims = param_.x->dims();
+  const auto &dw_dims = param_.dw_filter->dims();
+  const auto &paddings = param_.paddings;
+  int64_t out_h =
+      (x_dims[2] + paddings[0] + paddings[1] - dw_dims[2]) / param_.strides[0] +
+      1;
+  int64_t out_w =
+      (x_dims[3] + paddings[2] + paddings[3] - dw_dims[3]) / param_.strides[1] +
+      1;
+  param_.output->Resize(
+      {x_dims[0], param_.pw_filter->dims()[0], out_h, out_w});
+  param_.output->set_lod(param_.x->lod());
+  return true;
+}
+
+bool DepthwisePointwiseConvOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                          lite::Scope *scope) {
+  auto find_optional = [&](const std::string &param) -> const lite::Tensor * {
+    if (!op_desc.HasInput(param) || op_desc.Input(param).empty()) {
+      return nullptr;
+    }
+    return scope->FindTensor(op_desc.Input(param).front());
+  };
+  param_.x = scope->FindTensor(op_desc.Input("Input").front());
+  param_.dw_filter = scope->FindTensor(op_desc.Input("DwFilter").front());
+  param_.dw_bias = find_optional("DwBias");
+  param_.pw_filter = scope->FindTensor(op_desc.Input("PwFilter").front());
+  param_.pw_bias = find_optional("PwBias");
+  param_.residual = find_optional("ResidualData");
+  param_.output = scope->FindMutableTensor(op_desc.Output("Output").front());
+  param_.strides = op_desc.GetAttr<std::vector<int>>("strides");
+  param_.paddings = op_desc.GetAttr<std::vector<int>>("paddings");
+  SetActivation(op_desc.GetAttr<std::string>("dw_act_type"),
+                op_desc.GetAttr<std::vector<float>>("dw_act_params"),
+                &param_.dw_activation_param);
+  SetActivation(op_desc.GetAttr<std::string>("pw_act_type"),
+                op_desc.GetAttr<std::vector<float>>("pw_act_params"),
+                &param_.pw_activation_param);
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(depthwise_pointwise_conv2d,
+                 paddle::lite::operators::DepthwisePointwiseConvOp);
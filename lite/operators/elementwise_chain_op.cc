@@ -0,0 +1,67 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/elementwise_chain_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool ElementwiseChainOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.X)
+  CHECK_OR_FALSE(param_.Out)
+  const size_t steps = param_.step_types.size();
+  CHECK_GT_OR_FALSE(steps, 0UL)
+  CHECK_EQ_OR_FALSE(param_.step_inputs.size(), steps)
+  CHECK_EQ_OR_FALSE(param_.step_axes.size(), steps)
+  CHECK_EQ_OR_FALSE(param_.step_reversed.size(), steps)
+  CHECK_EQ_OR_FALSE(param_.step_params.size(), steps * 3)
+  for (auto index : param_.step_inputs) {
+    CHECK_OR_FALSE(index < static_cast<int>(param_.Y.size()))
+  }
+  return true;
+}
+
+bool ElementwiseChainOp::InferShapeImpl() const {
+  param_.Out->Resize(param_.X->dims());
+  param_.Out->set_lod(param_.X->lod());
+  return true;
+}
+
+bool ElementwiseChainOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                    lite::Scope *scope) {
+  param_.X = scope->FindTensor(op_desc.Input("X").front());
+  param_.Y.clear();
+  if (op_desc.HasInput("Y")) {
+    for (const auto &name : op_desc.Input("Y")) {
+      param_.Y.push_back(scope->FindTensor(name));
+    }
+  }
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+  param_.step_types =
+      op_desc.GetAttr<std::vector<std::string>>("step_types");
+  param_.step_inputs = op_desc.GetAttr<std::vector<int>>("step_inputs");
+  param_.step_axes = op_desc.GetAttr<std::vector<int>>("step_axes");
+  param_.step_reversed = op_desc.GetAttr<std::vector<int>>("step_reversed");
+  param_.step_params = op_desc.GetAttr<std::vector<float>>("step_params");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(elementwise_chain,
+                 paddle::lite::operators::ElementwiseChainOp);
@@ -101,6 +101,20 @@ bool ElementwiseOp::AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) {
     param_.alpha = opdesc.GetAttr<float>("alpha");
     param_.bias = opdesc.GetAttr<float>("bias");
   }
+  // For Int8
+  const OpInfo* op_info = static_cast<const OpInfo*>(&opdesc);
+  if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
+    param_.enable_int8 = op_info->GetAttr<bool>("enable_int8");
+    auto x_scale_name = "X0_scale";
+    auto y_scale_name = "Y0_scale";
+    auto output_scale_name = "Out0_scale";
+    if (op_info->HasInputScale(x_scale_name, true))
+      param_.x_input_scale = op_info->GetInputScale(x_scale_name, true)[0];
+    if (op_info->HasInputScale(y_scale_name, true))
+      param_.y_input_scale = op_info->GetInputScale(y_scale_name, true)[0];
+    if (op_info->HasOutputScale(output_scale_name, true))
+      param_.output_scale = op_info->GetOutputScale(output_scale_name, true)[0];
+  }
   input_tensor_ptrs_cache_.push_back(param_.X);
   input_tensor_ptrs_cache_.push_back(param_.Y);
   output_tensor_ptrs_cache_.push_back(param_.Out);
@@ -0,0 +1,65 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/expand_batch_size_like_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool ExpandBatchSizeLikeOp::CheckShape() const {
+  CHECK(param_.x);
+  CHECK(param_.input);
+  CHECK(param_.out);
+  CHECK_GE(param_.input_dim_idx, 0);
+  CHECK_GE(param_.output_dim_idx, 0);
+  CHECK_LT(static_cast<size_t>(param_.input_dim_idx),
+           param_.input->dims().size());
+  CHECK_LT(static_cast<size_t>(param_.output_dim_idx),
+           param_.x->dims().size());
+  return true;
+}
+
+bool ExpandBatchSizeLikeOp::InferShapeImpl() const {
+  auto out_dims = param_.x->dims();
+  const int64_t rows = out_dims[param_.output_dim_idx];
+  const int64_t batch_size = param_.input->dims()[param_.input_dim_idx];
+  CHECK(rows == 1 || rows == batch_size)
+      << "Can't expand " << rows << " rows to the batch size " << batch_size;
+  out_dims[param_.output_dim_idx] = batch_size;
+  param_.out->Resize(out_dims);
+  return true;
+}
+
+bool ExpandBatchSizeLikeOp::AttachImpl(const cpp::OpDesc& opdesc,
+                                       lite::Scope* scope) {
+  param_.x = scope->FindTensor(opdesc.Input("X").front());
+  param_.input = scope->FindTensor(opdesc.Input("Input").front());
+  param_.out = scope->FindMutableTensor(opdesc.Output("Out").front());
+  if (opdesc.HasAttr("input_dim_idx")) {
+    param_.input_dim_idx = opdesc.GetAttr<int>("input_dim_idx");
+  }
+  if (opdesc.HasAttr("output_dim_idx")) {
+    param_.output_dim_idx = opdesc.GetAttr<int>("output_dim_idx");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(expand_batch_size_like,
+                 paddle::lite::operators::ExpandBatchSizeLikeOp);
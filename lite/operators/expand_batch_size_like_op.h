@@ -0,0 +1,52 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <string>
+#include "lite/core/op_lite.h"
+#include "lite/core/scope.h"
+#include "lite/utils/all.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+// Out is X repeated along `output_dim_idx` to the size of dim `input_dim_idx`
+// of Input, X must have 1 or that many rows along the dim. It's inserted by
+// shared_prefix_pass to broadcast the per-request tensors to the batch.
+class ExpandBatchSizeLikeOp : public OpLite {
+ public:
+  ExpandBatchSizeLikeOp() {}
+
+  explicit ExpandBatchSizeLikeOp(const std::string &op_type)
+      : OpLite(op_type) {}
+
+  bool CheckShape() const override;
+
+  bool InferShapeImpl() const override;
+
+  bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
+
+  void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
+  std::string DebugString() const override {
+    return "expand_batch_size_like";
+  }
+
+ private:
+  mutable ExpandBatchSizeLikeParam param_;
+};
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
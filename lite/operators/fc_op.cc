@@ -129,6 +129,9 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
   if (param_.activation_type == "relu6") {
     param_.alpha = op_desc.GetAttr<float>("alpha");
   }
+  if (op_desc.HasAttr("half_weight_type")) {
+    param_.half_weight_type = op_desc.GetAttr<std::string>("half_weight_type");
+  }
 
   // For Int8
   const OpInfo* op_info = static_cast<const OpInfo*>(&op_desc);
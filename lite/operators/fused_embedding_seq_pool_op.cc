@@ -0,0 +1,73 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_embedding_seq_pool_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedEmbeddingSeqPoolOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.W)
+  CHECK_OR_FALSE(param_.Ids)
+  CHECK_OR_FALSE(param_.Out)
+  CHECK_EQ(param_.Ids->lod().empty(), false)
+      << "Input(Ids) Tensor of FusedEmbeddingSeqPoolOp does not contain "
+         "LoD information.";
+  CHECK_GE_OR_FALSE(2UL, param_.Ids->lod().size());
+  CHECK_OR_FALSE(param_.pool_type == "SUM" || param_.pool_type == "AVERAGE")
+  CHECK_EQ_OR_FALSE(param_.W->dims().size(), 2)
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::InferShapeImpl() const {
+  // Same as the output of lookup_table(_v2) pooled by sequence_pool
+  auto out_dims = param_.Ids->dims().Vectorize();
+  if (param_.lookup_type == "lookup_table_v2") {
+    out_dims.push_back(param_.W->dims()[1]);
+  } else {
+    out_dims.back() = param_.W->dims()[1];
+  }
+  const auto& lod = param_.Ids->lod();
+  out_dims[0] = static_cast<int64_t>(lod.back().size()) - 1;
+  param_.Out->Resize(out_dims);
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::AttachImpl(const cpp::OpDesc& op_desc,
+                                         lite::Scope* scope) {
+  param_.W = scope->FindTensor(op_desc.Input("W").front());
+  param_.Ids = scope->FindTensor(op_desc.Input("Ids").front());
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+  if (op_desc.HasInput("W_scale")) {
+    auto names = op_desc.Input("W_scale");
+    if (!names.empty()) {
+      param_.W_scale = scope->FindTensor(names.front());
+    }
+  }
+  param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  param_.pool_type = op_desc.GetAttr<std::string>("pooltype");
+  if (op_desc.HasAttr("lookup_type")) {
+    param_.lookup_type = op_desc.GetAttr<std::string>("lookup_type");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_embedding_seq_pool,
+                 paddle::lite::operators::FusedEmbeddingSeqPoolOp);
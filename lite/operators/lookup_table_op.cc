@@ -60,6 +60,12 @@ bool LookupTableOpLite::AttachImpl(const cpp::OpDesc& op_desc,
   param_.Out = scope->FindMutableTensor(out);
 
   param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  if (op_desc.HasInput("W_scale")) {
+    auto names = op_desc.Input("W_scale");
+    if (!names.empty()) {
+      param_.W_scale = scope->FindTensor(names.front());
+    }
+  }
   if (op_desc.HasAttr("is_test")) {
     param_.is_test = op_desc.GetAttr<bool>("is_test");
   }
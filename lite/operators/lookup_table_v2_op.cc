@@ -58,6 +58,13 @@ bool LookupTableV2OpLite::AttachImpl(const cpp::OpDesc &op_desc,
 
   param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
 
+  if (op_desc.HasInput("W_scale")) {
+    auto names = op_desc.Input("W_scale");
+    if (!names.empty()) {
+      param_.W_scale = scope->FindTensor(names.front());
+    }
+  }
+
   return true;
 }
 
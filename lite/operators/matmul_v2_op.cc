@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/operators/matmul_v2_op.h"
+#include <algorithm>
 #include "lite/core/op_registry.h"
 
 namespace paddle {
@@ -52,7 +53,7 @@ bool MatMulV2OpLite::CheckShape() const {
         << "not supported x_dims(" << x_dims << ") and y_dims(" << y_dims
         << ")";
   } else if (y_dims.size() > 2 && x_dims.size() == 1) {
-    CHECK_EQ(x_dims[y_dims.size() - 1], x_dims[0])
+    CHECK_EQ(y_dims[y_dims.size() - (y_transpose ? 1 : 2)], x_dims[0])
         << "not supported x_dims(" << x_dims << ") and y_dims(" << y_dims
         << ")";
   } else if (x_dims.size() == 1 && y_dims.size() == 1) {
@@ -97,11 +98,15 @@ bool MatMulV2OpLite::InferShapeImpl() const {
   } else {
     N = dims_y[ndims_y - 1];
   }
-  std::vector<int64_t> new_dims;
-  if (ndims_x >= ndims_y) {
-    dim_out_vec.assign(dims_x.begin(), dims_x.end() - 2);
-  } else {
-    dim_out_vec.assign(dims_y.begin(), dims_y.end() - 2);
+  // The batch dims are broadcast against each other, right-aligned.
+  const int ndims_batch = (std::max)(ndims_x, ndims_y) - 2;
+  dim_out_vec.assign(ndims_batch, 1);
+  for (int i = 0; i < ndims_x - 2; ++i) {
+    dim_out_vec[ndims_batch - ndims_x + 2 + i] = dims_x[i];
+  }
+  for (int i = 0; i < ndims_y - 2; ++i) {
+    auto& dim = dim_out_vec[ndims_batch - ndims_y + 2 + i];
+    dim = dim == 1 ? dims_y[i] : dim;
   }
   if (!x_broadcasted) {
     dim_out_vec.push_back(M);
@@ -107,6 +107,8 @@ struct FcParam : ParamBase {
       "channel"};  // prelu param, can be "all", "channel" or "element"
   std::string op_type{"mul"};
   float alpha{6.f};
+  // "fp16" or "bf16" if w is stored in 16 bits, see x86_half_weight_pass
+  std::string half_weight_type{""};
   // for int8
   WITH_INT8_CONFIG
 };
@@ -289,6 +291,9 @@ struct ConcatParam : ParamBase {
   lite::Tensor* output{};
   int axis{0};
   lite::Tensor* axis_tensor{};
+  // for int8
+  WITH_INT8_CONFIG
+  std::vector<float> x_input_scales{};
 };
 
 /// ----------------------- activation operators ----------------------
@@ -323,6 +328,8 @@ struct ActivationParam : ParamBase {
   // softplus
   float softplus_beta{1.0f};
   float softplus_threshold{20.f};
+  // for int8
+  WITH_INT8_CONFIG
 };
 
 struct ActivationGradParam : ParamBase {
@@ -363,6 +370,24 @@ struct SparseConvParam : ParamBase {
   int bit_length{8};
 };
 
+// A depthwise conv followed by a 1x1 conv, fused by
+// depthwise_pointwise_conv_fuse_pass. paddings are {top, bottom, left, right}
+// of the depthwise conv, the 1x1 conv has stride 1 and no padding.
+// output = pw_act(pw_filter * dw_act(dw(x) + dw_bias) + pw_bias) + residual
+struct DepthwisePointwiseConvParam : ParamBase {
+  const lite::Tensor* x{};
+  const lite::Tensor* dw_filter{};
+  const lite::Tensor* dw_bias{nullptr};
+  const lite::Tensor* pw_filter{};
+  const lite::Tensor* pw_bias{nullptr};
+  const lite::Tensor* residual{nullptr};
+  lite::Tensor* output{};
+  std::vector<int> strides{1, 1};
+  std::vector<int> paddings{0, 0, 0, 0};
+  ActivationParam dw_activation_param;
+  ActivationParam pw_activation_param;
+};
+
 // For Convolution op
 struct ConvParam : ParamBase {
   lite::Tensor* x{};
@@ -411,6 +436,8 @@ struct ConvParam : ParamBase {
   // only used in conv_transpose.
   std::vector<int> output_size;
   std::vector<int> output_padding;
+  // "fp16" or "bf16" if filter is stored in 16 bits
+  std::string half_weight_type{""};
 
 #ifdef LITE_WITH_FPGA
   lite::Tensor* scale{nullptr};
@@ -574,6 +601,21 @@ struct FusionElementwiseActivationGradParam : public ElementwiseGradParam {
   std::string act_type;
 };
 
+// A chain of elementwise/activation/scale ops evaluated in one kernel. Step
+// k is step_types[k], binary steps read Y[step_inputs[k]] (or X when it is
+// -1) broadcast with step_axes[k], `step_reversed[k]` swaps the operands and
+// step_params holds three floats per step.
+struct ElementwiseChainParam : ParamBase {
+  const lite::Tensor* X{};
+  std::vector<const lite::Tensor*> Y{};
+  lite::Tensor* Out{};
+  std::vector<std::string> step_types{};
+  std::vector<int> step_inputs{};
+  std::vector<int> step_axes{};
+  std::vector<int> step_reversed{};
+  std::vector<float> step_params{};
+};
+
 /// ----------------------- mean operators ----------------------
 struct MeanParam : ParamBase {
   const lite::Tensor* X{};
@@ -622,6 +664,16 @@ struct FillConstantBatchSizeLikeParam : ParamBase {
   bool force_cpu{false};
 };
 
+// Repeats x along output_dim_idx to the size of input.dims()[input_dim_idx]
+struct ExpandBatchSizeLikeParam : ParamBase {
+  const lite::Tensor* x{nullptr};
+  const lite::Tensor* input{nullptr};
+  lite::Tensor* out{nullptr};
+
+  int input_dim_idx{0};
+  int output_dim_idx{0};
+};
+
 //
 struct FakeQuantizeMovingAvgMaxAbsParam : ParamBase {
   const lite::Tensor* x{};
@@ -962,12 +1014,27 @@ struct LookupTableParam : ParamBase {
   const lite::Tensor* W{nullptr};
   const lite::Tensor* Ids{nullptr};
   lite::Tensor* Out{nullptr};
+  // Per-row dequantization scales of a row-wise int8 table
+  const lite::Tensor* W_scale{nullptr};
   int64_t padding_idx{-1};
   bool is_test{true};
   std::string entry_config{""};  // used in distributed training
   std::string entry{"none"};
 };
 
+struct FusedEmbeddingSeqPoolParam : ParamBase {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  const lite::Tensor* W_scale{nullptr};
+  lite::Tensor* Out{nullptr};
+  int64_t padding_idx{-1};
+  // SUM or AVERAGE
+  std::string pool_type{"SUM"};
+  // The fused lookup op, lookup_table_v2 appends the embedding dim to the
+  // shape of Ids instead of replacing the last one.
+  std::string lookup_type{"lookup_table"};
+};
+
 struct LookupTableDequantParam : ParamBase {
   lite::Tensor* W{nullptr};
   lite::Tensor* Ids{nullptr};
@@ -1386,6 +1453,8 @@ struct MatMulParam : ParamBase {
   bool transpose_X{false};
   bool transpose_Y{false};
   float alpha{1.0f};
+  // "fp16" or "bf16" if Y is a weight stored in 16 bits
+  std::string half_weight_type{""};
   WITH_INT8_CONFIG
 };
 
@@ -89,6 +89,20 @@ class PoolOpLite : public OpLite {
     }
     param_.paddings = std::make_shared<std::vector<int>>(paddings);
 
+    // For Int8
+    const OpInfo *op_info = static_cast<const OpInfo *>(&op_desc);
+    if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
+      param_.enable_int8 = op_info->GetAttr<bool>("enable_int8");
+      auto input_scale_name = "X0_scale";
+      auto output_scale_name = "Out0_scale";
+      if (op_info->HasInputScale(input_scale_name, true))
+        param_.input_scale = op_info->GetInputScale(input_scale_name, true)[0];
+      if (op_info->HasOutputScale(output_scale_name, true)) {
+        param_.output_scale =
+            op_info->GetOutputScale(output_scale_name, true)[0];
+      }
+    }
+
 #ifdef LITE_WITH_XPU
     if (op_desc.HasAttr("pad_zero")) {
       param_.pad_zero = op_desc.GetAttr<bool>("pad_zero");
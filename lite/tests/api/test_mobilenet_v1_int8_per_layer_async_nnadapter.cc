@@ -0,0 +1,111 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/api/test/lite_api_test_helper.h"
+#include "lite/api/test/test_helper.h"
+#include "lite/tests/api/ILSVRC2012_utility.h"
+
+DEFINE_string(data_dir, "", "data dir");
+DEFINE_int32(iteration, 10, "iteration times to run");
+DEFINE_int32(batch, 1, "batch of image");
+DEFINE_int32(channel, 3, "image channel");
+DEFINE_int32(device_delay_ms, 20, "artificial latency of the fake device");
+
+namespace paddle {
+namespace lite {
+
+// Runs the model synchronously and asynchronously on the fake device, which
+// sleeps `device_delay_ms` in every execution, and checks that both produce
+// the same outputs.
+TEST(MobileNetV1, test_mobilenet_v1_int8_per_layer_async_nnadapter) {
+#if defined(LITE_WITH_NNADAPTER) && defined(NNADAPTER_WITH_FAKE_DEVICE)
+  std::vector<std::string> nnadapter_device_names{"fake_device"};
+  std::string nnadapter_context_properties =
+      "FAKE_DEVICE_EXECUTION_DELAY_MS=" + std::to_string(FLAGS_device_delay_ms);
+  std::vector<paddle::lite_api::Place> valid_places;
+  valid_places.push_back(lite_api::Place{TARGET(kNNAdapter), PRECISION(kInt8)});
+  valid_places.push_back(
+      lite_api::Place{TARGET(kNNAdapter), PRECISION(kFloat)});
+#if defined(LITE_WITH_ARM)
+  valid_places.push_back(lite_api::Place{TARGET(kARM), PRECISION(kInt8)});
+  valid_places.push_back(lite_api::Place{TARGET(kARM), PRECISION(kFloat)});
+#elif defined(LITE_WITH_X86)
+  valid_places.push_back(lite_api::Place{TARGET(kX86), PRECISION(kInt8)});
+  valid_places.push_back(lite_api::Place{TARGET(kX86), PRECISION(kFloat)});
+#else
+  LOG(INFO) << "Unsupported host arch!";
+  return;
+#endif
+  lite_api::CxxConfig cxx_config;
+  cxx_config.set_model_dir(FLAGS_model_dir);
+  cxx_config.set_valid_places(valid_places);
+  cxx_config.set_nnadapter_device_names(nnadapter_device_names);
+  cxx_config.set_nnadapter_context_properties(nnadapter_context_properties);
+  auto predictor = lite_api::CreatePaddlePredictor(cxx_config);
+  predictor->SaveOptimizedModel(FLAGS_model_dir,
+                                paddle::lite_api::LiteModelType::kNaiveBuffer);
+
+  std::string raw_data_dir = FLAGS_data_dir + std::string("/raw_data");
+  std::vector<int> input_shape{
+      FLAGS_batch, FLAGS_channel, FLAGS_im_width, FLAGS_im_height};
+  auto raw_data = ReadRawData(raw_data_dir, input_shape, FLAGS_iteration);
+  int input_size = 1;
+  for (auto i : input_shape) {
+    input_size *= i;
+  }
+
+  auto run = [&](bool async_execution, std::vector<std::vector<float>>* outs) {
+    paddle::lite_api::MobileConfig mobile_config;
+    mobile_config.set_model_from_file(FLAGS_model_dir + ".nb");
+    mobile_config.set_threads(FLAGS_threads);
+    mobile_config.set_nnadapter_device_names(nnadapter_device_names);
+    mobile_config.set_nnadapter_context_properties(
+        nnadapter_context_properties);
+    mobile_config.set_nnadapter_async_execution(async_execution);
+    auto predictor = paddle::lite_api::CreatePaddlePredictor(mobile_config);
+    outs->resize(raw_data.size());
+    double cost_time = 0;
+    for (size_t i = 0; i < raw_data.size(); ++i) {
+      auto input_tensor = predictor->GetInput(0);
+      input_tensor->Resize(
+          std::vector<int64_t>(input_shape.begin(), input_shape.end()));
+      auto* data = input_tensor->mutable_data<float>();
+      memcpy(data, raw_data[i].data(), sizeof(float) * input_size);
+      double start = GetCurrentUS();
+      predictor->Run();
+      cost_time += GetCurrentUS() - start;
+      auto output_tensor = predictor->GetOutput(0);
+      auto output_data = output_tensor->data<float>();
+      auto output_size = ShapeProduction(output_tensor->shape());
+      (*outs)[i].assign(output_data, output_data + output_size);
+    }
+    LOG(INFO) << (async_execution ? "async" : "sync") << " execution spends "
+              << cost_time / raw_data.size() / 1000.0 << " ms in average.";
+  };
+  std::vector<std::vector<float>> sync_outs, async_outs;
+  run(false, &sync_outs);
+  run(true, &async_outs);
+  ASSERT_EQ(sync_outs.size(), async_outs.size());
+  for (size_t i = 0; i < sync_outs.size(); i++) {
+    ASSERT_EQ(sync_outs[i], async_outs[i]);
+  }
+#endif
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,132 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/api/test/lite_api_test_helper.h"
+#include "lite/api/test/test_helper.h"
+#include "lite/tests/api/ILSVRC2012_utility.h"
+
+DEFINE_string(data_dir, "", "data dir");
+DEFINE_int32(iteration, 10, "iteration times to run");
+DEFINE_int32(batch, 1, "batch of image");
+DEFINE_int32(channel, 3, "image channel");
+DEFINE_int32(predictor_count, 4, "number of the predictors run concurrently");
+
+namespace paddle {
+namespace lite {
+
+// Checks that the cloned predictors and the ones loaded from the same model
+// reuse the device program compiled by the first predictor, even if they are
+// run on several threads at the same time.
+TEST(MobileNetV1, test_mobilenet_v1_int8_per_layer_program_cache_nnadapter) {
+#if defined(LITE_WITH_NNADAPTER) && defined(NNADAPTER_WITH_FAKE_DEVICE)
+  std::vector<std::string> nnadapter_device_names{"fake_device"};
+  std::vector<paddle::lite_api::Place> valid_places;
+  valid_places.push_back(lite_api::Place{TARGET(kNNAdapter), PRECISION(kInt8)});
+  valid_places.push_back(
+      lite_api::Place{TARGET(kNNAdapter), PRECISION(kFloat)});
+#if defined(LITE_WITH_ARM)
+  valid_places.push_back(lite_api::Place{TARGET(kARM), PRECISION(kInt8)});
+  valid_places.push_back(lite_api::Place{TARGET(kARM), PRECISION(kFloat)});
+#elif defined(LITE_WITH_X86)
+  valid_places.push_back(lite_api::Place{TARGET(kX86), PRECISION(kInt8)});
+  valid_places.push_back(lite_api::Place{TARGET(kX86), PRECISION(kFloat)});
+#else
+  LOG(INFO) << "Unsupported host arch!";
+  return;
+#endif
+  lite_api::CxxConfig cxx_config;
+  cxx_config.set_model_dir(FLAGS_model_dir);
+  cxx_config.set_valid_places(valid_places);
+  cxx_config.set_nnadapter_device_names(nnadapter_device_names);
+  auto predictor = lite_api::CreatePaddlePredictor(cxx_config);
+  predictor->SaveOptimizedModel(FLAGS_model_dir,
+                                paddle::lite_api::LiteModelType::kNaiveBuffer);
+  lite_api::ClearNNAdapterProgramCache();
+
+  std::string raw_data_dir = FLAGS_data_dir + std::string("/raw_data");
+  std::vector<int> input_shape{
+      FLAGS_batch, FLAGS_channel, FLAGS_im_width, FLAGS_im_height};
+  auto raw_data = ReadRawData(raw_data_dir, input_shape, FLAGS_iteration);
+  int input_size = 1;
+  for (auto i : input_shape) {
+    input_size *= i;
+  }
+  auto run = [&](std::shared_ptr<lite_api::PaddlePredictor> predictor,
+                 std::vector<std::vector<float>>* outs) {
+    outs->resize(raw_data.size());
+    for (size_t i = 0; i < raw_data.size(); ++i) {
+      auto input_tensor = predictor->GetInput(0);
+      input_tensor->Resize(
+          std::vector<int64_t>(input_shape.begin(), input_shape.end()));
+      auto* data = input_tensor->mutable_data<float>();
+      memcpy(data, raw_data[i].data(), sizeof(float) * input_size);
+      predictor->Run();
+      auto output_tensor = predictor->GetOutput(0);
+      auto output_data = output_tensor->data<float>();
+      auto output_size = ShapeProduction(output_tensor->shape());
+      (*outs)[i].assign(output_data, output_data + output_size);
+    }
+  };
+
+  paddle::lite_api::MobileConfig mobile_config;
+  mobile_config.set_model_from_file(FLAGS_model_dir + ".nb");
+  mobile_config.set_threads(FLAGS_threads);
+  mobile_config.set_nnadapter_device_names(nnadapter_device_names);
+  auto first_predictor = paddle::lite_api::CreatePaddlePredictor(mobile_config);
+  double start = GetCurrentUS();
+  std::vector<std::vector<float>> ref_outs;
+  run(first_predictor, &ref_outs);
+  LOG(INFO) << "The first predictor spends "
+            << (GetCurrentUS() - start) / 1000.0
+            << " ms including the compilation.";
+  auto ref_stats = lite_api::GetNNAdapterProgramCacheStats();
+  ASSERT_GT(ref_stats.misses, 0u);
+  ASSERT_GT(ref_stats.entries, 0u);
+
+  std::vector<std::shared_ptr<lite_api::PaddlePredictor>> predictors;
+  predictors.push_back(first_predictor->Clone());
+  for (int i = 1; i < FLAGS_predictor_count; i++) {
+    predictors.push_back(
+        paddle::lite_api::CreatePaddlePredictor(mobile_config));
+  }
+  std::vector<std::vector<std::vector<float>>> outs(predictors.size());
+  std::vector<std::thread> threads;
+  start = GetCurrentUS();
+  for (size_t i = 0; i < predictors.size(); i++) {
+    threads.emplace_back([&, i]() { run(predictors[i], &outs[i]); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  LOG(INFO) << predictors.size() << " predictors spend "
+            << (GetCurrentUS() - start) / 1000.0 << " ms concurrently.";
+  auto stats = lite_api::GetNNAdapterProgramCacheStats();
+  LOG(INFO) << "hits: " << stats.hits << " misses: " << stats.misses
+            << " evictions: " << stats.evictions
+            << " entries: " << stats.entries;
+  ASSERT_EQ(stats.misses, ref_stats.misses);
+  ASSERT_GE(stats.hits, ref_stats.hits + predictors.size());
+  for (size_t i = 0; i < predictors.size(); i++) {
+    ASSERT_EQ(outs[i], ref_outs);
+  }
+#endif
+}
+
+}  // namespace lite
+}  // namespace paddle
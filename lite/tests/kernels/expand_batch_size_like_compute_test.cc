@@ -0,0 +1,130 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/test/arena/framework.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+
+template <class T>
+class ExpandBatchSizeLikeComputeTester : public arena::TestCase {
+ protected:
+  std::string x_ = "X";
+  std::string input_ = "Input";
+  std::string out_ = "Out";
+  DDim x_dims_;
+  DDim input_dims_;
+  int input_dim_idx_;
+  int output_dim_idx_;
+
+ public:
+  ExpandBatchSizeLikeComputeTester(const Place& place,
+                                   const std::string& alias,
+                                   DDim x_dims,
+                                   DDim input_dims,
+                                   int input_dim_idx,
+                                   int output_dim_idx)
+      : TestCase(place, alias),
+        x_dims_(x_dims),
+        input_dims_(input_dims),
+        input_dim_idx_(input_dim_idx),
+        output_dim_idx_(output_dim_idx) {}
+
+  void RunBaseline(Scope* scope) override {
+    const auto* x = scope->FindTensor(x_);
+    auto* out = scope->NewTensor(out_);
+    auto out_dims = x_dims_;
+    const int64_t batch_size = input_dims_[input_dim_idx_];
+    out_dims[output_dim_idx_] = batch_size;
+    out->Resize(out_dims);
+    const T* x_data = x->template data<T>();
+    T* out_data = out->template mutable_data<T>();
+    const int64_t outer = x_dims_.count(0, output_dim_idx_);
+    const int64_t rows = x_dims_[output_dim_idx_];
+    const int64_t inner = x_dims_.count(output_dim_idx_ + 1, x_dims_.size());
+    for (int64_t i = 0; i < outer; i++) {
+      for (int64_t j = 0; j < batch_size; j++) {
+        for (int64_t k = 0; k < inner; k++) {
+          const int64_t row = rows == 1 ? 0 : j;
+          out_data[(i * batch_size + j) * inner + k] =
+              x_data[(i * rows + row) * inner + k];
+        }
+      }
+    }
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) {
+    op_desc->SetType("expand_batch_size_like");
+    op_desc->SetInput("X", {x_});
+    op_desc->SetInput("Input", {input_});
+    op_desc->SetOutput("Out", {out_});
+    op_desc->SetAttr("input_dim_idx", input_dim_idx_);
+    op_desc->SetAttr("output_dim_idx", output_dim_idx_);
+  }
+
+  void PrepareData() override {
+    std::vector<T> x_data(x_dims_.production());
+    fill_data_rand(x_data.data(),
+                   static_cast<T>(-10),
+                   static_cast<T>(10),
+                   x_dims_.production());
+    SetCommonTensor(x_, x_dims_, x_data.data());
+
+    std::vector<float> input_data(input_dims_.production(), 0.f);
+    SetCommonTensor(input_, input_dims_, input_data.data());
+  }
+};
+
+template <class T>
+void TestExpandBatchSizeLike(Place place) {
+  // The user side [1, D] of a CTR model broadcast to 100 candidates
+  for (int64_t batch_size : {1, 7, 100}) {
+    std::unique_ptr<arena::TestCase> tester(
+        new ExpandBatchSizeLikeComputeTester<T>(
+            place, "def", DDim({1, 16}), DDim({batch_size, 3}), 0, 0));
+    arena::Arena arena(std::move(tester), place, 0.f);
+    arena.TestPrecision();
+  }
+  // Already batched
+  std::unique_ptr<arena::TestCase> tester(
+      new ExpandBatchSizeLikeComputeTester<T>(
+          place, "def", DDim({5, 2, 3}), DDim({5, 1}), 0, 0));
+  arena::Arena arena(std::move(tester), place, 0.f);
+  arena.TestPrecision();
+  // A middle dim
+  std::unique_ptr<arena::TestCase> middle_tester(
+      new ExpandBatchSizeLikeComputeTester<T>(
+          place, "def", DDim({2, 1, 3}), DDim({4, 6}), 1, 1));
+  arena::Arena middle_arena(std::move(middle_tester), place, 0.f);
+  middle_arena.TestPrecision();
+}
+
+TEST(ExpandBatchSizeLike, precision) {
+  Place place;
+#if defined(LITE_WITH_ARM) || defined(LITE_WITH_X86)
+  place = TARGET(kHost);
+#else
+  return;
+#endif
+
+  TestExpandBatchSizeLike<float>(place);
+  TestExpandBatchSizeLike<int64_t>(place);
+}
+
+}  // namespace lite
+}  // namespace paddle
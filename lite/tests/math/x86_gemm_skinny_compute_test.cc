@@ -0,0 +1,242 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_skinny.h"
+#include "lite/core/context.h"
+#include "lite/core/profile/timer.h"
+#include "lite/core/tensor.h"
+#include "lite/tests/utils/tensor_utils.h"
+
+typedef paddle::lite::Tensor Tensor;
+using paddle::lite::profile::Timer;
+
+bool test_gemm_skinny(
+    bool trans, int m, int n, int k, bool has_bias, bool has_relu) {
+  Tensor ta, tb, tbias, tc;
+  ta.Resize({m, k});
+  tb.Resize(trans ? std::vector<int64_t>{n, k} : std::vector<int64_t>{k, n});
+  tbias.Resize({n});
+  tc.Resize({m, n});
+  ta.set_precision(PRECISION(kFloat));
+  tb.set_precision(PRECISION(kFloat));
+  tbias.set_precision(PRECISION(kFloat));
+  fill_tensor_rand(ta, -1.f, 1.f);
+  fill_tensor_rand(tb, -1.f, 1.f);
+  fill_tensor_rand(tbias, -1.f, 1.f);
+  auto a = ta.data<float>();
+  auto b = tb.data<float>();
+  auto bias = has_bias ? tbias.data<float>() : nullptr;
+  auto c = tc.mutable_data<float>();
+
+  std::vector<float> packed(paddle::lite::x86::math::skinny_packed_size(k, n));
+  paddle::lite::x86::math::pack_skinny_weight(
+      trans, k, n, b, trans ? k : n, packed.data());
+  paddle::lite::x86::math::gemm_skinny(
+      m, n, k, 0.5f, a, k, packed.data(), bias, has_relu, c, n);
+
+  float max_err = 0.f;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      float ref = 0.f;
+      for (int p = 0; p < k; p++) {
+        ref += a[i * k + p] * (trans ? b[j * k + p] : b[p * n + j]);
+      }
+      ref = 0.5f * ref + (bias ? bias[j] : 0.f);
+      if (has_relu) ref = std::max(ref, 0.f);
+      max_err = std::max(max_err, std::fabs(ref - c[i * n + j]));
+    }
+  }
+  return max_err < 1e-3f;
+}
+
+// gemm_skinny_half against the fp32 product of the expanded weight
+bool test_gemm_skinny_half(paddle::lite::x86::math::HalfType type,
+                           bool trans,
+                           int m,
+                           int n,
+                           int k,
+                           bool has_bias,
+                           bool has_relu) {
+  Tensor ta, tb, tbias, tc;
+  ta.Resize({m, k});
+  tb.Resize(trans ? std::vector<int64_t>{n, k} : std::vector<int64_t>{k, n});
+  tbias.Resize({n});
+  tc.Resize({m, n});
+  ta.set_precision(PRECISION(kFloat));
+  tb.set_precision(PRECISION(kFloat));
+  tbias.set_precision(PRECISION(kFloat));
+  fill_tensor_rand(ta, -1.f, 1.f);
+  fill_tensor_rand(tb, -1.f, 1.f);
+  fill_tensor_rand(tbias, -1.f, 1.f);
+  auto a = ta.data<float>();
+  auto bias = has_bias ? tbias.data<float>() : nullptr;
+  auto c = tc.mutable_data<float>();
+  // Round the weight to 16 bits and expand it back for the reference
+  std::vector<uint16_t> b_half(tb.numel());
+  std::vector<float> b(tb.numel());
+  for (int64_t i = 0; i < tb.numel(); i++) {
+    float value = tb.data<float>()[i];
+    if (type == paddle::lite::x86::math::HalfType::kFP16) {
+      b_half[i] = paddle::lite::fluid::float16(value).x;
+    } else {
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      b_half[i] = static_cast<uint16_t>(bits >> 16);
+    }
+  }
+  paddle::lite::x86::math::half_to_float(
+      type, b_half.data(), b.data(), tb.numel());
+
+  std::vector<uint16_t> packed(
+      paddle::lite::x86::math::skinny_packed_size(k, n));
+  paddle::lite::x86::math::pack_skinny_weight(
+      trans, k, n, b_half.data(), trans ? k : n, packed.data());
+  paddle::lite::x86::math::gemm_skinny_half(
+      type, m, n, k, 0.5f, a, k, packed.data(), bias, has_relu, c, n);
+
+  float max_err = 0.f;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      float ref = 0.f;
+      for (int p = 0; p < k; p++) {
+        ref += a[i * k + p] * (trans ? b[j * k + p] : b[p * n + j]);
+      }
+      ref = 0.5f * ref + (bias ? bias[j] : 0.f);
+      if (has_relu) ref = std::max(ref, 0.f);
+      max_err = std::max(max_err, std::fabs(ref - c[i * n + j]));
+    }
+  }
+  return max_err < 1e-3f;
+}
+
+TEST(TestX86GemmSkinny, gemm_skinny_compute) {
+  for (auto m : {1, 2, 3, 4, 7}) {
+    for (auto n : {1, 15, 16, 33, 100}) {
+      for (auto k : {1, 3, 64, 129}) {
+        for (auto trans : {true, false}) {
+          for (auto bias : {true, false}) {
+            for (auto relu : {true, false}) {
+              EXPECT_TRUE(test_gemm_skinny(trans, m, n, k, bias, relu))
+                  << "m: " << m << ", n: " << n << ", k: " << k
+                  << ", trans: " << trans << ", bias: " << bias
+                  << ", relu: " << relu;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86GemmSkinny, gemm_skinny_half_compute) {
+  for (auto type : {paddle::lite::x86::math::HalfType::kFP16,
+                    paddle::lite::x86::math::HalfType::kBF16}) {
+    for (auto m : {1, 4, 7, 16}) {
+      for (auto n : {1, 15, 16, 33, 100}) {
+        for (auto k : {1, 3, 64, 129}) {
+          for (auto trans : {true, false}) {
+            for (auto bias : {true, false}) {
+              EXPECT_TRUE(
+                  test_gemm_skinny_half(type, trans, m, n, k, bias, !bias))
+                  << "type: " << static_cast<int>(type) << ", m: " << m
+                  << ", n: " << n << ", k: " << k << ", trans: " << trans
+                  << ", bias: " << bias;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Weight bandwidth of gemm_skinny, gemm_skinny_half on fp16 weights and
+// Blas::GEMM on the fc shapes of BERT-base and CTR towers.
+TEST(TestX86GemmSkinny, gemm_skinny_bandwidth) {
+  std::unique_ptr<paddle::lite::KernelContext> ctx1(
+      new paddle::lite::KernelContext);
+  auto& ctx = ctx1->As<paddle::lite::X86Context>();
+  paddle::lite::x86::math::Blas<paddle::lite::TargetType::kX86> blas(ctx);
+  const int repeat = 20;
+  std::vector<std::pair<int, int>> kn{{768, 768}, {768, 3072}, {4096, 1024}};
+  for (auto m : {1, 2, 4}) {
+    for (auto& shape : kn) {
+      const int k = shape.first;
+      const int n = shape.second;
+      Tensor ta, tb, tc;
+      ta.Resize({m, k});
+      tb.Resize({k, n});
+      tc.Resize({m, n});
+      ta.set_precision(PRECISION(kFloat));
+      tb.set_precision(PRECISION(kFloat));
+      fill_tensor_rand(ta, -1.f, 1.f);
+      fill_tensor_rand(tb, -1.f, 1.f);
+      auto a = ta.data<float>();
+      auto b = tb.data<float>();
+      auto c = tc.mutable_data<float>();
+      std::vector<float> packed(
+          paddle::lite::x86::math::skinny_packed_size(k, n));
+      paddle::lite::x86::math::pack_skinny_weight(
+          false, k, n, b, n, packed.data());
+      std::vector<uint16_t> packed_half(packed.size());
+      for (size_t i = 0; i < packed.size(); i++) {
+        packed_half[i] = paddle::lite::fluid::float16(packed[i]).x;
+      }
+
+      Timer t0, t1, t2;
+      for (int i = 0; i < repeat; i++) {
+        t0.Start();
+        blas.GEMM<float>(false, false, m, n, k, 1.f, a, k, b, n, 0.f, c, n);
+        t0.Stop();
+        t1.Start();
+        paddle::lite::x86::math::gemm_skinny(
+            m, n, k, 1.f, a, k, packed.data(), nullptr, false, c, n);
+        t1.Stop();
+        t2.Start();
+        paddle::lite::x86::math::gemm_skinny_half(
+            paddle::lite::x86::math::HalfType::kFP16,
+            m,
+            n,
+            k,
+            1.f,
+            a,
+            k,
+            packed_half.data(),
+            nullptr,
+            false,
+            c,
+            n);
+        t2.Stop();
+      }
+      // bytes / ms / 1e6 = GB/s
+      const double gbytes = 4.0 * k * n / 1e6;
+      LOG(INFO) << "M: " << m << ", N: " << n << ", K: " << k
+                << ", gemm: " << gbytes / t0.LapTimes().Min()
+                << " GB/s, gemm_skinny: " << gbytes / t1.LapTimes().Min()
+                << " GB/s, gemm_skinny_half: "
+                << gbytes / 2 / t2.LapTimes().Min() << " GB/s";
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
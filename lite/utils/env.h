@@ -46,6 +46,12 @@
 #define QUANT_INPUT_OUTPUT_SCALE_RESTRICT_METHOD \
   "QUANT_INPUT_OUTPUT_SCALE_RESTRICT_METHOD"
 
+// The environment variables for the optimizer settings.
+// The constant folding pass stops folding ops once the tensors they produce
+// take this many bytes more than the weights they make unused, so broadcasts
+// of small weights don't blow up the model file. Defaults to 4MB.
+#define CONSTANT_FOLDING_MAX_BYTES "CONSTANT_FOLDING_MAX_BYTES"
+
 namespace paddle {
 namespace lite {
 